@@ -19,6 +19,7 @@
 
 #include "capi/astra_core.h"
 #include <astra_core/StreamDescription.hpp>
+#include <astra_core/Stats.hpp>
 #include <stdexcept>
 
 namespace astra {
@@ -58,6 +59,23 @@ namespace astra {
             astra_stream_stop(connection_);
         }
 
+        StreamStats stats()
+        {
+            if(connection_ == nullptr)
+            {
+                throw std::logic_error("Cannot get stats for a stream that is not available");
+            }
+
+            astra_stream_stats_t stats{};
+            if (astra_stream_get_stats(connection_, &stats) != ASTRA_STATUS_SUCCESS)
+            {
+                //a failed call may have filled part of stats, report nothing instead
+                return StreamStats(astra_stream_stats_t{});
+            }
+
+            return StreamStats(stats);
+        }
+
     private:
         astra_streamconnection_t connection_{nullptr};
         astra_stream_desc_t description_;
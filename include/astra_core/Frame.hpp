@@ -50,6 +50,20 @@ namespace astra {
             return frameRef_->get_frame() != nullptr;
         }
 
+        // keeps this frame's data valid after the frame is closed without
+        // copying it. the reader carries on presenting new frames meanwhile.
+        Frame retain()
+        {
+            astra_reader_frame_t retainedFrame = nullptr;
+
+            if (is_valid())
+            {
+                astra_frame_retain(frameRef_->get_frame(), &retainedFrame);
+            }
+
+            return Frame(retainedFrame);
+        }
+
         operator bool()
         {
             return is_valid();
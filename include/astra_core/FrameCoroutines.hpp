@@ -0,0 +1,281 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#ifndef ASTRA_FRAMECOROUTINES_HPP
+#define ASTRA_FRAMECOROUTINES_HPP
+
+// coroutine frame API, enabled by building with ASTRA_COROUTINES (C++20)
+#if defined(ASTRA_COROUTINES)
+
+#if !defined(__cpp_impl_coroutine)
+#error "ASTRA_COROUTINES requires a C++20 compiler with coroutine support"
+#endif
+
+#include <coroutine>
+#include <deque>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include "capi/astra_core.h"
+#include <astra_core/Frame.hpp>
+#include <astra_core/FrameExecutor.hpp>
+#include <astra_core/StreamReader.hpp>
+
+namespace astra {
+
+    // Frames from one reader as they arrive, for coroutines that loop over
+    // a reader:
+    //
+    //   FrameSequence frames = reader.frames();
+    //   for (;;) { Frame frame = co_await frames.next(); ... }
+    //
+    // Frames are retained, so they stay valid after the reader moves on.
+    // Coroutines resume on the executor, never on the thread that raised
+    // frame ready. When more than maxPendingFrames are waiting, the oldest
+    // is dropped. Once the reader is destroyed, the frames already pending
+    // are delivered and after them an invalid frame, so a waiting coroutine
+    // can return instead of staying suspended forever.
+    class FrameSequence
+    {
+    private:
+        struct State
+        {
+            State(FrameExecutor& executor, size_t maxPendingFrames)
+                : executor(executor),
+                  maxPendingFrames(maxPendingFrames > 0 ? maxPendingFrames : 1)
+            { }
+
+            FrameExecutor& executor;
+            const size_t maxPendingFrames;
+
+            std::mutex mutex;
+            std::deque<Frame> pending;
+            std::coroutine_handle<> waiting;
+            astra_reader_callback_id_t callbackId{nullptr};
+            bool closed{false};
+        };
+
+        using StatePtr = std::shared_ptr<State>;
+
+    public:
+        class NextAwaitable
+        {
+        public:
+            NextAwaitable(State& state)
+                : state_(state)
+            { }
+
+            bool await_ready()
+            {
+                std::lock_guard<std::mutex> lock(state_.mutex);
+                return !state_.pending.empty() || state_.closed;
+            }
+
+            bool await_suspend(std::coroutine_handle<> handle)
+            {
+                std::lock_guard<std::mutex> lock(state_.mutex);
+
+                //a frame may have arrived, or the reader gone, since await_ready()
+                if (!state_.pending.empty() || state_.closed)
+                    return false;
+
+                state_.waiting = handle;
+                return true;
+            }
+
+            Frame await_resume()
+            {
+                std::lock_guard<std::mutex> lock(state_.mutex);
+
+                if (state_.pending.empty())
+                    return Frame(nullptr);
+
+                Frame frame = std::move(state_.pending.front());
+                state_.pending.pop_front();
+                return frame;
+            }
+
+        private:
+            State& state_;
+        };
+
+        FrameSequence(StreamReader& reader, FrameExecutor& executor, size_t maxPendingFrames)
+            : state_(std::make_shared<State>(executor, maxPendingFrames)),
+              readerRef_(reader.readerRef_)
+        {
+            astra_reader_register_frame_ready_callback(reader.readerRef_->get_reader(),
+                                                       &FrameSequence::frame_ready_thunk,
+                                                       state_.get(),
+                                                       &state_->callbackId);
+
+            //the hook owns the state too, the reader may outlive this sequence
+            StatePtr state = state_;
+            closeHookId_ = reader.readerRef_->add_close_hook([state] { close(*state); });
+        }
+
+        ~FrameSequence()
+        {
+            if (!state_)
+                return;
+
+            if (auto readerRef = readerRef_.lock())
+            {
+                readerRef->remove_close_hook(closeHookId_);
+            }
+
+            unregister_callback(*state_);
+        }
+
+        FrameSequence(FrameSequence&& other) noexcept
+            : state_(std::move(other.state_)),
+              readerRef_(std::move(other.readerRef_)),
+              closeHookId_(other.closeHookId_)
+        { }
+
+        FrameSequence(const FrameSequence&) = delete;
+        FrameSequence& operator=(const FrameSequence&) = delete;
+        FrameSequence& operator=(FrameSequence&&) = delete;
+
+        // only one coroutine may wait on a sequence at a time
+        NextAwaitable next() { return NextAwaitable(*state_); }
+
+    private:
+        static void frame_ready_thunk(void* clientTag,
+                                      astra_reader_t reader,
+                                      astra_reader_frame_t frame)
+        {
+            State* state = static_cast<State*>(clientTag);
+
+            astra_reader_frame_t retainedFrame = nullptr;
+            if (astra_frame_retain(frame, &retainedFrame) != ASTRA_STATUS_SUCCESS ||
+                retainedFrame == nullptr)
+            {
+                return;
+            }
+
+            std::coroutine_handle<> waiting;
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+
+                if (state->pending.size() >= state->maxPendingFrames)
+                {
+                    state->pending.pop_front();
+                }
+
+                state->pending.emplace_back(retainedFrame);
+                waiting = std::exchange(state->waiting, nullptr);
+            }
+
+            //the resumed coroutine may destroy the sequence, state is not used after this
+            if (waiting)
+            {
+                state->executor.execute([waiting] { waiting.resume(); });
+            }
+        }
+
+        // runs while the reader is being destroyed
+        static void close(State& state)
+        {
+            //no frame ready comes after this, so the waiter is resumed once
+            unregister_callback(state);
+
+            std::coroutine_handle<> waiting;
+            {
+                std::lock_guard<std::mutex> lock(state.mutex);
+                state.closed = true;
+                waiting = std::exchange(state.waiting, nullptr);
+            }
+
+            if (waiting)
+            {
+                state.executor.execute([waiting] { waiting.resume(); });
+            }
+        }
+
+        static void unregister_callback(State& state)
+        {
+            astra_reader_callback_id_t callbackId;
+            {
+                std::lock_guard<std::mutex> lock(state.mutex);
+                callbackId = std::exchange(state.callbackId, nullptr);
+            }
+
+            //no callback is running once this returns, they hold the core mutex
+            if (callbackId != nullptr)
+            {
+                astra_reader_unregister_frame_ready_callback(&callbackId);
+            }
+        }
+
+        StatePtr state_;
+        std::weak_ptr<StreamReader::ReaderRef> readerRef_;
+        size_t closeHookId_{0};
+    };
+
+    // co_await reader.next_frame() resumes with the first frame raised after
+    // next_frame() was called, or an invalid frame if the reader is destroyed
+    class NextFrameAwaitable
+    {
+    public:
+        NextFrameAwaitable(StreamReader& reader, FrameExecutor& executor)
+            : sequence_(reader, executor, 1)
+        { }
+
+        bool await_ready() { return sequence_.next().await_ready(); }
+        bool await_suspend(std::coroutine_handle<> handle) { return sequence_.next().await_suspend(handle); }
+        Frame await_resume() { return sequence_.next().await_resume(); }
+
+    private:
+        FrameSequence sequence_;
+    };
+
+    // Fire-and-forget coroutine type for frame pipelines. The coroutine
+    // starts right away and frees itself when it finishes.
+    class FrameTask
+    {
+    public:
+        struct promise_type
+        {
+            FrameTask get_return_object() noexcept { return FrameTask(); }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() noexcept { }
+            void unhandled_exception() noexcept { std::terminate(); }
+        };
+    };
+
+    inline NextFrameAwaitable StreamReader::next_frame(FrameExecutor& executor)
+    {
+        if (!is_valid())
+            throw std::logic_error("StreamReader is not associated with a streamset.");
+
+        return NextFrameAwaitable(*this, executor);
+    }
+
+    inline FrameSequence StreamReader::frames(FrameExecutor& executor, size_t maxPendingFrames)
+    {
+        if (!is_valid())
+            throw std::logic_error("StreamReader is not associated with a streamset.");
+
+        return FrameSequence(*this, executor, maxPendingFrames);
+    }
+}
+
+#endif // ASTRA_COROUTINES
+
+#endif // ASTRA_FRAMECOROUTINES_HPP
@@ -0,0 +1,139 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#ifndef ASTRA_FRAMEEXECUTOR_HPP
+#define ASTRA_FRAMEEXECUTOR_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace astra {
+
+    // Runs frame listener callbacks off the thread that produced the frame.
+    // Implement this to deliver frames on an application-owned thread pool.
+    class FrameExecutor
+    {
+    public:
+        virtual ~FrameExecutor() = default;
+        virtual void execute(std::function<void()> task) = 0;
+    };
+
+    // What an asynchronous listener does with a new frame while it is still
+    // busy and its queue of pending frames is full
+    enum class BackpressurePolicy
+    {
+        // discard the oldest pending frame to make room
+        DropOldest,
+        // discard the new frame
+        DropNewest,
+        // keep every frame. the thread delivering frames waits until the
+        // listener takes one off its queue, which holds up frame delivery
+        // but not other readers of the stream. while the queue is full the
+        // listener should only read its frame, other calls into astra wait
+        // on the delivering thread.
+        Block
+    };
+
+    class ThreadPoolExecutor : public FrameExecutor
+    {
+    public:
+        explicit ThreadPoolExecutor(size_t threadCount = default_thread_count())
+        {
+            if (threadCount == 0)
+            {
+                threadCount = 1;
+            }
+
+            for (size_t i = 0; i < threadCount; ++i)
+            {
+                threads_.push_back(std::thread(&ThreadPoolExecutor::run, this));
+            }
+        }
+
+        // runs the tasks already queued, then joins the threads
+        ~ThreadPoolExecutor()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            condition_.notify_all();
+
+            for (auto& thread : threads_)
+            {
+                thread.join();
+            }
+        }
+
+        ThreadPoolExecutor(const ThreadPoolExecutor&) = delete;
+        ThreadPoolExecutor& operator=(const ThreadPoolExecutor&) = delete;
+
+        void execute(std::function<void()> task) override
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                tasks_.push_back(std::move(task));
+            }
+            condition_.notify_one();
+        }
+
+        static size_t default_thread_count()
+        {
+            size_t count = std::thread::hardware_concurrency();
+            return count > 0 ? count : 2;
+        }
+
+    private:
+        void run()
+        {
+            for (;;)
+            {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    condition_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+
+                    if (tasks_.empty())
+                        return;
+
+                    task = std::move(tasks_.front());
+                    tasks_.pop_front();
+                }
+
+                task();
+            }
+        }
+
+        std::mutex mutex_;
+        std::condition_variable condition_;
+        std::deque<std::function<void()>> tasks_;
+        std::vector<std::thread> threads_;
+        bool stopping_{false};
+    };
+
+    // thread pool shared by asynchronous listeners that don't bring their own
+    inline FrameExecutor& default_frame_executor()
+    {
+        static ThreadPoolExecutor executor;
+        return executor;
+    }
+}
+
+#endif // ASTRA_FRAMEEXECUTOR_HPP
@@ -0,0 +1,121 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#ifndef ASTRA_STATS_HPP
+#define ASTRA_STATS_HPP
+
+#include "capi/astra_core.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace astra {
+
+    class Histogram
+    {
+    public:
+        Histogram(const astra_histogram_t& histogram)
+            : histogram_(histogram)
+        {}
+
+        uint64_t count() const { return histogram_.count; }
+        uint64_t max_microseconds() const { return histogram_.maxMicroseconds; }
+
+        double mean_microseconds() const
+        {
+            if (histogram_.count == 0)
+                return 0;
+
+            return static_cast<double>(histogram_.sumMicroseconds) / histogram_.count;
+        }
+
+        // upper bound of the bucket holding the given fraction of samples,
+        // e.g. percentile_microseconds(0.99)
+        uint64_t percentile_microseconds(double fraction) const
+        {
+            if (histogram_.count == 0)
+                return 0;
+
+            const double target = fraction * histogram_.count;
+            uint64_t seen = 0;
+            for (int i = 0; i < ASTRA_STATS_HISTOGRAM_BUCKETS - 1; ++i)
+            {
+                seen += histogram_.buckets[i];
+                if (seen >= target)
+                {
+                    uint64_t upperBound = uint64_t(1) << i;
+                    return upperBound < histogram_.maxMicroseconds ? upperBound : histogram_.maxMicroseconds;
+                }
+            }
+
+            return histogram_.maxMicroseconds;
+        }
+
+        const astra_histogram_t& get() const { return histogram_; }
+
+    private:
+        astra_histogram_t histogram_;
+    };
+
+    class StreamStats
+    {
+    public:
+        StreamStats(const astra_stream_stats_t& stats)
+            : stats_(stats)
+        {}
+
+        uint64_t frames_produced() const { return stats_.framesProduced; }
+        uint64_t frames_overwritten() const { return stats_.framesOverwritten; }
+        uint64_t frames_delivered() const { return stats_.framesDelivered; }
+        uint64_t frames_skipped() const { return stats_.framesSkipped; }
+        float frames_per_second() const { return stats_.framesPerSecond; }
+
+        Histogram frame_period() const { return Histogram(stats_.framePeriod); }
+        Histogram delivery_latency() const { return Histogram(stats_.deliveryLatency); }
+        Histogram lock_duration() const { return Histogram(stats_.lockDuration); }
+        Histogram client_hold_time() const { return Histogram(stats_.clientHoldTime); }
+
+        const astra_stream_stats_t& get() const { return stats_; }
+
+    private:
+        astra_stream_stats_t stats_;
+    };
+
+    struct PluginStats
+    {
+        std::string name;
+        Histogram updateDuration;
+    };
+
+    inline std::vector<PluginStats> get_plugin_stats()
+    {
+        astra_context_stats_t stats;
+        std::vector<PluginStats> pluginStats;
+
+        if (astra_context_get_stats(&stats) != ASTRA_STATUS_SUCCESS)
+            return pluginStats;
+
+        for (uint32_t i = 0; i < stats.pluginCount; ++i)
+        {
+            pluginStats.push_back(PluginStats{ stats.plugins[i].name,
+                                               Histogram(stats.plugins[i].updateDuration) });
+        }
+
+        return pluginStats;
+    }
+}
+
+#endif // ASTRA_STATS_HPP
@@ -20,14 +20,25 @@
 #include "capi/astra_core.h"
 #include <astra_core/FrameListener.hpp>
 #include <astra_core/Frame.hpp>
+#include <astra_core/FrameExecutor.hpp>
 #include <memory>
 #include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
 #include <algorithm>
 #include <functional>
 #include <iterator>
+#include <utility>
 
 namespace astra {
 
+#if defined(ASTRA_COROUTINES)
+    class NextFrameAwaitable;
+    class FrameSequence;
+#endif
+
     class StreamReader
     {
     public:
@@ -36,7 +47,7 @@ namespace astra {
         {}
 
         StreamReader(astra_reader_t reader)
-            : readerRef_(std::make_shared<ReaderRef>(reader))
+            : readerRef_(ReaderRef::create(reader))
         {}
 
         StreamReader(const StreamReader& reader)
@@ -70,6 +81,10 @@ namespace astra {
             return T(connection);
         }
 
+        // the listener is called on the thread that updates the plugins, with the
+        // core mutex held: the caller of astra_temp_update() until a reader first
+        // blocks waiting for a frame, and a core update thread from then on (or
+        // always, with background update configured).
         void add_listener(FrameListener& listener)
         {
             if (!is_valid())
@@ -78,6 +93,22 @@ namespace astra {
             readerRef_.get()->add_listener(listener);
         }
 
+        // calls the listener on the executor instead of the thread that
+        // produced the frame. each listener gets one frame at a time, in order.
+        // frames are held until every asynchronous listener is done with them.
+        // remove_listener() waits for a running callback to return, so don't
+        // remove an asynchronous listener from inside another listener.
+        void add_listener(FrameListener& listener,
+                          FrameExecutor& executor,
+                          BackpressurePolicy policy = BackpressurePolicy::DropOldest,
+                          size_t maxPendingFrames = 1)
+        {
+            if (!is_valid())
+                throw std::logic_error("StreamReader is not associated with a streamset.");
+
+            readerRef_.get()->add_async_listener(listener, executor, policy, maxPendingFrames);
+        }
+
         void remove_listener(FrameListener& listener)
         {
             if (!is_valid())
@@ -88,6 +119,8 @@ namespace astra {
 
         bool is_valid() { return readerRef_ != nullptr; }
 
+        astra_reader_t get_handle() const { return readerRef_ != nullptr ? readerRef_->get_reader() : nullptr; }
+
         Frame get_latest_frame(int timeoutMillis = ASTRA_TIMEOUT_FOREVER)
         {
             if (!is_valid())
@@ -99,6 +132,49 @@ namespace astra {
             return astra::Frame(frame);
         }
 
+        void set_sync_policy(astra_reader_sync_policy_t policy,
+                             uint32_t toleranceMicroseconds = 0)
+        {
+            if (!is_valid())
+                throw std::logic_error("StreamReader is not associated with a streamset.");
+
+            astra_reader_set_sync_policy(readerRef_->get_reader(), policy, toleranceMicroseconds);
+        }
+
+        // blocks until any of the readers has a new frame and returns its
+        // index, or -1 on timeout or when all the readers are destroyed
+        // while waiting. get_latest_frame() on that reader then returns
+        // without blocking.
+        static int wait_any(const std::vector<StreamReader>& readers,
+                            int timeoutMillis = ASTRA_TIMEOUT_FOREVER)
+        {
+            std::vector<astra_reader_t> readerHandles;
+            readerHandles.reserve(readers.size());
+
+            for (const StreamReader& reader : readers)
+            {
+                if (reader.readerRef_ == nullptr)
+                    throw std::logic_error("StreamReader is not associated with a streamset.");
+
+                readerHandles.push_back(reader.readerRef_->get_reader());
+            }
+
+            size_t readyIndex = 0;
+            astra_status_t rc = astra_reader_wait_any(readerHandles.data(),
+                                                      readerHandles.size(),
+                                                      timeoutMillis,
+                                                      &readyIndex);
+
+            return rc == ASTRA_STATUS_SUCCESS ? static_cast<int>(readyIndex) : -1;
+        }
+
+#if defined(ASTRA_COROUTINES)
+        // see FrameCoroutines.hpp
+        NextFrameAwaitable next_frame(FrameExecutor& executor = default_frame_executor());
+        FrameSequence frames(FrameExecutor& executor = default_frame_executor(),
+                             size_t maxPendingFrames = 1);
+#endif
+
     private:
         class ReaderRef;
         using ReaderRefPtr = std::shared_ptr<ReaderRef>;
@@ -107,18 +183,230 @@ namespace astra {
             : readerRef_(readerRef)
         { }
 
-        class ReaderRef :
-            public std::enable_shared_from_this<ReaderRef>
+        using ReaderRefWeakPtr = std::weak_ptr<ReaderRef>;
+
+        // keeps a retained reader frame for asynchronous listeners,
+        // released when the last listener lets go of it. it doesn't keep
+        // the reader alive, a retained frame outlives its reader.
+        class FrameHold
+        {
+        public:
+            FrameHold(astra_reader_frame_t frame)
+                : frame_(frame)
+            { }
+
+            ~FrameHold()
+            {
+                if (frame_ != nullptr)
+                {
+                    astra_reader_close_frame(&frame_);
+                }
+            }
+
+            FrameHold(const FrameHold&) = delete;
+            FrameHold& operator=(const FrameHold&) = delete;
+
+            astra_reader_frame_t get_frame() const { return frame_; }
+
+        private:
+            astra_reader_frame_t frame_;
+        };
+
+        using FrameHoldPtr = std::shared_ptr<FrameHold>;
+
+        class AsyncListener :
+            public std::enable_shared_from_this<AsyncListener>
+        {
+        public:
+            AsyncListener(ReaderRefWeakPtr readerRef,
+                          FrameListener& listener,
+                          FrameExecutor& executor,
+                          BackpressurePolicy policy,
+                          size_t maxPendingFrames)
+                : readerRef_(std::move(readerRef)),
+                  listener_(listener),
+                  executor_(executor),
+                  policy_(policy),
+                  maxPendingFrames_(maxPendingFrames > 0 ? maxPendingFrames : 1)
+            { }
+
+            FrameListener& get_listener() const { return listener_; }
+
+            void post(const FrameHoldPtr& hold)
+            {
+                FrameHoldPtr dropped;
+                bool startRunning = false;
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+
+                    if (closed_)
+                        return;
+
+                    if (pending_.size() >= maxPendingFrames_)
+                    {
+                        switch (policy_)
+                        {
+                        case BackpressurePolicy::DropNewest:
+                            return;
+                        case BackpressurePolicy::DropOldest:
+                            dropped = std::move(pending_.front());
+                            pending_.pop_front();
+                            break;
+                        case BackpressurePolicy::Block:
+                            //an executor running the listener on this thread
+                            //would never make room
+                            if (runningThread_ != std::this_thread::get_id())
+                            {
+                                spaceCondition_.wait(lock, [this] {
+                                    return closed_ || pending_.size() < maxPendingFrames_;
+                                });
+
+                                if (closed_)
+                                    return;
+                            }
+                            break;
+                        }
+                    }
+
+                    pending_.push_back(hold);
+
+                    if (!running_)
+                    {
+                        running_ = true;
+                        startRunning = true;
+                    }
+                }
+
+                if (startRunning)
+                {
+                    std::shared_ptr<AsyncListener> self = this->shared_from_this();
+                    executor_.execute([self] { self->run(); });
+                }
+            }
+
+            // drops pending frames and stops taking new ones. a thread
+            // blocked in post() returns without waiting for the callback.
+            void cancel()
+            {
+                std::deque<FrameHoldPtr> dropped;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    closed_ = true;
+                    dropped.swap(pending_);
+                    spaceCondition_.notify_all();
+                }
+            }
+
+            // cancels, then waits for a running callback to return. a run
+            // that is queued but hasn't started finds the listener closed.
+            void close()
+            {
+                cancel();
+
+                const std::thread::id self = std::this_thread::get_id();
+                std::unique_lock<std::mutex> lock(mutex_);
+                if (runningThread_ != self)
+                {
+                    idleCondition_.wait(lock, [this] { return runningThread_ == std::thread::id(); });
+                }
+            }
+
+        private:
+            void run()
+            {
+                for (;;)
+                {
+                    FrameHoldPtr hold;
+                    {
+                        std::lock_guard<std::mutex> lock(mutex_);
+
+                        if (closed_ || pending_.empty())
+                        {
+                            running_ = false;
+                            return;
+                        }
+
+                        hold = std::move(pending_.front());
+                        pending_.pop_front();
+                        runningThread_ = std::this_thread::get_id();
+                        spaceCondition_.notify_all();
+                    }
+
+                    deliver(hold);
+                    hold = nullptr;
+
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    runningThread_ = std::thread::id();
+                    idleCondition_.notify_all();
+                }
+            }
+
+            void deliver(const FrameHoldPtr& hold)
+            {
+                //the reader is going away and closes this listener
+                ReaderRefPtr readerRef = readerRef_.lock();
+                if (!readerRef)
+                    return;
+
+                //the hold closes the frame, not the wrapper
+                const bool autoCloseFrame = false;
+                astra::Frame frame(hold->get_frame(), autoCloseFrame);
+                StreamReader reader(std::move(readerRef));
+
+                //if the app let go of the reader meanwhile, it is destroyed
+                //here, on this thread
+                listener_.on_frame_ready(reader, frame);
+            }
+
+            const ReaderRefWeakPtr readerRef_;
+            FrameListener& listener_;
+            FrameExecutor& executor_;
+            const BackpressurePolicy policy_;
+            const size_t maxPendingFrames_;
+
+            std::mutex mutex_;
+            std::condition_variable idleCondition_;
+            std::condition_variable spaceCondition_;
+            std::deque<FrameHoldPtr> pending_;
+            std::thread::id runningThread_;
+            bool running_{false};
+            bool closed_{false};
+        };
+
+        using AsyncListenerPtr = std::shared_ptr<AsyncListener>;
+
+        class ReaderRef
         {
         public:
             ReaderRef(astra_reader_t reader)
                 :  reader_(reader)
             { }
 
+            static ReaderRefPtr create(astra_reader_t reader)
+            {
+                ReaderRefPtr readerRef = std::make_shared<ReaderRef>(reader);
+                readerRef->self_ = readerRef;
+                return readerRef;
+            }
+
             ~ReaderRef()
             {
-                listeners_.clear();
+                //a thread delivering a frame may be blocked on a full
+                //listener queue, let it go so the callback can be removed
+                cancel_async_listeners();
+
+                //waits for a frame being delivered, after this nothing
+                //calls back into this reader
                 ensure_callback_removed();
+
+                listeners_.clear();
+
+                //a thread raising frames holds the core mutex, which a running
+                //callback may be waiting on, so it doesn't wait for them. a
+                //callback that could still reach its listener holds the reader,
+                //so the ones left only release their frame.
+                close_async_listeners(!is_raising_frames());
+                run_close_hooks();
                 astra_reader_destroy(&reader_);
             }
 
@@ -127,7 +415,10 @@ namespace astra {
                                           astra_reader_frame_t frame)
             {
                 ReaderRef* self = static_cast<ReaderRef*>(clientTag);
+
+                ++raising_depth();
                 self->notify_listeners(frame);
+                --raising_depth();
             }
 
             void add_listener(FrameListener& listener)
@@ -151,8 +442,41 @@ namespace astra {
                 }
             }
 
+            void add_async_listener(FrameListener& listener,
+                                    FrameExecutor& executor,
+                                    BackpressurePolicy policy,
+                                    size_t maxPendingFrames)
+            {
+                ensure_callback_added();
+
+                std::lock_guard<std::mutex> lock(asyncMutex_);
+
+                auto it = std::find_if(asyncListeners_.begin(),
+                                       asyncListeners_.end(),
+                                       [&listener] (const AsyncListenerPtr& async)
+                                       { return async->get_listener() == listener; });
+
+                if (it != asyncListeners_.end())
+                    return;
+
+                asyncListeners_.push_back(std::make_shared<AsyncListener>(self_,
+                                                                          listener,
+                                                                          executor,
+                                                                          policy,
+                                                                          maxPendingFrames));
+            }
+
             void remove_listener(FrameListener& listener)
             {
+                if (remove_async_listener(listener))
+                {
+                    if (listeners_.size() == 0 && !has_async_listeners())
+                    {
+                        ensure_callback_removed();
+                    }
+                    return;
+                }
+
                 auto it = std::find(listeners_.begin(),
                                     listeners_.end(),
                                     listener);
@@ -169,7 +493,7 @@ namespace astra {
                     listeners_.erase(it);
                 }
 
-                if (listeners_.size() == 0)
+                if (listeners_.size() == 0 && !has_async_listeners())
                 {
                     ensure_callback_removed();
                 }
@@ -177,6 +501,12 @@ namespace astra {
 
             void notify_listeners(astra_reader_frame_t readerFrame)
             {
+                //the last reference went away on another thread, which is
+                //waiting to remove the callback
+                ReaderRefPtr self = self_.lock();
+                if (!self)
+                    return;
+
                 if (removedListeners_.size() > 0)
                 {
                     for(FrameListener& listener : removedListeners_)
@@ -193,10 +523,17 @@ namespace astra {
                 std::move(addedListeners_.begin(),
                           addedListeners_.end(),
                           std::back_inserter(listeners_));
+                addedListeners_.clear();
+
+                //async listeners start first so they run alongside the others
+                notify_async_listeners(readerFrame);
 
                 if (listeners_.size() == 0)
                 {
-                    ensure_callback_removed();
+                    if (!has_async_listeners())
+                    {
+                        ensure_callback_removed();
+                    }
                     return;
                 }
 
@@ -206,7 +543,7 @@ namespace astra {
                 astra::Frame frameWrapper(readerFrame, autoCloseFrame);
 
                 isNotifying_ = true;
-                StreamReader reader(shared_from_this());
+                StreamReader reader(std::move(self));
                 for(FrameListener& listener : listeners_)
                 {
                     listener.on_frame_ready(reader, frameWrapper);
@@ -217,7 +554,149 @@ namespace astra {
 
             astra_reader_t get_reader() { return reader_; }
 
+            // hooks run once when the reader is destroyed, for anything
+            // still waiting on its frames
+            size_t add_close_hook(std::function<void()> hook)
+            {
+                std::lock_guard<std::mutex> lock(closeHookMutex_);
+                closeHooks_.emplace_back(++lastCloseHookId_, std::move(hook));
+                return lastCloseHookId_;
+            }
+
+            void remove_close_hook(size_t hookId)
+            {
+                std::lock_guard<std::mutex> lock(closeHookMutex_);
+
+                auto it = std::find_if(closeHooks_.begin(),
+                                       closeHooks_.end(),
+                                       [hookId] (const CloseHook& hook)
+                                       { return hook.first == hookId; });
+
+                if (it != closeHooks_.end())
+                {
+                    closeHooks_.erase(it);
+                }
+            }
+
         private:
+            void notify_async_listeners(astra_reader_frame_t readerFrame)
+            {
+                std::vector<AsyncListenerPtr> asyncListeners;
+                {
+                    std::lock_guard<std::mutex> lock(asyncMutex_);
+                    asyncListeners = asyncListeners_;
+                }
+
+                //every listener shares one retained frame, so the reader and
+                //its streams move on right away whatever the listeners do
+                FrameHoldPtr hold;
+                for (auto& asyncListener : asyncListeners)
+                {
+                    if (!hold)
+                    {
+                        hold = create_frame_hold(readerFrame);
+                    }
+
+                    if (hold)
+                    {
+                        asyncListener->post(hold);
+                    }
+                }
+            }
+
+            FrameHoldPtr create_frame_hold(astra_reader_frame_t readerFrame)
+            {
+                astra_reader_frame_t heldFrame = nullptr;
+                astra_status_t rc = astra_frame_retain(readerFrame, &heldFrame);
+
+                if (rc != ASTRA_STATUS_SUCCESS || heldFrame == nullptr)
+                    return nullptr;
+
+                return std::make_shared<FrameHold>(heldFrame);
+            }
+
+            bool remove_async_listener(FrameListener& listener)
+            {
+                AsyncListenerPtr removed;
+                {
+                    std::lock_guard<std::mutex> lock(asyncMutex_);
+
+                    auto it = std::find_if(asyncListeners_.begin(),
+                                           asyncListeners_.end(),
+                                           [&listener] (const AsyncListenerPtr& async)
+                                           { return async->get_listener() == listener; });
+
+                    if (it == asyncListeners_.end())
+                        return false;
+
+                    removed = *it;
+                    asyncListeners_.erase(it);
+                }
+
+                removed->close();
+                return true;
+            }
+
+            bool has_async_listeners()
+            {
+                std::lock_guard<std::mutex> lock(asyncMutex_);
+                return !asyncListeners_.empty();
+            }
+
+            void cancel_async_listeners()
+            {
+                std::lock_guard<std::mutex> lock(asyncMutex_);
+
+                for (auto& asyncListener : asyncListeners_)
+                {
+                    asyncListener->cancel();
+                }
+            }
+
+            void close_async_listeners(bool waitForCallbacks)
+            {
+                std::vector<AsyncListenerPtr> asyncListeners;
+                {
+                    std::lock_guard<std::mutex> lock(asyncMutex_);
+                    asyncListeners.swap(asyncListeners_);
+                }
+
+                for (auto& asyncListener : asyncListeners)
+                {
+                    if (waitForCallbacks)
+                    {
+                        asyncListener->close();
+                    }
+                    else
+                    {
+                        asyncListener->cancel();
+                    }
+                }
+            }
+
+            //frames raised on this thread, the core calls back with its mutex held
+            static int& raising_depth()
+            {
+                static thread_local int depth = 0;
+                return depth;
+            }
+
+            static bool is_raising_frames() { return raising_depth() > 0; }
+
+            void run_close_hooks()
+            {
+                std::vector<CloseHook> closeHooks;
+                {
+                    std::lock_guard<std::mutex> lock(closeHookMutex_);
+                    closeHooks.swap(closeHooks_);
+                }
+
+                for (auto& hook : closeHooks)
+                {
+                    hook.second();
+                }
+            }
+
             void ensure_callback_added()
             {
                 if (!callbackRegistered_)
@@ -241,6 +720,7 @@ namespace astra {
             }
 
             astra_reader_t reader_;
+            ReaderRefWeakPtr self_;
 
             bool isNotifying_{false};
             bool callbackRegistered_{false};
@@ -251,11 +731,23 @@ namespace astra {
             ListenerList addedListeners_;
             ListenerList removedListeners_;
 
+            std::mutex asyncMutex_;
+            std::vector<AsyncListenerPtr> asyncListeners_;
+
+            using CloseHook = std::pair<size_t, std::function<void()>>;
+
+            std::mutex closeHookMutex_;
+            std::vector<CloseHook> closeHooks_;
+            size_t lastCloseHookId_{0};
+
             astra_reader_callback_id_t callbackId_;
         };
 
         ReaderRefPtr readerRef_;
 
+#if defined(ASTRA_COROUTINES)
+        friend class FrameSequence;
+#endif
         friend bool operator==(const StreamReader& lhs, const StreamReader& rhs);
     };
 
@@ -270,4 +762,8 @@ namespace astra {
     }
 }
 
+#if defined(ASTRA_COROUTINES)
+#include <astra_core/FrameCoroutines.hpp>
+#endif
+
 #endif // ASTRA_STREAMREADER_HPP
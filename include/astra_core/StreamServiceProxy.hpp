@@ -143,6 +143,51 @@ namespace astra {
         {
             return astra_streamservice_proxy_t::temp_update(streamService);
         }
+
+        astra_status_t reader_set_sync_policy(astra_reader_t reader,
+                                              astra_reader_sync_policy_t policy,
+                                              uint32_t toleranceMicroseconds)
+        {
+            return astra_streamservice_proxy_t::reader_set_sync_policy(streamService, reader, policy, toleranceMicroseconds);
+        }
+
+        astra_status_t stream_get_stats(astra_streamconnection_t connection,
+                                        astra_stream_stats_t* stats)
+        {
+            return astra_streamservice_proxy_t::stream_get_stats(streamService, connection, stats);
+        }
+
+        astra_status_t context_get_stats(astra_context_stats_t* stats)
+        {
+            return astra_streamservice_proxy_t::context_get_stats(streamService, stats);
+        }
+
+        astra_status_t frame_retain(astra_reader_frame_t frame,
+                                    astra_reader_frame_t* retainedFrame)
+        {
+            return astra_streamservice_proxy_t::frame_retain(streamService, frame, retainedFrame);
+        }
+
+        astra_status_t frame_release(astra_reader_frame_t* frame)
+        {
+            return astra_streamservice_proxy_t::frame_release(streamService, frame);
+        }
+
+        astra_status_t reader_wait_any(astra_reader_t* readers,
+                                       size_t count,
+                                       int timeoutMillis,
+                                       size_t* readyIndex)
+        {
+            return astra_streamservice_proxy_t::reader_wait_any(streamService, readers, count, timeoutMillis, readyIndex);
+        }
+
+        astra_status_t stream_read_parameter(astra_streamconnection_t connection,
+                                             astra_parameter_id parameterId,
+                                             size_t byteLength,
+                                             astra_parameter_data_t data)
+        {
+            return astra_streamservice_proxy_t::stream_read_parameter(streamService, connection, parameterId, byteLength, data);
+        }
     };
 }
 
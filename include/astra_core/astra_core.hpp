@@ -20,9 +20,12 @@
 #include "StreamSet.hpp"
 #include "StreamDescription.hpp"
 #include "Frame.hpp"
+#include "FrameExecutor.hpp"
 #include "FrameListener.hpp"
 #include "StreamReader.hpp"
+#include "FrameCoroutines.hpp"
 #include "DataStream.hpp"
+#include "Stats.hpp"
 #include "astra_cxx_make_unique.hpp"
 
 namespace astra {
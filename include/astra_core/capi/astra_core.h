@@ -38,6 +38,10 @@ ASTRA_API astra_status_t astra_reader_open_frame(astra_reader_t reader,
 
 ASTRA_API astra_status_t astra_reader_close_frame(astra_reader_frame_t* frame);
 
+// callbacks run on the thread that updates the plugins. with background update
+// configured that is always a core update thread. otherwise it is the caller of
+// astra_temp_update() until a reader first blocks in astra_reader_open_frame()
+// with a nonzero timeout, which starts a core update thread for good.
 ASTRA_API astra_status_t astra_reader_register_frame_ready_callback(astra_reader_t reader,
                                                                     astra_frame_ready_callback_t callback,
                                                                     void* clientTag,
@@ -74,6 +78,30 @@ ASTRA_API astra_status_t astra_stream_invoke(astra_streamconnection_t connection
 
 ASTRA_API astra_status_t astra_temp_update();
 
+ASTRA_API astra_status_t astra_reader_set_sync_policy(astra_reader_t reader,
+                                                      astra_reader_sync_policy_t policy,
+                                                      uint32_t toleranceMicroseconds);
+
+ASTRA_API astra_status_t astra_stream_get_stats(astra_streamconnection_t connection,
+                                                astra_stream_stats_t* stats);
+
+ASTRA_API astra_status_t astra_context_get_stats(astra_context_stats_t* stats);
+
+ASTRA_API astra_status_t astra_frame_retain(astra_reader_frame_t frame,
+                                            astra_reader_frame_t* retainedFrame);
+
+ASTRA_API astra_status_t astra_frame_release(astra_reader_frame_t* frame);
+
+ASTRA_API astra_status_t astra_reader_wait_any(astra_reader_t* readers,
+                                               size_t count,
+                                               int timeoutMillis,
+                                               size_t* readyIndex);
+
+ASTRA_API astra_status_t astra_stream_read_parameter(astra_streamconnection_t connection,
+                                                     astra_parameter_id parameterId,
+                                                     size_t byteLength,
+                                                     astra_parameter_data_t data);
+
 ASTRA_END_DECLS
 
 #endif /* ASTRA_CAPI_H */
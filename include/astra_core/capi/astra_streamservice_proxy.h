@@ -105,6 +105,37 @@ struct astra_streamservice_proxy_t
 
     astra_status_t (*temp_update)(void*);
 
+    astra_status_t (*reader_set_sync_policy)(void*,
+                                             astra_reader_t,
+                                             astra_reader_sync_policy_t,
+                                             uint32_t);
+
+    astra_status_t (*stream_get_stats)(void*,
+                                       astra_streamconnection_t,
+                                       astra_stream_stats_t*);
+
+    astra_status_t (*context_get_stats)(void*,
+                                        astra_context_stats_t*);
+
+    astra_status_t (*frame_retain)(void*,
+                                   astra_reader_frame_t,
+                                   astra_reader_frame_t*);
+
+    astra_status_t (*frame_release)(void*,
+                                    astra_reader_frame_t*);
+
+    astra_status_t (*reader_wait_any)(void*,
+                                      astra_reader_t*,
+                                      size_t,
+                                      int,
+                                      size_t*);
+
+    astra_status_t (*stream_read_parameter)(void*,
+                                            astra_streamconnection_t,
+                                            astra_parameter_id,
+                                            size_t,
+                                            astra_parameter_data_t);
+
 };
 
 #endif /* ASTRA_STREAMSERVICE_PROXY_H */
@@ -87,6 +87,67 @@ typedef enum {
     ASTRA_SEVERITY_TRACE   = 6
 } astra_log_severity_t;
 
+// log statements above this severity are compiled out of the LOG_ macros
+#ifndef ASTRA_LOG_MAX_SEVERITY
+#define ASTRA_LOG_MAX_SEVERITY ASTRA_SEVERITY_TRACE
+#endif
+
 typedef uint32_t astra_event_id;
 
+typedef enum {
+    // frame ready as soon as every stream has a new frame
+    ASTRA_READER_SYNC_LATEST = 0,
+    // frame ready when every stream's frame has the same frame index
+    ASTRA_READER_SYNC_FRAME_INDEX = 1,
+    // frame ready when every stream's frame was captured within the tolerance.
+    // plugins report capture times, otherwise the time a frame was produced is used
+    ASTRA_READER_SYNC_NEAREST_TIMESTAMP = 2
+} astra_reader_sync_policy_t;
+
+// bucket 0 counts samples under 1us, bucket i counts samples in
+// [2^(i-1), 2^i) us and the last bucket counts everything above that
+#define ASTRA_STATS_HISTOGRAM_BUCKETS 24
+
+typedef struct {
+    uint64_t count;
+    uint64_t sumMicroseconds;
+    uint64_t maxMicroseconds;
+    uint64_t buckets[ASTRA_STATS_HISTOGRAM_BUCKETS];
+} astra_histogram_t;
+
+typedef struct {
+    // frames cycled by the producer into this stream's bin while linked
+    uint64_t framesProduced;
+    // frames dropped by the bin before any reader could lock them
+    uint64_t framesOverwritten;
+    // distinct frames handed to readers of this stream
+    uint64_t framesDelivered;
+    // frames presented to this stream but never locked by a reader
+    uint64_t framesSkipped;
+    // producer frame rate, averaged over the last few frames
+    float framesPerSecond;
+    // time between producer frames
+    astra_histogram_t framePeriod;
+    // time from the producer cycling a frame to a reader locking it
+    astra_histogram_t deliveryLatency;
+    // time the stream's front buffer stays locked by readers
+    astra_histogram_t lockDuration;
+    // time clients keep reader frames open
+    astra_histogram_t clientHoldTime;
+} astra_stream_stats_t;
+
+#define ASTRA_STATS_MAX_PLUGINS 16
+#define ASTRA_STATS_PLUGIN_NAME_LENGTH 64
+
+typedef struct {
+    char name[ASTRA_STATS_PLUGIN_NAME_LENGTH];
+    astra_histogram_t updateDuration;
+} astra_plugin_stats_t;
+
+typedef struct {
+    // time taken by each plugin's update
+    astra_plugin_stats_t plugins[ASTRA_STATS_MAX_PLUGINS];
+    uint32_t pluginCount;
+} astra_context_stats_t;
+
 #endif /* ASTRA_TYPES_H */
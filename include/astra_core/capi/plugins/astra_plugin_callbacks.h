@@ -55,6 +55,10 @@ typedef void(*host_event_callback_t)(void*,
                                      const void*,
                                      size_t);
 
+typedef void(*stream_compute_callback_t)(void*,
+                                         astra_stream_t,
+                                         astra_frame_t*);
+
 struct stream_callbacks_t {
     void* context;
     set_parameter_callback_t set_parameter_callback;
@@ -97,6 +97,45 @@ struct astra_pluginservice_proxy_t
                           const char*,
                           va_list);
 
+    astra_status_t (*create_stream_bin_with_depth)(void*,
+                                                   astra_stream_t,
+                                                   size_t,
+                                                   size_t,
+                                                   astra_bin_t*,
+                                                   astra_frame_t**);
+
+    astra_status_t (*register_dataflow_node)(void*,
+                                             astra_reader_t,
+                                             const astra_stream_desc_t*,
+                                             size_t,
+                                             const astra_stream_desc_t*,
+                                             size_t,
+                                             astra_frame_ready_callback_t,
+                                             void*,
+                                             astra_callback_id_t*);
+
+    astra_status_t (*unregister_dataflow_node)(void*,
+                                               astra_callback_id_t);
+
+    astra_status_t (*set_stream_compute_callback)(void*,
+                                                  astra_stream_t,
+                                                  stream_compute_callback_t,
+                                                  void*);
+
+    astra_status_t (*set_parameter_cacheable)(void*,
+                                              astra_stream_t,
+                                              astra_parameter_id,
+                                              bool);
+
+    astra_status_t (*invalidate_parameters)(void*,
+                                            astra_stream_t);
+
+    astra_status_t (*set_bin_capture_timestamp)(void*,
+                                                astra_bin_t,
+                                                uint64_t);
+
+    astra_status_t (*request_update)(void*);
+
 };
 
 #endif /* ASTRA_PLUGINSERVICE_PROXY_H */
@@ -0,0 +1,117 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#ifndef ASTRA_PLUGIN_DATAFLOW_NODE_HPP
+#define ASTRA_PLUGIN_DATAFLOW_NODE_HPP
+
+#include <astra_core/Frame.hpp>
+#include <astra_core/FrameListener.hpp>
+#include <astra_core/StreamReader.hpp>
+#include <astra_core/StreamDescription.hpp>
+#include <astra_core/plugins/PluginServiceProxy.hpp>
+#include <astra_core/plugins/PluginLogging.hpp>
+#include <initializer_list>
+#include <vector>
+
+namespace astra { namespace plugins {
+
+    // Calls a frame listener for every frame of a reader, scheduled by the
+    // core as a node of its dataflow graph. The inputs are started on the
+    // reader; the outputs are the streams the listener writes.
+    //
+    // When the core runs dataflow nodes on worker threads the listener is
+    // called there without the core lock, one frame at a time. State it
+    // shares with stream callbacks such as set_parameter needs its own lock.
+    // Destroying the node waits for a running call to return.
+    class dataflow_node
+    {
+    public:
+        dataflow_node(PluginServiceProxy& pluginService,
+                      StreamReader& reader,
+                      std::initializer_list<StreamDescription> inputs,
+                      std::initializer_list<StreamDescription> outputs,
+                      FrameListener& listener)
+            : pluginService_(pluginService),
+              reader_(reader),
+              listener_(listener)
+        {
+            std::vector<astra_stream_desc_t> inputDescs = to_descs(inputs);
+            std::vector<astra_stream_desc_t> outputDescs = to_descs(outputs);
+
+            astra_status_t rc = pluginService_.register_dataflow_node(reader_.get_handle(),
+                                                                      inputDescs.data(),
+                                                                      inputDescs.size(),
+                                                                      outputDescs.data(),
+                                                                      outputDescs.size(),
+                                                                      &dataflow_node::frame_ready_thunk,
+                                                                      this,
+                                                                      &nodeId_);
+
+            if (rc != ASTRA_STATUS_SUCCESS)
+            {
+                LOG_WARN("astra.plugins.dataflow_node", "failed to register dataflow node");
+            }
+        }
+
+        ~dataflow_node()
+        {
+            if (nodeId_ != 0)
+            {
+                pluginService_.unregister_dataflow_node(nodeId_);
+            }
+        }
+
+        dataflow_node(const dataflow_node&) = delete;
+        dataflow_node& operator=(const dataflow_node&) = delete;
+
+    private:
+        static std::vector<astra_stream_desc_t> to_descs(std::initializer_list<StreamDescription> descriptions)
+        {
+            std::vector<astra_stream_desc_t> descs;
+            descs.reserve(descriptions.size());
+
+            for (const StreamDescription& description : descriptions)
+            {
+                astra_stream_desc_t desc;
+                desc.type = description.type();
+                desc.subtype = description.subtype();
+                descs.push_back(desc);
+            }
+
+            return descs;
+        }
+
+        static void frame_ready_thunk(void* clientTag,
+                                      astra_reader_t reader,
+                                      astra_reader_frame_t readerFrame)
+        {
+            dataflow_node* self = static_cast<dataflow_node*>(clientTag);
+
+            //the core closes or releases the frame
+            const bool autoCloseFrame = false;
+            Frame frame(readerFrame, autoCloseFrame);
+
+            self->listener_.on_frame_ready(self->reader_, frame);
+        }
+
+        PluginServiceProxy& pluginService_;
+        StreamReader reader_;
+        FrameListener& listener_;
+        astra_callback_id_t nodeId_{0};
+    };
+}}
+
+#endif /* ASTRA_PLUGIN_DATAFLOW_NODE_HPP */
@@ -25,5 +25,6 @@
 #include <astra_core/plugins/StreamCallbackListener.hpp>
 #include <astra_core/plugins/PluginStream.hpp>
 #include <astra_core/plugins/SingleBinStream.hpp>
+#include <astra_core/plugins/DataflowNode.hpp>
 
 #endif /* ASTRA_PLUGIN_HPP */
@@ -36,23 +36,29 @@
 #   endif  // defined(__func__)
 #endif  // defined(_MSC_VER)
 
+#define ASTRA_PLUGIN_LOG_AT(channel, logLevel, format, ...) \
+    do { \
+        if (logLevel <= ASTRA_LOG_MAX_SEVERITY) \
+            ::astra::plugins::log(channel, logLevel, __FILE__, __LINE__, LOG_FUNC, format, ##__VA_ARGS__); \
+    } while (0)
+
 #define LOG_TRACE(channel, format, ...) \
-    ::astra::plugins::log(channel, ASTRA_SEVERITY_TRACE, __FILE__, __LINE__, LOG_FUNC, format, ##__VA_ARGS__)
+    ASTRA_PLUGIN_LOG_AT(channel, ASTRA_SEVERITY_TRACE, format, ##__VA_ARGS__)
 
 #define LOG_INFO(channel, format, ...) \
-    ::astra::plugins::log(channel, ASTRA_SEVERITY_INFO, __FILE__, __LINE__, LOG_FUNC, format, ##__VA_ARGS__)
+    ASTRA_PLUGIN_LOG_AT(channel, ASTRA_SEVERITY_INFO, format, ##__VA_ARGS__)
 
 #define LOG_DEBUG(channel, format, ...) \
-    ::astra::plugins::log(channel, ASTRA_SEVERITY_DEBUG, __FILE__, __LINE__, LOG_FUNC, format, ##__VA_ARGS__)
+    ASTRA_PLUGIN_LOG_AT(channel, ASTRA_SEVERITY_DEBUG, format, ##__VA_ARGS__)
 
 #define LOG_ERROR(channel, format, ...) \
-    ::astra::plugins::log(channel, ASTRA_SEVERITY_ERROR, __FILE__, __LINE__, LOG_FUNC, format, ##__VA_ARGS__)
+    ASTRA_PLUGIN_LOG_AT(channel, ASTRA_SEVERITY_ERROR, format, ##__VA_ARGS__)
 
 #define LOG_FATAL(channel, format, ...) \
-    ::astra::plugins::log(channel, ASTRA_SEVERITY_FATAL, __FILE__, __LINE__, LOG_FUNC, format, ##__VA_ARGS__)
+    ASTRA_PLUGIN_LOG_AT(channel, ASTRA_SEVERITY_FATAL, format, ##__VA_ARGS__)
 
 #define LOG_WARN(channel, format, ...) \
-    ::astra::plugins::log(channel, ASTRA_SEVERITY_WARN, __FILE__, __LINE__, LOG_FUNC, format, ##__VA_ARGS__)
+    ASTRA_PLUGIN_LOG_AT(channel, ASTRA_SEVERITY_WARN, format, ##__VA_ARGS__)
 
 extern astra::PluginServiceProxy* __g_serviceProxy;
 
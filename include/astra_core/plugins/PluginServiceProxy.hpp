@@ -154,6 +154,62 @@ namespace astra {
     {
         return astra_pluginservice_proxy_t::log(pluginService, channel, logLevel, fileName, lineNo, func, format, args);
     }
+
+    astra_status_t create_stream_bin_with_depth(astra_stream_t streamHandle,
+                                                size_t lengthInBytes,
+                                                size_t bufferCount,
+                                                astra_bin_t* binHandle,
+                                                astra_frame_t** binBuffer)
+    {
+        return astra_pluginservice_proxy_t::create_stream_bin_with_depth(pluginService, streamHandle, lengthInBytes, bufferCount, binHandle, binBuffer);
+    }
+
+    astra_status_t register_dataflow_node(astra_reader_t reader,
+                                          const astra_stream_desc_t* inputs,
+                                          size_t inputCount,
+                                          const astra_stream_desc_t* outputs,
+                                          size_t outputCount,
+                                          astra_frame_ready_callback_t callback,
+                                          void* clientTag,
+                                          astra_callback_id_t* nodeId)
+    {
+        return astra_pluginservice_proxy_t::register_dataflow_node(pluginService, reader, inputs, inputCount, outputs, outputCount, callback, clientTag, nodeId);
+    }
+
+    astra_status_t unregister_dataflow_node(astra_callback_id_t nodeId)
+    {
+        return astra_pluginservice_proxy_t::unregister_dataflow_node(pluginService, nodeId);
+    }
+
+    astra_status_t set_stream_compute_callback(astra_stream_t stream,
+                                               stream_compute_callback_t callback,
+                                               void* clientTag)
+    {
+        return astra_pluginservice_proxy_t::set_stream_compute_callback(pluginService, stream, callback, clientTag);
+    }
+
+    astra_status_t set_parameter_cacheable(astra_stream_t stream,
+                                           astra_parameter_id parameterId,
+                                           bool cacheable)
+    {
+        return astra_pluginservice_proxy_t::set_parameter_cacheable(pluginService, stream, parameterId, cacheable);
+    }
+
+    astra_status_t invalidate_parameters(astra_stream_t stream)
+    {
+        return astra_pluginservice_proxy_t::invalidate_parameters(pluginService, stream);
+    }
+
+    astra_status_t set_bin_capture_timestamp(astra_bin_t bin,
+                                             uint64_t captureTimestamp)
+    {
+        return astra_pluginservice_proxy_t::set_bin_capture_timestamp(pluginService, bin, captureTimestamp);
+    }
+
+    astra_status_t request_update()
+    {
+        return astra_pluginservice_proxy_t::request_update(pluginService);
+    }
     };
 }
 
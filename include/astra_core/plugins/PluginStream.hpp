@@ -103,6 +103,19 @@ namespace astra { namespace plugins {
 
     protected:
         inline PluginServiceProxy& pluginService() const { return pluginService_; }
+
+        //connections keep the parameter's result until invalidate_parameters()
+        //or until a client sets a parameter or invokes a command
+        void set_parameter_cacheable(astra_parameter_id id, bool cacheable = true)
+        {
+            pluginService_.set_parameter_cacheable(streamHandle_, id, cacheable);
+        }
+
+        //call when a cacheable parameter changes for any other reason
+        void invalidate_parameters()
+        {
+            pluginService_.invalidate_parameters(streamHandle_);
+        }
     private:
         virtual void connection_added(astra_stream_t stream,
                                       astra_streamconnection_t connection) override final;
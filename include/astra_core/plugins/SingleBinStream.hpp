@@ -30,14 +30,16 @@ namespace astra { namespace plugins {
         single_bin_stream(PluginServiceProxy& pluginService,
                           astra_streamset_t streamSet,
                           StreamDescription description,
-                          size_t bufferSize)
+                          size_t bufferSize,
+                          size_t bufferCount = 0)
             : stream(pluginService,
                      streamSet,
                      description)
         {
             bin_ = astra::make_unique<bin_type>(pluginService,
                                                 get_handle(),
-                                                sizeof(TFrameType) + bufferSize);
+                                                sizeof(TFrameType) + bufferSize,
+                                                bufferCount);
         }
 
         using frame_type = TFrameType;
@@ -52,6 +54,12 @@ namespace astra { namespace plugins {
             return bin_->begin_write(frameIndex);
         }
 
+        //also returns the bin buffer the frame is written to
+        std::pair<astra_frame_t*, TFrameType*> begin_write_ex(size_t frameIndex)
+        {
+            return bin_->begin_write_ex(frameIndex);
+        }
+
         void end_write()
         {
             return bin_->end_write();
@@ -27,17 +27,31 @@ namespace astra { namespace plugins {
     class stream_bin
     {
     public:
+        //bufferCount of 0 uses the core's default triple buffering
         stream_bin(PluginServiceProxy& pluginService,
                    astra_stream_t streamHandle,
-                   size_t dataSize)
+                   size_t dataSize,
+                   size_t bufferCount = 0)
             : streamHandle_(streamHandle),
               pluginService_(pluginService)
         {
             size_t dataWrapperSize = dataSize + sizeof(TFrameType);
-            pluginService_.create_stream_bin(streamHandle,
-                                             dataWrapperSize,
-                                             &binHandle_,
-                                             &currentBuffer_);
+
+            if (bufferCount == 0)
+            {
+                pluginService_.create_stream_bin(streamHandle,
+                                                 dataWrapperSize,
+                                                 &binHandle_,
+                                                 &currentBuffer_);
+            }
+            else
+            {
+                pluginService_.create_stream_bin_with_depth(streamHandle,
+                                                            dataWrapperSize,
+                                                            bufferCount,
+                                                            &binHandle_,
+                                                            &currentBuffer_);
+            }
         }
 
         ~stream_bin()
@@ -81,6 +95,14 @@ namespace astra { namespace plugins {
             return std::make_pair(currentBuffer_, reinterpret_cast<TFrameType*>(currentBuffer_->data));
         }
 
+        //steady clock microseconds when the frame being written was captured.
+        //readers syncing by timestamp match on it, it defaults to the time
+        //the frame is cycled
+        void set_capture_timestamp(uint64_t captureTimestamp)
+        {
+            pluginService_.set_bin_capture_timestamp(binHandle_, captureTimestamp);
+        }
+
         void end_write()
         {
             if (!locked_)
@@ -267,6 +267,85 @@
                               (make-param :type "const char*" :name "format")
                               (make-param :type "va_list" :name "args")))
 
+;; astra_status_t create_stream_bin_with_depth(astra_stream_t streamHandle,
+;;                                             size_t lengthInBytes,
+;;                                             size_t bufferCount,
+;;                                             astra_bin_t* binHandle,
+;;                                             astra_frame_t** binBuffer)
+(add-func       :funcset "plugin"
+                :returntype "astra_status_t"
+                :funcname "create_stream_bin_with_depth"
+                :params (list (make-param :type "astra_stream_t" :name "streamHandle")
+                              (make-param :type "size_t" :name "lengthInBytes")
+                              (make-param :type "size_t" :name "bufferCount")
+                              (make-param :type "astra_bin_t*" :name "binHandle" :deref t)
+                              (make-param :type "astra_frame_t**" :name "binBuffer" :deref t)))
+
+;; astra_status_t register_dataflow_node(astra_reader_t reader,
+;;                                       const astra_stream_desc_t* inputs,
+;;                                       size_t inputCount,
+;;                                       const astra_stream_desc_t* outputs,
+;;                                       size_t outputCount,
+;;                                       astra_frame_ready_callback_t callback,
+;;                                       void* clientTag,
+;;                                       astra_callback_id_t* nodeId)
+(add-func       :funcset "plugin"
+                :returntype "astra_status_t"
+                :funcname "register_dataflow_node"
+                :params (list (make-param :type "astra_reader_t" :name "reader")
+                              (make-param :type "const astra_stream_desc_t*" :name "inputs")
+                              (make-param :type "size_t" :name "inputCount")
+                              (make-param :type "const astra_stream_desc_t*" :name "outputs")
+                              (make-param :type "size_t" :name "outputCount")
+                              (make-param :type "astra_frame_ready_callback_t" :name "callback")
+                              (make-param :type "void*" :name "clientTag")
+                              (make-param :type "astra_callback_id_t*" :name "nodeId" :deref t)))
+
+;; astra_status_t unregister_dataflow_node(astra_callback_id_t nodeId)
+(add-func       :funcset "plugin"
+                :returntype "astra_status_t"
+                :funcname "unregister_dataflow_node"
+                :params (list (make-param :type "astra_callback_id_t" :name "nodeId")))
+
+;; astra_status_t set_stream_compute_callback(astra_stream_t stream,
+;;                                            stream_compute_callback_t callback,
+;;                                            void* clientTag)
+(add-func       :funcset "plugin"
+                :returntype "astra_status_t"
+                :funcname "set_stream_compute_callback"
+                :params (list (make-param :type "astra_stream_t" :name "stream")
+                              (make-param :type "stream_compute_callback_t" :name "callback")
+                              (make-param :type "void*" :name "clientTag")))
+;; astra_status_t set_parameter_cacheable(astra_stream_t stream,
+;;                                        astra_parameter_id parameterId,
+;;                                        bool cacheable)
+(add-func       :funcset "plugin"
+                :returntype "astra_status_t"
+                :funcname "set_parameter_cacheable"
+                :params (list (make-param :type "astra_stream_t" :name "stream")
+                              (make-param :type "astra_parameter_id" :name "parameterId")
+                              (make-param :type "bool" :name "cacheable")))
+
+;; astra_status_t invalidate_parameters(astra_stream_t stream)
+(add-func       :funcset "plugin"
+                :returntype "astra_status_t"
+                :funcname "invalidate_parameters"
+                :params (list (make-param :type "astra_stream_t" :name "stream")))
+
+;; astra_status_t set_bin_capture_timestamp(astra_bin_t bin,
+;;                                          uint64_t captureTimestamp)
+(add-func       :funcset "plugin"
+                :returntype "astra_status_t"
+                :funcname "set_bin_capture_timestamp"
+                :params (list (make-param :type "astra_bin_t" :name "bin")
+                              (make-param :type "uint64_t" :name "captureTimestamp")))
+
+;; astra_status_t request_update()
+(add-func       :funcset "plugin"
+                :returntype "astra_status_t"
+                :funcname "request_update"
+                :params '())
+
 ;; ASTRA_API astra_status_t astra_initialize();
 ;; (add-func       :funcset "stream"
 ;;                 :returntype "astra_status_t"
@@ -448,3 +527,65 @@
                 :returntype "astra_status_t"
                 :funcname "temp_update"
                 :params '())
+
+;; ASTRA_API astra_status_t astra_reader_set_sync_policy(astra_reader_t reader,
+;;                                                       astra_reader_sync_policy_t policy,
+;;                                                       uint32_t toleranceMicroseconds);
+(add-func       :funcset "stream"
+                :returntype "astra_status_t"
+                :funcname "reader_set_sync_policy"
+                :params (list (make-param :type "astra_reader_t" :name "reader")
+                              (make-param :type "astra_reader_sync_policy_t" :name "policy")
+                              (make-param :type "uint32_t" :name "toleranceMicroseconds")))
+
+;; ASTRA_API astra_status_t astra_stream_get_stats(astra_streamconnection_t connection,
+;;                                                 astra_stream_stats_t* stats);
+(add-func       :funcset "stream"
+                :returntype "astra_status_t"
+                :funcname "stream_get_stats"
+                :params (list (make-param :type "astra_streamconnection_t" :name "connection")
+                              (make-param :type "astra_stream_stats_t*" :name "stats")))
+
+;; ASTRA_API astra_status_t astra_context_get_stats(astra_context_stats_t* stats);
+(add-func       :funcset "stream"
+                :returntype "astra_status_t"
+                :funcname "context_get_stats"
+                :params (list (make-param :type "astra_context_stats_t*" :name "stats")))
+
+;; ASTRA_API astra_status_t astra_frame_retain(astra_reader_frame_t frame,
+;;                                             astra_reader_frame_t* retainedFrame);
+(add-func       :funcset "stream"
+                :returntype "astra_status_t"
+                :funcname "frame_retain"
+                :params (list (make-param :type "astra_reader_frame_t" :name "frame")
+                              (make-param :type "astra_reader_frame_t*" :name "retainedFrame" :deref T)))
+
+;; ASTRA_API astra_status_t astra_frame_release(astra_reader_frame_t* frame); //frame set to null
+(add-func       :funcset "stream"
+                :returntype "astra_status_t"
+                :funcname "frame_release"
+                :params (list (make-param :type "astra_reader_frame_t*" :name "frame" :deref T)))
+
+;; ASTRA_API astra_status_t astra_reader_wait_any(astra_reader_t* readers,
+;;                                                size_t count,
+;;                                                int timeoutMillis,
+;;                                                size_t* readyIndex);
+(add-func       :funcset "stream"
+                :returntype "astra_status_t"
+                :funcname "reader_wait_any"
+                :params (list (make-param :type "astra_reader_t*" :name "readers")
+                              (make-param :type "size_t" :name "count")
+                              (make-param :type "int" :name "timeoutMillis")
+                              (make-param :type "size_t*" :name "readyIndex" :deref T)))
+
+;; ASTRA_API astra_status_t astra_stream_read_parameter(astra_streamconnection_t connection,
+;;                                                      astra_parameter_id parameterId,
+;;                                                      size_t byteLength,
+;;                                                      astra_parameter_data_t data);
+(add-func       :funcset "stream"
+                :returntype "astra_status_t"
+                :funcname "stream_read_parameter"
+                :params (list (make-param :type "astra_streamconnection_t" :name "connection")
+                              (make-param :type "astra_parameter_id" :name "parameterId")
+                              (make-param :type "size_t" :name "byteLength")
+                              (make-param :type "astra_parameter_data_t" :name "data")))
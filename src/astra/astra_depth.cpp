@@ -23,34 +23,18 @@
 #include <string.h>
 #include <astra/capi/streams/image_capi.h>
 #include <astra/capi/streams/image_parameters.h>
-#include <unordered_map>
 #include <Shiny.h>
 
-using ConversionMap = std::unordered_map<astra_depthstream_t, conversion_cache_t>;
-
-ConversionMap g_astra_conversion_map;
-
 conversion_cache_t astra_depth_fetch_conversion_cache(astra_depthstream_t depthStream)
 {
     PROFILE_FUNC();
-    auto it = g_astra_conversion_map.find(depthStream);
-
-    if (it != g_astra_conversion_map.end())
-    {
-        return it->second;
-    }
-    else
-    {
-        PROFILE_BEGIN(depth_cache_get);
-        conversion_cache_t conversionCache;
-        astra_stream_get_parameter_fixed(depthStream,
-                                         ASTRA_PARAMETER_DEPTH_CONVERSION_CACHE,
-                                         sizeof(conversion_cache_t),
-                                         reinterpret_cast<astra_parameter_data_t*>(&conversionCache));
-        g_astra_conversion_map.insert(std::make_pair(depthStream, conversionCache));
-        PROFILE_END();
-        return conversionCache;
-    }
+    //cached by the connection until the depth stream changes mode
+    conversion_cache_t conversionCache;
+    astra_stream_get_parameter_fixed(depthStream,
+                                     ASTRA_PARAMETER_DEPTH_CONVERSION_CACHE,
+                                     sizeof(conversion_cache_t),
+                                     reinterpret_cast<astra_parameter_data_t*>(&conversionCache));
+    return conversionCache;
 }
 
 ASTRA_BEGIN_DECLS
@@ -98,25 +98,11 @@ inline astra_status_t astra_stream_get_parameter_fixed(astra_streamconnection_t
                                                        std::size_t byteLength,
                                                        astra_parameter_data_t* data)
 {
-    astra_result_token_t token;
-    std::size_t paramSize;
-    astra_status_t rc = astra_stream_get_parameter(connection,
-                                                   parameterId,
-                                                   &paramSize,
-                                                   &token);
-
-    if (rc != ASTRA_STATUS_SUCCESS)
-    {
-        std::memset(data, 0, byteLength);
-        return rc;
-    }
-
-    assert(paramSize == byteLength);
-
-    return astra_stream_get_result(connection,
-                                   token,
-                                   byteLength,
-                                   data);
+    //served from the connection's cache when the stream marked the parameter cacheable
+    return astra_stream_read_parameter(connection,
+                                       parameterId,
+                                       byteLength,
+                                       data);
 }
 
 
@@ -293,6 +293,100 @@ ASTRA_API astra_status_t astra_temp_update()
     }
 }
 
+ASTRA_API astra_status_t astra_reader_set_sync_policy(astra_reader_t reader,
+                                                      astra_reader_sync_policy_t policy,
+                                                      uint32_t toleranceMicroseconds)
+{
+    if (g_contextPtr)
+    {
+        return g_contextPtr->reader_set_sync_policy(reader, policy, toleranceMicroseconds);
+    }
+    else
+    {
+        return ASTRA_STATUS_UNINITIALIZED;
+    }
+}
+
+ASTRA_API astra_status_t astra_stream_get_stats(astra_streamconnection_t connection,
+                                                astra_stream_stats_t* stats)
+{
+    if (g_contextPtr)
+    {
+        return g_contextPtr->stream_get_stats(connection, stats);
+    }
+    else
+    {
+        return ASTRA_STATUS_UNINITIALIZED;
+    }
+}
+
+ASTRA_API astra_status_t astra_context_get_stats(astra_context_stats_t* stats)
+{
+    if (g_contextPtr)
+    {
+        return g_contextPtr->context_get_stats(stats);
+    }
+    else
+    {
+        return ASTRA_STATUS_UNINITIALIZED;
+    }
+}
+
+ASTRA_API astra_status_t astra_frame_retain(astra_reader_frame_t frame,
+                                            astra_reader_frame_t* retainedFrame)
+{
+    if (g_contextPtr)
+    {
+        return g_contextPtr->frame_retain(frame, *retainedFrame);
+    }
+    else
+    {
+        return ASTRA_STATUS_UNINITIALIZED;
+    }
+}
+
+ASTRA_API astra_status_t astra_frame_release(astra_reader_frame_t* frame)
+{
+    if (g_contextPtr)
+    {
+        return g_contextPtr->frame_release(*frame);
+    }
+    else
+    {
+        return ASTRA_STATUS_UNINITIALIZED;
+    }
+}
+
+ASTRA_API astra_status_t astra_reader_wait_any(astra_reader_t* readers,
+                                               size_t count,
+                                               int timeoutMillis,
+                                               size_t* readyIndex)
+{
+    if (g_contextPtr)
+    {
+        return g_contextPtr->reader_wait_any(readers, count, timeoutMillis, *readyIndex);
+    }
+    else
+    {
+        return ASTRA_STATUS_UNINITIALIZED;
+    }
+}
+
+ASTRA_API astra_status_t astra_stream_read_parameter(astra_streamconnection_t connection,
+                                                     astra_parameter_id parameterId,
+                                                     size_t byteLength,
+                                                     astra_parameter_data_t data)
+{
+    if (g_contextPtr)
+    {
+        return g_contextPtr->stream_read_parameter(connection, parameterId, byteLength, data);
+    }
+    else
+    {
+        return ASTRA_STATUS_UNINITIALIZED;
+    }
+}
+
 ASTRA_API astra_status_t astra_notify_host_event(astra_event_id id, const void* data, size_t dataSize)
 {
     if (g_contextPtr)
@@ -0,0 +1,246 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#include "astra_async_log_sink.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+namespace astra {
+
+    //how long the drain thread sleeps when the queue is empty. producers
+    //only wake it early once the queue is half full.
+    static const std::chrono::milliseconds DRAIN_INTERVAL(5);
+
+    static size_t round_up_to_power_of_two(size_t value)
+    {
+        size_t result = 1;
+        while (result < value)
+        {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    static void copy_truncated(char* destination, size_t destinationSize, const char* source)
+    {
+        if (source == nullptr)
+        {
+            destination[0] = '\0';
+            return;
+        }
+
+        //keep the tail, file paths are most useful from the end
+        size_t length = std::strlen(source);
+        if (length >= destinationSize)
+        {
+            source += length - (destinationSize - 1);
+            length = destinationSize - 1;
+        }
+
+        std::memcpy(destination, source, length);
+        destination[length] = '\0';
+    }
+
+    async_log_sink::async_log_sink(dispatch_callback dispatch, size_t capacity)
+        : dispatch_(dispatch),
+          capacity_(round_up_to_power_of_two(capacity < 2 ? 2 : capacity)),
+          mask_(capacity_ - 1)
+    { }
+
+    async_log_sink::~async_log_sink()
+    {
+        stop();
+    }
+
+    void async_log_sink::start()
+    {
+        std::lock_guard<std::mutex> lock(lifecycleMutex_);
+
+        if (running_)
+            return;
+
+        //allocated on first start, the sink exists whether or not
+        //async output is enabled
+        if (!cells_)
+        {
+            cells_.reset(new cell[capacity_]);
+            for (size_t i = 0; i < capacity_; ++i)
+            {
+                cells_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        running_ = true;
+        thread_ = std::thread(&async_log_sink::run, this);
+    }
+
+    void async_log_sink::stop()
+    {
+        std::lock_guard<std::mutex> lock(lifecycleMutex_);
+
+        if (!running_)
+            return;
+
+        {
+            std::lock_guard<std::mutex> wakeLock(wakeMutex_);
+            running_ = false;
+        }
+        wakeCondition_.notify_one();
+
+        if (thread_.joinable())
+        {
+            thread_.join();
+        }
+
+        //producers that saw the sink running may still be writing their
+        //records. once they are done nothing else can be enqueued, so this
+        //drain picks up everything accepted
+        while (inFlightCount_.load() != 0)
+        {
+            std::this_thread::yield();
+        }
+
+        drain();
+    }
+
+    bool async_log_sink::try_enqueue(const char* channel,
+                                     astra_log_severity_t logLevel,
+                                     const char* fileName,
+                                     int lineNo,
+                                     const char* func,
+                                     const char* format,
+                                     va_list args)
+    {
+        //counted before checking running_, stop() waits for the count to reach
+        //zero after clearing it. one of the two always sees the other's write.
+        inFlightCount_.fetch_add(1);
+
+        bool enqueued = running_.load() && enqueue(channel, logLevel, fileName, lineNo, func, format, args);
+
+        inFlightCount_.fetch_sub(1, std::memory_order_release);
+
+        return enqueued;
+    }
+
+    bool async_log_sink::enqueue(const char* channel,
+                                 astra_log_severity_t logLevel,
+                                 const char* fileName,
+                                 int lineNo,
+                                 const char* func,
+                                 const char* format,
+                                 va_list args)
+    {
+        cell* target;
+        size_t position = enqueuePos_.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            target = &cells_[position & mask_];
+            size_t sequence = target->sequence.load(std::memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+            if (difference == 0)
+            {
+                if (enqueuePos_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (difference < 0)
+            {
+                droppedCount_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            else
+            {
+                position = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        log_record& record = target->record;
+        record.logLevel = logLevel;
+        record.lineNo = lineNo;
+        copy_truncated(record.channel, sizeof(record.channel), channel);
+        copy_truncated(record.fileName, sizeof(record.fileName), fileName);
+        copy_truncated(record.func, sizeof(record.func), func);
+        vsnprintf(record.message, sizeof(record.message), format, args);
+
+        target->sequence.store(position + 1, std::memory_order_release);
+
+        if (position - dequeuePos_.load(std::memory_order_relaxed) >= capacity_ / 2)
+        {
+            wakeCondition_.notify_one();
+        }
+
+        return true;
+    }
+
+    bool async_log_sink::drain()
+    {
+        bool drainedAny = false;
+        size_t position = dequeuePos_.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            cell& source = cells_[position & mask_];
+            size_t sequence = source.sequence.load(std::memory_order_acquire);
+            if (sequence != position + 1)
+                break;
+
+            dispatch_(source.record);
+
+            source.sequence.store(position + capacity_, std::memory_order_release);
+            ++position;
+            dequeuePos_.store(position, std::memory_order_relaxed);
+            drainedAny = true;
+        }
+
+        size_t droppedCount = droppedCount_.load(std::memory_order_relaxed);
+        if (droppedCount != reportedDropCount_)
+        {
+            log_record notice;
+            notice.logLevel = ASTRA_SEVERITY_WARN;
+            notice.lineNo = __LINE__;
+            copy_truncated(notice.channel, sizeof(notice.channel), "astra.logging");
+            copy_truncated(notice.fileName, sizeof(notice.fileName), __FILE__);
+            copy_truncated(notice.func, sizeof(notice.func), __func__);
+            snprintf(notice.message, sizeof(notice.message),
+                     "async log queue full, dropped %lu messages",
+                     static_cast<unsigned long>(droppedCount - reportedDropCount_));
+
+            dispatch_(notice);
+            reportedDropCount_ = droppedCount;
+        }
+
+        return drainedAny;
+    }
+
+    void async_log_sink::run()
+    {
+        while (running_)
+        {
+            if (drain())
+                continue;
+
+            std::unique_lock<std::mutex> lock(wakeMutex_);
+            if (running_)
+            {
+                wakeCondition_.wait_for(lock, DRAIN_INTERVAL);
+            }
+        }
+
+        drain();
+    }
+}
@@ -0,0 +1,114 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#ifndef ASTRA_ASYNC_LOG_SINK_H
+#define ASTRA_ASYNC_LOG_SINK_H
+
+#include <astra_core/capi/astra_types.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace astra {
+
+    struct log_record
+    {
+        astra_log_severity_t logLevel;
+        int lineNo;
+        char channel[64];
+        char fileName[128];
+        char func[128];
+        char message[512];
+    };
+
+    // Formats log statements into a bounded lock-free queue and writes them
+    // out on a background thread, so a frame thread never waits on log I/O.
+    // Producers never block: when the queue is full the record is dropped
+    // and counted, and the drain thread reports the count.
+    class async_log_sink
+    {
+    public:
+        using dispatch_callback = void(*)(const log_record& record);
+
+        const static size_t DEFAULT_CAPACITY = 1024;
+
+        async_log_sink(dispatch_callback dispatch, size_t capacity = DEFAULT_CAPACITY);
+        ~async_log_sink();
+
+        async_log_sink(const async_log_sink&) = delete;
+        async_log_sink& operator=(const async_log_sink&) = delete;
+
+        void start();
+        //writes out everything queued before returning
+        void stop();
+
+        bool is_running() const { return running_.load(std::memory_order_relaxed); }
+        size_t dropped_count() const { return droppedCount_.load(std::memory_order_relaxed); }
+
+        //returns false if the sink is stopped or full
+        bool try_enqueue(const char* channel,
+                         astra_log_severity_t logLevel,
+                         const char* fileName,
+                         int lineNo,
+                         const char* func,
+                         const char* format,
+                         va_list args);
+
+    private:
+        struct cell
+        {
+            std::atomic<size_t> sequence;
+            log_record record;
+        };
+
+        bool enqueue(const char* channel,
+                     astra_log_severity_t logLevel,
+                     const char* fileName,
+                     int lineNo,
+                     const char* func,
+                     const char* format,
+                     va_list args);
+        bool drain();
+        void run();
+
+        dispatch_callback dispatch_;
+        const size_t capacity_;
+        const size_t mask_;
+        std::unique_ptr<cell[]> cells_;
+
+        //producers claim cells with enqueuePos_, the single drain thread
+        //owns dequeuePos_
+        std::atomic<size_t> enqueuePos_{0};
+        std::atomic<size_t> dequeuePos_{0};
+
+        std::atomic<bool> running_{false};
+        //producers between their running_ check and publishing their record
+        std::atomic<size_t> inFlightCount_{0};
+        std::atomic<size_t> droppedCount_{0};
+        size_t reportedDropCount_{0};
+
+        std::mutex wakeMutex_;
+        std::condition_variable wakeCondition_;
+        std::mutex lifecycleMutex_;
+        std::thread thread_;
+    };
+}
+
+#endif /* ASTRA_ASYNC_LOG_SINK_H */
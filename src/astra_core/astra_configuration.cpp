@@ -56,6 +56,9 @@ namespace astra {
         set_severityLevel(ASTRA_SEVERITY_INFO);
         set_consoleOutput(false);
         set_fileOutput(false);
+        set_asyncLogging(false);
+        set_backgroundUpdate(false);
+        set_dataflowThreads(0);
     }
 
     configuration* configuration::load_from_file(const char* tomlFilePath)
@@ -98,6 +101,53 @@ namespace astra {
             config->set_fileOutput(fileOutput);
         }
 
+        const char* asyncLoggingKey = "logging.async_output";
+        if (t.contains_qualified(asyncLoggingKey))
+        {
+            bool asyncLogging = t.get_qualified(asyncLoggingKey)->as<bool>()->get();
+            config->set_asyncLogging(asyncLogging);
+        }
+
+        const char* channelLevelsKey = "logging.channels";
+        if (auto channelLevels = t.get_table_qualified(channelLevelsKey))
+        {
+            for (auto& entry : *channelLevels)
+            {
+                auto logLevel = entry.second->as<std::string>();
+                if (!logLevel)
+                    continue;
+
+                auto severity = convert_string_to_severity(logLevel->get());
+                if (severity != ASTRA_SEVERITY_UNKNOWN)
+                {
+                    config->add_channelSeverityLevel(entry.first, severity);
+                }
+            }
+        }
+
+        const char* backgroundUpdateKey = "update.background_threads";
+        if (t.contains_qualified(backgroundUpdateKey))
+        {
+            bool backgroundUpdate = t.get_qualified(backgroundUpdateKey)->as<bool>()->get();
+            config->set_backgroundUpdate(backgroundUpdate);
+        }
+
+        const char* dataflowThreadsKey = "dataflow.threads";
+        if (t.contains_qualified(dataflowThreadsKey))
+        {
+            int64_t dataflowThreads = t.get_qualified(dataflowThreadsKey)->as<int64_t>()->get();
+            config->set_dataflowThreads(dataflowThreads > 0 ? static_cast<size_t>(dataflowThreads) : 0);
+        }
+
+        const char* sharedMemoryExportKey = "shared_memory.export";
+        if (auto exportUris = t.get_array_qualified(sharedMemoryExportKey))
+        {
+            for (auto& uri : exportUris->array_of<std::string>())
+            {
+                config->add_sharedMemoryExport(uri->get());
+            }
+        }
+
         const char* pluginsPathKey = "plugins.path";
         if (t.contains_qualified(pluginsPathKey))
         {
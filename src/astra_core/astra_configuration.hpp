@@ -19,6 +19,8 @@
 
 #include <astra_core/capi/astra_types.h>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace astra {
 
@@ -41,11 +43,35 @@ namespace astra {
         bool fileOutput(){ return fileOutput_; }
         void set_fileOutput(bool fileOutput){ fileOutput_ = fileOutput; }
 
+        using channel_severity = std::pair<std::string, astra_log_severity_t>;
+        const std::vector<channel_severity>& channelSeverityLevels() const { return channelSeverityLevels_; }
+        void add_channelSeverityLevel(std::string channel, astra_log_severity_t level)
+        {
+            channelSeverityLevels_.push_back(channel_severity(channel, level));
+        }
+
+        bool asyncLogging(){ return asyncLogging_; }
+        void set_asyncLogging(bool asyncLogging){ asyncLogging_ = asyncLogging; }
+
+        bool backgroundUpdate(){ return backgroundUpdate_; }
+        void set_backgroundUpdate(bool backgroundUpdate){ backgroundUpdate_ = backgroundUpdate; }
+
+        size_t dataflowThreads(){ return dataflowThreads_; }
+        void set_dataflowThreads(size_t dataflowThreads){ dataflowThreads_ = dataflowThreads; }
+
+        const std::vector<std::string>& sharedMemoryExports() const { return sharedMemoryExports_; }
+        void add_sharedMemoryExport(std::string uri) { sharedMemoryExports_.push_back(uri); }
+
     private:
         astra_log_severity_t severityLevel_{ASTRA_SEVERITY_FATAL};
         std::string pluginsPath_;
+        std::vector<channel_severity> channelSeverityLevels_;
+        std::vector<std::string> sharedMemoryExports_;
         bool consoleOutput_;
         bool fileOutput_;
+        bool asyncLogging_;
+        bool backgroundUpdate_;
+        size_t dataflowThreads_;
     };
 }
 
@@ -164,6 +164,51 @@ namespace astra {
         return impl_->temp_update();
     }
 
+    astra_status_t context::reader_set_sync_policy(astra_reader_t reader,
+                                                   astra_reader_sync_policy_t policy,
+                                                   uint32_t toleranceMicroseconds)
+    {
+        return impl_->reader_set_sync_policy(reader, policy, toleranceMicroseconds);
+    }
+
+    astra_status_t context::stream_get_stats(astra_streamconnection_t connection,
+                                             astra_stream_stats_t* stats)
+    {
+        return impl_->stream_get_stats(connection, stats);
+    }
+
+    astra_status_t context::context_get_stats(astra_context_stats_t* stats)
+    {
+        return impl_->context_get_stats(stats);
+    }
+
+    astra_status_t context::frame_retain(astra_reader_frame_t frame,
+                                         astra_reader_frame_t& retainedFrame)
+    {
+        return impl_->frame_retain(frame, retainedFrame);
+    }
+
+    astra_status_t context::frame_release(astra_reader_frame_t& frame)
+    {
+        return impl_->frame_release(frame);
+    }
+
+    astra_status_t context::reader_wait_any(astra_reader_t* readers,
+                                            size_t count,
+                                            int timeoutMillis,
+                                            size_t& readyIndex)
+    {
+        return impl_->reader_wait_any(readers, count, timeoutMillis, readyIndex);
+    }
+
+    astra_status_t context::stream_read_parameter(astra_streamconnection_t connection,
+                                                  astra_parameter_id parameterId,
+                                                  size_t byteLength,
+                                                  astra_parameter_data_t data)
+    {
+        return impl_->stream_read_parameter(connection, parameterId, byteLength, data);
+    }
+
 
     astra_status_t context::notify_host_event(astra_event_id id, const void* data, size_t dataSize)
     {
@@ -105,6 +105,30 @@ namespace astra {
 
         astra_status_t temp_update();
 
+        astra_status_t reader_set_sync_policy(astra_reader_t reader,
+                                              astra_reader_sync_policy_t policy,
+                                              uint32_t toleranceMicroseconds);
+
+        astra_status_t stream_get_stats(astra_streamconnection_t connection,
+                                        astra_stream_stats_t* stats);
+
+        astra_status_t context_get_stats(astra_context_stats_t* stats);
+
+        astra_status_t frame_retain(astra_reader_frame_t frame,
+                                    astra_reader_frame_t& retainedFrame);
+
+        astra_status_t frame_release(astra_reader_frame_t& frame);
+
+        astra_status_t reader_wait_any(astra_reader_t* readers,
+                                       size_t count,
+                                       int timeoutMillis,
+                                       size_t& readyIndex);
+
+        astra_status_t stream_read_parameter(astra_streamconnection_t connection,
+                                             astra_parameter_id parameterId,
+                                             size_t byteLength,
+                                             astra_parameter_data_t data);
+
         astra_streamservice_proxy_t* proxy();
 
         astra_status_t notify_host_event(astra_event_id id, const void* data, size_t dataSize);
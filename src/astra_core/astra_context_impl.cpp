@@ -19,6 +19,8 @@
 #include <astra_core/capi/plugins/astra_plugin.h>
 #include <astra_core_api.h>
 #include "astra_stream_reader.hpp"
+#include "astra_retained_frame.hpp"
+#include "astra_frame_buffer_pool.hpp"
 #include "astra_stream_connection.hpp"
 #include "astra_streamset_connection.hpp"
 #include "astra_logging.hpp"
@@ -27,13 +29,24 @@
 #include "astra_configuration.hpp"
 #include "astra_filesystem.hpp"
 #include "astra_cxx_compatibility.hpp"
+#include <chrono>
 
 INITIALIZE_LOGGING
 
 namespace astra {
 
+    //pause between plugin updates on an update thread. plugins poll their devices
+    //without blocking, so this bounds the added capture latency.
+    //fallback for plugins that never raise the update signal
+    static const std::chrono::milliseconds UPDATE_POLL_INTERVAL(1);
+    //pause for a plugin that asks for updates when its device has data, so it is
+    //updated at the device's rate. still updated now and then in case it doesn't.
+    static const std::chrono::milliseconds UPDATE_IDLE_POLL_INTERVAL(100);
+
     astra_status_t context_impl::initialize()
     {
+        std::lock_guard<core_mutex> lock(mutex_);
+
         if (initialized_)
             return ASTRA_STATUS_SUCCESS;
 
@@ -49,11 +62,22 @@ namespace astra {
         std::unique_ptr<configuration> config(configuration::load_from_file(configPath.c_str()));
         initialize_logging(logPath.c_str(), config->severityLevel(), config->consoleOutput(), config->fileOutput());
 
+        for (auto& channelSeverity : config->channelSeverityLevels())
+        {
+            set_log_channel_severity(channelSeverity.first.c_str(), channelSeverity.second);
+        }
+
+        if (config->asyncLogging())
+        {
+            start_async_logging();
+        }
+
         LOG_WARN("context", "Hold on to yer butts");
         LOG_INFO("context", "configuration path: %s", configPath.c_str());
         LOG_INFO("context", "log file path: %s", logPath.c_str());
 
-        pluginManager_ = astra::make_unique<plugin_manager>(setCatalog_);
+        setCatalog_.set_shared_memory_exports(config->sharedMemoryExports());
+        pluginManager_ = astra::make_unique<plugin_manager>(setCatalog_, mutex_, updateSignal_, config->dataflowThreads());
 
 #if !__ANDROID__
         std::string pluginsPath = filesystem::combine_paths(environment::lib_path(),
@@ -73,6 +97,23 @@ namespace astra {
             LOG_WARN("context", "Astra found no plugins. Is there a Plugins folder? Is the working directory correct?");
         }
 
+        backgroundUpdate_ = config->backgroundUpdate();
+        if (backgroundUpdate_)
+        {
+            start_background_update();
+        }
+        else
+        {
+            //started on demand by the first reader that blocks waiting for a frame
+            updateThreads_.push_back(astra::make_unique<update_thread>(updateSignal_,
+                                                                       [this] {
+                                                                           std::lock_guard<core_mutex> lock(mutex_);
+                                                                           pluginManager_->update();
+                                                                       },
+                                                                       UPDATE_POLL_INTERVAL,
+                                                                       UPDATE_POLL_INTERVAL));
+        }
+
         initialized_ = true;
 
         return ASTRA_STATUS_SUCCESS;
@@ -83,28 +124,50 @@ namespace astra {
         if (!initialized_)
             return ASTRA_STATUS_UNINITIALIZED;
 
+        //must happen before taking the lock, the update threads and dataflow
+        //nodes may be waiting on it
+        updateThreads_.clear();
+        pluginManager_->stop_dataflow();
+
+        std::lock_guard<core_mutex> lock(mutex_);
+
         pluginManager_.reset();
         setCatalog_.clear();
 
+        //the bins are gone, don't keep their buffers cached until exit
+        frame_buffer_pool::shared().trim();
+
         initialized_ = false;
 
         LOG_INFO("context", "Astra terminated.");
 
+        stop_async_logging();
+
         return ASTRA_STATUS_SUCCESS;
     }
 
     astra_status_t context_impl::streamset_open(const char* uri, astra_streamsetconnection_t& streamSet)
     {
+        std::lock_guard<core_mutex> lock(mutex_);
+
         LOG_INFO("context", "client opening streamset: %s", uri);
 
-        streamset_connection& conn = setCatalog_.open_set_connection(uri);
-        streamSet = conn.get_handle();
+        streamset_connection* conn = setCatalog_.open_set_connection(uri);
+        if (!conn)
+        {
+            streamSet = nullptr;
+            return ASTRA_STATUS_INTERNAL_ERROR;
+        }
+
+        streamSet = conn->get_handle();
 
         return ASTRA_STATUS_SUCCESS;
     }
 
     astra_status_t context_impl::streamset_close(astra_streamsetconnection_t& streamSet)
     {
+        std::lock_guard<core_mutex> lock(mutex_);
+
         if (!initialized_)
         {
             streamSet = nullptr;
@@ -136,6 +199,8 @@ namespace astra {
     astra_status_t context_impl::reader_create(astra_streamsetconnection_t streamSet,
                                                    astra_reader_t& reader)
     {
+        std::lock_guard<core_mutex> lock(mutex_);
+
         assert(streamSet != nullptr);
 
         streamset_connection* actualConnection = streamset_connection::get_ptr(streamSet);
@@ -143,6 +208,13 @@ namespace astra {
         if (actualConnection)
         {
             stream_reader* actualReader = actualConnection->create_reader();
+            if (!actualReader)
+            {
+                LOG_WARN("context", "no handle left for a new reader");
+                reader = nullptr;
+                return ASTRA_STATUS_INTERNAL_ERROR;
+            }
+
             activeReaders_.push_back(actualReader);
 
             reader = actualReader->get_handle();
@@ -158,6 +230,8 @@ namespace astra {
 
     astra_status_t context_impl::reader_destroy(astra_reader_t& reader)
     {
+        std::lock_guard<core_mutex> lock(mutex_);
+
         assert(reader != nullptr);
 
         stream_reader* actualReader = stream_reader::get_ptr(reader);
@@ -182,6 +256,8 @@ namespace astra {
                                                        astra_stream_subtype_t subtype,
                                                        astra_streamconnection_t& connection)
     {
+        std::lock_guard<core_mutex> lock(mutex_);
+
         assert(reader != nullptr);
 
         stream_reader* actualReader = stream_reader::get_ptr(reader);
@@ -192,7 +268,15 @@ namespace astra {
             desc.type = type;
             desc.subtype = subtype;
 
-            connection = actualReader->get_stream(desc)->get_handle();
+            stream_connection* actualConnection = actualReader->get_stream(desc);
+            if (!actualConnection)
+            {
+                LOG_WARN("context", "no handle left for a new stream connection");
+                connection = nullptr;
+                return ASTRA_STATUS_INTERNAL_ERROR;
+            }
+
+            connection = actualConnection->get_handle();
         }
         else
         {
@@ -206,6 +290,8 @@ namespace astra {
     astra_status_t context_impl::stream_get_description(astra_streamconnection_t connection,
                                                             astra_stream_desc_t* description)
     {
+        std::lock_guard<core_mutex> lock(mutex_);
+
         stream_connection* actualConnection = stream_connection::get_ptr(connection);
 
         if (actualConnection)
@@ -222,6 +308,8 @@ namespace astra {
 
     astra_status_t context_impl::stream_start(astra_streamconnection_t connection)
     {
+        std::lock_guard<core_mutex> lock(mutex_);
+
         assert(connection != nullptr);
         assert(connection->handle != nullptr);
 
@@ -241,6 +329,8 @@ namespace astra {
 
     astra_status_t context_impl::stream_stop(astra_streamconnection_t connection)
     {
+        std::lock_guard<core_mutex> lock(mutex_);
+
         assert(connection != nullptr);
         assert(connection->handle != nullptr);
 
@@ -262,6 +352,8 @@ namespace astra {
                                                        int timeoutMillis,
                                                        astra_reader_frame_t& frame)
     {
+        std::lock_guard<core_mutex> lock(mutex_);
+
         if (reader == nullptr)
         {
             LOG_WARN("context", "reader_open_frame called with null reader");
@@ -273,7 +365,27 @@ namespace astra {
 
         if (actualReader)
         {
-            return actualReader->lock(timeoutMillis, frame);
+            core_mutex* waitMutex = nullptr;
+            if (timeoutMillis != ASTRA_TIMEOUT_RETURN_IMMEDIATELY)
+            {
+                if (can_wait_for_update_thread())
+                {
+                    for (auto& thread : updateThreads_)
+                    {
+                        thread->start();
+                    }
+                    waitMutex = &mutex_;
+                }
+                else if (backgroundUpdate_)
+                {
+                    //astra_temp_update() does nothing in background mode, so pumping
+                    //while holding the core mutex could never produce a frame
+                    LOG_WARN("context", "reader_open_frame can't block here, returning immediately");
+                    timeoutMillis = ASTRA_TIMEOUT_RETURN_IMMEDIATELY;
+                }
+            }
+
+            return actualReader->lock(timeoutMillis, frame, waitMutex);
         }
         else
         {
@@ -282,6 +394,34 @@ namespace astra {
         }
     }
 
+    astra_status_t context_impl::reader_wait_any(astra_reader_t* readers,
+                                                 size_t count,
+                                                 int timeoutMillis,
+                                                 size_t& readyIndex)
+    {
+        std::lock_guard<core_mutex> lock(mutex_);
+
+        core_mutex* waitMutex = nullptr;
+        if (timeoutMillis != ASTRA_TIMEOUT_RETURN_IMMEDIATELY)
+        {
+            if (can_wait_for_update_thread())
+            {
+                for (auto& thread : updateThreads_)
+                {
+                    thread->start();
+                }
+                waitMutex = &mutex_;
+            }
+            else if (backgroundUpdate_)
+            {
+                LOG_WARN("context", "reader_wait_any can't block here, returning immediately");
+                timeoutMillis = ASTRA_TIMEOUT_RETURN_IMMEDIATELY;
+            }
+        }
+
+        return stream_reader::wait_any(readers, count, timeoutMillis, readyIndex, waitMutex);
+    }
+
     astra_status_t context_impl::reader_close_frame(astra_reader_frame_t& frame)
     {
         if (frame == nullptr)
@@ -291,6 +431,14 @@ namespace astra {
             return ASTRA_STATUS_INVALID_OPERATION;
         }
 
+        if (retained_frame::from_frame(frame))
+        {
+            //closing a retained frame is the same as releasing it
+            return frame_release(frame);
+        }
+
+        std::lock_guard<core_mutex> lock(mutex_);
+
         stream_reader* actualReader = stream_reader::from_frame(frame);
 
         if (!actualReader)
@@ -308,6 +456,8 @@ namespace astra {
                                                                           void* clientTag,
                                                                           astra_reader_callback_id_t& callbackId)
     {
+        std::lock_guard<core_mutex> lock(mutex_);
+
         assert(reader != nullptr);
         callbackId = nullptr;
 
@@ -334,6 +484,8 @@ namespace astra {
 
     astra_status_t context_impl::reader_unregister_frame_ready_callback(astra_reader_callback_id_t& callbackId)
     {
+        std::lock_guard<core_mutex> lock(mutex_);
+
         if (!initialized_)
         {
             delete callbackId;
@@ -370,14 +522,26 @@ namespace astra {
     {
         assert(frame != nullptr);
 
+        astra_stream_desc_t desc;
+        desc.type = type;
+        desc.subtype = subtype;
+
+        //retained frames never change and hold no core state, so they are read,
+        //retained and released without the core mutex. asynchronous listeners
+        //rely on it, the thread delivering frames may be waiting on them.
+        retained_frame* retained = retained_frame::from_frame(frame);
+        if (retained)
+        {
+            subFrame = retained->get_subframe(desc);
+            return ASTRA_STATUS_SUCCESS;
+        }
+
+        std::lock_guard<core_mutex> lock(mutex_);
+
         stream_reader* actualReader = stream_reader::from_frame(frame);
 
         if (actualReader)
         {
-            astra_stream_desc_t desc;
-            desc.type = type;
-            desc.subtype = subtype;
-
             subFrame = actualReader->get_subframe(desc);
 
             return ASTRA_STATUS_SUCCESS;
@@ -389,8 +553,54 @@ namespace astra {
         }
     }
 
+    void context_impl::start_background_update()
+    {
+        //each plugin updates outside the core mutex, under its own update lock,
+        //so a slow plugin holds up only the clients calling into it. each thread
+        //sleeps until its own plugin produces a frame or asks for an update.
+        LOG_INFO("context", "starting %u background update threads", pluginManager_->plugin_count());
+
+        for (size_t i = 0; i < pluginManager_->plugin_count(); ++i)
+        {
+            auto thread = astra::make_unique<update_thread>(pluginManager_->plugin_update_signal(i),
+                                                            [this, i] { pluginManager_->update_plugin(i); },
+                                                            UPDATE_POLL_INTERVAL,
+                                                            UPDATE_IDLE_POLL_INTERVAL);
+            thread->start();
+            updateThreads_.push_back(std::move(thread));
+        }
+    }
+
+    bool context_impl::is_update_thread() const
+    {
+        for (auto& thread : updateThreads_)
+        {
+            if (thread->is_current_thread())
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool context_impl::can_wait_for_update_thread() const
+    {
+        //sleeping is only possible when the wait releases the core mutex completely
+        //and an update thread isn't the one asking, i.e. not from inside a frame callback
+        return !is_update_thread() && mutex_.is_held_once();
+    }
+
     astra_status_t context_impl::temp_update()
     {
+        std::lock_guard<core_mutex> lock(mutex_);
+
+        if (backgroundUpdate_)
+        {
+            //plugins are updated by their own threads
+            return ASTRA_STATUS_SUCCESS;
+        }
+
         pluginManager_->update();
 
         return ASTRA_STATUS_SUCCESS;
@@ -401,6 +611,8 @@ namespace astra {
                                                           size_t inByteLength,
                                                           astra_parameter_data_t inData)
     {
+        std::lock_guard<core_mutex> lock(mutex_);
+
         assert(connection != nullptr);
         assert(connection->handle != nullptr);
 
@@ -423,6 +635,8 @@ namespace astra {
                                                           size_t& resultByteLength,
                                                           astra_result_token_t& token)
     {
+        std::lock_guard<core_mutex> lock(mutex_);
+
         assert(connection != nullptr);
         assert(connection->handle != nullptr);
 
@@ -445,6 +659,8 @@ namespace astra {
                                                        size_t dataByteLength,
                                                        astra_parameter_data_t dataDestination)
     {
+        std::lock_guard<core_mutex> lock(mutex_);
+
         assert(connection != nullptr);
         assert(connection->handle != nullptr);
 
@@ -467,6 +683,8 @@ namespace astra {
                                                    size_t& resultByteLength,
                                                    astra_result_token_t& token)
     {
+        std::lock_guard<core_mutex> lock(mutex_);
+
         assert(connection != nullptr);
         assert(connection->handle != nullptr);
 
@@ -484,8 +702,154 @@ namespace astra {
         }
     }
 
+    astra_status_t context_impl::stream_read_parameter(astra_streamconnection_t connection,
+                                                       astra_parameter_id parameterId,
+                                                       size_t byteLength,
+                                                       astra_parameter_data_t data)
+    {
+        assert(connection != nullptr);
+        assert(connection->handle != nullptr);
+        assert(data != nullptr);
+
+        //handle lookups and cached values don't need the core mutex
+        stream_connection* actualConnection = stream_connection::get_ptr(connection);
+        if (actualConnection && actualConnection->try_get_cached_parameter(parameterId, byteLength, data))
+        {
+            return ASTRA_STATUS_SUCCESS;
+        }
+
+        std::lock_guard<core_mutex> lock(mutex_);
+
+        actualConnection = stream_connection::get_ptr(connection);
+        if (actualConnection)
+        {
+            return actualConnection->read_parameter(parameterId, byteLength, data);
+        }
+        else
+        {
+            LOG_WARN("context", "read_parameter called on non-existent stream");
+            return ASTRA_STATUS_INVALID_PARAMETER;
+        }
+    }
+
+    astra_status_t context_impl::reader_set_sync_policy(astra_reader_t reader,
+                                                        astra_reader_sync_policy_t policy,
+                                                        uint32_t toleranceMicroseconds)
+    {
+        std::lock_guard<core_mutex> lock(mutex_);
+
+        assert(reader != nullptr);
+
+        stream_reader* actualReader = stream_reader::get_ptr(reader);
+
+        if (actualReader)
+        {
+            return actualReader->set_sync_policy(policy, toleranceMicroseconds);
+        }
+        else
+        {
+            LOG_WARN("context", "set_sync_policy called on non-existent reader");
+            return ASTRA_STATUS_INVALID_PARAMETER;
+        }
+    }
+
+    astra_status_t context_impl::stream_get_stats(astra_streamconnection_t connection,
+                                                  astra_stream_stats_t* stats)
+    {
+        std::lock_guard<core_mutex> lock(mutex_);
+
+        assert(stats != nullptr);
+
+        stream_connection* actualConnection = stream_connection::get_ptr(connection);
+
+        if (actualConnection)
+        {
+            actualConnection->get_stats(*stats);
+            return ASTRA_STATUS_SUCCESS;
+        }
+        else
+        {
+            LOG_WARN("context", "get_stats called on non-existent stream");
+            return ASTRA_STATUS_INVALID_PARAMETER;
+        }
+    }
+
+    astra_status_t context_impl::context_get_stats(astra_context_stats_t* stats)
+    {
+        std::lock_guard<core_mutex> lock(mutex_);
+
+        assert(stats != nullptr);
+
+        if (!initialized_)
+            return ASTRA_STATUS_UNINITIALIZED;
+
+        pluginManager_->get_stats(*stats);
+
+        return ASTRA_STATUS_SUCCESS;
+    }
+
+    astra_status_t context_impl::frame_retain(astra_reader_frame_t frame,
+                                              astra_reader_frame_t& retainedFrame)
+    {
+        assert(frame != nullptr);
+        retainedFrame = nullptr;
+
+        retained_frame* retained = retained_frame::from_frame(frame);
+        if (retained)
+        {
+            retained->add_ref();
+            retainedFrame = frame;
+            return ASTRA_STATUS_SUCCESS;
+        }
+
+        std::lock_guard<core_mutex> lock(mutex_);
+
+        stream_reader* actualReader = stream_reader::from_frame(frame);
+
+        if (actualReader)
+        {
+            return actualReader->retain(frame, retainedFrame);
+        }
+        else
+        {
+            LOG_WARN("context", "frame_retain called on non-existent reader/frame combo");
+            return ASTRA_STATUS_INVALID_PARAMETER;
+        }
+    }
+
+    astra_status_t context_impl::frame_release(astra_reader_frame_t& frame)
+    {
+        //only retained frames are released, see reader_get_frame()
+        if (frame == nullptr)
+        {
+            LOG_WARN("context", "frame_release called with null frame");
+            assert(frame != nullptr);
+            return ASTRA_STATUS_INVALID_OPERATION;
+        }
+
+        retained_frame* retained = retained_frame::from_frame(frame);
+
+        if (retained)
+        {
+            if (retained->release())
+            {
+                delete retained;
+            }
+
+            frame = nullptr;
+            return ASTRA_STATUS_SUCCESS;
+        }
+        else
+        {
+            LOG_WARN("context", "frame_release called on a frame that wasn't retained");
+            return ASTRA_STATUS_INVALID_OPERATION;
+        }
+    }
+
     astra_status_t context_impl::notify_host_event(astra_event_id id, const void* data, size_t dataSize)
     {
+        std::lock_guard<core_mutex> lock(mutex_);
+
         pluginManager_->notify_host_event(id, data, dataSize);
         return ASTRA_STATUS_SUCCESS;
     }
@@ -23,6 +23,7 @@
 #include <memory>
 #include <unordered_map>
 #include <string>
+#include <vector>
 
 #include "astra_plugin_manager.hpp"
 #include "astra_streamset.hpp"
@@ -30,6 +31,8 @@
 #include "astra_shared_library.hpp"
 #include "astra_logger.hpp"
 #include "astra_streamset_catalog.hpp"
+#include "astra_core_mutex.hpp"
+#include "astra_update_thread.hpp"
 
 struct astra_streamservice_proxy_t;
 
@@ -109,10 +112,52 @@ namespace astra {
 
         astra_status_t temp_update();
 
+        astra_status_t reader_set_sync_policy(astra_reader_t reader,
+                                              astra_reader_sync_policy_t policy,
+                                              uint32_t toleranceMicroseconds);
+
+        astra_status_t stream_get_stats(astra_streamconnection_t connection,
+                                        astra_stream_stats_t* stats);
+
+        astra_status_t context_get_stats(astra_context_stats_t* stats);
+
+        astra_status_t frame_retain(astra_reader_frame_t frame,
+                                    astra_reader_frame_t& retainedFrame);
+
+        astra_status_t frame_release(astra_reader_frame_t& frame);
+
+        astra_status_t reader_wait_any(astra_reader_t* readers,
+                                       size_t count,
+                                       int timeoutMillis,
+                                       size_t& readyIndex);
+
+        astra_status_t stream_read_parameter(astra_streamconnection_t connection,
+                                             astra_parameter_id parameterId,
+                                             size_t byteLength,
+                                             astra_parameter_data_t data);
+
         astra_status_t notify_host_event(astra_event_id id, const void* data, size_t dataSize);
 
     private:
+        void start_background_update();
+        bool is_update_thread() const;
+        bool can_wait_for_update_thread() const;
+
         bool initialized_{false};
+        bool backgroundUpdate_{false};
+
+        core_mutex mutex_;
+        update_signal updateSignal_;
+
+        using update_thread_ptr = std::unique_ptr<update_thread>;
+        using UpdateThreadList = std::vector<update_thread_ptr>;
+
+        //background mode: one thread per plugin, started at initialize. each update
+        //holds only its plugin's update lock, the core mutex is taken for the calls
+        //the plugin makes into the core.
+        //otherwise: a single thread updating all plugins under the core mutex,
+        //started on demand by blocking readers
+        UpdateThreadList updateThreads_;
 
         using plugin_manager_ptr = std::unique_ptr<plugin_manager>;
         plugin_manager_ptr pluginManager_;
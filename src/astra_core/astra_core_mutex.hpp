@@ -0,0 +1,168 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#ifndef ASTRA_CORE_MUTEX_H
+#define ASTRA_CORE_MUTEX_H
+
+#include <cassert>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace astra {
+
+    // Recursive mutex that serializes the core between the client API
+    // and the update thread. It remembers its owner and recursion depth so a
+    // waiter can tell whether a condition wait would fully release it.
+    class core_mutex
+    {
+    public:
+        core_mutex() = default;
+        core_mutex(const core_mutex&) = delete;
+        core_mutex& operator=(const core_mutex&) = delete;
+
+        void lock()
+        {
+            std::unique_lock<std::mutex> lock(stateMutex_);
+            const std::thread::id self = std::this_thread::get_id();
+
+            if (owner_ != self)
+            {
+                ++waiterCount_;
+                released_.wait(lock, [this, self] { return is_free_for(self); });
+                --waiterCount_;
+                owner_ = self;
+            }
+            ++depth_;
+        }
+
+        bool try_lock()
+        {
+            std::lock_guard<std::mutex> lock(stateMutex_);
+            const std::thread::id self = std::this_thread::get_id();
+
+            if (owner_ != self)
+            {
+                if (!is_free_for(self))
+                    return false;
+
+                owner_ = self;
+            }
+            ++depth_;
+            return true;
+        }
+
+        void unlock()
+        {
+            std::unique_lock<std::mutex> lock(stateMutex_);
+            assert(owner_ == std::this_thread::get_id());
+
+            if (--depth_ > 0)
+                return;
+
+            owner_ = std::thread::id();
+            notify_released(lock);
+        }
+
+        // true if the calling thread holds the mutex exactly once
+        bool is_held_once() const
+        {
+            std::lock_guard<std::mutex> lock(stateMutex_);
+            return owner_ == std::this_thread::get_id() && depth_ == 1;
+        }
+
+        // Hands the mutex held by the calling thread to one other thread
+        // while the caller waits on it. Nobody else gets in meanwhile, so
+        // for the caller it is as if the borrower's core calls were made
+        // nested in its own. Does nothing if the caller doesn't hold it.
+        class loan
+        {
+        public:
+            loan(core_mutex& mutex, std::thread::id borrower)
+                : mutex_(mutex)
+            {
+                std::unique_lock<std::mutex> lock(mutex_.stateMutex_);
+
+                if (mutex_.owner_ != std::this_thread::get_id())
+                    return;
+
+                depth_ = mutex_.depth_;
+                previousHeir_ = mutex_.heir_;
+
+                mutex_.owner_ = std::thread::id();
+                mutex_.depth_ = 0;
+                mutex_.heir_ = borrower;
+                mutex_.notify_released(lock);
+            }
+
+            //waits for the borrower to unlock
+            ~loan()
+            {
+                if (depth_ == 0)
+                    return;
+
+                std::unique_lock<std::mutex> lock(mutex_.stateMutex_);
+                const std::thread::id self = std::this_thread::get_id();
+
+                mutex_.heir_ = self;
+                ++mutex_.waiterCount_;
+                mutex_.released_.wait(lock, [this, self] { return mutex_.is_free_for(self); });
+                --mutex_.waiterCount_;
+
+                mutex_.owner_ = self;
+                mutex_.depth_ = depth_;
+                mutex_.heir_ = previousHeir_;
+            }
+
+            loan(const loan&) = delete;
+            loan& operator=(const loan&) = delete;
+
+        private:
+            core_mutex& mutex_;
+            int depth_{0};
+            std::thread::id previousHeir_;
+        };
+
+    private:
+        bool is_free_for(std::thread::id thread) const
+        {
+            return owner_ == std::thread::id() &&
+                (heir_ == std::thread::id() || heir_ == thread);
+        }
+
+        void notify_released(std::unique_lock<std::mutex>& lock)
+        {
+            const bool hasWaiters = waiterCount_ > 0;
+            lock.unlock();
+
+            //waiters may be held back for an heir, so wake them all
+            if (hasWaiters)
+            {
+                released_.notify_all();
+            }
+        }
+
+        mutable std::mutex stateMutex_;
+        std::condition_variable released_;
+        std::thread::id owner_;
+        //while set, only this thread may take the free mutex, see loan
+        std::thread::id heir_;
+        int depth_{0};
+        int waiterCount_{0};
+    };
+}
+
+#endif /* ASTRA_CORE_MUTEX_H */
@@ -47,6 +47,14 @@ astra_pluginservice_proxy_t* create_plugin_proxy(plugin_service* service)
         proxy->link_connection_to_bin = &plugin_service_delegate::link_connection_to_bin;
         proxy->get_parameter_bin = &plugin_service_delegate::get_parameter_bin;
         proxy->log = &plugin_service_delegate::log;
+        proxy->create_stream_bin_with_depth = &plugin_service_delegate::create_stream_bin_with_depth;
+        proxy->register_dataflow_node = &plugin_service_delegate::register_dataflow_node;
+        proxy->unregister_dataflow_node = &plugin_service_delegate::unregister_dataflow_node;
+        proxy->set_stream_compute_callback = &plugin_service_delegate::set_stream_compute_callback;
+        proxy->set_parameter_cacheable = &plugin_service_delegate::set_parameter_cacheable;
+        proxy->invalidate_parameters = &plugin_service_delegate::invalidate_parameters;
+        proxy->set_bin_capture_timestamp = &plugin_service_delegate::set_bin_capture_timestamp;
+        proxy->request_update = &plugin_service_delegate::request_update;
         proxy->pluginService = service;
 
         return proxy;
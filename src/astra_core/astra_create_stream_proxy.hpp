@@ -46,6 +46,13 @@ namespace astra {
         proxy->stream_get_result = &stream_service_delegate::stream_get_result;
         proxy->stream_invoke = &stream_service_delegate::stream_invoke;
         proxy->temp_update = &stream_service_delegate::temp_update;
+        proxy->reader_set_sync_policy = &stream_service_delegate::reader_set_sync_policy;
+        proxy->stream_get_stats = &stream_service_delegate::stream_get_stats;
+        proxy->context_get_stats = &stream_service_delegate::context_get_stats;
+        proxy->frame_retain = &stream_service_delegate::frame_retain;
+        proxy->frame_release = &stream_service_delegate::frame_release;
+        proxy->reader_wait_any = &stream_service_delegate::reader_wait_any;
+        proxy->stream_read_parameter = &stream_service_delegate::stream_read_parameter;
         proxy->streamService = context;
 
         return proxy;
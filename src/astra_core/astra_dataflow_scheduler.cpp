@@ -0,0 +1,364 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#include "astra_dataflow_scheduler.hpp"
+#include "astra_stream_reader.hpp"
+#include "astra_streamset.hpp"
+#include "astra_streamset_connection.hpp"
+#include "astra_retained_frame.hpp"
+#include "astra_logger.hpp"
+#include <algorithm>
+#include <cassert>
+
+namespace astra {
+
+    struct dataflow_scheduler::node : std::enable_shared_from_this<node>
+    {
+        dataflow_scheduler* scheduler;
+        astra_callback_id_t id;
+        astra_reader_t reader;
+        astra_callback_id_t readerCallbackId;
+        std::string setUri;
+        std::vector<astra_stream_desc_t> inputs;
+        std::vector<astra_stream_desc_t> outputs;
+        astra_frame_ready_callback_t callback;
+        void* clientTag;
+
+        //guarded by the scheduler's mutex_
+        astra_reader_frame_t pendingFrame{nullptr};
+        //queued on or running on the pool
+        bool isScheduled{false};
+        bool isRunning{false};
+        bool isRemoved{false};
+        std::thread::id runningThread;
+        size_t droppedFrameCount{0};
+    };
+
+    static bool contains_desc(const std::vector<astra_stream_desc_t>& descs,
+                              const astra_stream_desc_t& desc)
+    {
+        return std::any_of(descs.begin(), descs.end(),
+                           [&desc] (const astra_stream_desc_t& d)
+                           {
+                               return d.type == desc.type && d.subtype == desc.subtype;
+                           });
+    }
+
+    dataflow_scheduler::dataflow_scheduler(core_mutex& coreMutex, size_t threadCount)
+        : coreMutex_(coreMutex),
+          threadCount_(threadCount)
+    {}
+
+    dataflow_scheduler::~dataflow_scheduler()
+    {
+        stop();
+
+        for (auto& n : nodes_)
+        {
+            LOG_WARN("astra.dataflow_scheduler", "node %u was never removed", n->id);
+
+            stream_reader* reader = stream_reader::get_ptr(n->reader);
+            if (reader)
+            {
+                reader->unregister_frame_ready_callback(n->readerCallbackId);
+            }
+        }
+    }
+
+    astra_callback_id_t dataflow_scheduler::add_node(stream_reader& reader,
+                                                     const astra_stream_desc_t* inputs,
+                                                     size_t inputCount,
+                                                     const astra_stream_desc_t* outputs,
+                                                     size_t outputCount,
+                                                     astra_frame_ready_callback_t callback,
+                                                     void* clientTag)
+    {
+        node_ptr n = std::make_shared<node>();
+        n->scheduler = this;
+        n->reader = reader.get_handle();
+        n->setUri = reader.get_connection().get_streamSet()->get_uri();
+        n->inputs.assign(inputs, inputs + inputCount);
+        n->outputs.assign(outputs, outputs + outputCount);
+        n->callback = callback;
+        n->clientTag = clientTag;
+
+        for (astra_stream_desc_t desc : n->inputs)
+        {
+            reader.get_stream(desc)->start();
+        }
+
+        if (threadCount_ > 0 && !pool_ && !stopped_)
+        {
+            pool_.reset(new work_stealing_pool(threadCount_));
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            n->id = nextNodeId_++;
+            nodes_.push_back(n);
+        }
+
+        n->readerCallbackId = reader.register_frame_ready_callback(&dataflow_scheduler::frame_ready_thunk, n.get());
+
+        LOG_INFO("astra.dataflow_scheduler", "added node %u on %s with %u inputs and %u outputs",
+                 n->id, n->setUri.c_str(), inputCount, outputCount);
+        log_edges(*n);
+
+        return n->id;
+    }
+
+    void dataflow_scheduler::log_edges(const node& added)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        for (auto& other : nodes_)
+        {
+            if (other.get() == &added || other->setUri != added.setUri)
+                continue;
+
+            for (auto& output : other->outputs)
+            {
+                if (contains_desc(added.inputs, output))
+                {
+                    LOG_INFO("astra.dataflow_scheduler", "node %u feeds node %u with stream %d:%d",
+                             other->id, added.id, output.type, output.subtype);
+                }
+            }
+
+            for (auto& output : added.outputs)
+            {
+                if (contains_desc(other->inputs, output))
+                {
+                    LOG_INFO("astra.dataflow_scheduler", "node %u feeds node %u with stream %d:%d",
+                             added.id, other->id, output.type, output.subtype);
+                }
+            }
+        }
+    }
+
+    bool dataflow_scheduler::remove_node(astra_callback_id_t nodeId)
+    {
+        node_ptr n;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = std::find_if(nodes_.begin(), nodes_.end(),
+                                   [nodeId] (const node_ptr& candidate) { return candidate->id == nodeId; });
+
+            if (it == nodes_.end())
+                return false;
+
+            n = *it;
+            nodes_.erase(it);
+        }
+
+        stream_reader* reader = stream_reader::get_ptr(n->reader);
+        if (reader)
+        {
+            reader->unregister_frame_ready_callback(n->readerCallbackId);
+        }
+
+        astra_reader_frame_t pendingFrame = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            n->isRemoved = true;
+            std::swap(pendingFrame, n->pendingFrame);
+
+            //a node may remove itself from its own callback
+            if (n->isRunning && n->runningThread != std::this_thread::get_id())
+            {
+                //the callback may be waiting for the core mutex, lend it just
+                //to the node's worker. it is taken back after mutex_ is
+                //released, the core mutex comes first.
+                core_mutex::loan loan(coreMutex_, n->runningThread);
+                idleCondition_.wait(lock, [&n] { return !n->isRunning; });
+                lock.unlock();
+            }
+        }
+
+        if (pendingFrame)
+        {
+            release_frame(pendingFrame);
+        }
+
+        LOG_INFO("astra.dataflow_scheduler", "removed node %u, %u frames dropped while it was busy",
+                 n->id, n->droppedFrameCount);
+
+        return true;
+    }
+
+    void dataflow_scheduler::stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopped_)
+                return;
+
+            stopped_ = true;
+        }
+
+        if (pool_)
+        {
+            pool_->stop();
+        }
+
+        std::vector<astra_reader_frame_t> pendingFrames;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto& n : nodes_)
+            {
+                n->isScheduled = false;
+                if (n->pendingFrame)
+                {
+                    pendingFrames.push_back(n->pendingFrame);
+                    n->pendingFrame = nullptr;
+                }
+            }
+        }
+
+        for (auto& frame : pendingFrames)
+        {
+            release_frame(frame);
+        }
+    }
+
+    void dataflow_scheduler::frame_ready_thunk(void* clientTag,
+                                               astra_reader_t reader,
+                                               astra_reader_frame_t frame)
+    {
+        node* n = static_cast<node*>(clientTag);
+        n->scheduler->on_frame_ready(n->shared_from_this(), frame);
+    }
+
+    void dataflow_scheduler::on_frame_ready(const node_ptr& n, astra_reader_frame_t frame)
+    {
+        if (!pool_)
+        {
+            n->callback(n->clientTag, n->reader, frame);
+            return;
+        }
+
+        stream_reader* reader = stream_reader::from_frame(frame);
+        astra_reader_frame_t retainedFrame = nullptr;
+
+        if (!reader || reader->retain(frame, retainedFrame) != ASTRA_STATUS_SUCCESS)
+            return;
+
+        astra_reader_frame_t droppedFrame = nullptr;
+        bool submit = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            if (n->isRemoved || stopped_)
+            {
+                droppedFrame = retainedFrame;
+            }
+            else
+            {
+                if (n->pendingFrame)
+                {
+                    droppedFrame = n->pendingFrame;
+                    ++n->droppedFrameCount;
+                }
+
+                n->pendingFrame = retainedFrame;
+
+                if (!n->isScheduled)
+                {
+                    n->isScheduled = true;
+                    submit = true;
+                }
+            }
+        }
+
+        if (droppedFrame)
+        {
+            release_frame(droppedFrame);
+        }
+
+        if (submit && !pool_->submit([this, n] { run_node(n); }))
+        {
+            //stopping, stop() may have already swept the pending frames
+            astra_reader_frame_t pendingFrame = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                n->isScheduled = false;
+                std::swap(pendingFrame, n->pendingFrame);
+            }
+
+            if (pendingFrame)
+            {
+                release_frame(pendingFrame);
+            }
+        }
+    }
+
+    void dataflow_scheduler::run_node(const node_ptr& n)
+    {
+        while (true)
+        {
+            astra_reader_frame_t frame = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                std::swap(frame, n->pendingFrame);
+
+                if (frame == nullptr || n->isRemoved)
+                {
+                    n->isScheduled = false;
+                }
+                else
+                {
+                    n->isRunning = true;
+                    n->runningThread = std::this_thread::get_id();
+                }
+            }
+
+            if (frame == nullptr)
+                return;
+
+            if (!n->isRunning)
+            {
+                //removed after the frame was queued
+                release_frame(frame);
+                return;
+            }
+
+            //the core mutex is not held, the node takes it for each call it makes
+            n->callback(n->clientTag, n->reader, frame);
+
+            release_frame(frame);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                n->isRunning = false;
+                n->runningThread = std::thread::id();
+            }
+            idleCondition_.notify_all();
+        }
+    }
+
+    void dataflow_scheduler::release_frame(astra_reader_frame_t& frame)
+    {
+        //retained frames are released without the core mutex
+        retained_frame* retained = retained_frame::from_frame(frame);
+        assert(retained != nullptr);
+        frame = nullptr;
+
+        if (retained != nullptr && retained->release())
+        {
+            delete retained;
+        }
+    }
+}
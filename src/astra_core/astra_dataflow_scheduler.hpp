@@ -0,0 +1,101 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#ifndef ASTRA_DATAFLOW_SCHEDULER_H
+#define ASTRA_DATAFLOW_SCHEDULER_H
+
+#include <astra_core/capi/astra_types.h>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "astra_core_mutex.hpp"
+#include "astra_work_stealing_pool.hpp"
+
+namespace astra {
+
+    class stream_reader;
+
+    // Runs plugin nodes that derive streams from other streams (depth ->
+    // points -> hands). A node declares the streams it reads and the ones it
+    // writes, and is called with each new frame of its reader.
+    //
+    // Without worker threads a node runs on the thread that raised frame
+    // ready, as plugin frame listeners always have. With worker threads the
+    // frame is retained and the node runs on the pool without the core
+    // mutex, one frame at a time. A node that is still busy keeps only the
+    // newest frame, so a slow node (hand tracking) drops frames instead of
+    // holding up its producer, and the next depth frame can be processed
+    // while the previous one is still being tracked.
+    class dataflow_scheduler
+    {
+    public:
+        dataflow_scheduler(core_mutex& coreMutex, size_t threadCount);
+        ~dataflow_scheduler();
+
+        dataflow_scheduler(const dataflow_scheduler&) = delete;
+        dataflow_scheduler& operator=(const dataflow_scheduler&) = delete;
+
+        //called with the core mutex held
+        astra_callback_id_t add_node(stream_reader& reader,
+                                     const astra_stream_desc_t* inputs,
+                                     size_t inputCount,
+                                     const astra_stream_desc_t* outputs,
+                                     size_t outputCount,
+                                     astra_frame_ready_callback_t callback,
+                                     void* clientTag);
+
+        // called with the core mutex held. waits for a running callback of
+        // the node to return. the callback's worker may use the core mutex
+        // meanwhile, no other thread gets in.
+        bool remove_node(astra_callback_id_t nodeId);
+
+        // stops the worker threads. called without the core mutex before
+        // the plugins are unloaded, nodes then no longer run.
+        void stop();
+
+        size_t thread_count() const { return threadCount_; }
+
+    private:
+        struct node;
+        using node_ptr = std::shared_ptr<node>;
+
+        static void frame_ready_thunk(void* clientTag,
+                                      astra_reader_t reader,
+                                      astra_reader_frame_t frame);
+
+        void on_frame_ready(const node_ptr& n, astra_reader_frame_t frame);
+        void run_node(const node_ptr& n);
+        void release_frame(astra_reader_frame_t& frame);
+        void log_edges(const node& n);
+
+        core_mutex& coreMutex_;
+        const size_t threadCount_;
+        //started with the first node
+        std::unique_ptr<work_stealing_pool> pool_;
+
+        //guards the nodes and their frame state. taken after the core mutex
+        std::mutex mutex_;
+        std::condition_variable idleCondition_;
+        std::vector<node_ptr> nodes_;
+        astra_callback_id_t nextNodeId_{1};
+        bool stopped_{false};
+    };
+}
+
+#endif /* ASTRA_DATAFLOW_SCHEDULER_H */
@@ -0,0 +1,200 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#include "astra_frame_buffer_pool.hpp"
+#include <algorithm>
+#include <new>
+#include <cstdlib>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace astra {
+
+    namespace {
+        const size_t PAGE_SIZE_BYTES = 4096;
+
+        size_t round_up(size_t value, size_t multiple)
+        {
+            return (value + multiple - 1) / multiple * multiple;
+        }
+    }
+
+    frame_buffer_pool& frame_buffer_pool::shared()
+    {
+        static std::shared_ptr<frame_buffer_pool>* instance =
+            new std::shared_ptr<frame_buffer_pool>(create(DEFAULT_MAX_CACHED_BYTES));
+
+        return **instance;
+    }
+
+    std::shared_ptr<frame_buffer_pool> frame_buffer_pool::create(size_t maxCachedBytes)
+    {
+        return std::shared_ptr<frame_buffer_pool>(new frame_buffer_pool(maxCachedBytes));
+    }
+
+    frame_buffer_pool::frame_buffer_pool(size_t maxCachedBytes)
+        : maxCachedBytes_(maxCachedBytes)
+    {}
+
+    frame_buffer_pool::~frame_buffer_pool()
+    {
+        trim();
+    }
+
+    size_t frame_buffer_pool::size_class_of(size_t byteSize)
+    {
+        //rounding wastes at most a quarter
+        if (byteSize >= HUGE_PAGE_MIN_BUFFER_SIZE)
+        {
+            return round_up(byteSize, HUGE_PAGE_SIZE);
+        }
+
+        if (byteSize >= PAGE_SIZE_BYTES)
+        {
+            return round_up(byteSize, PAGE_SIZE_BYTES);
+        }
+
+        return round_up(std::max<size_t>(byteSize, 1), ALIGNMENT);
+    }
+
+    uint8_t* frame_buffer_pool::allocate(size_t sizeClass)
+    {
+        const size_t alignment = sizeClass >= HUGE_PAGE_MIN_BUFFER_SIZE ? HUGE_PAGE_SIZE : ALIGNMENT;
+
+#if defined(_WIN32)
+        void* buffer = _aligned_malloc(sizeClass, alignment);
+        if (buffer == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+#else
+        void* buffer = nullptr;
+        if (posix_memalign(&buffer, alignment, sizeClass) != 0)
+        {
+            throw std::bad_alloc();
+        }
+
+#if defined(MADV_HUGEPAGE)
+        if (alignment == HUGE_PAGE_SIZE)
+        {
+            //advisory, the buffer works the same without huge pages
+            madvise(buffer, sizeClass, MADV_HUGEPAGE);
+        }
+#endif
+#endif
+
+        return static_cast<uint8_t*>(buffer);
+    }
+
+    void frame_buffer_pool::deallocate(uint8_t* buffer)
+    {
+#if defined(_WIN32)
+        _aligned_free(buffer);
+#else
+        free(buffer);
+#endif
+    }
+
+    frame_buffer_pool::free_list* frame_buffer_pool::find_free_list(size_t sizeClass)
+    {
+        for (auto& freeList : freeLists_)
+        {
+            if (freeList.sizeClass == sizeClass)
+            {
+                return &freeList;
+            }
+        }
+
+        return nullptr;
+    }
+
+    frame_buffer_pool::buffer_ptr frame_buffer_pool::acquire(size_t byteSize)
+    {
+        const size_t sizeClass = size_class_of(byteSize);
+        uint8_t* buffer = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            free_list* freeList = find_free_list(sizeClass);
+            if (freeList != nullptr && !freeList->buffers.empty())
+            {
+                buffer = freeList->buffers.back();
+                freeList->buffers.pop_back();
+                cachedBytes_ -= sizeClass;
+            }
+        }
+
+        if (buffer == nullptr)
+        {
+            buffer = allocate(sizeClass);
+        }
+
+        //the deleter keeps the pool alive until every buffer is back
+        std::shared_ptr<frame_buffer_pool> self = shared_from_this();
+        return buffer_ptr(buffer, [self, sizeClass] (uint8_t* released) { self->release(released, sizeClass); });
+    }
+
+    void frame_buffer_pool::release(uint8_t* buffer, size_t sizeClass)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            if (cachedBytes_ + sizeClass <= maxCachedBytes_)
+            {
+                free_list* freeList = find_free_list(sizeClass);
+                if (freeList == nullptr)
+                {
+                    freeLists_.push_back(free_list{ sizeClass, {} });
+                    freeList = &freeLists_.back();
+                }
+
+                freeList->buffers.push_back(buffer);
+                cachedBytes_ += sizeClass;
+                return;
+            }
+        }
+
+        deallocate(buffer);
+    }
+
+    size_t frame_buffer_pool::cached_bytes()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return cachedBytes_;
+    }
+
+    void frame_buffer_pool::trim()
+    {
+        std::vector<free_list> freeLists;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            freeLists.swap(freeLists_);
+            cachedBytes_ = 0;
+        }
+
+        for (auto& freeList : freeLists)
+        {
+            for (uint8_t* buffer : freeList.buffers)
+            {
+                deallocate(buffer);
+            }
+        }
+    }
+}
@@ -0,0 +1,95 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#ifndef ASTRA_FRAME_BUFFER_POOL_H
+#define ASTRA_FRAME_BUFFER_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace astra {
+
+    // Frame data buffers for every stream_bin in the process, cached by
+    // size class. A buffer goes back to the pool when its last owner lets
+    // go of it, which may be after its bin is gone, so a bin recreated for
+    // a mode change or a reconnect finds the buffers of the old one.
+    //
+    // Buffers are aligned to ALIGNMENT for vectorized consumers and are not
+    // cleared, recycled ones keep the last frame written to them. Buffers
+    // of HUGE_PAGE_MIN_BUFFER_SIZE or more are rounded to whole huge pages
+    // and backed by them where available; smaller ones would waste too
+    // much of their last page.
+    class frame_buffer_pool : public std::enable_shared_from_this<frame_buffer_pool>
+    {
+    public:
+        using buffer_ptr = std::shared_ptr<uint8_t>;
+
+        const static size_t ALIGNMENT = 64;
+        const static size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+        const static size_t HUGE_PAGE_MIN_BUFFER_SIZE = 4 * HUGE_PAGE_SIZE;
+        const static size_t DEFAULT_MAX_CACHED_BYTES = 256 * 1024 * 1024;
+
+        //the pool shared by all bins. never destroyed, buffers may be
+        //released during static destruction
+        static frame_buffer_pool& shared();
+
+        static std::shared_ptr<frame_buffer_pool> create(size_t maxCachedBytes);
+        ~frame_buffer_pool();
+
+        frame_buffer_pool(const frame_buffer_pool&) = delete;
+        frame_buffer_pool& operator=(const frame_buffer_pool&) = delete;
+
+        buffer_ptr acquire(size_t byteSize);
+
+        //bytes held in free buffers
+        size_t cached_bytes();
+
+        //frees every cached buffer
+        void trim();
+
+        //sizes are rounded up to a size class, so buffers of nearly equal
+        //sizes are interchangeable
+        static size_t size_class_of(size_t byteSize);
+
+    private:
+        frame_buffer_pool(size_t maxCachedBytes);
+
+        void release(uint8_t* buffer, size_t sizeClass);
+
+        static uint8_t* allocate(size_t sizeClass);
+        static void deallocate(uint8_t* buffer);
+
+        struct free_list
+        {
+            size_t sizeClass;
+            std::vector<uint8_t*> buffers;
+        };
+
+        free_list* find_free_list(size_t sizeClass);
+
+        const size_t maxCachedBytes_;
+
+        std::mutex mutex_;
+        //a bin per stream and mode, so a handful of size classes
+        std::vector<free_list> freeLists_;
+        size_t cachedBytes_{0};
+    };
+}
+
+#endif /* ASTRA_FRAME_BUFFER_POOL_H */
@@ -0,0 +1,101 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#ifndef ASTRA_HISTOGRAM_H
+#define ASTRA_HISTOGRAM_H
+
+#include <astra_core/capi/astra_types.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace astra {
+
+    //steady clock time in microseconds, the unit of every histogram sample
+    inline uint64_t stats_clock_microseconds()
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Fixed-size log2 histogram of microsecond durations. record() is a
+    // handful of relaxed atomic adds, so it can be called from producer and
+    // client threads without a lock. A snapshot taken while samples are
+    // being recorded may be off by the in-flight samples.
+    class histogram
+    {
+    public:
+        const static size_t BUCKET_COUNT = ASTRA_STATS_HISTOGRAM_BUCKETS;
+
+        histogram() { reset(); }
+
+        histogram(const histogram&) = delete;
+        histogram& operator=(const histogram&) = delete;
+
+        void record(uint64_t microseconds)
+        {
+            count_.fetch_add(1, std::memory_order_relaxed);
+            sum_.fetch_add(microseconds, std::memory_order_relaxed);
+            buckets_[bucket_of(microseconds)].fetch_add(1, std::memory_order_relaxed);
+
+            uint64_t currentMax = max_.load(std::memory_order_relaxed);
+            while (microseconds > currentMax &&
+                   !max_.compare_exchange_weak(currentMax, microseconds, std::memory_order_relaxed))
+            { }
+        }
+
+        void snapshot(astra_histogram_t& out) const
+        {
+            out.count = count_.load(std::memory_order_relaxed);
+            out.sumMicroseconds = sum_.load(std::memory_order_relaxed);
+            out.maxMicroseconds = max_.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < BUCKET_COUNT; ++i)
+            {
+                out.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+            }
+        }
+
+        void reset()
+        {
+            count_.store(0, std::memory_order_relaxed);
+            sum_.store(0, std::memory_order_relaxed);
+            max_.store(0, std::memory_order_relaxed);
+            for (auto& bucket : buckets_)
+            {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        static size_t bucket_of(uint64_t microseconds)
+        {
+            size_t bucket = 0;
+            while (microseconds != 0 && bucket < BUCKET_COUNT - 1)
+            {
+                microseconds >>= 1;
+                ++bucket;
+            }
+            return bucket;
+        }
+
+    private:
+        std::atomic<uint64_t> count_;
+        std::atomic<uint64_t> sum_;
+        std::atomic<uint64_t> max_;
+        std::atomic<uint64_t> buckets_[BUCKET_COUNT];
+    };
+}
+
+#endif /* ASTRA_HISTOGRAM_H */
@@ -16,12 +16,138 @@
 // Be excellent to each other.
 #include "astra_logger.hpp"
 #include "astra_logging.hpp"
+#include "astra_async_log_sink.hpp"
+#include <algorithm>
 #include <cstdarg>
+#include <cstring>
 #include <memory>
 #include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
 
 namespace astra {
 
+    std::atomic<int> g_logSeverityCeiling{ASTRA_SEVERITY_TRACE};
+
+    namespace {
+
+        struct channel_severity
+        {
+            std::string channel;
+            astra_log_severity_t severity;
+        };
+
+        using channel_severity_list = std::vector<channel_severity>;
+
+        struct log_filter
+        {
+            std::atomic<int> severity{ASTRA_SEVERITY_TRACE};
+
+            //immutable once published. replaced lists are kept alive rather
+            //than freed because a logging thread may still be reading one;
+            //they only change when logging is configured.
+            std::atomic<const channel_severity_list*> channelSeverities{nullptr};
+            std::vector<std::unique_ptr<channel_severity_list>> retiredLists;
+            std::mutex mutex;
+        };
+
+        log_filter& get_log_filter()
+        {
+            //never destroyed, logging continues during static destruction
+            static log_filter* filter = new log_filter;
+            return *filter;
+        }
+
+        bool channel_matches(const std::string& prefix, const char* channel)
+        {
+            const size_t length = prefix.length();
+            return std::strncmp(prefix.c_str(), channel, length) == 0
+                && (channel[length] == '\0' || channel[length] == '.');
+        }
+
+        bool channel_log_enabled(const char* channel, astra_log_severity_t logLevel)
+        {
+            log_filter& filter = get_log_filter();
+            int severity = filter.severity.load(std::memory_order_relaxed);
+
+            const channel_severity_list* list = filter.channelSeverities.load(std::memory_order_acquire);
+            if (list != nullptr && channel != nullptr)
+            {
+                //longest matching channel prefix wins
+                size_t matchLength = 0;
+                for (const channel_severity& entry : *list)
+                {
+                    if (entry.channel.length() >= matchLength && channel_matches(entry.channel, channel))
+                    {
+                        matchLength = entry.channel.length();
+                        severity = entry.severity;
+                    }
+                }
+            }
+
+            return logLevel <= severity;
+        }
+
+        void update_severity_ceiling(log_filter& filter, const channel_severity_list* list)
+        {
+            int ceiling = filter.severity.load(std::memory_order_relaxed);
+            if (list != nullptr)
+            {
+                for (const channel_severity& entry : *list)
+                {
+                    ceiling = std::max(ceiling, static_cast<int>(entry.severity));
+                }
+            }
+            g_logSeverityCeiling.store(ceiling, std::memory_order_relaxed);
+        }
+    }
+
+    void set_log_severity(astra_log_severity_t severity)
+    {
+        log_filter& filter = get_log_filter();
+        std::lock_guard<std::mutex> lock(filter.mutex);
+
+        filter.severity.store(severity, std::memory_order_relaxed);
+        update_severity_ceiling(filter, filter.channelSeverities.load(std::memory_order_relaxed));
+    }
+
+    void set_log_channel_severity(const char* channel, astra_log_severity_t severity)
+    {
+        log_filter& filter = get_log_filter();
+        std::lock_guard<std::mutex> lock(filter.mutex);
+
+        const channel_severity_list* current = filter.channelSeverities.load(std::memory_order_relaxed);
+        std::unique_ptr<channel_severity_list> list(current != nullptr
+                                                    ? new channel_severity_list(*current)
+                                                    : new channel_severity_list());
+
+        auto it = std::find_if(list->begin(), list->end(),
+                               [channel] (const channel_severity& entry) { return entry.channel == channel; });
+
+        if (it != list->end())
+        {
+            it->severity = severity;
+        }
+        else
+        {
+            list->push_back(channel_severity{ channel, severity });
+        }
+
+        update_severity_ceiling(filter, list.get());
+        filter.channelSeverities.store(list.get(), std::memory_order_release);
+        filter.retiredLists.push_back(std::move(list));
+    }
+
+    void clear_log_channel_severities()
+    {
+        log_filter& filter = get_log_filter();
+        std::lock_guard<std::mutex> lock(filter.mutex);
+
+        filter.channelSeverities.store(nullptr, std::memory_order_release);
+        update_severity_ceiling(filter, nullptr);
+    }
+
     static void dispatch_log(const char* fileName,
                              int lineNo,
                              const char* func,
@@ -97,6 +223,33 @@ namespace astra {
         }
     }
 
+    static void dispatch_record(const log_record& record)
+    {
+        dispatch_log(record.fileName,
+                     record.lineNo,
+                     record.func,
+                     record.channel,
+                     record.logLevel,
+                     record.message);
+    }
+
+    static async_log_sink& get_async_sink()
+    {
+        //never destroyed, see get_log_filter()
+        static async_log_sink* sink = new async_log_sink(&dispatch_record);
+        return *sink;
+    }
+
+    void start_async_logging()
+    {
+        get_async_sink().start();
+    }
+
+    void stop_async_logging()
+    {
+        get_async_sink().stop();
+    }
+
     void log_vargs(const char* channel,
                    astra_log_severity_t logLevel,
                    const char* fileName,
@@ -105,6 +258,26 @@ namespace astra {
                    const char* format,
                    va_list args)
     {
+        //filter before formatting, plugin logging arrives here unfiltered
+        if (!log_level_enabled(logLevel) || !channel_log_enabled(channel, logLevel))
+            return;
+
+        //fatal logs may abort, so they are never deferred
+        if (logLevel != ASTRA_SEVERITY_FATAL)
+        {
+            async_log_sink& sink = get_async_sink();
+            if (sink.is_running())
+            {
+                //a full queue drops the message rather than block the caller.
+                //if the sink stopped meanwhile it is written out below instead
+                if (sink.try_enqueue(channel, logLevel, fileName, lineNo, func, format, args)
+                    || sink.is_running())
+                {
+                    return;
+                }
+            }
+        }
+
 #ifdef _WIN32
         int len = _vscprintf(format, args);
 #else
@@ -19,6 +19,7 @@
 
 #include <astra_core/capi/astra_types.h>
 #include "astra_logging.hpp"
+#include <atomic>
 #include <string>
 
 #if defined(_MSC_VER)  // Visual C++
@@ -37,26 +38,52 @@
 #   endif  // defined(__func__)
 #endif  // defined(_MSC_VER)
 
+#define ASTRA_LOG_AT(channel, logLevel, format, ...) \
+    do { \
+        if (logLevel <= ASTRA_LOG_MAX_SEVERITY && ::astra::log_level_enabled(logLevel)) \
+            ::astra::log(channel, logLevel, __FILE__, __LINE__, LOG_FUNC, format , ##__VA_ARGS__); \
+    } while (0)
+
 #define LOG_TRACE(channel, format, ...) \
-    ::astra::log(channel, ASTRA_SEVERITY_TRACE, __FILE__, __LINE__, LOG_FUNC, format , ##__VA_ARGS__)
+    ASTRA_LOG_AT(channel, ASTRA_SEVERITY_TRACE, format , ##__VA_ARGS__)
 
 #define LOG_INFO(channel, format, ...) \
-    ::astra::log(channel, ASTRA_SEVERITY_INFO, __FILE__, __LINE__, LOG_FUNC, format , ##__VA_ARGS__)
+    ASTRA_LOG_AT(channel, ASTRA_SEVERITY_INFO, format , ##__VA_ARGS__)
 
 #define LOG_DEBUG(channel, format, ...) \
-    ::astra::log(channel, ASTRA_SEVERITY_DEBUG, __FILE__, __LINE__, LOG_FUNC, format , ##__VA_ARGS__)
+    ASTRA_LOG_AT(channel, ASTRA_SEVERITY_DEBUG, format , ##__VA_ARGS__)
 
 #define LOG_ERROR(channel, format, ...) \
-    ::astra::log(channel, ASTRA_SEVERITY_ERROR, __FILE__, __LINE__, LOG_FUNC, format , ##__VA_ARGS__)
+    ASTRA_LOG_AT(channel, ASTRA_SEVERITY_ERROR, format , ##__VA_ARGS__)
 
 #define LOG_FATAL(channel, format, ...) \
-    ::astra::log(channel, ASTRA_SEVERITY_FATAL, __FILE__, __LINE__, LOG_FUNC, format , ##__VA_ARGS__)
+    ASTRA_LOG_AT(channel, ASTRA_SEVERITY_FATAL, format , ##__VA_ARGS__)
 
 #define LOG_WARN(channel, format, ...) \
-    ::astra::log(channel, ASTRA_SEVERITY_WARN, __FILE__, __LINE__, LOG_FUNC, format , ##__VA_ARGS__)
+    ASTRA_LOG_AT(channel, ASTRA_SEVERITY_WARN, format , ##__VA_ARGS__)
 
 namespace astra {
 
+    //most verbose severity any channel currently logs at. checked before
+    //the call so disabled statements cost one relaxed load.
+    extern std::atomic<int> g_logSeverityCeiling;
+
+    inline bool log_level_enabled(astra_log_severity_t logLevel)
+    {
+        return logLevel <= g_logSeverityCeiling.load(std::memory_order_relaxed);
+    }
+
+    //global severity, plus overrides for channels and their sub-channels
+    //(an override for "astra.stream" also covers "astra.stream.reader")
+    void set_log_severity(astra_log_severity_t severity);
+    void set_log_channel_severity(const char* channel, astra_log_severity_t severity);
+    void clear_log_channel_severities();
+
+    //queue log output for a background thread instead of writing it on
+    //the logging thread. stopping writes out everything still queued.
+    void start_async_logging();
+    void stop_async_logging();
+
     void log(const char* channel,
              astra_log_severity_t logLevel,
              const char* fileName,
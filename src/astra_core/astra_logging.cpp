@@ -15,6 +15,7 @@
 //
 // Be excellent to each other.
 #include "astra_logging.hpp"
+#include "astra_logger.hpp"
 
 #include <astra_core/capi/astra_types.h>
 
@@ -61,7 +62,12 @@ namespace astra {
         defaultConf.setGlobally(el::ConfigurationType::Filename, logFilePath);
 
         el::Loggers::setDefaultConfigurations(defaultConf, true);
-        el::Loggers::setLoggingLevel(convert_sk_to_elpp_level(severity));
+
+        //severity is filtered by set_log_severity before messages are
+        //formatted, easylogging++ passes through whatever reaches it
+        el::Loggers::setLoggingLevel(el::Level::Trace);
+        clear_log_channel_severities();
+        set_log_severity(severity);
 
         defaultConf.clear();
     }
@@ -19,23 +19,27 @@
 
 #include <memory>
 #include <astra_core/capi/astra_types.h>
+#include <cstddef>
+#include <cstdint>
 #include <cstring>
+#include <mutex>
 
 namespace astra {
 
+    // Result storage handed to plugins by get_parameter_bin. Bins come from
+    // a size-classed pool and go back to it when the client reads the
+    // result. Results of INLINE_SIZE bytes or less are stored in the bin
+    // itself, so the common case never touches the heap.
     class parameter_bin
     {
     public:
-        parameter_bin(size_t byteSize)
-            : byteLength_(byteSize)
-        {
-            //TODO pooling
-            data_ = DataPtr(new uint8_t[byteSize]);
-	    std::memset(data_.get(), 0, byteSize);
-        }
+        const static size_t INLINE_SIZE = 64;
+
+        static parameter_bin* acquire(size_t byteSize);
+        static void release(parameter_bin* bin);
 
         size_t byteLength() { return byteLength_; }
-        void* data() { return data_.get(); }
+        void* data() { return data_; }
 
         astra_parameter_bin_t get_handle() { return reinterpret_cast<astra_parameter_bin_t>(this); }
         static parameter_bin* get_ptr(astra_parameter_bin_t bin)
@@ -43,12 +47,194 @@ namespace astra {
             return reinterpret_cast<parameter_bin*>(bin);
         }
 
+        parameter_bin(const parameter_bin&) = delete;
+        parameter_bin& operator=(const parameter_bin&) = delete;
+
     private:
         using DataPtr = std::unique_ptr<uint8_t[]>;
 
-        DataPtr data_;
-        size_t byteLength_;
+        const static size_t SIZE_CLASS_COUNT = 6;
+        const static size_t MAX_CACHED_PER_CLASS = 4;
+        const static size_t MAX_SHARED_PER_CLASS = 16;
+        const static size_t UNPOOLED = SIZE_CLASS_COUNT;
+
+        static size_t class_capacity(size_t sizeClass)
+        {
+            //64, 256, 1K, 4K, 16K, 64K
+            return INLINE_SIZE << (2 * sizeClass);
+        }
+
+        static size_t size_class_of(size_t byteSize)
+        {
+            for (size_t sizeClass = 0; sizeClass < SIZE_CLASS_COUNT; ++sizeClass)
+            {
+                if (byteSize <= class_capacity(sizeClass))
+                    return sizeClass;
+            }
+            return UNPOOLED;
+        }
+
+        parameter_bin(size_t sizeClass, size_t capacity)
+            : sizeClass_(sizeClass)
+        {
+            if (capacity <= INLINE_SIZE)
+            {
+                data_ = inlineData_;
+            }
+            else
+            {
+                heapData_ = DataPtr(new uint8_t[capacity]);
+                data_ = heapData_.get();
+            }
+        }
+
+        struct free_list
+        {
+            parameter_bin* head{nullptr};
+            size_t count{0};
+
+            parameter_bin* pop()
+            {
+                parameter_bin* bin = head;
+                if (bin != nullptr)
+                {
+                    head = bin->next_;
+                    bin->next_ = nullptr;
+                    --count;
+                }
+                return bin;
+            }
+
+            void push(parameter_bin* bin)
+            {
+                bin->next_ = head;
+                head = bin;
+                ++count;
+            }
+        };
+
+        //shared by all threads; never destroyed because connections may
+        //release pending results during static destruction
+        struct shared_pool
+        {
+            std::mutex mutex;
+            free_list lists[SIZE_CLASS_COUNT];
+        };
+
+        static shared_pool& get_shared_pool()
+        {
+            static shared_pool* instance = new shared_pool;
+            return *instance;
+        }
+
+        //per-thread front of the shared pool, so a get_parameter/get_result
+        //round trip on one thread takes no lock
+        struct thread_cache
+        {
+            free_list lists[SIZE_CLASS_COUNT];
+
+            ~thread_cache()
+            {
+                is_destroyed() = true;
+
+                shared_pool& pool = get_shared_pool();
+                std::lock_guard<std::mutex> lock(pool.mutex);
+
+                for (size_t sizeClass = 0; sizeClass < SIZE_CLASS_COUNT; ++sizeClass)
+                {
+                    while (parameter_bin* bin = lists[sizeClass].pop())
+                    {
+                        if (pool.lists[sizeClass].count < MAX_SHARED_PER_CLASS)
+                            pool.lists[sizeClass].push(bin);
+                        else
+                            delete bin;
+                    }
+                }
+            }
+
+            static bool& is_destroyed()
+            {
+                static thread_local bool destroyed = false;
+                return destroyed;
+            }
+        };
+
+        static thread_cache* get_thread_cache()
+        {
+            if (thread_cache::is_destroyed())
+                return nullptr;
+
+            static thread_local thread_cache cache;
+            return &cache;
+        }
+
+        alignas(std::max_align_t) uint8_t inlineData_[INLINE_SIZE];
+        DataPtr heapData_;
+        uint8_t* data_{nullptr};
+        size_t byteLength_{0};
+        size_t sizeClass_;
+        parameter_bin* next_{nullptr};
     };
+
+    inline parameter_bin* parameter_bin::acquire(size_t byteSize)
+    {
+        const size_t sizeClass = size_class_of(byteSize);
+        parameter_bin* bin = nullptr;
+
+        if (sizeClass != UNPOOLED)
+        {
+            thread_cache* cache = get_thread_cache();
+            if (cache != nullptr)
+            {
+                bin = cache->lists[sizeClass].pop();
+            }
+
+            if (bin == nullptr)
+            {
+                shared_pool& pool = get_shared_pool();
+                std::lock_guard<std::mutex> lock(pool.mutex);
+                bin = pool.lists[sizeClass].pop();
+            }
+        }
+
+        if (bin == nullptr)
+        {
+            const size_t capacity = sizeClass != UNPOOLED ? class_capacity(sizeClass) : byteSize;
+            bin = new parameter_bin(sizeClass, capacity);
+        }
+
+        bin->byteLength_ = byteSize;
+        std::memset(bin->data_, 0, byteSize);
+
+        return bin;
+    }
+
+    inline void parameter_bin::release(parameter_bin* bin)
+    {
+        if (bin == nullptr)
+            return;
+
+        const size_t sizeClass = bin->sizeClass_;
+        if (sizeClass != UNPOOLED)
+        {
+            thread_cache* cache = get_thread_cache();
+            if (cache != nullptr && cache->lists[sizeClass].count < MAX_CACHED_PER_CLASS)
+            {
+                cache->lists[sizeClass].push(bin);
+                return;
+            }
+
+            shared_pool& pool = get_shared_pool();
+            std::lock_guard<std::mutex> lock(pool.mutex);
+            if (pool.lists[sizeClass].count < MAX_SHARED_PER_CLASS)
+            {
+                pool.lists[sizeClass].push(bin);
+                return;
+            }
+        }
+
+        delete bin;
+    }
 }
 
 #endif /* ASTRA_PARAMETER_BIN_H */
@@ -0,0 +1,172 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#ifndef ASTRA_PARAMETER_CACHE_H
+#define ASTRA_PARAMETER_CACHE_H
+
+#include <astra_core/capi/astra_types.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace astra {
+
+    // A connection's copies of the parameter results its stream marked
+    // cacheable. Values are stored and invalidated under the core mutex and
+    // read without it. Each entry is guarded by a sequence number that is odd
+    // while the entry is written; a reader that sees it odd or changed
+    // treats the read as a miss and asks the plugin instead.
+    class parameter_cache
+    {
+    public:
+        const static size_t MAX_PARAMETERS = 8;
+        const static size_t MAX_PARAMETER_SIZE = 64;
+
+        parameter_cache() = default;
+
+        parameter_cache(const parameter_cache&) = delete;
+        parameter_cache& operator=(const parameter_cache&) = delete;
+
+        //false when the value isn't cached or was being replaced
+        bool try_get(astra_parameter_id id, size_t byteLength, void* data) const
+        {
+            if (byteLength > MAX_PARAMETER_SIZE)
+                return false;
+
+            const size_t count = count_.load(std::memory_order_acquire);
+            for (size_t i = 0; i < count; ++i)
+            {
+                const entry& e = entries_[i];
+                if (e.id.load(std::memory_order_relaxed) != id)
+                    continue;
+
+                const uint32_t sequence = e.sequence.load(std::memory_order_acquire);
+                if ((sequence & 1) != 0 || e.byteLength.load(std::memory_order_relaxed) != byteLength)
+                    return false;
+
+                uint64_t words[WORD_COUNT];
+                const size_t wordCount = words_for(byteLength);
+                for (size_t w = 0; w < wordCount; ++w)
+                {
+                    words[w] = e.words[w].load(std::memory_order_relaxed);
+                }
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (e.sequence.load(std::memory_order_relaxed) != sequence)
+                    return false;
+
+                std::memcpy(data, words, byteLength);
+                return true;
+            }
+
+            return false;
+        }
+
+        //core mutex held. values that don't fit or don't have a free entry
+        //are left uncached
+        void store(astra_parameter_id id, size_t byteLength, const void* data)
+        {
+            if (byteLength == 0 || byteLength > MAX_PARAMETER_SIZE)
+                return;
+
+            entry* e = find_or_add(id);
+            if (e == nullptr)
+                return;
+
+            uint64_t words[WORD_COUNT] = {};
+            std::memcpy(words, data, byteLength);
+
+            begin_write(*e);
+            e->byteLength.store(byteLength, std::memory_order_relaxed);
+            for (size_t w = 0; w < words_for(byteLength); ++w)
+            {
+                e->words[w].store(words[w], std::memory_order_relaxed);
+            }
+            end_write(*e);
+        }
+
+        //core mutex held
+        void invalidate()
+        {
+            const size_t count = count_.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < count; ++i)
+            {
+                entry& e = entries_[i];
+                begin_write(e);
+                e.byteLength.store(0, std::memory_order_relaxed);
+                end_write(e);
+            }
+            ++invalidations_;
+        }
+
+        //core mutex held. a value fetched across an invalidation must not be stored
+        uint64_t invalidations() const { return invalidations_; }
+
+    private:
+        const static size_t WORD_COUNT = MAX_PARAMETER_SIZE / sizeof(uint64_t);
+
+        static size_t words_for(size_t byteLength)
+        {
+            return (byteLength + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+        }
+
+        //entries are claimed for an id once and keep it
+        struct entry
+        {
+            std::atomic<uint32_t> sequence{0};
+            std::atomic<astra_parameter_id> id{0};
+            //0 when empty or invalidated
+            std::atomic<size_t> byteLength{0};
+            std::atomic<uint64_t> words[WORD_COUNT];
+        };
+
+        entry* find_or_add(astra_parameter_id id)
+        {
+            const size_t count = count_.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (entries_[i].id.load(std::memory_order_relaxed) == id)
+                    return &entries_[i];
+            }
+
+            if (count == MAX_PARAMETERS)
+                return nullptr;
+
+            entry& e = entries_[count];
+            e.id.store(id, std::memory_order_relaxed);
+            count_.store(count + 1, std::memory_order_release);
+            return &e;
+        }
+
+        static void begin_write(entry& e)
+        {
+            e.sequence.store(e.sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+
+        static void end_write(entry& e)
+        {
+            e.sequence.store(e.sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        entry entries_[MAX_PARAMETERS];
+        std::atomic<size_t> count_{0};
+        uint64_t invalidations_{0};
+    };
+}
+
+#endif /* ASTRA_PARAMETER_CACHE_H */
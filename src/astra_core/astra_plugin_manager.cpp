@@ -17,12 +17,18 @@
 #include "astra_plugin_manager.hpp"
 #include "tinydir.h"
 #include "astra_cxx_compatibility.hpp"
+#include <cassert>
+#include <cstring>
 
 namespace astra {
 
-    plugin_manager::plugin_manager(streamset_catalog& catalog)
-        : pluginService_(astra::make_unique<plugin_service>(catalog)),
-          pluginServiceProxy_(pluginService_->proxy())
+    plugin_manager::plugin_manager(streamset_catalog& catalog,
+                                   core_mutex& coreMutex,
+                                   update_signal& updateSignal,
+                                   size_t dataflowThreads)
+        : coreMutex_(coreMutex),
+          scheduler_(coreMutex, dataflowThreads),
+          pluginService_(astra::make_unique<plugin_service_impl>(catalog, coreMutex, updateSignal, scheduler_))
     {}
 
     plugin_manager::~plugin_manager()
@@ -105,11 +111,15 @@ namespace astra {
         process::get_proc_address(libHandle, ASTRA_STRINGIFY(astra_plugin_terminate), (process::far_proc&)pluginFuncs.terminate);
         process::get_proc_address(libHandle, ASTRA_STRINGIFY(astra_plugin_update), (process::far_proc&)pluginFuncs.update);
         pluginFuncs.libHandle = libHandle;
+        pluginFuncs.name = path.substr(path.find_last_of("/\\") + 1);
+        pluginFuncs.updateDuration = std::make_shared<histogram>();
 
         if (pluginFuncs.is_valid())
         {
             LOG_TRACE("plugin_manager", "try_load_plugin valid plugin");
-            pluginFuncs.initialize(pluginServiceProxy_);
+            pluginFuncs.state = std::make_shared<plugin_state>(coreMutex_);
+            pluginFuncs.service = std::make_shared<plugin_service>(*pluginService_, pluginFuncs.state);
+            pluginFuncs.initialize(pluginFuncs.service->proxy());
             LOG_TRACE("plugin_manager", "try_load_plugin initialized plugin");
             pluginList_.push_back(pluginFuncs);
         }
@@ -126,12 +136,54 @@ namespace astra {
 
     void plugin_manager::update()
     {
-        for(auto plinfo : pluginList_)
+        for(auto& plinfo : pluginList_)
         {
-            if (plinfo.update)
-            {
-                plinfo.update();
-            }
+            update_plugin(plinfo);
+        }
+    }
+
+    void plugin_manager::update_plugin(size_t index)
+    {
+        assert(index < pluginList_.size());
+
+        update_plugin(pluginList_[index]);
+    }
+
+    update_signal& plugin_manager::plugin_update_signal(size_t index)
+    {
+        assert(index < pluginList_.size());
+
+        return pluginList_[index].state->updateSignal;
+    }
+
+    void plugin_manager::update_plugin(PluginFuncs& plinfo)
+    {
+        if (plinfo.update)
+        {
+            plugin_call_guard guard(plinfo.state->updateLock);
+
+            const uint64_t start = stats_clock_microseconds();
+            plinfo.update();
+            plinfo.updateDuration->record(stats_clock_microseconds() - start);
+        }
+    }
+
+    void plugin_manager::get_stats(astra_context_stats_t& stats) const
+    {
+        stats.pluginCount = 0;
+
+        for (auto& plinfo : pluginList_)
+        {
+            if (stats.pluginCount == ASTRA_STATS_MAX_PLUGINS)
+                break;
+
+            astra_plugin_stats_t& pluginStats = stats.plugins[stats.pluginCount];
+
+            std::strncpy(pluginStats.name, plinfo.name.c_str(), ASTRA_STATS_PLUGIN_NAME_LENGTH - 1);
+            pluginStats.name[ASTRA_STATS_PLUGIN_NAME_LENGTH - 1] = '\0';
+            plinfo.updateDuration->snapshot(pluginStats.updateDuration);
+
+            ++stats.pluginCount;
         }
     }
 
@@ -21,9 +21,13 @@
 #include <vector>
 #include <memory>
 #include "astra_plugin_service.hpp"
+#include "astra_plugin_service_impl.hpp"
+#include "astra_dataflow_scheduler.hpp"
+#include "astra_update_signal.hpp"
 #include "astra_shared_library.hpp"
 #include <astra_core/capi/plugins/astra_pluginservice_proxy.h>
 #include "astra_logger.hpp"
+#include "astra_histogram.hpp"
 
 namespace astra {
 
@@ -37,6 +41,11 @@ namespace astra {
         terminate_fn terminate{nullptr};
         update_fn update{nullptr};
         process::lib_handle libHandle{nullptr};
+        std::string name;
+        std::shared_ptr<histogram> updateDuration;
+        std::shared_ptr<plugin_state> state;
+        //the plugin's own view of the plugin service, see plugin_service
+        std::shared_ptr<plugin_service> service;
 
         bool is_valid()
         {
@@ -50,28 +59,47 @@ namespace astra {
     class plugin_manager
     {
     public:
-        plugin_manager(streamset_catalog& setCatalog);
+        plugin_manager(streamset_catalog& setCatalog,
+                       core_mutex& coreMutex,
+                       update_signal& updateSignal,
+                       size_t dataflowThreads);
         ~plugin_manager();
 
         void load_plugins(std::string searchPath);
         void load_plugin(std::string pluginPath);
 
+        //call holding the core mutex
         void update();
+        //call without it. holds the plugin's update lock instead, the plugin
+        //takes the core mutex for each call it makes
+        void update_plugin(size_t index);
+        //raised when the plugin cycles a bin or asks for an update
+        update_signal& plugin_update_signal(size_t index);
         void unload_all_plugins();
         size_t plugin_count() const { return pluginList_.size(); }
 
+        //called without the core mutex, before the plugins are unloaded
+        void stop_dataflow() { scheduler_.stop(); }
+
         void notify_host_event(astra_event_id id, const void* data, size_t dataSize);
+
+        void get_stats(astra_context_stats_t& stats) const;
     private:
+        void update_plugin(PluginFuncs& plinfo);
+
         std::vector<std::string> find_libraries(const std::string& pluginsPath);
         void try_load_plugin(const std::string& path);
 
         using PluginList = std::vector<PluginFuncs>;
         PluginList pluginList_;
 
-        using plugin_service_ptr = std::unique_ptr<plugin_service>;
-        plugin_service_ptr pluginService_;
+        core_mutex& coreMutex_;
+
+        //declared before the service, which refers to it
+        dataflow_scheduler scheduler_;
 
-        astra_pluginservice_proxy_t* pluginServiceProxy_{nullptr};
+        using plugin_service_impl_ptr = std::unique_ptr<plugin_service_impl>;
+        plugin_service_impl_ptr pluginService_;
     };
 }
 
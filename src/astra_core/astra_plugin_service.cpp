@@ -21,19 +21,15 @@
 
 namespace astra
 {
-    plugin_service::plugin_service(streamset_catalog& catalog)
-        : impl_(astra::make_unique<plugin_service_impl>(catalog)),
+    plugin_service::plugin_service(plugin_service_impl& impl, std::shared_ptr<plugin_state> caller)
+        : impl_(impl),
+          caller_(std::move(caller)),
           proxy_(create_plugin_proxy(this))
     {}
 
     plugin_service::~plugin_service()
     {}
 
-    void plugin_service::notify_host_event(astra_event_id id, const void* data, size_t dataSize)
-    {
-        impl_->notify_host_event(id, data, dataSize);
-    }
-
     astra_pluginservice_proxy_t* plugin_service::proxy()
     {
         return proxy_.get();
@@ -43,76 +39,89 @@ namespace astra
                                                                       void* clientTag,
                                                                       astra_callback_id_t& callbackId)
    {
-       return impl_->register_stream_registered_callback(callback, clientTag, callbackId);
+       plugin_service_impl::caller_scope scope(caller_);
+       return impl_.register_stream_registered_callback(callback, clientTag, callbackId);
    }
 
    astra_status_t plugin_service::register_stream_unregistering_callback(stream_unregistering_callback_t callback,
                                                                          void* clientTag,
                                                                          astra_callback_id_t& callbackId)
    {
-       return impl_->register_stream_unregistering_callback(callback, clientTag, callbackId);
+       plugin_service_impl::caller_scope scope(caller_);
+       return impl_.register_stream_unregistering_callback(callback, clientTag, callbackId);
    }
 
    astra_status_t plugin_service::register_host_event_callback(host_event_callback_t callback,
                                                                void* clientTag,
                                                                astra_callback_id_t& callbackId)
    {
-       return impl_->register_host_event_callback(callback, clientTag, callbackId);
+       plugin_service_impl::caller_scope scope(caller_);
+       return impl_.register_host_event_callback(callback, clientTag, callbackId);
    }
 
    astra_status_t plugin_service::unregister_host_event_callback(astra_callback_id_t callback)
    {
-       return impl_->unregister_host_event_callback(callback);
+       plugin_service_impl::caller_scope scope(caller_);
+       return impl_.unregister_host_event_callback(callback);
    }
 
    astra_status_t plugin_service::unregister_stream_registered_callback(astra_callback_id_t callback)
    {
-       return impl_->unregister_stream_registered_callback(callback);
+       plugin_service_impl::caller_scope scope(caller_);
+       return impl_.unregister_stream_registered_callback(callback);
    }
 
    astra_status_t plugin_service::unregister_stream_unregistering_callback(astra_callback_id_t callback)
    {
-       return impl_->unregister_stream_unregistering_callback(callback);
+       plugin_service_impl::caller_scope scope(caller_);
+       return impl_.unregister_stream_unregistering_callback(callback);
    }
 
    astra_status_t plugin_service::create_stream_set(const char* setUri,
                                                     astra_streamset_t& setHandle)
    {
-       return impl_->create_stream_set(setUri, setHandle);
+       plugin_service_impl::caller_scope scope(caller_);
+       return impl_.create_stream_set(setUri, setHandle);
    }
 
    astra_status_t plugin_service::destroy_stream_set(astra_streamset_t& setHandle)
    {
-       return impl_->destroy_stream_set(setHandle);
+       plugin_service_impl::caller_scope scope(caller_);
+       return impl_.destroy_stream_set(setHandle);
    }
 
    astra_status_t plugin_service::get_streamset_uri(astra_streamset_t setHandle,
                                                     const char*& uri)
    {
-       return impl_->get_streamset_uri(setHandle, uri);
+       plugin_service_impl::caller_scope scope(caller_);
+       return impl_.get_streamset_uri(setHandle, uri);
    }
 
    astra_status_t plugin_service::create_stream(astra_streamset_t setHandle,
                                                 astra_stream_desc_t desc,
                                                 astra_stream_t& handle)
    {
-       return impl_->create_stream(setHandle, desc, handle);
+       plugin_service_impl::caller_scope scope(caller_);
+       return impl_.create_stream(setHandle, desc, handle);
    }
 
    astra_status_t plugin_service::register_stream(astra_stream_t handle,
                                                   stream_callbacks_t pluginCallbacks)
    {
-       return impl_->register_stream(handle, pluginCallbacks);
+       plugin_service_impl::caller_scope scope(caller_);
+       return impl_.register_stream(handle, pluginCallbacks);
    }
 
    astra_status_t plugin_service::unregister_stream(astra_stream_t handle)
    {
-       return impl_->unregister_stream(handle);
+       plugin_service_impl::caller_scope scope(caller_);
+       return impl_.unregister_stream(handle);
    }
 
    astra_status_t plugin_service::destroy_stream(astra_stream_t& handle)
    {
-       return impl_->destroy_stream(handle);
+       plugin_service_impl::caller_scope scope(caller_);
+       return impl_.destroy_stream(handle);
    }
 
    astra_status_t plugin_service::create_stream_bin(astra_stream_t streamHandle,
@@ -120,39 +129,45 @@ namespace astra
                                                     astra_bin_t& binHandle,
                                                     astra_frame_t*& binBuffer)
    {
-       return impl_->create_stream_bin(streamHandle, lengthInBytes, binHandle, binBuffer);
+       plugin_service_impl::caller_scope scope(caller_);
+       return impl_.create_stream_bin(streamHandle, lengthInBytes, binHandle, binBuffer);
    }
 
    astra_status_t plugin_service::destroy_stream_bin(astra_stream_t streamHandle,
                                                      astra_bin_t& binHandle,
                                                      astra_frame_t*& binBuffer)
    {
-       return impl_->destroy_stream_bin(streamHandle, binHandle, binBuffer);
+       plugin_service_impl::caller_scope scope(caller_);
+       return impl_.destroy_stream_bin(streamHandle, binHandle, binBuffer);
    }
 
    astra_status_t plugin_service::bin_has_connections(astra_bin_t binHandle,
                                                       bool& hasConnections)
    {
-       return impl_->bin_has_connections(binHandle, hasConnections);
+       plugin_service_impl::caller_scope scope(caller_);
+       return impl_.bin_has_connections(binHandle, hasConnections);
    }
 
    astra_status_t plugin_service::cycle_bin_buffers(astra_bin_t binHandle,
                                                     astra_frame_t*& binBuffer)
    {
-       return impl_->cycle_bin_buffers(binHandle, binBuffer);
+       plugin_service_impl::caller_scope scope(caller_);
+       return impl_.cycle_bin_buffers(binHandle, binBuffer);
    }
 
    astra_status_t plugin_service::link_connection_to_bin(astra_streamconnection_t connection,
                                                          astra_bin_t binHandle)
    {
-       return impl_->link_connection_to_bin(connection, binHandle);
+       plugin_service_impl::caller_scope scope(caller_);
+       return impl_.link_connection_to_bin(connection, binHandle);
    }
 
    astra_status_t plugin_service::get_parameter_bin(size_t byteSize,
                                                     astra_parameter_bin_t& binHandle,
                                                     astra_parameter_data_t& parameterData)
    {
-       return impl_->get_parameter_bin(byteSize, binHandle, parameterData);
+       plugin_service_impl::caller_scope scope(caller_);
+       return impl_.get_parameter_bin(byteSize, binHandle, parameterData);
    }
 
    astra_status_t plugin_service::log(const char* channel,
@@ -163,7 +178,72 @@ namespace astra
                                       const char* format,
                                       va_list args)
    {
-       return impl_->log(channel, logLevel, fileName, lineNo, func, format, args);
+       plugin_service_impl::caller_scope scope(caller_);
+       return impl_.log(channel, logLevel, fileName, lineNo, func, format, args);
+   }
+
+   astra_status_t plugin_service::create_stream_bin_with_depth(astra_stream_t streamHandle,
+                                                               size_t lengthInBytes,
+                                                               size_t bufferCount,
+                                                               astra_bin_t& binHandle,
+                                                               astra_frame_t*& binBuffer)
+   {
+       plugin_service_impl::caller_scope scope(caller_);
+       return impl_.create_stream_bin_with_depth(streamHandle, lengthInBytes, bufferCount, binHandle, binBuffer);
+   }
+
+   astra_status_t plugin_service::register_dataflow_node(astra_reader_t reader,
+                                                         const astra_stream_desc_t* inputs,
+                                                         size_t inputCount,
+                                                         const astra_stream_desc_t* outputs,
+                                                         size_t outputCount,
+                                                         astra_frame_ready_callback_t callback,
+                                                         void* clientTag,
+                                                         astra_callback_id_t& nodeId)
+   {
+       plugin_service_impl::caller_scope scope(caller_);
+       return impl_.register_dataflow_node(reader, inputs, inputCount, outputs, outputCount, callback, clientTag, nodeId);
+   }
+
+   astra_status_t plugin_service::unregister_dataflow_node(astra_callback_id_t nodeId)
+   {
+       plugin_service_impl::caller_scope scope(caller_);
+       return impl_.unregister_dataflow_node(nodeId);
+   }
+
+   astra_status_t plugin_service::set_stream_compute_callback(astra_stream_t stream,
+                                                              stream_compute_callback_t callback,
+                                                              void* clientTag)
+   {
+       plugin_service_impl::caller_scope scope(caller_);
+       return impl_.set_stream_compute_callback(stream, callback, clientTag);
+   }
+
+   astra_status_t plugin_service::set_parameter_cacheable(astra_stream_t stream,
+                                                          astra_parameter_id parameterId,
+                                                          bool cacheable)
+   {
+       plugin_service_impl::caller_scope scope(caller_);
+       return impl_.set_parameter_cacheable(stream, parameterId, cacheable);
+   }
+
+   astra_status_t plugin_service::invalidate_parameters(astra_stream_t stream)
+   {
+       plugin_service_impl::caller_scope scope(caller_);
+       return impl_.invalidate_parameters(stream);
+   }
+
+   astra_status_t plugin_service::set_bin_capture_timestamp(astra_bin_t bin,
+                                                            uint64_t captureTimestamp)
+   {
+       plugin_service_impl::caller_scope scope(caller_);
+       return impl_.set_bin_capture_timestamp(bin, captureTimestamp);
+   }
+
+   astra_status_t plugin_service::request_update()
+   {
+       plugin_service_impl::caller_scope scope(caller_);
+       return impl_.request_update();
    }
 
 
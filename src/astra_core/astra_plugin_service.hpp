@@ -28,21 +28,21 @@ struct astra_pluginservice_proxy_t;
 
 namespace astra
 {
-    class streamset;
-    class streamset_catalog;
     class plugin_service_impl;
+    struct plugin_state;
 
+    // One plugin's view of the shared plugin service. Each plugin gets its own,
+    // so the core knows which plugin makes a call whatever thread it comes from.
     class plugin_service
     {
     public:
-        plugin_service(streamset_catalog& catalog);
+        plugin_service(plugin_service_impl& impl, std::shared_ptr<plugin_state> caller);
         ~plugin_service();
 
         plugin_service(const plugin_service& service) = delete;
         plugin_service& operator=(const plugin_service& rhs) = delete;
 
         astra_pluginservice_proxy_t* proxy();
-        void notify_host_event(astra_event_id id, const void* data, size_t dataSize);
 
         astra_status_t register_stream_registered_callback(stream_registered_callback_t callback,
                                                            void* clientTag,
@@ -91,9 +91,34 @@ namespace astra
                            const char* func,
                            const char* format,
                            va_list args);
+        astra_status_t create_stream_bin_with_depth(astra_stream_t streamHandle,
+                                                    size_t lengthInBytes,
+                                                    size_t bufferCount,
+                                                    astra_bin_t& binHandle,
+                                                    astra_frame_t*& binBuffer);
+        astra_status_t register_dataflow_node(astra_reader_t reader,
+                                              const astra_stream_desc_t* inputs,
+                                              size_t inputCount,
+                                              const astra_stream_desc_t* outputs,
+                                              size_t outputCount,
+                                              astra_frame_ready_callback_t callback,
+                                              void* clientTag,
+                                              astra_callback_id_t& nodeId);
+        astra_status_t unregister_dataflow_node(astra_callback_id_t nodeId);
+        astra_status_t set_stream_compute_callback(astra_stream_t stream,
+                                                   stream_compute_callback_t callback,
+                                                   void* clientTag);
+        astra_status_t set_parameter_cacheable(astra_stream_t stream,
+                                               astra_parameter_id parameterId,
+                                               bool cacheable);
+        astra_status_t invalidate_parameters(astra_stream_t stream);
+        astra_status_t set_bin_capture_timestamp(astra_bin_t bin,
+                                                 uint64_t captureTimestamp);
+        astra_status_t request_update();
 
     private:
-        std::unique_ptr<plugin_service_impl> impl_;
+        plugin_service_impl& impl_;
+        std::shared_ptr<plugin_state> caller_;
         std::unique_ptr<astra_pluginservice_proxy_t> proxy_;
     };
 }
@@ -174,6 +174,69 @@ namespace astra {
         {
             return static_cast<plugin_service*>(pluginService)->log(channel, logLevel, fileName, lineNo, func, format, args);
         }
+
+        static astra_status_t create_stream_bin_with_depth(void* pluginService,
+                                                           astra_stream_t streamHandle,
+                                                           size_t lengthInBytes,
+                                                           size_t bufferCount,
+                                                           astra_bin_t* binHandle,
+                                                           astra_frame_t** binBuffer)
+        {
+            return static_cast<plugin_service*>(pluginService)->create_stream_bin_with_depth(streamHandle, lengthInBytes, bufferCount, *binHandle, *binBuffer);
+        }
+
+        static astra_status_t register_dataflow_node(void* pluginService,
+                                                     astra_reader_t reader,
+                                                     const astra_stream_desc_t* inputs,
+                                                     size_t inputCount,
+                                                     const astra_stream_desc_t* outputs,
+                                                     size_t outputCount,
+                                                     astra_frame_ready_callback_t callback,
+                                                     void* clientTag,
+                                                     astra_callback_id_t* nodeId)
+        {
+            return static_cast<plugin_service*>(pluginService)->register_dataflow_node(reader, inputs, inputCount, outputs, outputCount, callback, clientTag, *nodeId);
+        }
+
+        static astra_status_t unregister_dataflow_node(void* pluginService,
+                                                       astra_callback_id_t nodeId)
+        {
+            return static_cast<plugin_service*>(pluginService)->unregister_dataflow_node(nodeId);
+        }
+
+        static astra_status_t set_stream_compute_callback(void* pluginService,
+                                                          astra_stream_t stream,
+                                                          stream_compute_callback_t callback,
+                                                          void* clientTag)
+        {
+            return static_cast<plugin_service*>(pluginService)->set_stream_compute_callback(stream, callback, clientTag);
+        }
+
+        static astra_status_t set_parameter_cacheable(void* pluginService,
+                                                      astra_stream_t stream,
+                                                      astra_parameter_id parameterId,
+                                                      bool cacheable)
+        {
+            return static_cast<plugin_service*>(pluginService)->set_parameter_cacheable(stream, parameterId, cacheable);
+        }
+
+        static astra_status_t invalidate_parameters(void* pluginService,
+                                                    astra_stream_t stream)
+        {
+            return static_cast<plugin_service*>(pluginService)->invalidate_parameters(stream);
+        }
+
+        static astra_status_t set_bin_capture_timestamp(void* pluginService,
+                                                        astra_bin_t bin,
+                                                        uint64_t captureTimestamp)
+        {
+            return static_cast<plugin_service*>(pluginService)->set_bin_capture_timestamp(bin, captureTimestamp);
+        }
+
+        static astra_status_t request_update(void* pluginService)
+        {
+            return static_cast<plugin_service*>(pluginService)->request_update();
+        }
     };
 }
 
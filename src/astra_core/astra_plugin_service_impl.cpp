@@ -21,11 +21,21 @@
 #include "astra_stream_unregistering_event_args.hpp"
 #include "astra_parameter_bin.hpp"
 #include "astra_logging.hpp"
+#include "astra_stream_reader.hpp"
+#include "astra_dataflow_scheduler.hpp"
 #include <cstdio>
 #include <memory>
 
 namespace astra
 {
+    thread_local const plugin_state_ptr* plugin_service_impl::caller_scope::current_ = nullptr;
+
+    plugin_update_lock_ptr plugin_service_impl::caller_update_lock()
+    {
+        plugin_state_ptr caller = caller_scope::current();
+        return caller != nullptr ? caller->updateLock : nullptr;
+    }
+
     void plugin_service_impl::notify_host_event(astra_event_id id, const void* data, size_t dataSize)
     {
         hostEventSignal_.raise(id, data, dataSize);
@@ -33,6 +43,8 @@ namespace astra
 
     astra_status_t plugin_service_impl::create_stream_set(const char* streamUri, astra_streamset_t& streamSet)
     {
+        std::lock_guard<core_mutex> lock(coreMutex_);
+
         streamset& set = setCatalog_.get_or_add(streamUri, true);
         streamSet = set.get_handle();
 
@@ -43,6 +55,8 @@ namespace astra
 
     astra_status_t plugin_service_impl::destroy_stream_set(astra_streamset_t& streamSet)
     {
+        std::lock_guard<core_mutex> lock(coreMutex_);
+
         streamset* actualSet = streamset::get_ptr(streamSet);
 
         LOG_INFO("astra.plugin_service", "destroying streamset: %s %x", actualSet->get_uri().c_str(), streamSet);
@@ -57,8 +71,12 @@ namespace astra
                                                                     void* clientTag,
                                                                     CallbackId& callbackId)
     {
-        auto thunk = [clientTag, callback](stream_registered_event_args args)
+        std::lock_guard<core_mutex> lock(coreMutex_);
+
+        plugin_update_lock_ptr updateLock = caller_update_lock();
+        auto thunk = [clientTag, callback, updateLock](stream_registered_event_args args)
             {
+                plugin_call_guard guard(updateLock);
                 callback(clientTag,
                          args.streamSet->get_handle(),
                          args.stream->get_handle(),
@@ -74,8 +92,12 @@ namespace astra
                                                                        void* clientTag,
                                                                        CallbackId& callbackId)
     {
-        auto thunk = [clientTag, callback](stream_unregistering_event_args args)
+        std::lock_guard<core_mutex> lock(coreMutex_);
+
+        plugin_update_lock_ptr updateLock = caller_update_lock();
+        auto thunk = [clientTag, callback, updateLock](stream_unregistering_event_args args)
             {
+                plugin_call_guard guard(updateLock);
                 callback(clientTag,
                          args.streamSet->get_handle(),
                          args.stream->get_handle(),
@@ -89,6 +111,8 @@ namespace astra
 
     astra_status_t plugin_service_impl::unregister_stream_registered_callback(CallbackId callbackId)
     {
+        std::lock_guard<core_mutex> lock(coreMutex_);
+
         setCatalog_.unregister_for_stream_registered_event(callbackId);
 
         return ASTRA_STATUS_SUCCESS;
@@ -96,6 +120,8 @@ namespace astra
 
     astra_status_t plugin_service_impl::unregister_stream_unregistering_callback(CallbackId callbackId)
     {
+        std::lock_guard<core_mutex> lock(coreMutex_);
+
         setCatalog_.unregister_form_stream_unregistering_event(callbackId);
 
         return ASTRA_STATUS_SUCCESS;
@@ -105,6 +131,8 @@ namespace astra
                                                    astra_stream_desc_t desc,
                                                    astra_stream_t& handle)
     {
+        std::lock_guard<core_mutex> lock(coreMutex_);
+
         streamset* set = streamset::get_ptr(setHandle);
         stream* stream = set->register_stream(desc);
         handle = stream->get_handle();
@@ -116,6 +144,8 @@ namespace astra
 
     astra_status_t plugin_service_impl::destroy_stream(astra_stream_t& streamHandle)
     {
+        std::lock_guard<core_mutex> lock(coreMutex_);
+
         if (streamHandle == nullptr)
             return ASTRA_STATUS_INVALID_PARAMETER;
 
@@ -141,17 +171,21 @@ namespace astra
 
     astra_status_t plugin_service_impl::register_stream(astra_stream_t handle, stream_callbacks_t pluginCallbacks)
     {
+        std::lock_guard<core_mutex> lock(coreMutex_);
+
         if (handle == nullptr)
             return ASTRA_STATUS_INVALID_PARAMETER;
 
         stream* stream = stream::get_ptr(handle);
-        stream->set_callbacks(pluginCallbacks);
+        stream->set_callbacks(pluginCallbacks, caller_update_lock());
 
         return ASTRA_STATUS_SUCCESS;
     }
 
     astra_status_t plugin_service_impl::unregister_stream(astra_stream_t handle)
     {
+        std::lock_guard<core_mutex> lock(coreMutex_);
+
         if (handle == nullptr)
             return ASTRA_STATUS_INVALID_PARAMETER;
 
@@ -165,6 +199,8 @@ namespace astra
     astra_status_t plugin_service_impl::get_streamset_uri(astra_streamset_t setHandle,
                                                        const char*& uri)
     {
+        std::lock_guard<core_mutex> lock(coreMutex_);
+
         assert(setHandle != nullptr);
 
         streamset* actualSet = streamset::get_ptr(setHandle);
@@ -178,17 +214,58 @@ namespace astra
                                                        astra_bin_t& binHandle,
                                                        astra_frame_t*& binBuffer)
     {
+        std::lock_guard<core_mutex> lock(coreMutex_);
+
+        return create_stream_bin_with_depth(streamHandle,
+                                            lengthInBytes,
+                                            stream_bin::DEFAULT_BUFFER_COUNT,
+                                            binHandle,
+                                            binBuffer);
+    }
+
+    astra_status_t plugin_service_impl::create_stream_bin_with_depth(astra_stream_t streamHandle,
+                                                                  size_t lengthInBytes,
+                                                                  size_t bufferCount,
+                                                                  astra_bin_t& binHandle,
+                                                                  astra_frame_t*& binBuffer)
+    {
+        std::lock_guard<core_mutex> lock(coreMutex_);
+
+        if (bufferCount < stream_bin::MIN_BUFFER_COUNT)
+        {
+            LOG_WARN("astra.plugin_service", "bin buffer count %u is below minimum of %u",
+                     bufferCount,
+                     stream_bin::MIN_BUFFER_COUNT);
+            return ASTRA_STATUS_INVALID_PARAMETER;
+        }
+
         stream* actualStream = stream::get_ptr(streamHandle);
-        stream_bin* bin = actualStream->create_bin(lengthInBytes);
+        stream_bin* bin = actualStream->create_bin(lengthInBytes, bufferCount);
+
+        //a client mirrors one bin per stream, later bins stay private
+        if (actualStream->bin_count() == 1 && is_exported(actualStream))
+        {
+            if (actualStream->is_computed_on_demand())
+            {
+                //clients would get frames that were never computed
+                LOG_INFO("astra.plugin_service", "not exporting on-demand stream: %x", streamHandle);
+            }
+            else
+            {
+                streamset* set = setCatalog_.find_streamset_for_stream(actualStream);
+                bin->export_to_shared_memory(set->get_uri(), actualStream->get_description());
+            }
+        }
 
         binHandle = bin->get_handle();
         binBuffer = bin->get_backBuffer();
 
-        LOG_INFO("astra.plugin_service", "creating bin -- handle: %x stream: %x type: %d size: %u",
+        LOG_INFO("astra.plugin_service", "creating bin -- handle: %x stream: %x type: %d size: %u buffers: %u",
                       binHandle,
                       streamHandle,
                       actualStream->get_description().type,
-                      lengthInBytes);
+                      lengthInBytes,
+                      bufferCount);
 
         return ASTRA_STATUS_SUCCESS;
     }
@@ -197,6 +274,8 @@ namespace astra
                                                         astra_bin_t& binHandle,
                                                         astra_frame_t*& binBuffer)
     {
+        std::lock_guard<core_mutex> lock(coreMutex_);
+
         stream* actualStream = stream::get_ptr(streamHandle);
         stream_bin* bin = stream_bin::get_ptr(binHandle);
 
@@ -216,6 +295,8 @@ namespace astra
 
     astra_status_t plugin_service_impl::bin_has_connections(astra_bin_t binHandle, bool& hasConnections)
     {
+        std::lock_guard<core_mutex> lock(coreMutex_);
+
         stream_bin* bin = stream_bin::get_ptr(binHandle);
         hasConnections = bin->has_clients_connected();
 
@@ -225,17 +306,28 @@ namespace astra
     astra_status_t plugin_service_impl::cycle_bin_buffers(astra_bin_t binHandle,
                                                        astra_frame_t*& binBuffer)
     {
+        std::lock_guard<core_mutex> lock(coreMutex_);
+
         assert(binHandle != nullptr);
 
         stream_bin* bin = stream_bin::get_ptr(binHandle);
         binBuffer = bin->cycle_buffers();
 
+        //a plugin that just produced a frame may have more waiting
+        updateSignal_.raise();
+        if (plugin_state_ptr caller = caller_scope::current())
+        {
+            caller->updateSignal.raise();
+        }
+
         return ASTRA_STATUS_SUCCESS;
     }
 
     astra_status_t plugin_service_impl::link_connection_to_bin(astra_streamconnection_t connection,
                                                             astra_bin_t binHandle)
     {
+        std::lock_guard<core_mutex> lock(coreMutex_);
+
         stream_connection* underlyingConnection = stream_connection::get_ptr(connection);
         stream_bin* bin = stream_bin::get_ptr(binHandle);
 
@@ -265,8 +357,9 @@ namespace astra
                                                        astra_parameter_bin_t& binHandle,
                                                        astra_parameter_data_t& parameterData)
     {
-        //TODO pooling
-        parameter_bin* parameterBin = new parameter_bin(byteSize);
+        std::lock_guard<core_mutex> lock(coreMutex_);
+
+        parameter_bin* parameterBin = parameter_bin::acquire(byteSize);
 
         binHandle = parameterBin->get_handle();
         parameterData = parameterBin->data();
@@ -290,8 +383,12 @@ namespace astra
                                                                   void* clientTag,
                                                                   CallbackId& callbackId)
     {
-        auto thunk = [clientTag, callback](astra_event_id id, const void* data, size_t dataSize)
+        std::lock_guard<core_mutex> lock(coreMutex_);
+
+        plugin_update_lock_ptr updateLock = caller_update_lock();
+        auto thunk = [clientTag, callback, updateLock](astra_event_id id, const void* data, size_t dataSize)
             {
+                plugin_call_guard guard(updateLock);
                 callback(clientTag, id, data, dataSize);
             };
 
@@ -304,8 +401,164 @@ namespace astra
 
     astra_status_t plugin_service_impl::unregister_host_event_callback(CallbackId callbackId)
     {
+        std::lock_guard<core_mutex> lock(coreMutex_);
+
         hostEventSignal_ -= callbackId;
 
         return ASTRA_STATUS_SUCCESS;
     }
+
+    astra_status_t plugin_service_impl::register_dataflow_node(astra_reader_t reader,
+                                                               const astra_stream_desc_t* inputs,
+                                                               size_t inputCount,
+                                                               const astra_stream_desc_t* outputs,
+                                                               size_t outputCount,
+                                                               astra_frame_ready_callback_t callback,
+                                                               void* clientTag,
+                                                               astra_callback_id_t& nodeId)
+    {
+        std::lock_guard<core_mutex> lock(coreMutex_);
+
+        nodeId = 0;
+
+        stream_reader* actualReader = stream_reader::get_ptr(reader);
+
+        if (actualReader == nullptr || callback == nullptr ||
+            (inputCount > 0 && inputs == nullptr) ||
+            (outputCount > 0 && outputs == nullptr))
+        {
+            LOG_WARN("astra.plugin_service", "register_dataflow_node called with invalid parameters");
+            return ASTRA_STATUS_INVALID_PARAMETER;
+        }
+
+        //the node starts its inputs, connect them first
+        for (size_t i = 0; i < inputCount; ++i)
+        {
+            astra_stream_desc_t desc = inputs[i];
+            if (!actualReader->get_stream(desc))
+            {
+                LOG_WARN("astra.plugin_service", "register_dataflow_node couldn't connect to its inputs");
+                return ASTRA_STATUS_INTERNAL_ERROR;
+            }
+        }
+
+        nodeId = scheduler_.add_node(*actualReader,
+                                     inputs,
+                                     inputCount,
+                                     outputs,
+                                     outputCount,
+                                     callback,
+                                     clientTag);
+
+        return ASTRA_STATUS_SUCCESS;
+    }
+
+    astra_status_t plugin_service_impl::unregister_dataflow_node(astra_callback_id_t nodeId)
+    {
+        std::lock_guard<core_mutex> lock(coreMutex_);
+
+        if (!scheduler_.remove_node(nodeId))
+        {
+            LOG_WARN("astra.plugin_service", "unregister_dataflow_node called with unknown node %u", nodeId);
+            return ASTRA_STATUS_INVALID_PARAMETER;
+        }
+
+        return ASTRA_STATUS_SUCCESS;
+    }
+
+    astra_status_t plugin_service_impl::set_stream_compute_callback(astra_stream_t streamHandle,
+                                                                    stream_compute_callback_t callback,
+                                                                    void* clientTag)
+    {
+        std::lock_guard<core_mutex> lock(coreMutex_);
+
+        if (streamHandle == nullptr)
+        {
+            LOG_WARN("astra.plugin_service", "set_stream_compute_callback called with null stream");
+            return ASTRA_STATUS_INVALID_PARAMETER;
+        }
+
+        stream* stream = stream::get_ptr(streamHandle);
+
+        if (callback != nullptr &&
+            !stream->is_computed_on_demand() &&
+            stream->bin_count() > 0 &&
+            is_exported(stream))
+        {
+            LOG_WARN("astra.plugin_service",
+                     "set_stream_compute_callback called after stream %x was exported to shared memory",
+                     streamHandle);
+            return ASTRA_STATUS_INVALID_OPERATION;
+        }
+
+        stream->set_compute_callback(callback, clientTag, caller_update_lock());
+
+        return ASTRA_STATUS_SUCCESS;
+    }
+
+    bool plugin_service_impl::is_exported(stream* stream)
+    {
+        streamset* set = setCatalog_.find_streamset_for_stream(stream);
+        return set != nullptr && setCatalog_.is_shared_memory_export(set->get_uri());
+    }
+
+    astra_status_t plugin_service_impl::set_parameter_cacheable(astra_stream_t streamHandle,
+                                                                astra_parameter_id parameterId,
+                                                                bool cacheable)
+    {
+        std::lock_guard<core_mutex> lock(coreMutex_);
+
+        if (streamHandle == nullptr)
+        {
+            LOG_WARN("astra.plugin_service", "set_parameter_cacheable called with null stream");
+            return ASTRA_STATUS_INVALID_PARAMETER;
+        }
+
+        stream* stream = stream::get_ptr(streamHandle);
+        stream->set_parameter_cacheable(parameterId, cacheable);
+
+        return ASTRA_STATUS_SUCCESS;
+    }
+
+    astra_status_t plugin_service_impl::invalidate_parameters(astra_stream_t streamHandle)
+    {
+        std::lock_guard<core_mutex> lock(coreMutex_);
+
+        if (streamHandle == nullptr)
+        {
+            LOG_WARN("astra.plugin_service", "invalidate_parameters called with null stream");
+            return ASTRA_STATUS_INVALID_PARAMETER;
+        }
+
+        stream* stream = stream::get_ptr(streamHandle);
+        stream->invalidate_parameters();
+
+        return ASTRA_STATUS_SUCCESS;
+    }
+
+    astra_status_t plugin_service_impl::set_bin_capture_timestamp(astra_bin_t binHandle,
+                                                                 uint64_t captureTimestamp)
+    {
+        std::lock_guard<core_mutex> lock(coreMutex_);
+
+        assert(binHandle != nullptr);
+
+        stream_bin* bin = stream_bin::get_ptr(binHandle);
+        bin->set_back_buffer_capture_timestamp(captureTimestamp);
+
+        return ASTRA_STATUS_SUCCESS;
+    }
+
+    astra_status_t plugin_service_impl::request_update()
+    {
+        //doesn't take the core mutex, plugins call this from their own device
+        //threads and must not wait behind an update in progress
+        updateSignal_.raise();
+        if (plugin_state_ptr caller = caller_scope::current())
+        {
+            caller->updateSignal.request();
+        }
+
+        return ASTRA_STATUS_SUCCESS;
+    }
 }
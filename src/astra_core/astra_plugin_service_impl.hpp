@@ -23,6 +23,10 @@
 #include "astra_stream_bin.hpp"
 #include "astra_signal.hpp"
 #include "astra_logger.hpp"
+#include "astra_core_mutex.hpp"
+#include "astra_update_signal.hpp"
+#include "astra_plugin_update_lock.hpp"
+#include <memory>
 
 using CallbackId = size_t;
 
@@ -32,12 +36,71 @@ namespace astra
 {
     class streamset;
     class streamset_catalog;
+    class dataflow_scheduler;
 
+    // What the core keeps for each plugin so it can be updated apart from the
+    // others. Calls a plugin makes come through its own plugin_service, which
+    // tags them with this, see plugin_service_impl::caller_scope.
+    struct plugin_state
+    {
+        explicit plugin_state(core_mutex& coreMutex)
+            : updateLock(std::make_shared<plugin_update_lock>(coreMutex))
+        {}
+
+        //held by the plugin's updates and the core's callbacks into it
+        plugin_update_lock_ptr updateLock;
+        //wakes the plugin's own background update thread
+        update_signal updateSignal;
+    };
+
+    using plugin_state_ptr = std::shared_ptr<plugin_state>;
+
+    // Calls are made by plugins from their update, which holds the core mutex
+    // when plugins are updated together and doesn't when each has its own
+    // background thread, by their device threads, and by dataflow nodes on
+    // worker threads. Each call takes the core mutex so all of them are
+    // serialized with the client API, except request_update, which only wakes
+    // the update threads.
     class plugin_service_impl
     {
     public:
-        plugin_service_impl(streamset_catalog& catalog)
-            : setCatalog_(catalog)
+        // tags the calls made on this thread with the plugin making them
+        class caller_scope
+        {
+        public:
+            explicit caller_scope(const plugin_state_ptr& caller)
+                : previous_(current_)
+            {
+                current_ = &caller;
+            }
+
+            ~caller_scope()
+            {
+                current_ = previous_;
+            }
+
+            caller_scope(const caller_scope&) = delete;
+            caller_scope& operator=(const caller_scope&) = delete;
+
+            //the calling plugin, or null for calls from inside the core
+            static plugin_state_ptr current()
+            {
+                return current_ != nullptr ? *current_ : nullptr;
+            }
+
+        private:
+            const plugin_state_ptr* previous_;
+            static thread_local const plugin_state_ptr* current_;
+        };
+
+        plugin_service_impl(streamset_catalog& catalog,
+                            core_mutex& coreMutex,
+                            update_signal& updateSignal,
+                            dataflow_scheduler& scheduler)
+            : setCatalog_(catalog),
+              coreMutex_(coreMutex),
+              updateSignal_(updateSignal),
+              scheduler_(scheduler)
             {}
 
         plugin_service_impl(const plugin_service_impl& service) = delete;
@@ -92,9 +155,39 @@ namespace astra
                            const char* func,
                            const char* format,
                            va_list args);
+        astra_status_t create_stream_bin_with_depth(astra_stream_t streamHandle,
+                                                    size_t lengthInBytes,
+                                                    size_t bufferCount,
+                                                    astra_bin_t& binHandle,
+                                                    astra_frame_t*& binBuffer);
+        astra_status_t register_dataflow_node(astra_reader_t reader,
+                                              const astra_stream_desc_t* inputs,
+                                              size_t inputCount,
+                                              const astra_stream_desc_t* outputs,
+                                              size_t outputCount,
+                                              astra_frame_ready_callback_t callback,
+                                              void* clientTag,
+                                              astra_callback_id_t& nodeId);
+        astra_status_t unregister_dataflow_node(astra_callback_id_t nodeId);
+        astra_status_t set_stream_compute_callback(astra_stream_t stream,
+                                                   stream_compute_callback_t callback,
+                                                   void* clientTag);
+        astra_status_t set_parameter_cacheable(astra_stream_t stream,
+                                               astra_parameter_id parameterId,
+                                               bool cacheable);
+        astra_status_t invalidate_parameters(astra_stream_t stream);
+        astra_status_t set_bin_capture_timestamp(astra_bin_t binHandle,
+                                                 uint64_t captureTimestamp);
+        astra_status_t request_update();
 
     private:
+        bool is_exported(stream* stream);
+        static plugin_update_lock_ptr caller_update_lock();
+
         streamset_catalog& setCatalog_;
+        core_mutex& coreMutex_;
+        update_signal& updateSignal_;
+        dataflow_scheduler& scheduler_;
         signal<astra_event_id, const void*, size_t> hostEventSignal_;
     };
 }
@@ -0,0 +1,131 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#ifndef ASTRA_PLUGIN_UPDATE_LOCK_H
+#define ASTRA_PLUGIN_UPDATE_LOCK_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "astra_core_mutex.hpp"
+
+namespace astra {
+
+    // Recursive lock held while a plugin updates and while the core calls back
+    // into it, so a plugin updated on its own thread outside the core mutex
+    // still never sees its update overlap its stream callbacks.
+    //
+    // The core calls back holding the core mutex, and an update takes the core
+    // mutex for each call it makes into the core. A thread holding the core
+    // mutex that finds the lock taken therefore lends the core mutex to the
+    // update while it waits, as if the update's core calls were nested in its own.
+    class plugin_update_lock
+    {
+    public:
+        explicit plugin_update_lock(core_mutex& coreMutex)
+            : coreMutex_(coreMutex)
+        {}
+
+        plugin_update_lock(const plugin_update_lock&) = delete;
+        plugin_update_lock& operator=(const plugin_update_lock&) = delete;
+
+        void lock()
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            const std::thread::id self = std::this_thread::get_id();
+
+            if (owner_ != self)
+            {
+                while (owner_ != std::thread::id())
+                {
+                    const std::thread::id holder = owner_;
+                    const std::uint64_t releaseCount = releaseCount_;
+                    lock.unlock();
+
+                    {
+                        //does nothing unless this thread holds the core mutex
+                        core_mutex::loan loan(coreMutex_, holder);
+
+                        std::unique_lock<std::mutex> waitLock(mutex_);
+                        released_.wait(waitLock, [this, releaseCount] { return releaseCount_ != releaseCount; });
+                    }
+
+                    lock.lock();
+                }
+
+                owner_ = self;
+            }
+            ++depth_;
+        }
+
+        void unlock()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                if (--depth_ > 0)
+                    return;
+
+                owner_ = std::thread::id();
+                ++releaseCount_;
+            }
+            released_.notify_all();
+        }
+
+    private:
+        core_mutex& coreMutex_;
+
+        std::mutex mutex_;
+        std::condition_variable released_;
+        std::thread::id owner_;
+        int depth_{0};
+        std::uint64_t releaseCount_{0};
+    };
+
+    using plugin_update_lock_ptr = std::shared_ptr<plugin_update_lock>;
+
+    // holds a plugin's update lock for a call into the plugin, if it has one
+    class plugin_call_guard
+    {
+    public:
+        explicit plugin_call_guard(const plugin_update_lock_ptr& updateLock)
+            : updateLock_(updateLock)
+        {
+            if (updateLock_)
+            {
+                updateLock_->lock();
+            }
+        }
+
+        ~plugin_call_guard()
+        {
+            if (updateLock_)
+            {
+                updateLock_->unlock();
+            }
+        }
+
+        plugin_call_guard(const plugin_call_guard&) = delete;
+        plugin_call_guard& operator=(const plugin_call_guard&) = delete;
+
+    private:
+        plugin_update_lock_ptr updateLock_;
+    };
+}
+
+#endif /* ASTRA_PLUGIN_UPDATE_LOCK_H */
@@ -23,12 +23,21 @@ using astra_frame_status_t = int8_t;
 const astra_frame_status_t ASTRA_FRAME_STATUS_AVAILABLE = 0;
 const astra_frame_status_t ASTRA_FRAME_STATUS_LOCKED_POLL = 1;
 const astra_frame_status_t ASTRA_FRAME_STATUS_LOCKED_EVENT = 2;
+const astra_frame_status_t ASTRA_FRAME_STATUS_RETAINED = 3;
+
+namespace astra {
+    class retained_frame;
+}
 
 struct _astra_reader_frame
 {
     astra_frame_id_t id;
     astra_frame_status_t status;
     astra_reader_t reader;
+    //stats clock time when the frame was locked for the client
+    uint64_t lockTimestamp;
+    //set on frames from astra_frame_retain(), which don't lock the reader
+    astra::retained_frame* retained;
 };
 
 #endif // ASTRA_PRIVATE_H
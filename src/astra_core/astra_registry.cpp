@@ -18,9 +18,70 @@
 
 namespace astra {
 
-    registry::store& registry::get_store()
+    registry::handle_table& registry::get_table()
     {
-        static registry::store store_;
-        return store_;
+        //never destroyed, instances may unregister during static destruction
+        static registry::handle_table* table_ = new registry::handle_table();
+        return *table_;
+    }
+
+    void* registry::handle_table::add(const tag_* tag, const void* object)
+    {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+
+        if (freeIndices_.empty())
+        {
+            if (chunkCount_ == MAX_CHUNKS)
+            {
+                LOG_ERROR("registry", "handle table full, %u instances registered",
+                          MAX_CHUNKS * SLOTS_PER_CHUNK);
+                return nullptr;
+            }
+
+            handle_bits firstIndex = chunkCount_ * SLOTS_PER_CHUNK;
+            chunks_[chunkCount_].store(new slot[SLOTS_PER_CHUNK], std::memory_order_release);
+            ++chunkCount_;
+
+            //hand out lower indices first
+            for (handle_bits i = SLOTS_PER_CHUNK; i > 0; --i)
+            {
+                freeIndices_.push_back(firstIndex + i - 1);
+            }
+        }
+
+        handle_bits index = freeIndices_.back();
+        freeIndices_.pop_back();
+
+        slot* s = slot_at(index);
+        s->object.store(object, std::memory_order_relaxed);
+        s->tag.store(tag, std::memory_order_relaxed);
+
+        handle_bits generation = s->generation.load(std::memory_order_relaxed);
+        return reinterpret_cast<void*>((generation << INDEX_BITS) | index);
+    }
+
+    void registry::handle_table::remove(const tag_* tag, const void* handle)
+    {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+
+        if (!find(tag, handle))
+            return;
+
+        handle_bits index = reinterpret_cast<handle_bits>(handle) & INDEX_MASK;
+        slot* s = slot_at(index);
+
+        //generation 0 is never used so a handle is never null
+        handle_bits generation = (s->generation.load(std::memory_order_relaxed) + 1) & GENERATION_MASK;
+        if (generation == 0)
+        {
+            generation = 1;
+        }
+
+        s->generation.store(generation, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        s->object.store(nullptr, std::memory_order_relaxed);
+        s->tag.store(nullptr, std::memory_order_relaxed);
+
+        freeIndices_.push_back(index);
     }
 }
@@ -18,76 +18,148 @@
 #define ASTRA_REGISTRY_H
 
 #include "astra_logger.hpp"
-#include <set>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
 
 namespace astra {
 
     template<typename>
     class tracked_instance;
 
+    // Hands out opaque handles for tracked instances. A handle encodes a slot
+    // index in the low half and the slot's generation in the high half.
+    // Looking one up is an array load and two compares, without locking.
+    // Unregistering bumps the slot's generation so stale handles are rejected
+    // even after the slot is reused.
     class registry
     {
     public:
 
         template<typename T>
-        static T* get(void* obj);
+        static T* get(const void* handle);
 
     private:
         struct tag_ {};
 
-        using key = std::pair<const tag_*, const void*>;
-        using store = std::set<key>;
+        using handle_bits = uintptr_t;
+
+        const static unsigned INDEX_BITS = sizeof(handle_bits) * 4;
+        const static handle_bits INDEX_MASK = (handle_bits(1) << INDEX_BITS) - 1;
+        const static handle_bits GENERATION_MASK = INDEX_MASK;
+
+        const static size_t SLOTS_PER_CHUNK = 256;
+        const static size_t MAX_CHUNKS = 256;
+
+        struct slot
+        {
+            std::atomic<handle_bits> generation{1};
+            std::atomic<const tag_*> tag{nullptr};
+            std::atomic<const void*> object{nullptr};
+        };
+
+        //slots live in fixed chunks that are never moved or freed,
+        //so lookups can run while other threads register instances
+        class handle_table
+        {
+        public:
+            handle_table() = default;
+
+            handle_table(const handle_table&) = delete;
+            handle_table& operator=(const handle_table&) = delete;
+
+            void* add(const tag_* tag, const void* object);
+            void remove(const tag_* tag, const void* handle);
+
+            inline const void* find(const tag_* tag, const void* handle) const
+            {
+                handle_bits bits = reinterpret_cast<handle_bits>(handle);
+                handle_bits index = bits & INDEX_MASK;
+                handle_bits generation = bits >> INDEX_BITS;
+
+                const slot* s = slot_at(index);
+                if (!s || s->generation.load(std::memory_order_acquire) != generation)
+                    return nullptr;
+
+                const tag_* slotTag = s->tag.load(std::memory_order_relaxed);
+                const void* object = s->object.load(std::memory_order_relaxed);
+
+                //if the slot was released while we read it the generation has moved on
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slotTag != tag || s->generation.load(std::memory_order_relaxed) != generation)
+                    return nullptr;
+
+                return object;
+            }
+
+        private:
+            inline slot* slot_at(handle_bits index) const
+            {
+                if (index >= MAX_CHUNKS * SLOTS_PER_CHUNK)
+                    return nullptr;
+
+                slot* chunk = chunks_[index / SLOTS_PER_CHUNK].load(std::memory_order_acquire);
+                if (!chunk)
+                    return nullptr;
+
+                return &chunk[index % SLOTS_PER_CHUNK];
+            }
+
+            std::atomic<slot*> chunks_[MAX_CHUNKS] = {};
+            size_t chunkCount_{0};
+
+            std::mutex writeMutex_;
+            std::vector<handle_bits> freeIndices_;
+        };
 
         template<typename T>
-        static void register_instance(tracked_instance<T>* instance);
+        static void* register_instance(tracked_instance<T>* instance);
 
         template<typename T>
         static void unregister_instance(tracked_instance<T>* instance);
 
-        static store& get_store();
+        static handle_table& get_table();
 
         template<typename T>
         friend class tracked_instance;
     };
 
     template<typename T>
-    void registry::register_instance(tracked_instance<T>* instance)
+    void* registry::register_instance(tracked_instance<T>* instance)
     {
         if (!instance)
-            return;
+            return nullptr;
 
         const tag_* tag = &tracked_instance<T>::TAG;
         const void* object = instance;
 
-        get_store().insert(std::make_pair(tag, object));
+        return get_table().add(tag, object);
     }
 
     template<typename T>
     void registry::unregister_instance(tracked_instance<T>* instance)
     {
-        if (!instance)
+        if (!instance || !instance->handle_)
             return;
 
         const tag_* tag = &tracked_instance<T>::TAG;
-        const void* object = instance;
-
-        auto& store = get_store();
-        auto pair = std::make_pair(tag, object);
 
-        store.erase(std::move(pair));
+        get_table().remove(tag, instance->handle_);
     }
 
     template<typename T>
-    T* registry::get(void* obj)
+    T* registry::get(const void* handle)
     {
-        if (!obj)
+        if (!handle)
             return nullptr;
 
         const tag_* tag = &tracked_instance<T>::TAG;
-        if (get_store().count(std::make_pair(tag, obj)) == 0)
+        const void* obj = get_table().find(tag, handle);
+        if (!obj)
             return nullptr;
 
-        return static_cast<T*>(reinterpret_cast<tracked_instance<T>*>(obj));
+        return static_cast<T*>(reinterpret_cast<tracked_instance<T>*>(const_cast<void*>(obj)));
     }
 
     template<typename T>
@@ -101,12 +173,18 @@ namespace astra {
         //tracked_instance(tracked_instance&&) = default;
         //tracked_instance& operator=(tracked_instance&&) = default;
 
-        tracked_instance(const tracked_instance&) = default;
-        tracked_instance& operator=(const tracked_instance&) = default;
+        //a copy is a new instance with its own handle
+        tracked_instance(const tracked_instance&);
+        tracked_instance& operator=(const tracked_instance&) { return *this; }
+
+        //nullptr when the registry is full, the instance can't be looked up
+        void* tracked_handle() const { return handle_; }
 
     private:
         static const registry::tag_ TAG;
 
+        void* handle_{nullptr};
+
         friend class registry;
 
     };
@@ -117,7 +195,13 @@ namespace astra {
     template<typename T>
     tracked_instance<T>::tracked_instance()
     {
-        registry::register_instance(this);
+        handle_ = registry::register_instance(this);
+    }
+
+    template<typename T>
+    tracked_instance<T>::tracked_instance(const tracked_instance&)
+    {
+        handle_ = registry::register_instance(this);
     }
 
     template<typename T>
@@ -0,0 +1,55 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#include "astra_retained_frame.hpp"
+#include "astra_histogram.hpp"
+
+namespace astra {
+
+    retained_frame::retained_frame(astra_reader_t reader)
+    {
+        readerFrame_.id = -1;
+        readerFrame_.status = ASTRA_FRAME_STATUS_RETAINED;
+        readerFrame_.reader = reader;
+        readerFrame_.lockTimestamp = stats_clock_microseconds();
+        readerFrame_.retained = this;
+    }
+
+    void retained_frame::add_subframe(const astra_stream_desc_t& desc,
+                                      const astra_frame_t& frame,
+                                      frame_buffer_pool::buffer_ptr storage)
+    {
+        subframe retained;
+        retained.desc = desc;
+        retained.frame = frame;
+        retained.storage = std::move(storage);
+
+        subframes_.push_back(std::move(retained));
+    }
+
+    astra_frame_t* retained_frame::get_subframe(const astra_stream_desc_t& desc)
+    {
+        for (auto& retained : subframes_)
+        {
+            if (retained.desc.type == desc.type && retained.desc.subtype == desc.subtype)
+            {
+                return &retained.frame;
+            }
+        }
+
+        return nullptr;
+    }
+}
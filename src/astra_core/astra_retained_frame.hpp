@@ -0,0 +1,72 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#ifndef ASTRA_RETAINED_FRAME_H
+#define ASTRA_RETAINED_FRAME_H
+
+#include <astra_core/capi/astra_types.h>
+#include <astra_core/capi/plugins/astra_plugin.h>
+#include <atomic>
+#include <vector>
+#include "astra_private.h"
+#include "astra_frame_buffer_pool.hpp"
+
+namespace astra {
+
+    // A reader frame kept past astra_reader_close_frame() by
+    // astra_frame_retain(). It shares the bins' buffers instead of copying
+    // them and holds no connection locks, so producers keep their full rate.
+    class retained_frame
+    {
+    public:
+        retained_frame(astra_reader_t reader);
+
+        retained_frame(const retained_frame&) = delete;
+        retained_frame& operator=(const retained_frame&) = delete;
+
+        void add_subframe(const astra_stream_desc_t& desc,
+                          const astra_frame_t& frame,
+                          frame_buffer_pool::buffer_ptr storage);
+
+        astra_frame_t* get_subframe(const astra_stream_desc_t& desc);
+
+        void add_ref() { ++refCount_; }
+        //true when the last reference was released
+        bool release() { return --refCount_ == 0; }
+
+        astra_reader_frame_t get_handle() { return &readerFrame_; }
+
+        static retained_frame* from_frame(astra_reader_frame_t frame)
+        {
+            return frame != nullptr ? frame->retained : nullptr;
+        }
+
+    private:
+        struct subframe
+        {
+            astra_stream_desc_t desc;
+            astra_frame_t frame;
+            frame_buffer_pool::buffer_ptr storage;
+        };
+
+        _astra_reader_frame readerFrame_;
+        //a handful of streams per reader, searched linearly
+        std::vector<subframe> subframes_;
+        std::atomic<int32_t> refCount_{1};
+    };
+}
+
+#endif /* ASTRA_RETAINED_FRAME_H */
@@ -0,0 +1,244 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#include "astra_shm_frame_ring.hpp"
+#include "astra_logger.hpp"
+#include <cassert>
+#include <cstring>
+
+#if defined(ASTRA_SHM_SUPPORTED)
+#include <cerrno>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace astra {
+
+#if defined(ASTRA_SHM_SUPPORTED)
+    static bool is_owned_by_live_host(const std::string& name)
+    {
+        int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0)
+        {
+            //another user's segment, not ours to replace
+            return errno == EACCES;
+        }
+
+        shm::segment_header header;
+        bool hasHeader = pread(fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header));
+        close(fd);
+
+        if (!hasHeader || header.magic != shm::SEGMENT_MAGIC || header.closed.load() != 0)
+        {
+            return false;
+        }
+
+        return kill(static_cast<pid_t>(header.hostPid), 0) == 0 || errno == EPERM;
+    }
+
+    //frames are readable only by processes running as the host's user
+    static const mode_t SEGMENT_MODE = S_IRUSR | S_IWUSR;
+#endif
+
+    std::shared_ptr<shm_frame_ring> shm_frame_ring::create(const std::string& uri,
+                                                           astra_stream_desc_t description,
+                                                           size_t slotSize,
+                                                           size_t slotCount)
+    {
+#if defined(ASTRA_SHM_SUPPORTED)
+        const std::string name = shm::segment_name(uri, description);
+        const size_t segmentSize = shm::segment_size(static_cast<uint32_t>(slotCount), slotSize);
+
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, SEGMENT_MODE);
+        if (fd < 0 && errno == EEXIST && !is_owned_by_live_host(name))
+        {
+            //left behind by a host that didn't shut down cleanly
+            shm_unlink(name.c_str());
+            fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, SEGMENT_MODE);
+        }
+
+        if (fd < 0)
+        {
+            if (errno == EEXIST)
+            {
+                LOG_WARN("astra.shm_frame_ring", "%s is already exported by another process", name.c_str());
+            }
+            else
+            {
+                LOG_WARN("astra.shm_frame_ring", "shm_open %s failed: %s", name.c_str(), strerror(errno));
+            }
+            return nullptr;
+        }
+
+        if (ftruncate(fd, static_cast<off_t>(segmentSize)) != 0)
+        {
+            LOG_WARN("astra.shm_frame_ring", "sizing %s to %u bytes failed: %s",
+                     name.c_str(),
+                     segmentSize,
+                     strerror(errno));
+            close(fd);
+            shm_unlink(name.c_str());
+            return nullptr;
+        }
+
+        void* mapped = mmap(nullptr, segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+
+        if (mapped == MAP_FAILED)
+        {
+            LOG_WARN("astra.shm_frame_ring", "mapping %s failed: %s", name.c_str(), strerror(errno));
+            shm_unlink(name.c_str());
+            return nullptr;
+        }
+
+        //ftruncate zero fills, so the slots start out even and unpublished
+        shm::segment_header* header = static_cast<shm::segment_header*>(mapped);
+        header->version = shm::SEGMENT_VERSION;
+        header->hostPid = static_cast<int32_t>(getpid());
+        header->description = description;
+        strncpy(header->uri, uri.c_str(), shm::MAX_URI_LENGTH - 1);
+        header->slotCount = static_cast<uint32_t>(slotCount);
+        header->slotSize = slotSize;
+        header->latestSlot.store(shm::NO_SLOT);
+
+        for (uint32_t slot = 0; slot < slotCount; ++slot)
+        {
+            shm::get_slot_header(header, slot)->hostAddress =
+                reinterpret_cast<uint64_t>(shm::get_slot_data(header, slot));
+        }
+
+        //clients ignore the segment until the magic is in place
+        std::atomic_thread_fence(std::memory_order_release);
+        header->magic = shm::SEGMENT_MAGIC;
+
+        LOG_INFO("astra.shm_frame_ring", "exporting %s type: %d subtype: %d to %s, %u slots of %u bytes",
+                 uri.c_str(),
+                 description.type,
+                 description.subtype,
+                 name.c_str(),
+                 slotCount,
+                 slotSize);
+
+        return std::shared_ptr<shm_frame_ring>(new shm_frame_ring(name, header, segmentSize));
+#else
+        LOG_WARN("astra.shm_frame_ring", "shared memory export is not supported on this platform");
+        return nullptr;
+#endif
+    }
+
+    shm_frame_ring::shm_frame_ring(std::string name, shm::segment_header* header, size_t segmentSize)
+        : name_(name),
+          header_(header),
+          segmentSize_(segmentSize)
+    {
+        for (uint32_t slot = header_->slotCount; slot > 0; --slot)
+        {
+            freeSlots_.push_back(slot - 1);
+        }
+    }
+
+    shm_frame_ring::~shm_frame_ring()
+    {
+#if defined(ASTRA_SHM_SUPPORTED)
+        LOG_INFO("astra.shm_frame_ring", "closing %s", name_.c_str());
+
+        //clients keep their mapping until they see closed and detach
+        header_->closed.store(1);
+        header_->publishedSequence.fetch_add(1);
+        shm::futex_wake_all(&header_->publishedSequence);
+
+        shm_unlink(name_.c_str());
+        munmap(header_, segmentSize_);
+#endif
+    }
+
+    frame_buffer_pool::buffer_ptr shm_frame_ring::acquire()
+    {
+        uint32_t slot;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (freeSlots_.empty())
+            {
+                return nullptr;
+            }
+
+            slot = freeSlots_.back();
+            freeSlots_.pop_back();
+        }
+
+        //the deleter keeps the mapping alive until every slot is back
+        std::shared_ptr<shm_frame_ring> self = shared_from_this();
+        return frame_buffer_pool::buffer_ptr(shm::get_slot_data(header_, slot),
+                                             [self, slot] (uint8_t*) { self->release(slot); });
+    }
+
+    void shm_frame_ring::release(uint32_t slot)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        freeSlots_.push_back(slot);
+    }
+
+    uint32_t shm_frame_ring::slot_of(const uint8_t* data) const
+    {
+        const uint8_t* first = shm::get_slot_data(header_, 0);
+        const size_t stride = shm::slot_stride(static_cast<size_t>(header_->slotSize));
+
+        if (data < first || data >= first + stride * header_->slotCount)
+        {
+            return shm::NO_SLOT;
+        }
+
+        return static_cast<uint32_t>((data - first) / stride);
+    }
+
+    void shm_frame_ring::begin_write(uint32_t slot)
+    {
+        assert(slot < header_->slotCount);
+
+        std::atomic<uint32_t>& generation = shm::get_slot_header(header_, slot)->generation;
+        uint32_t current = generation.load(std::memory_order_relaxed);
+
+        if ((current & 1) == 0)
+        {
+            generation.store(current + 1, std::memory_order_relaxed);
+            //clients must see the odd generation before any of the new data
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+    }
+
+    void shm_frame_ring::publish(uint32_t slot, const astra_frame_t& frame, uint64_t timestamp)
+    {
+        assert(slot < header_->slotCount);
+
+        shm::slot_header* slotHeader = shm::get_slot_header(header_, slot);
+        slotHeader->frameIndex = frame.frameIndex;
+        slotHeader->byteLength = frame.byteLength;
+        slotHeader->timestamp = timestamp;
+
+        //the next even generation, the slot's data is complete
+        uint32_t current = slotHeader->generation.load(std::memory_order_relaxed);
+        slotHeader->generation.store((current | 1) + 1, std::memory_order_release);
+
+        header_->latestSlot.store(slot, std::memory_order_release);
+        header_->publishedSequence.fetch_add(1, std::memory_order_release);
+
+#if defined(ASTRA_SHM_SUPPORTED)
+        shm::futex_wake_all(&header_->publishedSequence);
+#endif
+    }
+}
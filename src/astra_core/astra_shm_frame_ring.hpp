@@ -0,0 +1,76 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#ifndef ASTRA_SHM_FRAME_RING_H
+#define ASTRA_SHM_FRAME_RING_H
+
+#include <astra_core/capi/astra_types.h>
+#include <astra_core/capi/plugins/astra_plugin.h>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "astra_frame_buffer_pool.hpp"
+#include "astra_shm_segment.hpp"
+
+namespace astra {
+
+    // Host side of a stream_bin exported to POSIX shared memory. The slots
+    // are the bin's frame buffers, so producers write straight into the
+    // segment and publishing a frame copies nothing. Like frame_buffer_pool
+    // buffers, a slot goes back to the ring when its last owner lets go.
+    class shm_frame_ring : public std::enable_shared_from_this<shm_frame_ring>
+    {
+    public:
+        //nullptr when the segment can't be created or the platform has no support
+        static std::shared_ptr<shm_frame_ring> create(const std::string& uri,
+                                                      astra_stream_desc_t description,
+                                                      size_t slotSize,
+                                                      size_t slotCount);
+        ~shm_frame_ring();
+
+        shm_frame_ring(const shm_frame_ring&) = delete;
+        shm_frame_ring& operator=(const shm_frame_ring&) = delete;
+
+        //nullptr when every slot is in use
+        frame_buffer_pool::buffer_ptr acquire();
+
+        //shm::NO_SLOT if data is not a slot of this ring
+        uint32_t slot_of(const uint8_t* data) const;
+
+        //hides the slot from clients until it is published again
+        void begin_write(uint32_t slot);
+        void publish(uint32_t slot, const astra_frame_t& frame, uint64_t timestamp);
+
+        const std::string& name() const { return name_; }
+        shm::segment_header* header() const { return header_; }
+
+    private:
+        shm_frame_ring(std::string name, shm::segment_header* header, size_t segmentSize);
+
+        void release(uint32_t slot);
+
+        const std::string name_;
+        shm::segment_header* header_;
+        const size_t segmentSize_;
+
+        std::mutex mutex_;
+        std::vector<uint32_t> freeSlots_;
+    };
+}
+
+#endif /* ASTRA_SHM_FRAME_RING_H */
@@ -0,0 +1,150 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#ifndef ASTRA_SHM_SEGMENT_H
+#define ASTRA_SHM_SEGMENT_H
+
+#include <astra_core/capi/astra_types.h>
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+#if defined(__linux__)
+#define ASTRA_SHM_SUPPORTED 1
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace astra { namespace shm {
+
+    // Layout of the POSIX shared memory segment an exported stream_bin
+    // lives in. Shared by the host (shm_frame_ring) and the shm_client
+    // plugin, which maps it read-only. Only the host writes, so clients
+    // detect frames rewritten under them with the slot generation.
+    //
+    //   segment_header | slot_header[slotCount] | padding | slot data[slotCount]
+
+    const uint32_t SEGMENT_MAGIC = 0x41534846;
+    const uint32_t SEGMENT_VERSION = 1;
+    const uint32_t NO_SLOT = UINT32_MAX;
+    const size_t MAX_URI_LENGTH = 128;
+    const size_t SLOT_ALIGNMENT = 64;
+
+    //every segment name starts with this, clients find exports by it
+    const char* const SEGMENT_NAME_PREFIX = "astra.";
+
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+                  "shared atomics must have the layout of their value to be futex words");
+
+    struct segment_header
+    {
+        uint32_t magic;
+        uint32_t version;
+        int32_t hostPid;
+        astra_stream_desc_t description;
+        char uri[MAX_URI_LENGTH];
+        uint32_t slotCount;
+        uint64_t slotSize;
+        //bumped once per published frame, the futex word clients wait on
+        std::atomic<uint32_t> publishedSequence;
+        std::atomic<uint32_t> latestSlot;
+        //set when the host stops publishing
+        std::atomic<uint32_t> closed;
+    };
+
+    struct slot_header
+    {
+        //odd while the host may be writing the slot
+        std::atomic<uint32_t> generation;
+        astra_frame_index_t frameIndex;
+        uint64_t byteLength;
+        uint64_t timestamp;
+        //where the host maps the slot data. frames store pointers into
+        //their own data, clients rebase them against this.
+        uint64_t hostAddress;
+    };
+
+    inline size_t align_up(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    inline size_t slot_stride(size_t slotSize)
+    {
+        return align_up(slotSize, SLOT_ALIGNMENT);
+    }
+
+    inline size_t data_offset(uint32_t slotCount)
+    {
+        return align_up(sizeof(segment_header) + slotCount * sizeof(slot_header), SLOT_ALIGNMENT);
+    }
+
+    inline size_t segment_size(uint32_t slotCount, size_t slotSize)
+    {
+        return data_offset(slotCount) + slotCount * slot_stride(slotSize);
+    }
+
+    inline slot_header* get_slot_header(segment_header* header, uint32_t slot)
+    {
+        return reinterpret_cast<slot_header*>(header + 1) + slot;
+    }
+
+    inline uint8_t* get_slot_data(segment_header* header, uint32_t slot)
+    {
+        return reinterpret_cast<uint8_t*>(header)
+            + data_offset(header->slotCount)
+            + slot * slot_stride(static_cast<size_t>(header->slotSize));
+    }
+
+    //"device/sensor0" depth becomes "/astra.device.sensor0.1.0"
+    inline std::string segment_name(const std::string& uri, astra_stream_desc_t description)
+    {
+        std::stringstream name;
+        name << "/" << SEGMENT_NAME_PREFIX;
+
+        for (char c : uri)
+        {
+            name << (c == '/' || c == ':' ? '.' : c);
+        }
+
+        name << "." << description.type << "." << description.subtype;
+        return name.str();
+    }
+
+#if defined(ASTRA_SHM_SUPPORTED)
+    inline void futex_wake_all(std::atomic<uint32_t>* word)
+    {
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+    }
+
+    //returns once word no longer holds expected, after the timeout, or spuriously
+    inline void futex_wait(const std::atomic<uint32_t>* word, uint32_t expected, int timeoutMillis)
+    {
+        timespec timeout;
+        timeout.tv_sec = timeoutMillis / 1000;
+        timeout.tv_nsec = (timeoutMillis % 1000) * 1000000L;
+
+        syscall(SYS_futex, reinterpret_cast<const uint32_t*>(word), FUTEX_WAIT, expected, &timeout, nullptr, 0);
+    }
+#endif
+}}
+
+#endif /* ASTRA_SHM_SEGMENT_H */
@@ -18,193 +18,215 @@
 #define ASTRA_SIGNAL_H
 
 #include <functional>
-
-//TODO: make add/remove callbacks threadsafe with mutex
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace astra {
 
-    template<typename R, typename... Signature> class CallbackList;
-
+    // Callbacks live in an immutable array that is replaced, never modified,
+    // when a callback is added or removed. invoke() walks the published array
+    // without locking or allocating, so it can run while other threads add or
+    // remove callbacks. Writers are serialized on a mutex and free replaced
+    // arrays once no invoke() is in progress.
+    //
+    // A removed callback is never called by an invoke() that starts after
+    // remove() returns, or later in an invoke() on the same thread. remove()
+    // does not wait for a call already running on another thread.
     template<typename R, typename... Signature>
-    class CallbackNode
+    class CallbackList
     {
-
     public:
-
         typedef std::function<R (Signature...)> callback_type;
 
-        CallbackNode(const callback_type& cb)
-            : prev_(nullptr), next_(nullptr), callback_(cb), refCount_(1)
-        {}
+        CallbackList() = default;
 
-        void inc_reference() { refCount_++; }
-        void dec_reference()
+        CallbackList(const CallbackList&) = delete;
+        CallbackList& operator=(const CallbackList&) = delete;
+
+        ~CallbackList()
         {
-            refCount_--;
-            if (refCount_ == 0)
+            delete slots_.load();
+            for (slot_array* retired : retired_)
             {
-                delete this;
+                delete retired;
             }
         }
 
-        void deactivate()
+        size_t add(const callback_type& cb)
         {
-            callback_ = nullptr;
-        }
+            std::lock_guard<std::mutex> lock(writeMutex_);
 
-        void remove_self()
-        {
-            deactivate();
-            if (next_)
-            {
-                next_->prev_ = prev_;
-            }
-            if (prev_)
+            slot_array* current = slots_.load();
+            size_t size = current ? current->size : 0;
+
+            slot_array* next = new slot_array(size + 1);
+            for (size_t i = 0; i < size; ++i)
             {
-                prev_->next_ = next_;
+                next->slots[i].id = current->slots[i].id;
+                next->slots[i].callback = current->slots[i].callback;
             }
-            dec_reference();
+
+            size_t id = nextId_++;
+            next->slots[size].id = id;
+            next->slots[size].callback = cb;
+
+            publish(next);
+
+            return id;
         }
 
-    private:
+        bool remove(size_t id)
+        {
+            std::lock_guard<std::mutex> lock(writeMutex_);
 
-        CallbackNode* prev_;
-        CallbackNode* next_;
-        callback_type callback_;
-        unsigned int refCount_;
+            slot_array* current = slots_.load();
+            if (!current || !current->contains(id))
+                return false;
 
-        friend class CallbackList<R, Signature...>;
-    };
+            //stop invokes already walking older arrays from reaching it
+            current->disable(id);
+            for (slot_array* retired : retired_)
+            {
+                retired->disable(id);
+            }
 
-    template<typename R, typename... Signature>
-    class CallbackList
-    {
-    public:
+            slot_array* next = nullptr;
+            if (current->size > 1)
+            {
+                next = new slot_array(current->size - 1);
 
-        typedef CallbackNode<R, Signature...> node_type;
-        typedef typename node_type::callback_type callback_type;
+                size_t j = 0;
+                for (size_t i = 0; i < current->size; ++i)
+                {
+                    if (current->slots[i].id != id)
+                    {
+                        next->slots[j].id = current->slots[i].id;
+                        next->slots[j].callback = current->slots[i].callback;
+                        ++j;
+                    }
+                }
+            }
 
-        CallbackList()
-            : count_(0), head_(nullptr) { };
+            publish(next);
 
-        ~CallbackList()
+            return true;
+        }
+
+        unsigned debug_count()
         {
-            if (!head_)
-                return;
+            return count();
+        }
 
-            node_type* node = head_;
-            while(node->next_ != head_)
-            {
-                node->next_->remove_self();
-            }
-            head_->dec_reference();
-            head_->dec_reference();
+        unsigned int count() const
+        {
+            return count_.load();
         }
 
-        size_t add(const callback_type& cb)
+        void invoke(Signature... sig)
         {
-            node_type* node = new node_type(cb);
+            invoke_guard guard(activeInvokes_);
 
-            if (!head_)
-            {
-                head_ = node;
-                head_->inc_reference();
-                // set up as ring list
-                head_->next_ = head_;
-                head_->prev_ = head_;
-            }
-            else
-            {
-                node->prev_ = head_->prev_;
-                node->next_ = head_;
+            slot_array* current = slots_.load();
+            if (!current)
+                return;
 
-                if (head_->prev_)
+            for (size_t i = 0; i < current->size; ++i)
+            {
+                slot& s = current->slots[i];
+                if (s.enabled.load(std::memory_order_acquire))
                 {
-                    head_->prev_->next_ = node;
+                    s.callback(sig...);
                 }
-
-                head_->prev_ = node;
             }
-
-            count_++;
-
-            return size_t(node);
         }
 
-        bool remove(size_t id)
+    private:
+        struct slot
         {
-            if (!head_)
-                return false;
+            size_t id{0};
+            callback_type callback;
+            std::atomic<bool> enabled{true};
+        };
 
-            if (size_t(head_) == id)
+        struct slot_array
+        {
+            slot_array(size_t count)
+                : size(count), slots(new slot[count])
+            {}
+
+            bool contains(size_t id) const
             {
-                head_->deactivate();
-                count_--;
-                return true;
+                for (size_t i = 0; i < size; ++i)
+                {
+                    if (slots[i].id == id)
+                        return true;
+                }
+                return false;
             }
 
-            for (node_type* node = head_->next_ ? head_->next_ : head_;
-                 node != head_;
-                 node = node->next_)
+            void disable(size_t id)
             {
-                if (id == size_t(node))
+                for (size_t i = 0; i < size; ++i)
                 {
-                    node->remove_self();
-                    count_--;
-                    return true;
+                    if (slots[i].id == id)
+                    {
+                        slots[i].enabled.store(false, std::memory_order_release);
+                    }
                 }
             }
 
-            return false;
-        }
+            const size_t size;
+            std::unique_ptr<slot[]> slots;
+        };
 
-        unsigned debug_count()
+        struct invoke_guard
         {
-            if (!head_)
-                return 0;
+            invoke_guard(std::atomic<unsigned>& active)
+                : active_(active)
+            {
+                ++active_;
+            }
 
-            unsigned count = 0;
-            for (node_type* node = head_->next_ ? head_->next_ : head_;
-                 node != head_;
-                 node = node->next_)
+            ~invoke_guard()
             {
-                count++;
+                --active_;
             }
 
-            count++;
+            std::atomic<unsigned>& active_;
+        };
 
-            return count;
-        }
-        unsigned int& count()
+        //writeMutex_ must be held
+        void publish(slot_array* next)
         {
-            return count_;
-        }
+            slot_array* previous = slots_.exchange(next);
+            count_ = next ? next->size : 0;
 
-        void invoke(Signature... sig)
-        {
-            if (!head_)
-                return;
+            if (previous)
+            {
+                retired_.push_back(previous);
+            }
 
-            node_type* node = head_;
-            node->inc_reference();
-            do
+            //an invoke that started before the exchange may still be reading a retired array.
+            //one that starts after it can only see the new array.
+            if (activeInvokes_.load() == 0)
             {
-                if (node->callback_ != nullptr)
+                for (slot_array* retired : retired_)
                 {
-                    node->callback_(sig...);
+                    delete retired;
                 }
-                node_type* prev = node;
-                node = node->next_;
-                node->inc_reference();
-                prev->dec_reference();
-            } while (node != head_);
-            node->dec_reference();
+                retired_.clear();
+            }
         }
 
-    private:
+        std::atomic<slot_array*> slots_{nullptr};
+        std::atomic<unsigned> activeInvokes_{0};
+        std::atomic<unsigned> count_{0};
 
-        unsigned int count_;
-        node_type* head_;
+        std::mutex writeMutex_;
+        std::vector<slot_array*> retired_;
+        size_t nextId_{1};
     };
 
     template<typename... Args>
@@ -218,7 +240,7 @@ namespace astra {
 
         signal()
             : callbackList_() { }
-        unsigned int& slot_count()
+        unsigned int slot_count() const
         {
             return callbackList_.count();
         }
@@ -250,7 +272,7 @@ namespace astra {
 
         signal()
             : callbackList_() { }
-        unsigned int& slot_count()
+        unsigned int slot_count() const
         {
             return callbackList_.count();
         }
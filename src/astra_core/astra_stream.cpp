@@ -47,6 +47,11 @@ namespace astra {
     stream_connection* stream::create_connection()
     {
         connection_ptr conn(new stream_connection(this));
+        if (!conn->tracked_handle())
+        {
+            LOG_WARN("astra.stream", "no handle for a new connection to stream %u", get_description().type);
+            return nullptr;
+        }
 
         stream_connection* rawPtr = conn.get();
 
@@ -122,6 +127,10 @@ namespace astra {
             {
                 connection->set_bin(nullptr);
             }
+
+            //the plugin that registers the stream next marks its own
+            invalidate_parameters();
+            cacheableParameters_.clear();
         }
     }
 
@@ -131,7 +140,10 @@ namespace astra {
                                astra_parameter_data_t inData)
     {
         if (is_available())
+        {
             on_set_parameter(connection, id, inByteLength, inData);
+            invalidate_parameters();
+        }
     }
 
     void stream::get_parameter(stream_connection* connection,
@@ -149,6 +161,63 @@ namespace astra {
                         astra_parameter_bin_t& parameterBin)
     {
         if (is_available())
+        {
             on_invoke(connection, commandId, inByteLength, inData, parameterBin);
+            invalidate_parameters();
+        }
+    }
+
+    void stream::set_parameter_cacheable(astra_parameter_id id, bool cacheable)
+    {
+        auto it = std::find(cacheableParameters_.begin(), cacheableParameters_.end(), id);
+
+        if (cacheable && it == cacheableParameters_.end())
+        {
+            cacheableParameters_.push_back(id);
+        }
+        else if (!cacheable && it != cacheableParameters_.end())
+        {
+            invalidate_parameters();
+            cacheableParameters_.erase(it);
+        }
+    }
+
+    bool stream::is_parameter_cacheable(astra_parameter_id id) const
+    {
+        return std::find(cacheableParameters_.begin(), cacheableParameters_.end(), id)
+            != cacheableParameters_.end();
+    }
+
+    void stream::invalidate_parameters()
+    {
+        if (cacheableParameters_.empty())
+            return;
+
+        for (auto& connection : connections_)
+        {
+            connection->invalidate_parameters();
+        }
+    }
+
+    void stream::set_compute_callback(stream_compute_callback_t callback,
+                                      void* clientTag,
+                                      plugin_update_lock_ptr updateLock)
+    {
+        LOG_DEBUG("astra.stream", "%p %s on-demand frames", this, callback != nullptr ? "enabling" : "disabling");
+
+        computeCallback_ = callback;
+        computeClientTag_ = clientTag;
+        computeUpdateLock_ = callback != nullptr ? std::move(updateLock) : nullptr;
+    }
+
+    void stream::compute_frame(astra_frame_t* frame)
+    {
+        if (computeCallback_ == nullptr)
+            return;
+
+        LOG_TRACE("astra.stream", "%p computing frame index: %d", this, frame->frameIndex);
+
+        plugin_call_guard guard(computeUpdateLock_);
+        computeCallback_(computeClientTag_, get_handle(), frame);
     }
 }
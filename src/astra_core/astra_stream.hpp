@@ -38,6 +38,7 @@ namespace astra {
         stream& operator=(const stream& stream) = delete;
         stream(const stream& stream) = delete;
 
+        //nullptr if the registry is full
         stream_connection* create_connection();
         void destroy_connection(stream_connection* connection);
 
@@ -78,11 +79,28 @@ namespace astra {
 
         bool has_connections() { return connections_.size() > 0; }
 
+        //results of cacheable parameters are kept by each connection until
+        //the plugin invalidates them or a client sets a parameter or invokes
+        //a command on the stream
+        void set_parameter_cacheable(astra_parameter_id id, bool cacheable);
+        bool is_parameter_cacheable(astra_parameter_id id) const;
+        void invalidate_parameters();
+
         void set_listener(stream_listener* listener)
         {
             listener_ = listener;
         }
 
+        //on-demand streams publish frame headers only. the producer's callback
+        //fills a frame's data the first time a reader asks for it, under the
+        //core mutex. they aren't exported to shared memory, which publishes
+        //frames before that happens.
+        void set_compute_callback(stream_compute_callback_t callback,
+                                  void* clientTag,
+                                  plugin_update_lock_ptr updateLock = nullptr);
+        bool is_computed_on_demand() const { return computeCallback_ != nullptr; }
+        void compute_frame(astra_frame_t* frame);
+
     private:
         void disconnect_connections(stream_bin* bin);
 
@@ -91,6 +109,12 @@ namespace astra {
 
         connection_vector connections_;
         stream_listener* listener_{nullptr};
+
+        std::vector<astra_parameter_id> cacheableParameters_;
+
+        stream_compute_callback_t computeCallback_{nullptr};
+        void* computeClientTag_{nullptr};
+        plugin_update_lock_ptr computeUpdateLock_;
     };
 }
 
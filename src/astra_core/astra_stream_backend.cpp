@@ -21,21 +21,24 @@
 
 namespace astra {
 
-    void stream_backend::set_callbacks(const stream_callbacks_t& callbacks)
+    void stream_backend::set_callbacks(const stream_callbacks_t& callbacks,
+                                       plugin_update_lock_ptr updateLock)
     {
         callbacks_ = astra::make_unique<stream_callbacks_t>(callbacks);
+        updateLock_ = std::move(updateLock);
         on_availability_changed();
     }
 
     void stream_backend::clear_callbacks()
     {
         callbacks_.reset();
+        updateLock_ = nullptr;
         on_availability_changed();
     }
 
-    stream_bin* stream_backend::create_bin(size_t bufferLengthInBytes)
+    stream_bin* stream_backend::create_bin(size_t bufferLengthInBytes, size_t bufferCount)
     {
-        bin_ptr bin(astra::make_unique<stream_bin>(bufferLengthInBytes));
+        bin_ptr bin(astra::make_unique<stream_bin>(bufferLengthInBytes, bufferCount));
         stream_bin* rawPtr = bin.get();
 
         bins_.push_back(std::move(bin));
@@ -63,6 +66,8 @@ namespace astra {
 
     void stream_backend::on_connection_created(stream_connection* connection, astra_stream_t stream)
     {
+        plugin_call_guard guard(updateLock_);
+
         if (callbacks_ &&
             callbacks_->connection_added_callback)
             callbacks_->connection_added_callback(callbacks_->context,
@@ -72,6 +77,8 @@ namespace astra {
 
     void stream_backend::on_connection_started(stream_connection* connection, astra_stream_t stream)
     {
+        plugin_call_guard guard(updateLock_);
+
         if (callbacks_ &&
             callbacks_->connection_started_callback)
             callbacks_->connection_started_callback(callbacks_->context,
@@ -82,6 +89,8 @@ namespace astra {
 
     void stream_backend::on_connection_stopped(stream_connection* connection, astra_stream_t stream)
     {
+        plugin_call_guard guard(updateLock_);
+
         if (callbacks_ &&
             callbacks_->connection_stopped_callback)
             callbacks_->connection_stopped_callback(callbacks_->context,
@@ -92,6 +101,8 @@ namespace astra {
 
     void stream_backend::on_connection_destroyed(stream_connection* connection, astra_stream_t stream)
     {
+        plugin_call_guard guard(updateLock_);
+
         if (callbacks_ &&
             callbacks_->connection_removed_callback)
         {
@@ -109,6 +120,7 @@ namespace astra {
                                          size_t inByteLength,
                                          astra_parameter_data_t inData)
     {
+        plugin_call_guard guard(updateLock_);
 
         if (callbacks_ &&
             callbacks_->set_parameter_callback != nullptr)
@@ -125,6 +137,8 @@ namespace astra {
                                          astra_parameter_id id,
                                          astra_parameter_bin_t& parameterBin)
     {
+        plugin_call_guard guard(updateLock_);
+
         if (callbacks_ &&
             callbacks_->get_parameter_callback != nullptr)
         {
@@ -141,6 +155,8 @@ namespace astra {
                                   astra_parameter_data_t inData,
                                   astra_parameter_bin_t& parameterBin)
     {
+        plugin_call_guard guard(updateLock_);
+
         if (callbacks_ &&
             callbacks_->invoke_callback != nullptr)
         {
@@ -20,6 +20,7 @@
 #include <astra_core/capi/astra_types.h>
 #include <astra_core/capi/plugins/astra_plugin.h>
 #include "astra_stream_connection.hpp"
+#include "astra_plugin_update_lock.hpp"
 #include <vector>
 #include <memory>
 
@@ -38,14 +39,17 @@ namespace astra {
             bins_.clear();
         }
 
-        stream_bin* create_bin(size_t byteLength);
+        stream_bin* create_bin(size_t byteLength, size_t bufferCount);
         void destroy_bin(stream_bin* bin);
+        size_t bin_count() const { return bins_.size(); }
 
         const astra_stream_desc_t& get_description() const { return description_; }
 
         bool is_available() { return callbacks_ != nullptr; }
 
-        void set_callbacks(const stream_callbacks_t& callbacks);
+        //callbacks are made holding the owning plugin's update lock, if given
+        void set_callbacks(const stream_callbacks_t& callbacks,
+                           plugin_update_lock_ptr updateLock = nullptr);
         void clear_callbacks();
 
     protected:
@@ -80,6 +84,7 @@ namespace astra {
 
         astra_stream_desc_t description_;
         std::unique_ptr<stream_callbacks_t> callbacks_{nullptr};
+        plugin_update_lock_ptr updateLock_;
 
         bin_list bins_;
     };
@@ -16,14 +16,33 @@
 // Be excellent to each other.
 #include "astra_stream_bin.hpp"
 #include <cassert>
+#include <cstring>
 #include <astra_core/capi/plugins/astra_plugin.h>
 
 namespace astra {
 
-    stream_bin::stream_bin(size_t bufferLengthInBytes)
+    stream_bin::stream_bin(size_t bufferLengthInBytes, size_t bufferCount)
         : bufferSize_(bufferLengthInBytes)
     {
-        LOG_TRACE("stream_bin", "Created stream_bin %x", this);
+        assert(bufferCount >= MIN_BUFFER_COUNT);
+        if (bufferCount < MIN_BUFFER_COUNT)
+        {
+            bufferCount = MIN_BUFFER_COUNT;
+        }
+
+        LOG_TRACE("stream_bin", "Created stream_bin %x with %u buffers", this, bufferCount);
+
+        buffers_.resize(bufferCount);
+        bufferStorage_.resize(bufferCount);
+        bufferTimestamps_.resize(bufferCount, 0);
+        captureTimestamps_.resize(bufferCount, 0);
+        maxReadyCount_ = bufferCount - 2;
+
+        for(size_t i = bufferCount - 1; i > backBufferIndex_; --i)
+        {
+            freeBufferIndices_.push_back(i);
+        }
+
         init_buffers(bufferLengthInBytes);
     }
 
@@ -35,37 +54,133 @@ namespace astra {
 
     void stream_bin::init_buffers(size_t bufferLengthInBytes)
     {
-        for(int i = 0; i < BUFFER_COUNT; ++i)
+        for (size_t i = 0; i < buffers_.size(); ++i)
         {
-            init_buffer(buffers_[i], bufferLengthInBytes);
+            init_buffer(i, bufferLengthInBytes);
         }
+
+        //pooled buffers keep whatever frame was last written to them, maybe
+        //another stream's. only the initial front buffer can reach a client
+        //before a producer writes it, the others are written before they're
+        //swapped to the front.
+        std::memset(buffers_[frontBufferIndex_].data, 0, bufferLengthInBytes);
     }
 
     void stream_bin::deinit_buffers()
     {
-        for(int i = 0; i < BUFFER_COUNT; ++i)
+        for (size_t i = 0; i < buffers_.size(); ++i)
         {
-            deinit_buffer(buffers_[i]);
+            deinit_buffer(i);
         }
     }
 
-    void stream_bin::init_buffer(astra_frame_t& frame, size_t bufferLengthInBytes)
+    void stream_bin::init_buffer(size_t bufferIndex, size_t bufferLengthInBytes)
     {
+        astra_frame_t& frame = buffers_[bufferIndex];
+        bufferStorage_[bufferIndex] = frame_buffer_pool::shared().acquire(bufferLengthInBytes);
+
         frame.byteLength = bufferLengthInBytes;
         frame.frameIndex = -1;
-        frame.data = new uint8_t[bufferLengthInBytes];
-        memset(frame.data, 0, bufferLengthInBytes);
+        frame.data = bufferStorage_[bufferIndex].get();
     }
 
-    void stream_bin::deinit_buffer(astra_frame_t& frame)
+    void stream_bin::deinit_buffer(size_t bufferIndex)
     {
-        uint8_t* data = static_cast<uint8_t*>(frame.data);
-        delete[] data;
+        astra_frame_t& frame = buffers_[bufferIndex];
+        bufferStorage_[bufferIndex] = nullptr;
+
         frame.data = nullptr;
         frame.frameIndex = -1;
         frame.byteLength = 0;
     }
 
+    void stream_bin::replace_retained_buffer(size_t bufferIndex)
+    {
+        //only retain_front_buffer() adds owners and it runs under bufferMutex_,
+        //so a stale count can only overstate them
+        if (bufferStorage_[bufferIndex].use_count() <= 1)
+        {
+            return;
+        }
+
+        LOG_TRACE("stream_bin", "%x replacing retained buffer frame index: %d",
+            this,
+            buffers_[bufferIndex].frameIndex);
+
+        bufferStorage_[bufferIndex] = acquire_storage();
+        buffers_[bufferIndex].data = bufferStorage_[bufferIndex].get();
+    }
+
+    frame_buffer_pool::buffer_ptr stream_bin::acquire_storage()
+    {
+        if (sharedRing_)
+        {
+            frame_buffer_pool::buffer_ptr slot = sharedRing_->acquire();
+            if (slot)
+            {
+                return slot;
+            }
+
+            //every slot is retained. frames written to a pooled buffer
+            //aren't published, clients skip them.
+            LOG_DEBUG("stream_bin", "%x no free shared memory slot", this);
+        }
+
+        return frame_buffer_pool::shared().acquire(bufferSize_);
+    }
+
+    bool stream_bin::export_to_shared_memory(const std::string& uri, astra_stream_desc_t description)
+    {
+        std::lock_guard<std::mutex> lock(bufferMutex_);
+
+        assert(!sharedRing_);
+
+        //as many spare slots as the pool keeps for retained buffers
+        sharedRing_ = shm_frame_ring::create(uri, description, bufferSize_, buffers_.size() * 2);
+        if (!sharedRing_)
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < buffers_.size(); ++i)
+        {
+            bufferStorage_[i] = sharedRing_->acquire();
+            buffers_[i].data = bufferStorage_[i].get();
+        }
+
+        begin_shared_write(backBufferIndex_);
+
+        return true;
+    }
+
+    void stream_bin::begin_shared_write(size_t bufferIndex)
+    {
+        if (!sharedRing_)
+        {
+            return;
+        }
+
+        uint32_t slot = sharedRing_->slot_of(bufferStorage_[bufferIndex].get());
+        if (slot != shm::NO_SLOT)
+        {
+            sharedRing_->begin_write(slot);
+        }
+    }
+
+    void stream_bin::publish_front_buffer()
+    {
+        if (!sharedRing_)
+        {
+            return;
+        }
+
+        uint32_t slot = sharedRing_->slot_of(bufferStorage_[frontBufferIndex_].get());
+        if (slot != shm::NO_SLOT)
+        {
+            sharedRing_->publish(slot, *get_frontBuffer(), bufferTimestamps_[frontBufferIndex_]);
+        }
+    }
+
     astra_callback_id_t stream_bin::register_front_buffer_ready_callback(FrontBufferReadyCallback callback)
     {
         return frontBufferReadySignal_ += callback;
@@ -82,123 +197,212 @@ namespace astra {
         return &buffers_[frontBufferIndex_];
     }
 
-    astra_frame_t* stream_bin::get_middleBuffer()
+    uint64_t stream_bin::front_timestamp()
+    {
+        std::lock_guard<std::mutex> lock(bufferMutex_);
+        return bufferTimestamps_[frontBufferIndex_];
+    }
+
+    void stream_bin::set_back_buffer_capture_timestamp(uint64_t captureTimestamp)
     {
-        return &buffers_[middleBufferIndex_];
+        std::lock_guard<std::mutex> lock(bufferMutex_);
+        backBufferCaptureTimestamp_ = captureTimestamp;
+    }
+
+    uint64_t stream_bin::front_capture_timestamp()
+    {
+        std::lock_guard<std::mutex> lock(bufferMutex_);
+        return captureTimestamps_[frontBufferIndex_];
+    }
+
+    float stream_bin::frames_per_second() const
+    {
+        uint64_t averagePeriod = averageFramePeriod_.load(std::memory_order_relaxed);
+        if (averagePeriod == 0)
+        {
+            return 0;
+        }
+
+        return 1000000.0f / averagePeriod;
     }
 
     astra_frame_t* stream_bin::lock_front_buffer()
     {
-        LOG_TRACE("stream_bin", "%x locking front buffer. lock count: %u -> %u", this, frontBufferLockCount_, frontBufferLockCount_+1);
+        uint32_t lockCount = frontBufferLockCount_.load();
+        LOG_TRACE("stream_bin", "%x locking front buffer. lock count: %u -> %u", this, lockCount, lockCount+1);
 
+        //the front buffer can't move while it is locked, so nested locks skip the mutex
+        while (lockCount > 0)
+        {
+            if (frontBufferLockCount_.compare_exchange_weak(lockCount, lockCount + 1))
+            {
+                return get_frontBuffer();
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(bufferMutex_);
         ++frontBufferLockCount_;
         return get_frontBuffer();
     }
 
     void stream_bin::unlock_front_buffer()
     {
-        LOG_TRACE("stream_bin", "%x unlocking front buffer. lock count: %u -> %u", this, frontBufferLockCount_, frontBufferLockCount_-1);
-        if (frontBufferLockCount_ == 0)
-        {
-            //TODO: error, logging
-            LOG_WARN("stream_bin", "%x stream_bin unlocked too many times!", this);
-            assert(frontBufferLockCount_ != 0);
-            return;
-        }
-        --frontBufferLockCount_;
-        if (frontBufferLockCount_ > 0)
+        uint32_t lockCount = frontBufferLockCount_.load();
+        LOG_TRACE("stream_bin", "%x unlocking front buffer. lock count: %u -> %u", this, lockCount, lockCount-1);
+
+        while (lockCount > 1)
         {
-            //can't swap front buffers because there is still an outstanding lock
-            return;
+            if (frontBufferLockCount_.compare_exchange_weak(lockCount, lockCount - 1))
+            {
+                //can't swap front buffers because there is still an outstanding lock
+                return;
+            }
         }
-        LOG_TRACE("stream_bin", "%x unlock pre indices: f: %d m: %d b: %d",
-            this,
-            get_frontBuffer()->frameIndex,
-            get_middleBuffer()->frameIndex,
-            get_backBuffer()->frameIndex);
-        astra_frame_index_t frontFrameIndex = get_frontBuffer()->frameIndex;
-        astra_frame_index_t middleFrameIndex = get_middleBuffer()->frameIndex;
 
-        //if the middle buffer's frameIndex is newer, signal readiness
-        if (middleFrameIndex != -1 && middleFrameIndex > frontFrameIndex)
+        astra_frame_index_t newFrameIndex = -1;
         {
-            //back buffer is locked.
-            //swap front and middle buffers only
-            size_t oldFrontBufferIndex = frontBufferIndex_;
-            frontBufferIndex_ = middleBufferIndex_;
-            middleBufferIndex_ = oldFrontBufferIndex;
+            std::lock_guard<std::mutex> lock(bufferMutex_);
 
-
-            LOG_TRACE("stream_bin", "%x unlock front/mid indices: f: %d m: %d b: %d",
+            if (frontBufferLockCount_.load() == 0)
+            {
+                //TODO: error, logging
+                LOG_WARN("stream_bin", "%x stream_bin unlocked too many times!", this);
+                assert(frontBufferLockCount_ != 0);
+                return;
+            }
+            if (--frontBufferLockCount_ > 0)
+            {
+                //another thread locked the front buffer again in the meantime
+                return;
+            }
+            LOG_TRACE("stream_bin", "%x unlock pre indices: f: %d ready: %u",
                 this,
                 get_frontBuffer()->frameIndex,
-                get_middleBuffer()->frameIndex,
-                get_backBuffer()->frameIndex);
+                readyBufferIndices_.size());
 
-            raiseFrameReadySignal();
+            //present the oldest frame that completed while the front buffer was locked
+            newFrameIndex = advance_front_buffer();
         }
+
+        raiseFrameReadySignal(newFrameIndex);
+    }
+
+    void stream_bin::retain_front_buffer(astra_frame_t& frame, frame_buffer_pool::buffer_ptr& storage)
+    {
+        std::lock_guard<std::mutex> lock(bufferMutex_);
+
+        assert(is_front_buffer_locked());
+
+        frame = *get_frontBuffer();
+        storage = bufferStorage_[frontBufferIndex_];
     }
 
     astra_frame_t* stream_bin::cycle_buffers()
     {
-        LOG_TRACE("stream_bin", "%x cycling buffer. lock count: %u produced frame index: %d",
-                            this, frontBufferLockCount_, get_backBuffer()->frameIndex);
-        LOG_TRACE("stream_bin", "%x cycle pre indices: f: %d m: %d b: %d",
-            this,
-            get_frontBuffer()->frameIndex,
-            get_middleBuffer()->frameIndex,
-            get_backBuffer()->frameIndex);
-        if (is_front_buffer_locked())
+        astra_frame_index_t newFrameIndex = -1;
+        astra_frame_t* backBuffer = nullptr;
         {
-            //Can't change front buffer.
-            //swap back and middle buffers only
-            size_t oldBackBufferIndex = backBufferIndex_;
-            backBufferIndex_ = middleBufferIndex_;
-            middleBufferIndex_ = oldBackBufferIndex;
+            std::lock_guard<std::mutex> lock(bufferMutex_);
 
-            LOG_TRACE("stream_bin", "%x cycle back/mid indices: f: %d m: %d b: %d",
+            LOG_TRACE("stream_bin", "%x cycling buffer. lock count: %u produced frame index: %d",
+                                this, frontBufferLockCount_.load(), get_backBuffer()->frameIndex);
+            LOG_TRACE("stream_bin", "%x cycle pre indices: f: %d b: %d ready: %u",
                 this,
                 get_frontBuffer()->frameIndex,
-                get_middleBuffer()->frameIndex,
-                get_backBuffer()->frameIndex);
-        }
-        else
-        {
-#ifdef DEBUG
-            astra_frame_index_t oldFrameIndex = get_frontBuffer()->frameIndex;
-#endif
-            //The rare case where neither front or back buffers are locked.
-            //Rotate back buffer directly to front buffer. (Ignore middle.)
-            size_t oldFrontBufferIndex = frontBufferIndex_;
-            frontBufferIndex_ = backBufferIndex_;
-            backBufferIndex_ = oldFrontBufferIndex;
-
-#ifdef DEBUG
-            astra_frame_index_t newFrameIndex = get_frontBuffer()->frameIndex;
-            if (frameIndex != -1 && newFrameIndex <= oldFrameIndex)
+                get_backBuffer()->frameIndex,
+                readyBufferIndices_.size());
+
+            ++framesProduced_;
+
+            const uint64_t now = stats_clock_microseconds();
+            bufferTimestamps_[backBufferIndex_] = now;
+            captureTimestamps_[backBufferIndex_] = backBufferCaptureTimestamp_ != 0 ? backBufferCaptureTimestamp_ : now;
+            backBufferCaptureTimestamp_ = 0;
+            record_frame_period(now);
+
+            enqueue_back_buffer();
+
+            if (!is_front_buffer_locked())
             {
-                LOG_WARN("stream_bin", "%x buffers cycled with out-of-order frame indices: %d->%d",
-                                this, oldFrameIndex, newFrameIndex);
-                assert(frameIndex > oldFrameIndex);
+                newFrameIndex = advance_front_buffer();
             }
-#endif
 
-            LOG_TRACE("stream_bin", "%x cycle front/back indices: f: %d m: %d b: %d",
-                this,
-                get_frontBuffer()->frameIndex,
-                get_middleBuffer()->frameIndex,
-                get_backBuffer()->frameIndex);
+            backBuffer = get_backBuffer();
+        }
+
+        //raised without bufferMutex_ held, handlers may lock the new front buffer
+        raiseFrameReadySignal(newFrameIndex);
+
+        return backBuffer;
+    }
+
+    void stream_bin::record_frame_period(uint64_t now)
+    {
+        if (lastCycleTimestamp_ != 0)
+        {
+            const uint64_t period = now - lastCycleTimestamp_;
+            framePeriod_.record(period);
+
+            //weights the last ~8 frames
+            uint64_t averagePeriod = averageFramePeriod_.load(std::memory_order_relaxed);
+            averagePeriod = averagePeriod == 0 ? period : (averagePeriod * 7 + period) / 8;
+            averageFramePeriod_.store(averagePeriod, std::memory_order_relaxed);
+        }
+
+        lastCycleTimestamp_ = now;
+    }
 
-            raiseFrameReadySignal();
+    void stream_bin::enqueue_back_buffer()
+    {
+        if (readyBufferIndices_.size() >= maxReadyCount_)
+        {
+            //ring is full, drop the oldest ready frame to make room
+            size_t droppedBufferIndex = readyBufferIndices_.front();
+            readyBufferIndices_.pop_front();
+            freeBufferIndices_.push_back(droppedBufferIndex);
+            ++framesOverwritten_;
+
+            LOG_TRACE("stream_bin", "%x overwrote ready frame index: %d",
+                this,
+                buffers_[droppedBufferIndex].frameIndex);
         }
 
-        return get_backBuffer();
+        assert(!freeBufferIndices_.empty());
+
+        readyBufferIndices_.push_back(backBufferIndex_);
+        backBufferIndex_ = freeBufferIndices_.back();
+        freeBufferIndices_.pop_back();
+
+        begin_shared_write(backBufferIndex_);
     }
 
-    void stream_bin::raiseFrameReadySignal()
+    astra_frame_index_t stream_bin::advance_front_buffer()
     {
-        astra_frame_index_t frameIndex = get_frontBuffer()->frameIndex;
+        if (readyBufferIndices_.empty())
+        {
+            return -1;
+        }
 
+        //the old front goes back to the producer, retained data must not
+        replace_retained_buffer(frontBufferIndex_);
+        freeBufferIndices_.push_back(frontBufferIndex_);
+        frontBufferIndex_ = readyBufferIndices_.front();
+        readyBufferIndices_.pop_front();
+        frontBufferComputed_ = false;
+
+        publish_front_buffer();
+
+        //the back buffer belongs to the producer, only log what this thread may read
+        LOG_TRACE("stream_bin", "%x advanced front indices: f: %d ready: %u",
+            this,
+            get_frontBuffer()->frameIndex,
+            readyBufferIndices_.size());
+
+        return get_frontBuffer()->frameIndex;
+    }
+
+    void stream_bin::raiseFrameReadySignal(astra_frame_index_t frameIndex)
+    {
         if (frameIndex != -1)
         {
             frontBufferReadySignal_.raise(this, frameIndex);
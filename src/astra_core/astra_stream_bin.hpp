@@ -18,11 +18,19 @@
 #define ASTRA_STREAM_BIN_H
 
 #include <exception>
-#include <array>
+#include <vector>
+#include <deque>
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include <string>
 #include <astra_core/capi/astra_types.h>
 #include "astra_signal.hpp"
 #include <astra_core/capi/plugins/astra_plugin.h>
 #include "astra_logger.hpp"
+#include "astra_histogram.hpp"
+#include "astra_frame_buffer_pool.hpp"
+#include "astra_shm_frame_ring.hpp"
 
 namespace astra {
 
@@ -31,7 +39,11 @@ namespace astra {
     public:
         using FrontBufferReadyCallback = std::function<void(stream_bin*,astra_frame_index_t)>;
 
-        stream_bin(size_t bufferSizeInBytes);
+        //front, back and at least one ready frame
+        const static size_t MIN_BUFFER_COUNT = 3;
+        const static size_t DEFAULT_BUFFER_COUNT = 3;
+
+        stream_bin(size_t bufferSizeInBytes, size_t bufferCount = DEFAULT_BUFFER_COUNT);
         ~stream_bin();
 
         stream_bin(const stream_bin& bin) = delete;
@@ -45,9 +57,28 @@ namespace astra {
 
         astra_frame_t* cycle_buffers();
 
+        //front buffer locks may be taken and released from any thread.
+        //nested locks only touch the atomic lock count, the first lock and
+        //the last unlock synchronize with cycle_buffers() on bufferMutex_.
         astra_frame_t* lock_front_buffer();
         void unlock_front_buffer();
 
+        //shares the locked front buffer's data with the caller. the bin
+        //swaps in a pooled buffer once the front moves on, so the retained
+        //data is never written again and needs no copy.
+        void retain_front_buffer(astra_frame_t& frame, frame_buffer_pool::buffer_ptr& storage);
+
+        //set once an on-demand stream has filled the locked front buffer,
+        //cleared whenever a new front buffer is presented
+        bool is_front_buffer_computed() const { return frontBufferComputed_; }
+        void set_front_buffer_computed() { frontBufferComputed_ = true; }
+
+        //moves the buffers into a shared memory segment other processes can
+        //map, and publishes each new front buffer there. call before the
+        //first frame is written, buffer contents are not carried over.
+        bool export_to_shared_memory(const std::string& uri, astra_stream_desc_t description);
+        bool is_exported() const { return sharedRing_ != nullptr; }
+
         astra_callback_id_t register_front_buffer_ready_callback(FrontBufferReadyCallback callback);
         void unregister_front_buffer_ready_callback(astra_callback_id_t& callbackId);
 
@@ -74,6 +105,25 @@ namespace astra {
         bool is_active() { return activeCount_ > 0; }
         bool has_clients_connected() { return connectedCount_ > 0; }
         size_t bufferSize() { return bufferSize_; }
+        size_t buffer_count() const { return buffers_.size(); }
+
+        //total frames cycled out of the back buffer
+        uint64_t frames_produced() const { return framesProduced_; }
+        //ready frames dropped because the ring was full
+        uint64_t frames_overwritten() const { return framesOverwritten_; }
+
+        //steady clock time in microseconds when the front buffer was cycled in
+        uint64_t front_timestamp();
+
+        //steady clock time in microseconds when the back buffer's frame was
+        //captured, as reported by the plugin before cycling it. frames without
+        //one take their cycle time.
+        void set_back_buffer_capture_timestamp(uint64_t captureTimestamp);
+        uint64_t front_capture_timestamp();
+
+        //time between cycle_buffers() calls
+        const histogram& frame_period() const { return framePeriod_; }
+        float frames_per_second() const;
 
         astra_bin_t get_handle() { return reinterpret_cast<astra_bin_t>(this); }
 
@@ -81,25 +131,52 @@ namespace astra {
             { return reinterpret_cast<stream_bin*>(bin); }
 
     private:
-        inline bool is_front_buffer_locked() { return frontBufferLockCount_ > 0; }
+        inline bool is_front_buffer_locked() { return frontBufferLockCount_.load() > 0; }
         void init_buffers(size_t bufferLengthInBytes);
         void deinit_buffers();
-        void init_buffer(astra_frame_t& frame, size_t bufferLengthInBytes);
-        void deinit_buffer(astra_frame_t& frame);
+        void init_buffer(size_t bufferIndex, size_t bufferLengthInBytes);
+        void deinit_buffer(size_t bufferIndex);
+        void replace_retained_buffer(size_t bufferIndex);
+        frame_buffer_pool::buffer_ptr acquire_storage();
+        void begin_shared_write(size_t bufferIndex);
+        void publish_front_buffer();
         astra_frame_t* get_frontBuffer();
-        astra_frame_t* get_middleBuffer();
-        void raiseFrameReadySignal();
+        void enqueue_back_buffer();
+        void record_frame_period(uint64_t now);
+        astra_frame_index_t advance_front_buffer();
+        void raiseFrameReadySignal(astra_frame_index_t frameIndex);
 
         size_t bufferSize_{0};
 
-        size_t frontBufferIndex_{0};
-        size_t middleBufferIndex_{1};
-        size_t backBufferIndex_{2};
-
-        uint32_t frontBufferLockCount_{0};
-
-        const static size_t BUFFER_COUNT = 3;
-        astra_frame_t buffers_[BUFFER_COUNT];
+        std::mutex bufferMutex_;
+        std::atomic<size_t> frontBufferIndex_{0};
+        size_t backBufferIndex_{1};
+
+        //completed frames waiting behind the front buffer, oldest first
+        std::deque<size_t> readyBufferIndices_;
+        std::vector<size_t> freeBufferIndices_;
+        size_t maxReadyCount_{1};
+
+        std::atomic<uint32_t> frontBufferLockCount_{0};
+        std::atomic<bool> frontBufferComputed_{false};
+
+        std::vector<astra_frame_t> buffers_;
+        //owns each buffer's data, shared with retained frames
+        std::vector<frame_buffer_pool::buffer_ptr> bufferStorage_;
+        //set when exported, buffers come from its slots before the pool
+        std::shared_ptr<shm_frame_ring> sharedRing_;
+        std::vector<uint64_t> bufferTimestamps_;
+        std::vector<uint64_t> captureTimestamps_;
+        //written by the producer for the back buffer, 0 when not reported
+        uint64_t backBufferCaptureTimestamp_{0};
+
+        std::atomic<uint64_t> framesProduced_{0};
+        std::atomic<uint64_t> framesOverwritten_{0};
+
+        histogram framePeriod_;
+        uint64_t lastCycleTimestamp_{0};
+        //moving average, written under bufferMutex_
+        std::atomic<uint64_t> averageFramePeriod_{0};
 
         int connectedCount_{0};
         int activeCount_{0};
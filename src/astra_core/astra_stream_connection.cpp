@@ -28,7 +28,7 @@ namespace astra {
         assert (stream != nullptr);
 
         connection_.handle =
-            reinterpret_cast<astra_streamconnection_handle_t>(this);
+            reinterpret_cast<astra_streamconnection_handle_t>(tracked_handle());
 
         connection_.desc = stream->get_description();
 
@@ -43,6 +43,7 @@ namespace astra {
     {
         clear_pending_parameter_result();
         set_bin(nullptr);
+        log_frame_counters();
     }
 
     astra_bin_t stream_connection::get_bin_handle()
@@ -57,6 +58,63 @@ namespace astra {
         }
     }
 
+    frame_counters stream_connection::get_frame_counters() const
+    {
+        frame_counters counters = unlinkedCounters_;
+
+        if (bin_ != nullptr)
+        {
+            counters.produced += bin_->frames_produced() - binProducedBase_;
+            counters.overwritten += bin_->frames_overwritten() - binOverwrittenBase_;
+        }
+
+        counters.delivered += framesDelivered_;
+        if (framesPresented_ > framesDelivered_)
+        {
+            counters.skipped += framesPresented_ - framesDelivered_;
+        }
+
+        return counters;
+    }
+
+    void stream_connection::get_stats(astra_stream_stats_t& stats) const
+    {
+        frame_counters counters = get_frame_counters();
+        stats.framesProduced = counters.produced;
+        stats.framesOverwritten = counters.overwritten;
+        stats.framesDelivered = counters.delivered;
+        stats.framesSkipped = counters.skipped;
+
+        if (bin_ != nullptr)
+        {
+            stats.framesPerSecond = bin_->frames_per_second();
+            bin_->frame_period().snapshot(stats.framePeriod);
+        }
+        else
+        {
+            histogram empty;
+            stats.framesPerSecond = 0;
+            empty.snapshot(stats.framePeriod);
+        }
+
+        deliveryLatency_.snapshot(stats.deliveryLatency);
+        lockDuration_.snapshot(stats.lockDuration);
+        clientHoldTime_.snapshot(stats.clientHoldTime);
+    }
+
+    void stream_connection::log_frame_counters() const
+    {
+        frame_counters counters = get_frame_counters();
+
+        LOG_DEBUG("astra.stream_connection",
+                  "%p frames produced: %llu delivered: %llu overwritten: %llu skipped: %llu",
+                  this,
+                  static_cast<unsigned long long>(counters.produced),
+                  static_cast<unsigned long long>(counters.delivered),
+                  static_cast<unsigned long long>(counters.overwritten),
+                  static_cast<unsigned long long>(counters.skipped));
+    }
+
     const astra_stream_desc_t& stream_connection::get_description() const
     {
         return stream_->get_description();
@@ -71,37 +129,96 @@ namespace astra {
             return currentFrame_;
         }
 
-        if (is_started() && bin_ != nullptr)
+        std::lock_guard<std::mutex> lock(lockMutex_);
+
+        if (locked_)
         {
-            currentFrame_ = bin_->lock_front_buffer();
+            return currentFrame_;
         }
-        else
+
+        astra_frame_t* frame = nullptr;
+
+        if (is_started() && bin_ != nullptr)
         {
-            currentFrame_ = nullptr;
+            frame = bin_->lock_front_buffer();
+            lockTimestamp_ = stats_clock_microseconds();
+
+            astra_frame_index_t frameIndex = frame->frameIndex;
+            if (frameIndex != -1 && frameIndex != lastDeliveredFrameIndex_)
+            {
+                ++framesDelivered_;
+                lastDeliveredFrameIndex_ = frameIndex;
+
+                //the front buffer can't move while locked
+                deliveryLatency_.record(lockTimestamp_ - bin_->front_timestamp());
+            }
         }
 
+        //publish the frame before the flag so lock-free readers see it
+        currentFrame_ = frame;
         locked_ = true;
 
-        return currentFrame_;
+        return frame;
     }
 
     void stream_connection::unlock()
     {
         LOG_TRACE("astra.stream_connection", "%x unlock", this);
 
-        if (!locked_)
         {
-            LOG_WARN("astra.stream_connection", "%x stream_connection::unlock() not locked", this);
-            assert(locked_);
+            std::lock_guard<std::mutex> lock(lockMutex_);
+
+            if (!locked_)
+            {
+                LOG_WARN("astra.stream_connection", "%x stream_connection::unlock() not locked", this);
+                assert(locked_);
+            }
+
+            if (lockTimestamp_ != 0)
+            {
+                lockDuration_.record(stats_clock_microseconds() - lockTimestamp_);
+                lockTimestamp_ = 0;
+            }
+
+            locked_ = false;
+            currentFrame_ = nullptr;
         }
 
+        //unlocking may present a new front buffer and re-enter lock() from a frame ready handler
         if (is_started() && bin_ != nullptr)
         {
             bin_->unlock_front_buffer();
         }
+    }
+
+    void stream_connection::compute_locked_frame()
+    {
+        astra_frame_t* frame = currentFrame_;
+
+        if (frame == nullptr
+            || frame->frameIndex == -1
+            || bin_ == nullptr
+            || !stream_->is_computed_on_demand()
+            || bin_->is_front_buffer_computed())
+        {
+            return;
+        }
+
+        stream_->compute_frame(frame);
+        bin_->set_front_buffer_computed();
+    }
+
+    bool stream_connection::retain(astra_frame_t& frame, frame_buffer_pool::buffer_ptr& storage)
+    {
+        std::lock_guard<std::mutex> lock(lockMutex_);
+
+        if (!locked_ || currentFrame_ == nullptr || bin_ == nullptr)
+        {
+            return false;
+        }
 
-        currentFrame_ = nullptr;
-        locked_ = false;
+        bin_->retain_front_buffer(frame, storage);
+        return true;
     }
 
     void stream_connection::start()
@@ -140,12 +257,18 @@ namespace astra {
         }
 
         started_ = false;
+
+        log_frame_counters();
     }
 
     void stream_connection::set_bin(stream_bin* bin)
     {
         if (bin_ != nullptr)
         {
+            unlinkedCounters_ = get_frame_counters();
+            framesPresented_ = 0;
+            framesDelivered_ = 0;
+
             bin_->unregister_front_buffer_ready_callback(binFrontBufferReadyCallbackId_);
             bin_->dec_connected();
         }
@@ -154,6 +277,9 @@ namespace astra {
 
         if (bin_ != nullptr)
         {
+            binProducedBase_ = bin_->frames_produced();
+            binOverwrittenBase_ = bin_->frames_overwritten();
+
             bin_->inc_connected();
 
             binFrontBufferReadyCallbackId_ =
@@ -166,6 +292,7 @@ namespace astra {
         assert(bin_ != nullptr);
         assert(bin_ == bin);
 
+        ++framesPresented_;
         frameReadySignal_.raise(this, frameIndex);
     }
 
@@ -231,6 +358,42 @@ namespace astra {
         cache_parameter_bin_token(parameterBinHandle, resultByteLength, token);
     }
 
+    astra_status_t stream_connection::read_parameter(astra_parameter_id id,
+                                                     size_t byteLength,
+                                                     astra_parameter_data_t data)
+    {
+        if (parameterCache_.try_get(id, byteLength, data))
+            return ASTRA_STATUS_SUCCESS;
+
+        const uint64_t invalidations = parameterCache_.invalidations();
+
+        astra_parameter_bin_t parameterBinHandle = nullptr;
+        stream_->get_parameter(this, id, parameterBinHandle);
+
+        parameter_bin* parameterBin = parameter_bin::get_ptr(parameterBinHandle);
+        if (parameterBin == nullptr || parameterBin->byteLength() != byteLength)
+        {
+            LOG_WARN("astra.stream_connection", "%p parameter %d has no result of %u bytes.", this, id, byteLength);
+            if (parameterBin != nullptr)
+            {
+                parameter_bin::release(parameterBin);
+            }
+            std::memset(data, 0, byteLength);
+            return ASTRA_STATUS_INVALID_PARAMETER;
+        }
+
+        std::memcpy(data, parameterBin->data(), byteLength);
+        parameter_bin::release(parameterBin);
+
+        //the plugin may have invalidated its parameters while producing this one
+        if (stream_->is_parameter_cacheable(id) && parameterCache_.invalidations() == invalidations)
+        {
+            parameterCache_.store(id, byteLength, data);
+        }
+
+        return ASTRA_STATUS_SUCCESS;
+    }
+
     void stream_connection::cache_parameter_bin_token(astra_parameter_bin_t parameterBinHandle,
                                                       size_t& resultByteLength,
                                                       astra_result_token_t& token)
@@ -255,7 +418,7 @@ namespace astra {
     {
         if (pendingParameterResult_ != nullptr)
         {
-            delete pendingParameterResult_;
+            parameter_bin::release(pendingParameterResult_);
             pendingParameterResult_ = nullptr;
         }
     }
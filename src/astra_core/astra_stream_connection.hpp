@@ -20,14 +20,30 @@
 #include <astra_core/capi/astra_types.h>
 #include <astra_core/capi/plugins/astra_plugin.h>
 #include "astra_parameter_bin.hpp"
+#include "astra_parameter_cache.hpp"
 #include "astra_stream_bin.hpp"
 #include "astra_logger.hpp"
 #include "astra_registry.hpp"
+#include "astra_histogram.hpp"
+#include <atomic>
+#include <mutex>
 
 namespace astra {
 
     class stream;
 
+    struct frame_counters
+    {
+        //frames produced into the bin while linked
+        uint64_t produced{0};
+        //distinct frames handed to this connection's readers
+        uint64_t delivered{0};
+        //frames dropped by the bin's ring before reaching the front buffer
+        uint64_t overwritten{0};
+        //frames that reached the front buffer but were never locked
+        uint64_t skipped{0};
+    };
+
     class stream_connection : public tracked_instance<stream_connection>
     {
     public:
@@ -44,9 +60,17 @@ namespace astra {
 
         bool is_started() const { return started_; }
 
+        //safe to call from any thread. once locked, lock() only reads atomics
         astra_frame_t* lock();
         void unlock();
 
+        //fills the locked frame of an on-demand stream, once per frame.
+        //called under the core mutex, the stream's callback may re-enter the core
+        void compute_locked_frame();
+
+        //shares the locked frame's header and data, false when nothing is locked
+        bool retain(astra_frame_t& frame, frame_buffer_pool::buffer_ptr& storage);
+
         void set_bin(stream_bin* bin);
         stream_bin* get_bin() const { return bin_; }
 
@@ -56,6 +80,12 @@ namespace astra {
 
         astra_bin_t get_bin_handle();
 
+        frame_counters get_frame_counters() const;
+        void get_stats(astra_stream_stats_t& stats) const;
+
+        //a reader of this connection returned a frame it held for holdMicroseconds
+        void record_client_hold(uint64_t holdMicroseconds) { clientHoldTime_.record(holdMicroseconds); }
+
         static stream_connection* get_ptr(astra_streamconnection_t conn)
         {
             return registry::get<stream_connection>(conn->handle);
@@ -84,22 +114,55 @@ namespace astra {
                     size_t& resultByteLength,
                     astra_result_token_t& token);
 
+        //safe to call from any thread. false when the stream didn't mark the
+        //parameter cacheable or it hasn't been read since it was invalidated
+        bool try_get_cached_parameter(astra_parameter_id id,
+                                      size_t byteLength,
+                                      astra_parameter_data_t data) const
+        {
+            return parameterCache_.try_get(id, byteLength, data);
+        }
+
+        //reads a fixed-size parameter in one call, from the cache if possible
+        astra_status_t read_parameter(astra_parameter_id id,
+                                      size_t byteLength,
+                                      astra_parameter_data_t data);
+
+        void invalidate_parameters() { parameterCache_.invalidate(); }
+
     private:
         void on_bin_front_buffer_ready(stream_bin* bin, astra_frame_index_t frameIndex);
         void clear_pending_parameter_result();
+        void log_frame_counters() const;
         void cache_parameter_bin_token(astra_parameter_bin_t parameterBinHandle,
                                        size_t& resultByteLength,
                                        astra_result_token_t& token);
 
         _astra_streamconnection connection_;
-        astra_frame_t* currentFrame_{nullptr};
+        std::mutex lockMutex_;
+        std::atomic<astra_frame_t*> currentFrame_{nullptr};
 
-        bool locked_{false};
+        std::atomic<bool> locked_{false};
         bool started_{false};
 
         stream* stream_{nullptr};
         stream_bin* bin_{nullptr};
         parameter_bin* pendingParameterResult_{nullptr};
+        parameter_cache parameterCache_;
+
+        //counters folded in from previously linked bins
+        frame_counters unlinkedCounters_;
+        uint64_t binProducedBase_{0};
+        uint64_t binOverwrittenBase_{0};
+        std::atomic<uint64_t> framesPresented_{0};
+        std::atomic<uint64_t> framesDelivered_{0};
+        astra_frame_index_t lastDeliveredFrameIndex_{-1};
+
+        //written under lockMutex_
+        uint64_t lockTimestamp_{0};
+        histogram deliveryLatency_;
+        histogram lockDuration_;
+        histogram clientHoldTime_;
 
         stream_bin::FrontBufferReadyCallback binFrontBufferReadyCallback_;
         astra_callback_id_t binFrontBufferReadyCallbackId_;
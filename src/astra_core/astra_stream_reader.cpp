@@ -18,6 +18,7 @@
 #include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <cstdint>
 #include <astra_core/capi/astra_core.h>
 #include "astra_streamset_connection.hpp"
 #include "astra_streamset.hpp"
@@ -31,34 +32,45 @@ namespace astra {
         : connection_(connection),
           scFrameReadyCallback_(nullptr)
     {
+        streams_.reserve(TYPICAL_STREAM_COUNT);
     }
 
     stream_reader::~stream_reader()
     {
         LOG_TRACE("astra.stream_reader", "destroying reader: %p", this);
-        for (auto& pair : streamMap_)
+
+        //wake readers waiting on this one so they notice it is gone
+        notify_frame_ready_waiters();
+
+        for (auto& data : streams_)
         {
-            reader_connection_data* data = pair.second;
-            data->connection->unregister_frame_ready_callback(data->scFrameReadyCallbackId);
-            connection_.get_streamSet()->destroy_stream_connection(data->connection);
-            delete data;
+            data.connection->unregister_frame_ready_callback(data.scFrameReadyCallbackId);
+            connection_.get_streamSet()->destroy_stream_connection(data.connection);
         }
 
-        streamMap_.clear();
+        streams_.clear();
     }
 
-    stream_connection* stream_reader::find_stream_of_type(astra_stream_desc_t& desc)
+    reader_connection_data* stream_reader::find_stream_data(const astra_stream_desc_t& desc)
     {
-        auto it = streamMap_.find(desc);
-
-        if (it != streamMap_.end())
+        for (auto& data : streams_)
         {
-            return it->second->connection;
+            if (data.desc.type == desc.type && data.desc.subtype == desc.subtype)
+            {
+                return &data;
+            }
         }
 
         return nullptr;
     }
 
+    stream_connection* stream_reader::find_stream_of_type(astra_stream_desc_t& desc)
+    {
+        reader_connection_data* data = find_stream_data(desc);
+
+        return data != nullptr ? data->connection : nullptr;
+    }
+
     stream_connection::FrameReadyCallback stream_reader::get_sc_frame_ready_callback()
     {
         if (scFrameReadyCallback_ == nullptr)
@@ -80,17 +92,24 @@ namespace astra {
 
         connection = connection_.get_streamSet()->create_stream_connection(desc);
 
-        assert(connection != nullptr);
+        if (!connection)
+        {
+            return nullptr;
+        }
 
         astra_callback_id_t cbId = connection->register_frame_ready_callback(get_sc_frame_ready_callback());
 
-        reader_connection_data* data = new reader_connection_data;
-        data->connection = connection;
-        data->scFrameReadyCallbackId = cbId;
-        data->isNewFrameReady = false;
-        data->currentFrameIndex = -1;
+        reader_connection_data data;
+        data.desc = desc;
+        data.connection = connection;
+        data.scFrameReadyCallbackId = cbId;
+        data.isNewFrameReady = false;
+        data.currentFrameIndex = -1;
+        data.matched = synced_frame();
+        data.hasMatched = false;
+        data.matchPosition = 0;
 
-        streamMap_.insert(std::make_pair(desc, data));
+        streams_.push_back(data);
 
         return connection;
     }
@@ -100,14 +119,26 @@ namespace astra {
         if (!locked_)
             return nullptr;
 
-        stream_connection* connection = find_stream_of_type(desc);
+        reader_connection_data* data = find_stream_data(desc);
 
-        if (connection == nullptr)
+        if (data == nullptr)
         {
             return nullptr;
         }
 
-        return connection->lock();
+        if (lockedSynced_)
+        {
+            //matched frames don't change while the reader is locked
+            return data->hasMatched ? &data->matched.frame : nullptr;
+        }
+
+        stream_connection* connection = data->connection;
+        astra_frame_t* frame = connection->lock();
+
+        //derived streams computed on demand cost nothing until a client asks here
+        connection->compute_locked_frame();
+
+        return frame;
     }
 
     astra_callback_id_t stream_reader::register_frame_ready_callback(astra_frame_ready_callback_t callback,
@@ -124,43 +155,216 @@ namespace astra {
         callbackId = 0;
     }
 
-    stream_reader::block_result stream_reader::block_until_frame_ready_or_timeout(int timeoutMillis)
+    void stream_reader::add_frame_ready_waiter(std::condition_variable_any& condition)
     {
-        LOG_TRACE("astra.stream_reader", "%p block_until_frame_ready_or_timeout", this);
-        if (isFrameReadyForLock_)
+        frameReadyWaiters_.push_back(&condition);
+    }
+
+    void stream_reader::remove_frame_ready_waiter(std::condition_variable_any& condition)
+    {
+        auto it = std::find(frameReadyWaiters_.begin(), frameReadyWaiters_.end(), &condition);
+        if (it != frameReadyWaiters_.end())
         {
-            return block_result::FRAMEREADY;
+            frameReadyWaiters_.erase(it);
         }
+    }
 
-        if (timeoutMillis != ASTRA_TIMEOUT_RETURN_IMMEDIATELY)
+    void stream_reader::notify_frame_ready_waiters()
+    {
+        frameReadyCondition_.notify_all();
+
+        for (std::condition_variable_any* condition : frameReadyWaiters_)
         {
-            long long milliseconds = 0;
-            std::chrono::steady_clock::time_point start, end;
-            start = std::chrono::steady_clock::now();
-            bool forever = timeoutMillis == ASTRA_TIMEOUT_FOREVER;
-            do
+            condition->notify_all();
+        }
+    }
+
+    astra_status_t stream_reader::wait_any(astra_reader_t* readers,
+                                           size_t count,
+                                           int timeoutMillis,
+                                           size_t& readyIndex,
+                                           core_mutex* waitMutex)
+    {
+        if (readers == nullptr || count == 0)
+        {
+            LOG_WARN("astra.stream_reader", "wait_any called without readers");
+            return ASTRA_STATUS_INVALID_PARAMETER;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (get_ptr(readers[i]) == nullptr)
             {
-                astra_temp_update();
-                if (isFrameReadyForLock_)
+                LOG_WARN("astra.stream_reader", "wait_any called with non-existent reader at index %u", i);
+                return ASTRA_STATUS_INVALID_PARAMETER;
+            }
+        }
+
+        //readers are looked up again on every check, one may be destroyed while we sleep.
+        //the wait also ends once they are all gone, no frame can arrive after that.
+        bool allReadersDestroyed = false;
+        auto isAnyFrameReady = [readers, count, &readyIndex, &allReadersDestroyed] ()
+            {
+                allReadersDestroyed = true;
+                for (size_t i = 0; i < count; ++i)
                 {
-                    return block_result::FRAMEREADY;
+                    stream_reader* actualReader = get_ptr(readers[i]);
+                    if (actualReader)
+                    {
+                        allReadersDestroyed = false;
+                        if (actualReader->is_frame_ready())
+                        {
+                            readyIndex = i;
+                            return true;
+                        }
+                    }
                 }
+                return false;
+            };
+        auto isWaitOver = [&isAnyFrameReady, &allReadersDestroyed] ()
+            {
+                return isAnyFrameReady() || allReadersDestroyed;
+            };
 
-                end = std::chrono::steady_clock::now();
-                std::chrono::duration<double> elapsed_seconds = end - start;
-                milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed_seconds).count();
-            } while (forever || milliseconds < timeoutMillis);
+        if (isAnyFrameReady())
+        {
+            return ASTRA_STATUS_SUCCESS;
+        }
+
+        if (timeoutMillis == ASTRA_TIMEOUT_RETURN_IMMEDIATELY)
+        {
+            return ASTRA_STATUS_TIMEOUT;
+        }
+
+        if (waitMutex != nullptr)
+        {
+            //every reader wakes this condition, so one thread can service them all
+            std::condition_variable_any frameReadyCondition;
+            for (size_t i = 0; i < count; ++i)
+            {
+                get_ptr(readers[i])->add_frame_ready_waiter(frameReadyCondition);
+            }
+
+            if (timeoutMillis == ASTRA_TIMEOUT_FOREVER)
+            {
+                frameReadyCondition.wait(*waitMutex, isWaitOver);
+            }
+            else
+            {
+                frameReadyCondition.wait_for(*waitMutex,
+                                             std::chrono::milliseconds(timeoutMillis),
+                                             isWaitOver);
+            }
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                stream_reader* actualReader = get_ptr(readers[i]);
+                if (actualReader)
+                {
+                    actualReader->remove_frame_ready_waiter(frameReadyCondition);
+                }
+            }
+        }
+        else
+        {
+            const auto start = std::chrono::steady_clock::now();
+            const auto timeout = std::chrono::milliseconds(timeoutMillis);
+
+            while (!isWaitOver() &&
+                   (timeoutMillis == ASTRA_TIMEOUT_FOREVER ||
+                    std::chrono::steady_clock::now() - start < timeout))
+            {
+                astra_temp_update();
+            }
+        }
+
+        if (isAnyFrameReady())
+        {
+            return ASTRA_STATUS_SUCCESS;
+        }
+
+        if (allReadersDestroyed)
+        {
+            LOG_WARN("astra.stream_reader", "wait_any readers were destroyed while waiting");
+            return ASTRA_STATUS_INVALID_OPERATION;
+        }
+
+        return ASTRA_STATUS_TIMEOUT;
+    }
+
+    stream_reader::block_result stream_reader::block_until_frame_ready_or_timeout(int timeoutMillis,
+                                                                                  core_mutex* waitMutex)
+    {
+        LOG_TRACE("astra.stream_reader", "%p block_until_frame_ready_or_timeout", this);
+        if (isFrameReadyForLock_)
+        {
+            return block_result::FRAMEREADY;
+        }
+
+        if (timeoutMillis == ASTRA_TIMEOUT_RETURN_IMMEDIATELY)
+        {
+            return block_result::TIMEOUT;
+        }
+
+        if (waitMutex != nullptr)
+        {
+            return wait_for_frame_ready(timeoutMillis, *waitMutex);
+        }
+
+        return pump_until_frame_ready(timeoutMillis);
+    }
+
+    stream_reader::block_result stream_reader::wait_for_frame_ready(int timeoutMillis, core_mutex& waitMutex)
+    {
+        //the update thread produces frames while we sleep with the core mutex released,
+        //check_for_all_frames_ready() wakes us up
+        auto isFrameReady = [this] { return isFrameReadyForLock_.load(); };
+
+        if (timeoutMillis == ASTRA_TIMEOUT_FOREVER)
+        {
+            frameReadyCondition_.wait(waitMutex, isFrameReady);
+        }
+        else
+        {
+            frameReadyCondition_.wait_for(waitMutex,
+                                          std::chrono::milliseconds(timeoutMillis),
+                                          isFrameReady);
         }
 
         return isFrameReadyForLock_ ? block_result::FRAMEREADY : block_result::TIMEOUT;
     }
 
-    astra_status_t stream_reader::lock(int timeoutMillis, astra_reader_frame_t& readerFrame)
+    stream_reader::block_result stream_reader::pump_until_frame_ready(int timeoutMillis)
+    {
+        long long milliseconds = 0;
+        std::chrono::steady_clock::time_point start, end;
+        start = std::chrono::steady_clock::now();
+        bool forever = timeoutMillis == ASTRA_TIMEOUT_FOREVER;
+        do
+        {
+            astra_temp_update();
+            if (isFrameReadyForLock_)
+            {
+                return block_result::FRAMEREADY;
+            }
+
+            end = std::chrono::steady_clock::now();
+            std::chrono::duration<double> elapsed_seconds = end - start;
+            milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed_seconds).count();
+        } while (forever || milliseconds < timeoutMillis);
+
+        return isFrameReadyForLock_ ? block_result::FRAMEREADY : block_result::TIMEOUT;
+    }
+
+    astra_status_t stream_reader::lock(int timeoutMillis,
+                                       astra_reader_frame_t& readerFrame,
+                                       core_mutex* waitMutex)
     {
         LOG_TRACE("astra.stream_reader", "%p lock", this);
         if (!locked_)
         {
-            stream_reader::block_result result = block_until_frame_ready_or_timeout(timeoutMillis);
+            //don't hold frameMutex_ while blocking, other threads may be closing frames
+            stream_reader::block_result result = block_until_frame_ready_or_timeout(timeoutMillis, waitMutex);
 
             isFrameReadyForLock_ = false;
 
@@ -171,6 +375,7 @@ namespace astra {
             }
         }
 
+        std::lock_guard<std::recursive_mutex> lock(frameMutex_);
         readerFrame = lock_frame_for_poll();
 
         return ASTRA_STATUS_SUCCESS;
@@ -186,6 +391,8 @@ namespace astra {
             return ASTRA_STATUS_INVALID_PARAMETER;
         }
 
+        std::lock_guard<std::recursive_mutex> lock(frameMutex_);
+
         if (readerFrame->status == ASTRA_FRAME_STATUS_AVAILABLE)
         {
             LOG_WARN("astra.stream_reader", "%p readerFrame was closed more than once", this);
@@ -203,6 +410,89 @@ namespace astra {
         return unlock_frame_and_check_connections(readerFrame);
     }
 
+    astra_status_t stream_reader::retain(astra_reader_frame_t& readerFrame,
+                                         astra_reader_frame_t& retainedFrame)
+    {
+        LOG_TRACE("astra.stream_reader", "%p retain", this);
+        retainedFrame = nullptr;
+
+        if (readerFrame == nullptr)
+        {
+            LOG_WARN("astra.stream_reader", "%p retain with null frame parameter", this);
+            assert(readerFrame != nullptr);
+            return ASTRA_STATUS_INVALID_PARAMETER;
+        }
+
+        std::lock_guard<std::recursive_mutex> lock(frameMutex_);
+
+        if (readerFrame->status == ASTRA_FRAME_STATUS_AVAILABLE || !locked_)
+        {
+            LOG_WARN("astra.stream_reader", "%p retain called on a closed readerFrame", this);
+            assert(readerFrame->status != ASTRA_FRAME_STATUS_AVAILABLE);
+            return ASTRA_STATUS_INVALID_OPERATION;
+        }
+
+        retained_frame* retained = new retained_frame(get_handle());
+
+        for (size_t i = 0; i < streams_.size(); ++i)
+        {
+            if (lockedSynced_)
+            {
+                //already computed when it was added to the history
+                if (streams_[i].hasMatched)
+                {
+                    retained->add_subframe(streams_[i].desc, streams_[i].matched.frame, streams_[i].matched.storage);
+                }
+                continue;
+            }
+
+            astra_frame_t subframe;
+            frame_buffer_pool::buffer_ptr storage;
+
+            //the retained data must be complete, it is shared rather than copied
+            streams_[i].connection->compute_locked_frame();
+
+            if (streams_[i].connection->retain(subframe, storage))
+            {
+                retained->add_subframe(streams_[i].desc, subframe, std::move(storage));
+            }
+        }
+
+        retainedFrame = retained->get_handle();
+
+        return ASTRA_STATUS_SUCCESS;
+    }
+
+    astra_status_t stream_reader::set_sync_policy(astra_reader_sync_policy_t policy,
+                                                  uint32_t toleranceMicroseconds)
+    {
+        switch (policy)
+        {
+        case ASTRA_READER_SYNC_LATEST:
+        case ASTRA_READER_SYNC_FRAME_INDEX:
+        case ASTRA_READER_SYNC_NEAREST_TIMESTAMP:
+            break;
+        default:
+            LOG_WARN("astra.stream_reader", "%p set_sync_policy unknown policy: %d", this, policy);
+            return ASTRA_STATUS_INVALID_PARAMETER;
+        }
+
+        std::lock_guard<std::recursive_mutex> lock(frameMutex_);
+
+        LOG_DEBUG("astra.stream_reader", "%p sync policy: %d tolerance: %uus", this, policy, toleranceMicroseconds);
+
+        syncPolicy_ = policy;
+        syncToleranceMicroseconds_ = toleranceMicroseconds;
+
+        //frames kept for the old policy may not match under the new one
+        for (auto& data : streams_)
+        {
+            data.history.clear();
+        }
+
+        return ASTRA_STATUS_SUCCESS;
+    }
+
     astra_status_t stream_reader::unlock_frame_and_check_connections(astra_reader_frame_t& readerFrame)
     {
         LOG_TRACE("astra.stream_reader", "%p unlock_frame_and_check_connections", this);
@@ -222,6 +512,7 @@ namespace astra {
 
         astra_reader_frame_t frame = acquire_available_reader_frame();
         frame->status = ASTRA_FRAME_STATUS_LOCKED_EVENT;
+        frame->lockTimestamp = stats_clock_microseconds();
         ++lockedFrameCount_;
         return frame;
     }
@@ -233,6 +524,7 @@ namespace astra {
 
         astra_reader_frame_t frame = acquire_available_reader_frame();
         frame->status = ASTRA_FRAME_STATUS_LOCKED_POLL;
+        frame->lockTimestamp = stats_clock_microseconds();
         ++lockedFrameCount_;
         return frame;
     }
@@ -255,6 +547,7 @@ namespace astra {
         newFrame->id = frameList_.size();
         newFrame->status = ASTRA_FRAME_STATUS_AVAILABLE;
         newFrame->reader = get_handle();
+        newFrame->retained = nullptr;
 
         astra_reader_frame_t framePtr = newFrame.get();
         frameList_.push_back(std::move(newFrame));
@@ -307,25 +600,36 @@ namespace astra {
         checkFrame->status = ASTRA_FRAME_STATUS_AVAILABLE;
         --lockedFrameCount_;
 
+        const uint64_t holdTime = stats_clock_microseconds() - checkFrame->lockTimestamp;
+        for (auto& data : streams_)
+        {
+            if (data.connection->is_started())
+            {
+                data.connection->record_client_hold(holdTime);
+            }
+        }
+
         readerFrame = nullptr;
         return ASTRA_STATUS_SUCCESS;
     }
 
     void stream_reader::ensure_connections_locked()
     {
-        LOG_TRACE("astra.stream_reader", "%p ensure_connections_locked locked_: %d", this, locked_);
+        LOG_TRACE("astra.stream_reader", "%p ensure_connections_locked locked_: %d", this, locked_.load());
 
         if (!locked_)
         {
+            //synced frames come from the histories, the bins stay free for other readers
+            lockedSynced_ = syncPolicy_ != ASTRA_READER_SYNC_LATEST;
+
             //LOG_INFO("astra.stream_reader", "locked run start");
-            for (auto pair : streamMap_)
+            for (auto& data : streams_)
             {
-                reader_connection_data* data = pair.second;
-                //LOG_INFO("astra.stream_reader", "locking: %u", data->connection->get_stream()->get_description().type);
-                if (data->connection->is_started())
+                //LOG_INFO("astra.stream_reader", "locking: %u", data.connection->get_stream()->get_description().type);
+                if (!lockedSynced_ && data.connection->is_started())
                 {
-                    //LOG_INFO("astra.stream_reader", "locked: %u", data->connection->get_stream()->get_description().type);
-                    data->connection->lock();
+                    //LOG_INFO("astra.stream_reader", "locked: %u", data.connection->get_stream()->get_description().type);
+                    data.connection->lock();
                 }
             }
             //LOG_INFO("astra.stream_reader", "locked run end");
@@ -336,7 +640,7 @@ namespace astra {
     astra_status_t stream_reader::unlock_connections_if_able()
     {
         LOG_TRACE("astra.stream_reader", "%p unlock_connections_if_able lockedFrameCount_: %d locked_: %d",
-               this, lockedFrameCount_, locked_);
+               this, lockedFrameCount_, locked_.load());
         if (!locked_)
         {
             LOG_WARN("astra.stream_reader", "%p unlock_connections_if_able called too many times (locked_ == false)", this);
@@ -360,26 +664,33 @@ namespace astra {
             }
         }
 
-        for(auto& pair : streamMap_)
+        for (auto& data : streams_)
         {
-            reader_connection_data* data = pair.second;
-            data->isNewFrameReady = false;
-            if (data->currentFrameIndex > lastFrameIndex_)
+            data.isNewFrameReady = false;
+            if (data.currentFrameIndex > lastFrameIndex_)
             {
-                lastFrameIndex_ = data->currentFrameIndex;
+                lastFrameIndex_ = data.currentFrameIndex;
             }
         }
 
         locked_ = false;
 
+        if (lockedSynced_)
+        {
+            //the connections were never locked. frames that arrived while this
+            //one was open are waiting in the histories, they may match now
+            check_for_all_frames_ready();
+            return ASTRA_STATUS_SUCCESS;
+        }
+
         //Do the connection unlock separately because unlock()
         //could call connection_frame_ready(...) again and we want to be ready
-        for(auto& pair : streamMap_)
+        for (size_t i = 0; i < streams_.size(); ++i)
         {
-            reader_connection_data* data = pair.second;
-            if (data->connection->is_started())
+            stream_connection* connection = streams_[i].connection;
+            if (connection->is_started())
             {
-                data->connection->unlock();
+                connection->unlock();
             }
         }
 
@@ -388,17 +699,34 @@ namespace astra {
 
     void stream_reader::on_connection_frame_ready(stream_connection* connection, astra_frame_index_t frameIndex)
     {
-        LOG_TRACE("astra.stream_reader", "%p connection_frame_ready", this, streamMap_.size(), connection->get_description().type);
+        LOG_TRACE("astra.stream_reader", "%p connection_frame_ready", this, streams_.size(), connection->get_description().type);
+
+        std::lock_guard<std::recursive_mutex> lock(frameMutex_);
+
+        if (syncPolicy_ != ASTRA_READER_SYNC_LATEST)
+        {
+            for (size_t i = 0; i < streams_.size(); ++i)
+            {
+                if (streams_[i].connection == connection)
+                {
+                    record_sync_frame(i, frameIndex);
+                    break;
+                }
+            }
+
+            check_for_all_frames_ready();
+            return;
+        }
+
         if (frameIndex > lastFrameIndex_)
         {
             auto& desc = connection->get_description();
 
-            auto pair = streamMap_.find(desc);
+            reader_connection_data* data = find_stream_data(desc);
 
-            if (pair != streamMap_.end())
+            if (data != nullptr)
             {
-                //TODO optimization/special case -- if streamMap_.size() == 1, call raise_frame_ready() directly
-                reader_connection_data* data = pair->second;
+                //TODO optimization/special case -- if streams_.size() == 1, call raise_frame_ready() directly
                 data->isNewFrameReady = true;
                 data->currentFrameIndex = frameIndex;
             }
@@ -416,25 +744,166 @@ namespace astra {
         LOG_TRACE("astra.stream_reader", "%p check_for_all_frames_ready", this);
 
         bool allReady = true;
-        for (auto& pair : streamMap_)
+
+        if (syncPolicy_ != ASTRA_READER_SYNC_LATEST)
+        {
+            allReady = sync_connections();
+        }
+        else
         {
-            reader_connection_data* data = pair.second;
-            if (!data->isNewFrameReady && data->connection->is_started())
+            for (auto& data : streams_)
             {
-                //TODO the new frames may not be synced.
-                //We need matching frame indices in the future
-                allReady = false;
-                break;
+                if (!data.isNewFrameReady && data.connection->is_started())
+                {
+                    allReady = false;
+                    break;
+                }
             }
         }
 
         if (allReady)
         {
             isFrameReadyForLock_ = true;
+            notify_frame_ready_waiters();
             raise_frame_ready();
         }
     }
 
+    void stream_reader::record_sync_frame(size_t streamIndex, astra_frame_index_t frameIndex)
+    {
+        reader_connection_data& data = streams_[streamIndex];
+        stream_connection* connection = data.connection;
+
+        if (!connection->is_started()
+            || frameIndex <= data.currentFrameIndex
+            || (!data.history.empty() && frameIndex <= data.history.back().frame.frameIndex))
+        {
+            return;
+        }
+
+        //the front buffer is only locked long enough to share its data
+        synced_frame entry;
+        connection->lock();
+        connection->compute_locked_frame();
+
+        if (connection->retain(entry.frame, entry.storage))
+        {
+            entry.captureTimestamp = connection->get_bin()->front_capture_timestamp();
+
+            data.history.push_back(std::move(entry));
+            if (data.history.size() > SYNC_HISTORY_DEPTH)
+            {
+                data.history.pop_front();
+            }
+        }
+
+        //may present the next ready frame and re-enter on_connection_frame_ready(),
+        //data must not be used past here
+        connection->unlock();
+    }
+
+    uint64_t stream_reader::sync_key(const synced_frame& frame) const
+    {
+        return syncPolicy_ == ASTRA_READER_SYNC_FRAME_INDEX
+            ? static_cast<uint64_t>(frame.frame.frameIndex)
+            : frame.captureTimestamp;
+    }
+
+    bool stream_reader::sync_connections()
+    {
+        if (locked_)
+        {
+            //the matched frames are in use, matching resumes once they're closed
+            return false;
+        }
+
+        //the stream furthest behind has the newest frames every stream may have
+        //a partner for, so matches are anchored on its history
+        reader_connection_data* laggard = nullptr;
+
+        for (auto& data : streams_)
+        {
+            if (!data.connection->is_started())
+            {
+                continue;
+            }
+
+            if (data.history.empty())
+            {
+                return false;
+            }
+
+            if (laggard == nullptr || sync_key(data.history.back()) < sync_key(laggard->history.back()))
+            {
+                laggard = &data;
+            }
+        }
+
+        if (laggard == nullptr)
+        {
+            return false;
+        }
+
+        const uint64_t tolerance = syncPolicy_ == ASTRA_READER_SYNC_FRAME_INDEX ? 0 : syncToleranceMicroseconds_;
+
+        for (auto anchor = laggard->history.rbegin(); anchor != laggard->history.rend(); ++anchor)
+        {
+            const uint64_t anchorKey = sync_key(*anchor);
+            bool matched = true;
+
+            for (auto& data : streams_)
+            {
+                if (!data.connection->is_started())
+                {
+                    continue;
+                }
+
+                uint64_t nearestDistance = UINT64_MAX;
+                for (size_t i = 0; i < data.history.size(); ++i)
+                {
+                    const uint64_t key = sync_key(data.history[i]);
+                    const uint64_t distance = key > anchorKey ? key - anchorKey : anchorKey - key;
+                    if (distance < nearestDistance)
+                    {
+                        nearestDistance = distance;
+                        data.matchPosition = i;
+                    }
+                }
+
+                if (nearestDistance > tolerance)
+                {
+                    matched = false;
+                    break;
+                }
+            }
+
+            if (matched)
+            {
+                for (auto& data : streams_)
+                {
+                    if (!data.connection->is_started())
+                    {
+                        data.history.clear();
+                        data.hasMatched = false;
+                        continue;
+                    }
+
+                    //older frames can't be part of a later match
+                    data.matched = std::move(data.history[data.matchPosition]);
+                    data.history.erase(data.history.begin(), data.history.begin() + data.matchPosition + 1);
+                    data.hasMatched = true;
+                    data.currentFrameIndex = data.matched.frame.frameIndex;
+                }
+
+                LOG_TRACE("astra.stream_reader", "%p synced frame, anchor key %llu",
+                          this, static_cast<unsigned long long>(anchorKey));
+                return true;
+            }
+        }
+
+        return false;
+    }
+
     void stream_reader::raise_frame_ready()
     {
         LOG_TRACE("astra.stream_reader", "%p raise_frame_ready", this);
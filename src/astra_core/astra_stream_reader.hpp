@@ -19,46 +19,47 @@
 
 #include <astra_core/capi/astra_types.h>
 #include "astra_registry.hpp"
-#include <unordered_map>
 #include <vector>
+#include <deque>
 #include <cassert>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
 #include "astra_signal.hpp"
 #include "astra_private.h"
 #include "astra_stream_connection.hpp"
+#include "astra_retained_frame.hpp"
+#include "astra_core_mutex.hpp"
 
 namespace astra {
 
     class streamset_connection;
     //class stream_connection;
 
-    class stream_desc_hash
+    //a frame retained from a connection, its data outlives the bin's front buffer
+    struct synced_frame
     {
-    public:
-        std::size_t operator()(const astra_stream_desc_t desc) const
-            {
-                std::size_t h1 = std::hash<astra_stream_type_t>()(desc.type);
-                std::size_t h2 = std::hash<astra_stream_subtype_t>()(desc.subtype);
-
-                return h1 ^ (h2 << 1);
-            }
-    };
-
-    class stream_desc_equal_to
-    {
-    public:
-        std::size_t operator()(const astra_stream_desc_t& lhs,
-                               const astra_stream_desc_t& rhs) const
-            {
-                return lhs.type == rhs.type && lhs.subtype == rhs.subtype;
-            }
+        astra_frame_t frame;
+        frame_buffer_pool::buffer_ptr storage;
+        uint64_t captureTimestamp;
     };
 
     struct reader_connection_data
     {
+        astra_stream_desc_t desc;
         stream_connection* connection;
         astra_callback_id_t scFrameReadyCallbackId;
         bool isNewFrameReady;
         astra_frame_index_t currentFrameIndex;
+
+        //sync policies only. recent frames of the connection, oldest first, so
+        //streams can be matched without holding the shared bin's front buffer
+        std::deque<synced_frame> history;
+        //the frame matched for the reader's current frame
+        synced_frame matched;
+        bool hasMatched;
+        //scratch for sync_connections()
+        size_t matchPosition;
     };
 
     class stream_reader : public tracked_instance<stream_reader>
@@ -72,19 +73,52 @@ namespace astra {
 
         inline streamset_connection& get_connection() const { return connection_; }
 
-        inline astra_reader_t get_handle() { return reinterpret_cast<astra_reader_t>(this); }
+        inline astra_reader_t get_handle() { return reinterpret_cast<astra_reader_t>(tracked_handle()); }
 
+        //nullptr if the registry is full
         stream_connection* get_stream(astra_stream_desc_t& desc);
         astra_frame_t* get_subframe(astra_stream_desc_t& desc);
 
         astra_callback_id_t register_frame_ready_callback(astra_frame_ready_callback_t callback, void* clientTag);
         void unregister_frame_ready_callback(astra_callback_id_t& callbackId);
 
-        //TODO: locking currently not threadsafe
-
-        astra_status_t lock(int timeoutMillis, astra_reader_frame_t& readerFrame);
+        // lock(), unlock() and get_subframe() may be called from several threads.
+        // a reader frame can be handed to worker threads and closed by the last
+        // one to finish. get_subframe() only reads atomics once the reader is locked,
+        // apart from computing on-demand frames, which it does under the core mutex.
+        //
+        // waitMutex: when non-null, frames are produced on another thread and
+        // lock() sleeps on it until a frame is ready instead of pumping updates
+        astra_status_t lock(int timeoutMillis,
+                            astra_reader_frame_t& readerFrame,
+                            core_mutex* waitMutex = nullptr);
         astra_status_t unlock(astra_reader_frame_t& readerFrame);
 
+        //true when lock() has a new frame without blocking
+        bool is_frame_ready() const { return isFrameReadyForLock_; }
+
+        //waiters are notified with frameReadyCondition_, for waits spanning
+        //several readers. added and removed under the core mutex.
+        void add_frame_ready_waiter(std::condition_variable_any& condition);
+        void remove_frame_ready_waiter(std::condition_variable_any& condition);
+
+        // Blocks until any of the readers has a frame ready for lock() and sets
+        // readyIndex to it. Readers may be destroyed while waiting; once all of
+        // them are, returns ASTRA_STATUS_INVALID_OPERATION. Called holding the
+        // core mutex, waitMutex is as for lock().
+        static astra_status_t wait_any(astra_reader_t* readers,
+                                       size_t count,
+                                       int timeoutMillis,
+                                       size_t& readyIndex,
+                                       core_mutex* waitMutex = nullptr);
+
+        //keeps the subframes of a locked frame after it is closed
+        astra_status_t retain(astra_reader_frame_t& readerFrame,
+                              astra_reader_frame_t& retainedFrame);
+
+        astra_status_t set_sync_policy(astra_reader_sync_policy_t policy,
+                                       uint32_t toleranceMicroseconds);
+
         static inline stream_reader* get_ptr(astra_reader_t reader) { return registry::get<stream_reader>(reader); }
         static inline stream_reader* from_frame(astra_reader_frame_t& frame)
         {
@@ -103,7 +137,9 @@ namespace astra {
             FRAMEREADY
         };
 
-        block_result block_until_frame_ready_or_timeout(int timeoutMillis);
+        block_result block_until_frame_ready_or_timeout(int timeoutMillis, core_mutex* waitMutex);
+        block_result wait_for_frame_ready(int timeoutMillis, core_mutex& waitMutex);
+        block_result pump_until_frame_ready(int timeoutMillis);
 
         astra_reader_frame_t lock_frame_for_event_callback();
         astra_reader_frame_t lock_frame_for_poll();
@@ -115,22 +151,40 @@ namespace astra {
         void ensure_connections_locked();
         astra_status_t unlock_connections_if_able();
 
+        reader_connection_data* find_stream_data(const astra_stream_desc_t& desc);
         stream_connection* find_stream_of_type(astra_stream_desc_t& desc);
         stream_connection::FrameReadyCallback get_sc_frame_ready_callback();
         void on_connection_frame_ready(stream_connection* connection, astra_frame_index_t frameIndex);
         void check_for_all_frames_ready();
+        void record_sync_frame(size_t streamIndex, astra_frame_index_t frameIndex);
+        bool sync_connections();
+        uint64_t sync_key(const synced_frame& frame) const;
+        void notify_frame_ready_waiters();
         void raise_frame_ready();
 
-        bool locked_{false};
-        bool isFrameReadyForLock_{false};
+        //guards frameList_, lockedFrameCount_ and the connection lock state.
+        //recursive because unlocking connections can raise frame ready
+        //handlers that lock this reader again on the same thread
+        std::recursive_mutex frameMutex_;
+
+        std::atomic<bool> locked_{false};
+        //the locked frame is made of matched history frames, not connection locks.
+        //written before locked_ is set
+        bool lockedSynced_{false};
+        std::atomic<bool> isFrameReadyForLock_{false};
         astra_frame_index_t lastFrameIndex_{-1};
+        astra_reader_sync_policy_t syncPolicy_{ASTRA_READER_SYNC_LATEST};
+        uint64_t syncToleranceMicroseconds_{0};
         streamset_connection& connection_;
 
-        using ConnectionMap = std::unordered_map<astra_stream_desc_t,
-                                                 reader_connection_data*,
-                                                 stream_desc_hash,
-                                                 stream_desc_equal_to>;
-        ConnectionMap streamMap_;
+        //readers have a handful of streams, so they are kept by value in one
+        //block and found by a linear scan. walked on every frame.
+        //handlers raised while walking it may add streams, so loops that
+        //call out to connections index it instead of holding iterators
+        const static size_t TYPICAL_STREAM_COUNT = 4;
+        //frames kept per connection while waiting for the others to catch up
+        const static size_t SYNC_HISTORY_DEPTH = 4;
+        std::vector<reader_connection_data> streams_;
 
         using FramePtr  = std::unique_ptr<_astra_reader_frame>;
         using FrameList = std::vector<FramePtr>;
@@ -139,6 +193,8 @@ namespace astra {
         int32_t lockedFrameCount_{0};
 
         signal<astra_reader_t, astra_reader_frame_t> frameReadySignal_;
+        std::condition_variable_any frameReadyCondition_;
+        std::vector<std::condition_variable_any*> frameReadyWaiters_;
 
         stream_connection::FrameReadyCallback scFrameReadyCallback_;
     };
@@ -161,6 +161,58 @@ namespace astra {
         {
             return static_cast<context*>(streamService)->temp_update();
         }
+
+        static astra_status_t reader_set_sync_policy(void* streamService,
+                                                     astra_reader_t reader,
+                                                     astra_reader_sync_policy_t policy,
+                                                     uint32_t toleranceMicroseconds)
+        {
+            return static_cast<context*>(streamService)->reader_set_sync_policy(reader, policy, toleranceMicroseconds);
+        }
+
+        static astra_status_t stream_get_stats(void* streamService,
+                                               astra_streamconnection_t connection,
+                                               astra_stream_stats_t* stats)
+        {
+            return static_cast<context*>(streamService)->stream_get_stats(connection, stats);
+        }
+
+        static astra_status_t context_get_stats(void* streamService,
+                                                astra_context_stats_t* stats)
+        {
+            return static_cast<context*>(streamService)->context_get_stats(stats);
+        }
+
+        static astra_status_t frame_retain(void* streamService,
+                                           astra_reader_frame_t frame,
+                                           astra_reader_frame_t* retainedFrame)
+        {
+            return static_cast<context*>(streamService)->frame_retain(frame, *retainedFrame);
+        }
+
+        static astra_status_t frame_release(void* streamService,
+                                            astra_reader_frame_t* frame)
+        {
+            return static_cast<context*>(streamService)->frame_release(*frame);
+        }
+
+        static astra_status_t reader_wait_any(void* streamService,
+                                              astra_reader_t* readers,
+                                              size_t count,
+                                              int timeoutMillis,
+                                              size_t* readyIndex)
+        {
+            return static_cast<context*>(streamService)->reader_wait_any(readers, count, timeoutMillis, *readyIndex);
+        }
+
+        static astra_status_t stream_read_parameter(void* streamService,
+                                                    astra_streamconnection_t connection,
+                                                    astra_parameter_id parameterId,
+                                                    size_t byteLength,
+                                                    astra_parameter_data_t data)
+        {
+            return static_cast<context*>(streamService)->stream_read_parameter(connection, parameterId, byteLength, data);
+        }
     };
 }
 
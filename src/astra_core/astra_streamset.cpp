@@ -117,6 +117,12 @@ namespace astra {
     {
         LOG_TRACE("astra.streamset","new connection to %s", uri_.c_str());
         streamset_connectionPtr ptr = astra::make_unique<streamset_connection>(this);
+        if (!ptr->tracked_handle())
+        {
+            LOG_WARN("astra.streamset", "no handle for a new connection to %s", uri_.c_str());
+            return nullptr;
+        }
+
         streamset_connection* conn = ptr.get();
         connections_.push_back(std::move(ptr));
 
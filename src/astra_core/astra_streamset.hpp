@@ -43,9 +43,11 @@ namespace astra {
         streamset& operator=(const streamset& rhs) = delete;
         streamset(const streamset& streamSet) = delete;
 
+        //nullptr if the registry is full
         streamset_connection* add_new_connection();
         void disconnect_streamset_connection(streamset_connection* connection);
 
+        //nullptr if the registry is full
         stream_connection* create_stream_connection(const astra_stream_desc_t& desc);
         bool destroy_stream_connection(stream_connection* connection);
 
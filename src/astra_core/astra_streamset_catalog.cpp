@@ -15,6 +15,7 @@
 //
 // Be excellent to each other.
 #include "astra_streamset_catalog.hpp"
+#include <algorithm>
 #include <cassert>
 #include "astra_streamset.hpp"
 #include "astra_streamset_connection.hpp"
@@ -26,7 +27,7 @@ namespace astra {
 
     streamset_catalog::~streamset_catalog() = default;
 
-    streamset_connection& streamset_catalog::open_set_connection(std::string uri)
+    streamset_connection* streamset_catalog::open_set_connection(std::string uri)
     {
         std::string finalUri = uri;
         if (uri == "device/default")
@@ -36,7 +37,7 @@ namespace astra {
         }
 
         streamset& set = get_or_add(finalUri, false);
-        return *set.add_new_connection();
+        return set.add_new_connection();
     }
 
     void streamset_catalog::close_set_connection(streamset_connection* conn)
@@ -84,6 +85,11 @@ namespace astra {
         return *streamSet;
     }
 
+    bool streamset_catalog::is_shared_memory_export(const std::string& uri) const
+    {
+        return std::find(sharedMemoryExports_.begin(), sharedMemoryExports_.end(), uri) != sharedMemoryExports_.end();
+    }
+
     void streamset_catalog::clear()
     {
         streamSets_.clear();
@@ -32,11 +32,16 @@ namespace astra {
     public:
         ~streamset_catalog();
 
-        streamset_connection& open_set_connection(std::string uri);
+        //nullptr if the registry is full
+        streamset_connection* open_set_connection(std::string uri);
         void close_set_connection(streamset_connection* connection);
         streamset& get_or_add(std::string uri, bool claim = false);
         streamset* find_streamset_for_stream(stream* stream);
 
+        //streamsets whose bins are exported to shared memory
+        void set_shared_memory_exports(std::vector<std::string> uris) { sharedMemoryExports_ = uris; }
+        bool is_shared_memory_export(const std::string& uri) const;
+
         void clear();
         void visit_sets(std::function<void(streamset*)> visitorMethod);
         void destroy_set(streamset* set);
@@ -97,6 +102,7 @@ namespace astra {
         using streamsetMap = std::map<std::string, streamset_entry_ptr>;
 
         streamsetMap streamSets_;
+        std::vector<std::string> sharedMemoryExports_;
 
         void on_stream_registered(stream_registered_event_args args);
         void on_stream_unregistering(stream_unregistering_event_args args);
@@ -23,6 +23,11 @@ namespace astra {
     stream_reader* streamset_connection::create_reader()
     {
         ReaderPtr reader = astra::make_unique<stream_reader>(*this);
+        if (!reader->tracked_handle())
+        {
+            return nullptr;
+        }
+
         stream_reader* rawPtr = reader.get();
 
         readers_.push_back(std::move(reader));
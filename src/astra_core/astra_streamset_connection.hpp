@@ -45,6 +45,7 @@ namespace astra {
 
         streamset* get_streamSet() { return streamSet_; }
 
+        //nullptr if the registry is full
         stream_reader* create_reader();
         bool destroy_reader(stream_reader* reader);
 
@@ -57,7 +58,7 @@ namespace astra {
 
         astra_streamsetconnection_t get_handle()
         {
-            return reinterpret_cast<astra_streamsetconnection_t>(this);
+            return reinterpret_cast<astra_streamsetconnection_t>(tracked_handle());
         }
 
     private:
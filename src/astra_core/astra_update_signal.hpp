@@ -0,0 +1,86 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#ifndef ASTRA_UPDATE_SIGNAL_H
+#define ASTRA_UPDATE_SIGNAL_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace astra {
+
+    // Wakes an update thread when there is something to update. Raised when a
+    // plugin cycles a bin, and requested when a plugin asks for an update because
+    // its device has data waiting. The sequence number lets a waiter notice a
+    // raise that happened between its last update and the start of its wait.
+    class update_signal
+    {
+    public:
+        using sequence_type = std::uint64_t;
+
+        void raise()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                ++sequence_;
+            }
+            cv_.notify_all();
+        }
+
+        void request()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                ++sequence_;
+                requested_ = true;
+            }
+            cv_.notify_all();
+        }
+
+        //true once requested. whoever requests updates announces its data,
+        //so its updates needn't be polled for.
+        bool is_requested() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return requested_;
+        }
+
+        sequence_type sequence() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return sequence_;
+        }
+
+        //waits until raised after lastSeen was read, or the timeout elapses.
+        //returns the sequence number to pass to the next wait
+        sequence_type wait_for(sequence_type lastSeen, std::chrono::microseconds timeout)
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait_for(lock, timeout, [this, lastSeen] { return sequence_ != lastSeen; });
+            return sequence_;
+        }
+
+    private:
+        mutable std::mutex mutex_;
+        std::condition_variable cv_;
+        sequence_type sequence_{0};
+        bool requested_{false};
+    };
+}
+
+#endif /* ASTRA_UPDATE_SIGNAL_H */
@@ -0,0 +1,84 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#include "astra_update_thread.hpp"
+#include "astra_logger.hpp"
+#include <cassert>
+
+namespace astra {
+
+    update_thread::update_thread(update_signal& signal,
+                                 UpdateCallback updateCallback,
+                                 std::chrono::microseconds pollInterval,
+                                 std::chrono::microseconds idlePollInterval)
+        : signal_(signal),
+          updateCallback_(updateCallback),
+          pollInterval_(pollInterval),
+          idlePollInterval_(idlePollInterval)
+    {}
+
+    update_thread::~update_thread()
+    {
+        stop();
+    }
+
+    void update_thread::start()
+    {
+        if (running_)
+            return;
+
+        LOG_INFO("astra.update_thread", "starting update thread");
+
+        running_ = true;
+        thread_ = std::thread(&update_thread::run, this);
+    }
+
+    void update_thread::stop()
+    {
+        if (!running_)
+            return;
+
+        LOG_INFO("astra.update_thread", "stopping update thread");
+
+        //joining from the update thread itself would deadlock
+        assert(!is_current_thread());
+
+        running_ = false;
+        signal_.raise();
+
+        if (thread_.joinable())
+        {
+            thread_.join();
+        }
+    }
+
+    void update_thread::run()
+    {
+        update_signal::sequence_type lastSeen = signal_.sequence();
+
+        while (running_)
+        {
+            updateCallback_();
+
+            //returns at once if a frame was produced during the update, so a
+            //plugin with more data waiting is drained before going back to sleep
+            const std::chrono::microseconds timeout =
+                signal_.is_requested() ? idlePollInterval_ : pollInterval_;
+
+            lastSeen = signal_.wait_for(lastSeen, timeout);
+        }
+    }
+}
@@ -0,0 +1,66 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#ifndef ASTRA_UPDATE_THREAD_H
+#define ASTRA_UPDATE_THREAD_H
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include "astra_update_signal.hpp"
+
+namespace astra {
+
+    // Runs an update function on a background thread. The function takes the
+    // locks it needs itself. Between updates the thread sleeps on its update
+    // signal, so a frame that a plugin announces is picked up right away.
+    // Updates that were never requested through the signal are still polled
+    // every pollInterval, the others only every idlePollInterval.
+    class update_thread
+    {
+    public:
+        using UpdateCallback = std::function<void()>;
+
+        update_thread(update_signal& signal,
+                      UpdateCallback updateCallback,
+                      std::chrono::microseconds pollInterval,
+                      std::chrono::microseconds idlePollInterval);
+        ~update_thread();
+
+        update_thread(const update_thread&) = delete;
+        update_thread& operator=(const update_thread&) = delete;
+
+        void start();
+        void stop();
+
+        bool is_running() const { return running_; }
+        bool is_current_thread() const { return thread_.get_id() == std::this_thread::get_id(); }
+
+    private:
+        void run();
+
+        update_signal& signal_;
+        UpdateCallback updateCallback_;
+        std::chrono::microseconds pollInterval_;
+        std::chrono::microseconds idlePollInterval_;
+
+        std::atomic<bool> running_{false};
+        std::thread thread_;
+    };
+}
+
+#endif /* ASTRA_UPDATE_THREAD_H */
@@ -0,0 +1,166 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#include "astra_work_stealing_pool.hpp"
+#include "astra_logger.hpp"
+#include <cassert>
+#include <iterator>
+
+namespace astra {
+
+    //the pool the calling thread works for and its slot in it
+    static thread_local const work_stealing_pool* currentPool = nullptr;
+    static thread_local size_t currentWorkerIndex = 0;
+
+    work_stealing_pool::work_stealing_pool(size_t threadCount)
+    {
+        assert(threadCount > 0);
+
+        for (size_t i = 0; i < threadCount; ++i)
+        {
+            workers_.push_back(std::unique_ptr<worker>(new worker()));
+        }
+
+        //start only once every deque exists, workers steal from each other
+        for (size_t i = 0; i < threadCount; ++i)
+        {
+            workers_[i]->thread = std::thread(&work_stealing_pool::run, this, i);
+        }
+
+        LOG_INFO("astra.work_stealing_pool", "started %u worker threads", threadCount);
+    }
+
+    work_stealing_pool::~work_stealing_pool()
+    {
+        stop();
+    }
+
+    bool work_stealing_pool::is_worker_thread() const
+    {
+        return currentPool == this;
+    }
+
+    bool work_stealing_pool::submit(Task task)
+    {
+        {
+            //held across the check and the push so stop() can't start in between,
+            //and so a worker can't check queuedCount_ and go to sleep in between
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+
+            if (stopping_)
+                return false;
+
+            const size_t index = is_worker_thread()
+                ? currentWorkerIndex
+                : nextWorker_++ % workers_.size();
+
+            worker& target = *workers_[index];
+            std::lock_guard<std::mutex> workerLock(target.mutex);
+            target.tasks.push_back(std::move(task));
+            ++queuedCount_;
+        }
+        wakeCondition_.notify_one();
+
+        return true;
+    }
+
+    void work_stealing_pool::stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            if (stopping_)
+                return;
+
+            stopping_ = true;
+        }
+        wakeCondition_.notify_all();
+
+        //joining from a worker would deadlock
+        assert(!is_worker_thread());
+
+        //the workers stay, submit() may still be looking at them
+        std::deque<Task> discarded;
+        for (auto& w : workers_)
+        {
+            w->thread.join();
+
+            std::lock_guard<std::mutex> lock(w->mutex);
+            std::move(w->tasks.begin(), w->tasks.end(), std::back_inserter(discarded));
+            w->tasks.clear();
+        }
+
+        if (!discarded.empty())
+        {
+            LOG_DEBUG("astra.work_stealing_pool", "stopped with %u tasks queued", discarded.size());
+        }
+    }
+
+    bool work_stealing_pool::pop_local(size_t index, Task& task)
+    {
+        worker& self = *workers_[index];
+        std::lock_guard<std::mutex> lock(self.mutex);
+
+        if (self.tasks.empty())
+            return false;
+
+        task = std::move(self.tasks.back());
+        self.tasks.pop_back();
+        return true;
+    }
+
+    bool work_stealing_pool::steal(size_t thiefIndex, Task& task)
+    {
+        const size_t count = workers_.size();
+
+        for (size_t offset = 1; offset < count; ++offset)
+        {
+            worker& victim = *workers_[(thiefIndex + offset) % count];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+
+            if (!victim.tasks.empty())
+            {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void work_stealing_pool::run(size_t index)
+    {
+        currentPool = this;
+        currentWorkerIndex = index;
+
+        while (!stopping_)
+        {
+            Task task;
+
+            if (pop_local(index, task) || steal(index, task))
+            {
+                --queuedCount_;
+                task();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            wakeCondition_.wait(lock, [this] { return stopping_ || queuedCount_ > 0; });
+        }
+
+        currentPool = nullptr;
+    }
+}
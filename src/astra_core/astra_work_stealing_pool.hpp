@@ -0,0 +1,79 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#ifndef ASTRA_WORK_STEALING_POOL_H
+#define ASTRA_WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace astra {
+
+    // Fixed set of worker threads, each with its own task deque. A worker
+    // runs its newest task first and steals the oldest task of another
+    // worker when it runs out, so a task submitted from a worker (the next
+    // stage of a pipeline) usually runs on the same thread while idle
+    // workers pick up independent work.
+    class work_stealing_pool
+    {
+    public:
+        using Task = std::function<void()>;
+
+        explicit work_stealing_pool(size_t threadCount);
+        ~work_stealing_pool();
+
+        work_stealing_pool(const work_stealing_pool&) = delete;
+        work_stealing_pool& operator=(const work_stealing_pool&) = delete;
+
+        //false once stopped, the task is not run
+        bool submit(Task task);
+
+        //waits for running tasks to return and discards queued ones. the
+        //first call stops the workers, later ones return right away
+        void stop();
+
+        size_t thread_count() const { return workers_.size(); }
+        bool is_worker_thread() const;
+
+    private:
+        struct worker
+        {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+            std::thread thread;
+        };
+
+        void run(size_t index);
+        bool pop_local(size_t index, Task& task);
+        bool steal(size_t thiefIndex, Task& task);
+
+        std::vector<std::unique_ptr<worker>> workers_;
+
+        std::mutex sleepMutex_;
+        std::condition_variable wakeCondition_;
+        std::atomic<size_t> queuedCount_{0};
+        std::atomic<size_t> nextWorker_{0};
+        std::atomic<bool> stopping_{false};
+    };
+}
+
+#endif /* ASTRA_WORK_STEALING_POOL_H */
@@ -0,0 +1,256 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#include "catch.hpp"
+#include "../astra_async_log_sink.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+    //the sink dispatches through a plain function pointer, so the records
+    //it writes out are collected here
+    struct dispatched_records
+    {
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::vector<astra::log_record> records;
+        size_t noticeCount{0};
+        size_t droppedReported{0};
+
+        bool gateClosed{false};
+        bool dispatching{false};
+
+        void reset()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            records.clear();
+            noticeCount = 0;
+            droppedReported = 0;
+            gateClosed = false;
+            dispatching = false;
+        }
+    };
+
+    dispatched_records dispatched;
+
+    bool is_drop_notice(const astra::log_record& record)
+    {
+        return std::strcmp(record.channel, "astra.logging") == 0;
+    }
+
+    void collect(const astra::log_record& record)
+    {
+        std::unique_lock<std::mutex> lock(dispatched.mutex);
+
+        if (is_drop_notice(record))
+        {
+            unsigned long count = 0;
+            std::sscanf(record.message, "async log queue full, dropped %lu messages", &count);
+            ++dispatched.noticeCount;
+            dispatched.droppedReported += count;
+            return;
+        }
+
+        dispatched.records.push_back(record);
+
+        //holds the drain thread inside dispatch until the test opens the gate
+        dispatched.dispatching = true;
+        dispatched.condition.notify_all();
+        dispatched.condition.wait(lock, [] { return !dispatched.gateClosed; });
+    }
+
+    bool enqueue(astra::async_log_sink& sink, const char* format, ...)
+    {
+        va_list args;
+        va_start(args, format);
+        bool enqueued = sink.try_enqueue("tests", ASTRA_SEVERITY_INFO, __FILE__, __LINE__, __func__, format, args);
+        va_end(args);
+
+        return enqueued;
+    }
+}
+
+TEST_CASE("Async log sink writes out concurrent records in enqueue order", "[async_log_sink]") {
+    dispatched.reset();
+
+    const int producerCount = 4;
+    const int recordsPerProducer = 2000;
+
+    astra::async_log_sink sink(&collect, 256);
+    sink.start();
+
+    std::vector<int> acceptedCounts(producerCount, 0);
+    std::vector<std::thread> producers;
+    for (int producer = 0; producer < producerCount; ++producer)
+    {
+        producers.emplace_back([&sink, &acceptedCounts, producer] {
+            for (int i = 0; i < recordsPerProducer; ++i)
+            {
+                if (enqueue(sink, "%d %d", producer, i))
+                {
+                    ++acceptedCounts[producer];
+                }
+            }
+        });
+    }
+
+    for (auto& producer : producers)
+    {
+        producer.join();
+    }
+
+    sink.stop();
+
+    size_t acceptedCount = 0;
+    for (int count : acceptedCounts)
+    {
+        acceptedCount += count;
+    }
+
+    std::lock_guard<std::mutex> lock(dispatched.mutex);
+    REQUIRE(dispatched.records.size() == acceptedCount);
+    REQUIRE(sink.dropped_count() == producerCount * recordsPerProducer - acceptedCount);
+    REQUIRE(dispatched.droppedReported == sink.dropped_count());
+
+    //each producer's records come out in the order it enqueued them
+    std::vector<int> lastSeen(producerCount, -1);
+    for (const auto& record : dispatched.records)
+    {
+        int producer = -1;
+        int index = -1;
+        REQUIRE(std::sscanf(record.message, "%d %d", &producer, &index) == 2);
+        REQUIRE(producer >= 0);
+        REQUIRE(producer < producerCount);
+        REQUIRE(index > lastSeen[producer]);
+        lastSeen[producer] = index;
+    }
+}
+
+TEST_CASE("Async log sink drops and counts records when its queue is full", "[async_log_sink]") {
+    dispatched.reset();
+
+    astra::async_log_sink sink(&collect, 8);
+    sink.start();
+
+    {
+        std::lock_guard<std::mutex> lock(dispatched.mutex);
+        dispatched.gateClosed = true;
+    }
+
+    //the drain thread takes the first record and is held inside dispatch,
+    //so its cell stays claimed and seven are left
+    REQUIRE(enqueue(sink, "first"));
+    {
+        std::unique_lock<std::mutex> lock(dispatched.mutex);
+        REQUIRE(dispatched.condition.wait_for(lock,
+                                              std::chrono::seconds(5),
+                                              [] { return dispatched.dispatching; }));
+    }
+
+    int acceptedCount = 0;
+    for (int i = 0; i < 10; ++i)
+    {
+        if (enqueue(sink, "record %d", i))
+        {
+            ++acceptedCount;
+        }
+    }
+
+    REQUIRE(acceptedCount == 7);
+    REQUIRE(sink.dropped_count() == 3);
+
+    {
+        std::lock_guard<std::mutex> lock(dispatched.mutex);
+        dispatched.gateClosed = false;
+    }
+    dispatched.condition.notify_all();
+
+    sink.stop();
+
+    std::lock_guard<std::mutex> lock(dispatched.mutex);
+    REQUIRE(dispatched.records.size() == 8);
+    REQUIRE(dispatched.noticeCount == 1);
+    REQUIRE(dispatched.droppedReported == 3);
+
+    //the accepted records are the first seven, the last three were dropped
+    REQUIRE(std::strcmp(dispatched.records.back().message, "record 6") == 0);
+}
+
+TEST_CASE("Async log sink writes out records enqueued while it stops", "[async_log_sink]") {
+    for (int round = 0; round < 20; ++round)
+    {
+        dispatched.reset();
+
+        astra::async_log_sink sink(&collect, 64);
+        sink.start();
+
+        std::atomic<bool> producing(true);
+        std::atomic<size_t> acceptedCount(0);
+        std::atomic<size_t> acceptedAfterStop(0);
+        std::atomic<size_t> rejectedAfterStop(0);
+        std::atomic<bool> stopped(false);
+
+        std::vector<std::thread> producers;
+        for (int producer = 0; producer < 3; ++producer)
+        {
+            producers.emplace_back([&] {
+                while (producing)
+                {
+                    const bool wasStopped = stopped;
+                    if (enqueue(sink, "record"))
+                    {
+                        ++acceptedCount;
+                        if (wasStopped)
+                        {
+                            ++acceptedAfterStop;
+                        }
+                    }
+                    else if (wasStopped)
+                    {
+                        ++rejectedAfterStop;
+                    }
+                }
+            });
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        sink.stop();
+        stopped = true;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        producing = false;
+
+        for (auto& producer : producers)
+        {
+            producer.join();
+        }
+
+        REQUIRE_FALSE(sink.is_running());
+        //nothing is accepted once stop() has returned
+        REQUIRE(acceptedAfterStop == 0u);
+        REQUIRE(rejectedAfterStop > 0u);
+
+        std::lock_guard<std::mutex> lock(dispatched.mutex);
+        REQUIRE(dispatched.records.size() == acceptedCount);
+    }
+}
@@ -0,0 +1,274 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#include "catch.hpp"
+#include "../astra_dataflow_scheduler.hpp"
+#include "../astra_streamset.hpp"
+#include "../astra_streamset_connection.hpp"
+#include "../astra_stream_reader.hpp"
+#include "../astra_stream.hpp"
+#include "../astra_stream_bin.hpp"
+#include "../astra_retained_frame.hpp"
+#include "../astra_logger.hpp"
+#include "../astra_core_mutex.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+    //a stream and its bin read by one reader, with a node on the reader
+    class scheduler_fixture
+    {
+    public:
+        scheduler_fixture(size_t threadCount)
+            : set_("test/dataflow_scheduler"),
+              scheduler_(coreMutex_, threadCount)
+        {
+            //logging isn't initialized without a context
+            astra::set_log_severity(ASTRA_SEVERITY_FATAL);
+
+            stream_callbacks_t callbacks{};
+            astra::stream* stream = set_.register_stream(desc_);
+            set_.claim_stream(stream, callbacks);
+
+            bin_ = stream->create_bin(sizeof(int32_t), 3);
+            backBuffer_ = bin_->get_backBuffer();
+
+            reader_.reset(new astra::stream_reader(*set_.add_new_connection()));
+            reader_->get_stream(desc_)->set_bin(bin_);
+        }
+
+        ~scheduler_fixture()
+        {
+            scheduler_.stop();
+            reader_->get_stream(desc_)->set_bin(nullptr);
+        }
+
+        //called with the core mutex held
+        astra_callback_id_t add_node(astra_frame_ready_callback_t callback, void* clientTag)
+        {
+            return scheduler_.add_node(*reader_, &desc_, 1, nullptr, 0, callback, clientTag);
+        }
+
+        //called with the core mutex held, as plugins write frames
+        void produce(astra_frame_index_t frameIndex)
+        {
+            backBuffer_->frameIndex = frameIndex;
+            *static_cast<int32_t*>(backBuffer_->data) = frameIndex;
+            backBuffer_ = bin_->cycle_buffers();
+        }
+
+        astra_frame_index_t frame_index_of(astra_reader_frame_t frame)
+        {
+            astra::retained_frame* retained = astra::retained_frame::from_frame(frame);
+            astra_frame_t* subFrame = retained != nullptr
+                ? retained->get_subframe(desc_)
+                : reader_->get_subframe(desc_);
+
+            return subFrame != nullptr ? subFrame->frameIndex : -1;
+        }
+
+        astra::core_mutex& core_mutex() { return coreMutex_; }
+        astra::dataflow_scheduler& scheduler() { return scheduler_; }
+
+    private:
+        astra_stream_desc_t desc_{ 1, 0 };
+        astra::core_mutex coreMutex_;
+        astra::streamset set_;
+        astra::dataflow_scheduler scheduler_;
+        astra::stream_bin* bin_;
+        astra_frame_t* backBuffer_;
+        std::unique_ptr<astra::stream_reader> reader_;
+    };
+
+    //what a node callback saw, and a gate that holds it in its callback
+    struct node_probe
+    {
+        scheduler_fixture* fixture;
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::vector<astra_frame_index_t> frameIndices;
+        std::vector<std::thread::id> threads;
+        bool isGateOpen{true};
+        bool isInCallback{false};
+        //takes the core mutex before returning, as a node writing a frame does
+        bool usesCore{false};
+
+        static void callback(void* clientTag, astra_reader_t reader, astra_reader_frame_t frame)
+        {
+            node_probe* self = static_cast<node_probe*>(clientTag);
+            const astra_frame_index_t frameIndex = self->fixture->frame_index_of(frame);
+
+            std::unique_lock<std::mutex> lock(self->mutex);
+            self->isInCallback = true;
+            self->condition.notify_all();
+            self->condition.wait(lock, [self] { return self->isGateOpen; });
+
+            if (self->usesCore)
+            {
+                lock.unlock();
+                std::lock_guard<astra::core_mutex> coreLock(self->fixture->core_mutex());
+                lock.lock();
+            }
+
+            self->frameIndices.push_back(frameIndex);
+            self->threads.push_back(std::this_thread::get_id());
+            self->isInCallback = false;
+            self->condition.notify_all();
+        }
+
+        bool wait_until(std::function<bool()> predicate)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            return condition.wait_for(lock, std::chrono::seconds(10), predicate);
+        }
+
+        void set_gate(bool isOpen)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            isGateOpen = isOpen;
+            condition.notify_all();
+        }
+    };
+}
+
+TEST_CASE("Dataflow node without workers runs on the producing thread", "[dataflow_scheduler]") {
+    scheduler_fixture fixture(0);
+    node_probe probe;
+    probe.fixture = &fixture;
+
+    std::lock_guard<astra::core_mutex> lock(fixture.core_mutex());
+    astra_callback_id_t nodeId = fixture.add_node(&node_probe::callback, &probe);
+
+    fixture.produce(1);
+
+    REQUIRE(probe.frameIndices == std::vector<astra_frame_index_t>{ 1 });
+    REQUIRE(probe.threads.front() == std::this_thread::get_id());
+    REQUIRE(fixture.scheduler().remove_node(nodeId));
+    REQUIRE_FALSE(fixture.scheduler().remove_node(nodeId));
+}
+
+TEST_CASE("Dataflow node with workers runs off the producing thread", "[dataflow_scheduler]") {
+    scheduler_fixture fixture(2);
+    node_probe probe;
+    probe.fixture = &fixture;
+
+    astra_callback_id_t nodeId;
+    {
+        std::lock_guard<astra::core_mutex> lock(fixture.core_mutex());
+        nodeId = fixture.add_node(&node_probe::callback, &probe);
+        fixture.produce(1);
+    }
+
+    REQUIRE(probe.wait_until([&probe] { return probe.frameIndices.size() == 1; }));
+    REQUIRE(probe.frameIndices.front() == 1);
+    REQUIRE(probe.threads.front() != std::this_thread::get_id());
+
+    std::lock_guard<astra::core_mutex> lock(fixture.core_mutex());
+    REQUIRE(fixture.scheduler().remove_node(nodeId));
+}
+
+TEST_CASE("Busy dataflow node keeps only the newest frame", "[dataflow_scheduler]") {
+    scheduler_fixture fixture(2);
+    node_probe probe;
+    probe.fixture = &fixture;
+    probe.isGateOpen = false;
+
+    astra_callback_id_t nodeId;
+    {
+        std::lock_guard<astra::core_mutex> lock(fixture.core_mutex());
+        nodeId = fixture.add_node(&node_probe::callback, &probe);
+        fixture.produce(1);
+    }
+
+    REQUIRE(probe.wait_until([&probe] { return probe.isInCallback; }));
+
+    {
+        std::lock_guard<astra::core_mutex> lock(fixture.core_mutex());
+        fixture.produce(2);
+        fixture.produce(3);
+        fixture.produce(4);
+    }
+
+    probe.set_gate(true);
+    REQUIRE(probe.wait_until([&probe] { return probe.frameIndices.size() == 2; }));
+    REQUIRE(probe.frameIndices == std::vector<astra_frame_index_t>({ 1, 4 }));
+
+    std::lock_guard<astra::core_mutex> lock(fixture.core_mutex());
+    REQUIRE(fixture.scheduler().remove_node(nodeId));
+}
+
+TEST_CASE("Removing a dataflow node waits for a callback that needs the core mutex", "[dataflow_scheduler]") {
+    scheduler_fixture fixture(2);
+    node_probe probe;
+    probe.fixture = &fixture;
+    probe.isGateOpen = false;
+    probe.usesCore = true;
+
+    //held twice, as by a plugin removing its node from a core callback
+    std::lock_guard<astra::core_mutex> lock(fixture.core_mutex());
+    std::lock_guard<astra::core_mutex> nestedLock(fixture.core_mutex());
+
+    astra_callback_id_t nodeId = fixture.add_node(&node_probe::callback, &probe);
+    fixture.produce(1);
+
+    REQUIRE(probe.wait_until([&probe] { return probe.isInCallback; }));
+    probe.set_gate(true);
+
+    REQUIRE(fixture.scheduler().remove_node(nodeId));
+
+    std::lock_guard<std::mutex> probeLock(probe.mutex);
+    REQUIRE_FALSE(probe.isInCallback);
+    REQUIRE(probe.frameIndices == std::vector<astra_frame_index_t>{ 1 });
+}
+
+TEST_CASE("Core mutex lent to one thread keeps others out", "[dataflow_scheduler]") {
+    astra::core_mutex coreMutex;
+    std::atomic<bool> borrowerDone{false};
+    std::atomic<bool> otherGotIn{false};
+
+    std::lock_guard<astra::core_mutex> lock(coreMutex);
+
+    std::thread other([&] {
+        std::lock_guard<astra::core_mutex> otherLock(coreMutex);
+        otherGotIn = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    {
+        std::thread borrower([&] {
+            std::lock_guard<astra::core_mutex> borrowerLock(coreMutex);
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            borrowerDone = true;
+        });
+
+        astra::core_mutex::loan loan(coreMutex, borrower.get_id());
+        borrower.join();
+    }
+
+    REQUIRE(borrowerDone);
+    REQUIRE_FALSE(otherGotIn);
+    REQUIRE(coreMutex.is_held_once());
+
+    coreMutex.unlock();
+    other.join();
+    coreMutex.lock();
+    REQUIRE(otherGotIn);
+}
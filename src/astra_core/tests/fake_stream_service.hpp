@@ -0,0 +1,214 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#ifndef FAKE_STREAM_SERVICE_H
+#define FAKE_STREAM_SERVICE_H
+
+#include <astra_core/capi/astra_core.h>
+#include <astra_core_api.h>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+//stands in for the core behind the C API, frames are raised by hand.
+//raising a frame, changing callbacks, getting streams and destroying readers
+//take a core mutex like the real calls do, retained frames are released
+//without it.
+class fake_stream_service
+{
+public:
+    fake_stream_service()
+    {
+        proxy_.streamService = this;
+        proxy_.reader_destroy = &fake_stream_service::reader_destroy;
+        proxy_.reader_get_stream = &fake_stream_service::reader_get_stream;
+        proxy_.reader_close_frame = &fake_stream_service::reader_close_frame;
+        proxy_.reader_register_frame_ready_callback = &fake_stream_service::register_callback;
+        proxy_.reader_unregister_frame_ready_callback = &fake_stream_service::unregister_callback;
+        proxy_.frame_retain = &fake_stream_service::frame_retain;
+        proxy_.frame_release = &fake_stream_service::reader_close_frame;
+
+        astra_api_set_proxy(&proxy_);
+    }
+
+    ~fake_stream_service()
+    {
+        astra_api_set_proxy(nullptr);
+    }
+
+    astra_reader_t create_reader()
+    {
+        return to_handle<astra_reader_t>(++lastHandle_);
+    }
+
+    void raise_frame(astra_reader_t reader, int frameNumber)
+    {
+        std::lock_guard<std::recursive_mutex> lock(coreMutex_);
+
+        astra_reader_frame_t frame = to_handle<astra_reader_frame_t>(++lastHandle_);
+        set_frame_number(frame, frameNumber);
+
+        std::vector<registration> callbacks;
+        for (auto& entry : callbacks_)
+        {
+            if (entry.second.reader == reader)
+            {
+                callbacks.push_back(entry.second);
+            }
+        }
+
+        for (auto& callback : callbacks)
+        {
+            callback.callback(callback.clientTag, reader, frame);
+        }
+
+        erase_frame(frame);
+    }
+
+    int frame_number(astra_reader_frame_t frame) const
+    {
+        std::lock_guard<std::mutex> lock(frameMutex_);
+
+        auto it = frameNumbers_.find(frame);
+        return it != frameNumbers_.end() ? it->second : -1;
+    }
+
+    size_t callback_count() const
+    {
+        std::lock_guard<std::recursive_mutex> lock(coreMutex_);
+        return callbacks_.size();
+    }
+
+    size_t retained_frame_count() const
+    {
+        std::lock_guard<std::mutex> lock(frameMutex_);
+        return frameNumbers_.size();
+    }
+
+    size_t destroyed_reader_count() const { return destroyedReaders_; }
+
+private:
+    struct registration
+    {
+        astra_reader_t reader;
+        astra_frame_ready_callback_t callback;
+        void* clientTag;
+    };
+
+    template<typename T>
+    static T to_handle(uintptr_t value)
+    {
+        return reinterpret_cast<T>(value);
+    }
+
+    static fake_stream_service& self(void* streamService)
+    {
+        return *static_cast<fake_stream_service*>(streamService);
+    }
+
+    void set_frame_number(astra_reader_frame_t frame, int frameNumber)
+    {
+        std::lock_guard<std::mutex> lock(frameMutex_);
+        frameNumbers_[frame] = frameNumber;
+    }
+
+    void erase_frame(astra_reader_frame_t frame)
+    {
+        std::lock_guard<std::mutex> lock(frameMutex_);
+        frameNumbers_.erase(frame);
+    }
+
+    static astra_status_t reader_destroy(void* streamService, astra_reader_t* reader)
+    {
+        fake_stream_service& service = self(streamService);
+        std::lock_guard<std::recursive_mutex> lock(service.coreMutex_);
+
+        ++service.destroyedReaders_;
+        *reader = nullptr;
+        return ASTRA_STATUS_SUCCESS;
+    }
+
+    static astra_status_t reader_get_stream(void* streamService,
+                                            astra_reader_t reader,
+                                            astra_stream_type_t type,
+                                            astra_stream_subtype_t subtype,
+                                            astra_streamconnection_t* connection)
+    {
+        fake_stream_service& service = self(streamService);
+        std::lock_guard<std::recursive_mutex> lock(service.coreMutex_);
+
+        *connection = to_handle<astra_streamconnection_t>(++service.lastHandle_);
+        return ASTRA_STATUS_SUCCESS;
+    }
+
+    static astra_status_t reader_close_frame(void* streamService, astra_reader_frame_t* frame)
+    {
+        self(streamService).erase_frame(*frame);
+        *frame = nullptr;
+        return ASTRA_STATUS_SUCCESS;
+    }
+
+    static astra_status_t register_callback(void* streamService,
+                                            astra_reader_t reader,
+                                            astra_frame_ready_callback_t callback,
+                                            void* clientTag,
+                                            astra_reader_callback_id_t* callbackId)
+    {
+        fake_stream_service& service = self(streamService);
+        std::lock_guard<std::recursive_mutex> lock(service.coreMutex_);
+
+        *callbackId = to_handle<astra_reader_callback_id_t>(++service.lastHandle_);
+        service.callbacks_[*callbackId] = { reader, callback, clientTag };
+        return ASTRA_STATUS_SUCCESS;
+    }
+
+    static astra_status_t unregister_callback(void* streamService,
+                                              astra_reader_callback_id_t* callbackId)
+    {
+        fake_stream_service& service = self(streamService);
+        std::lock_guard<std::recursive_mutex> lock(service.coreMutex_);
+
+        service.callbacks_.erase(*callbackId);
+        *callbackId = nullptr;
+        return ASTRA_STATUS_SUCCESS;
+    }
+
+    static astra_status_t frame_retain(void* streamService,
+                                       astra_reader_frame_t frame,
+                                       astra_reader_frame_t* retainedFrame)
+    {
+        fake_stream_service& service = self(streamService);
+
+        *retainedFrame = to_handle<astra_reader_frame_t>(++service.lastHandle_);
+        service.set_frame_number(*retainedFrame, service.frame_number(frame));
+        return ASTRA_STATUS_SUCCESS;
+    }
+
+    astra_streamservice_proxy_t proxy_{};
+    std::atomic<uintptr_t> lastHandle_{0};
+
+    mutable std::recursive_mutex coreMutex_;
+    std::map<astra_reader_callback_id_t, registration> callbacks_;
+
+    mutable std::mutex frameMutex_;
+    std::map<astra_reader_frame_t, int> frameNumbers_;
+
+    std::atomic<size_t> destroyedReaders_{0};
+};
+
+#endif // FAKE_STREAM_SERVICE_H
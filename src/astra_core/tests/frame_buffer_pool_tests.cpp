@@ -0,0 +1,133 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#include "catch.hpp"
+#include "../astra_frame_buffer_pool.hpp"
+#include "../astra_stream_bin.hpp"
+#include "../astra_logger.hpp"
+#include <algorithm>
+#include <vector>
+
+TEST_CASE("Frame buffer pool recycles released buffers", "[frame_buffer_pool]") {
+    auto pool = astra::frame_buffer_pool::create(1024);
+
+    uint8_t* first;
+    {
+        auto buffer = pool->acquire(64);
+        first = buffer.get();
+    }
+    REQUIRE(pool->cached_bytes() == 64);
+
+    //any size in the same class gets the released buffer
+    auto recycled = pool->acquire(60);
+    REQUIRE(recycled.get() == first);
+    REQUIRE(pool->cached_bytes() == 0);
+}
+
+TEST_CASE("Frame buffer pool aligns buffers", "[frame_buffer_pool]") {
+    auto pool = astra::frame_buffer_pool::create(0);
+
+    auto small = pool->acquire(1);
+    auto large = pool->acquire(640 * 480 * 2 + 1);
+
+    REQUIRE((reinterpret_cast<uintptr_t>(small.get()) % astra::frame_buffer_pool::ALIGNMENT) == 0);
+    REQUIRE((reinterpret_cast<uintptr_t>(large.get()) % astra::frame_buffer_pool::ALIGNMENT) == 0);
+}
+
+TEST_CASE("Frame buffer pool rounds sizes to size classes", "[frame_buffer_pool]") {
+    using astra::frame_buffer_pool;
+
+    REQUIRE(frame_buffer_pool::size_class_of(0) == 64);
+    REQUIRE(frame_buffer_pool::size_class_of(65) == 128);
+    REQUIRE(frame_buffer_pool::size_class_of(4097) == 8192);
+    REQUIRE(frame_buffer_pool::size_class_of(frame_buffer_pool::HUGE_PAGE_SIZE + 1) ==
+            frame_buffer_pool::HUGE_PAGE_SIZE + 4096);
+    REQUIRE(frame_buffer_pool::size_class_of(frame_buffer_pool::HUGE_PAGE_MIN_BUFFER_SIZE + 1) ==
+            frame_buffer_pool::HUGE_PAGE_MIN_BUFFER_SIZE + frame_buffer_pool::HUGE_PAGE_SIZE);
+}
+
+TEST_CASE("Frame buffer pool keeps size classes apart", "[frame_buffer_pool]") {
+    auto pool = astra::frame_buffer_pool::create(1024);
+
+    uint8_t* smallData;
+    {
+        auto small = pool->acquire(64);
+        smallData = small.get();
+    }
+
+    auto larger = pool->acquire(128);
+    REQUIRE(larger.get() != smallData);
+    REQUIRE(pool->cached_bytes() == 64);
+}
+
+TEST_CASE("Frame buffer pool outlives its last owner", "[frame_buffer_pool]") {
+    auto pool = astra::frame_buffer_pool::create(1024);
+    auto buffer = pool->acquire(16);
+    std::weak_ptr<astra::frame_buffer_pool> weakPool = pool;
+
+    pool = nullptr;
+    REQUIRE_FALSE(weakPool.expired());
+
+    buffer.get()[15] = 42;
+    buffer = nullptr;
+    REQUIRE(weakPool.expired());
+}
+
+TEST_CASE("Frame buffer pool caches at most its limit", "[frame_buffer_pool]") {
+    auto pool = astra::frame_buffer_pool::create(128);
+
+    auto a = pool->acquire(64);
+    auto b = pool->acquire(64);
+    auto c = pool->acquire(64);
+
+    a = nullptr;
+    b = nullptr;
+    c = nullptr;
+    REQUIRE(pool->cached_bytes() == 128);
+
+    pool->trim();
+    REQUIRE(pool->cached_bytes() == 0);
+}
+
+TEST_CASE("Stream bin clears only its initial front buffer", "[frame_buffer_pool]") {
+    //logging isn't initialized without a context
+    astra::set_log_severity(ASTRA_SEVERITY_FATAL);
+
+    //a size class nothing else uses, filled with an old frame
+    const size_t bufferSize = 3000;
+    const size_t bufferCount = 3;
+    std::vector<uint8_t*> released;
+    {
+        std::vector<astra::frame_buffer_pool::buffer_ptr> buffers;
+        for (size_t i = 0; i < bufferCount; ++i)
+        {
+            buffers.push_back(astra::frame_buffer_pool::shared().acquire(bufferSize));
+            std::fill_n(buffers.back().get(), bufferSize, 0xAB);
+            released.push_back(buffers.back().get());
+        }
+    }
+
+    astra::stream_bin bin(bufferSize, bufferCount);
+
+    uint8_t* front = static_cast<uint8_t*>(bin.lock_front_buffer()->data);
+    REQUIRE(std::count(front, front + bufferSize, 0) == bufferSize);
+    bin.unlock_front_buffer();
+
+    //the back buffer is left for the producer to write
+    uint8_t* back = static_cast<uint8_t*>(bin.get_backBuffer()->data);
+    REQUIRE(std::find(released.begin(), released.end(), back) != released.end());
+    REQUIRE(std::count(back, back + bufferSize, 0xAB) == bufferSize);
+}
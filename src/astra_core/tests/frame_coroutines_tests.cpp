@@ -0,0 +1,207 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "fake_stream_service.hpp"
+#include <astra_core/StreamReader.hpp>
+#include <deque>
+#include <functional>
+#include <vector>
+
+namespace {
+    //runs tasks only when asked, so the test sees where coroutines resume
+    class manual_executor : public astra::FrameExecutor
+    {
+    public:
+        void execute(std::function<void()> task) override
+        {
+            tasks_.push_back(std::move(task));
+        }
+
+        size_t run_all()
+        {
+            size_t count = 0;
+            while (!tasks_.empty())
+            {
+                std::function<void()> task = std::move(tasks_.front());
+                tasks_.pop_front();
+                task();
+                ++count;
+            }
+            return count;
+        }
+
+    private:
+        std::deque<std::function<void()>> tasks_;
+    };
+
+    //reads the raw reader frame back out of an astra::Frame
+    struct raw_frame
+    {
+        template<typename T>
+        static T acquire(astra_reader_frame_t frame, astra_stream_subtype_t)
+        {
+            return T{ frame };
+        }
+
+        astra_reader_frame_t frame;
+    };
+
+    //the reader is taken by reference so the coroutine doesn't keep it alive
+    astra::FrameTask await_next_frame(astra::StreamReader& reader,
+                                      astra::FrameExecutor& executor,
+                                      fake_stream_service& service,
+                                      std::vector<int>& frameNumbers,
+                                      bool& finished)
+    {
+        astra::Frame frame = co_await reader.next_frame(executor);
+        frameNumbers.push_back(frame.is_valid() ? service.frame_number(frame.get<raw_frame>().frame) : -1);
+        finished = true;
+    }
+
+    astra::FrameTask read_frames(astra::StreamReader& reader,
+                                 astra::FrameExecutor& executor,
+                                 size_t maxPendingFrames,
+                                 fake_stream_service& service,
+                                 std::vector<int>& frameNumbers,
+                                 bool& finished)
+    {
+        astra::FrameSequence frames = reader.frames(executor, maxPendingFrames);
+
+        for (;;)
+        {
+            astra::Frame frame = co_await frames.next();
+            if (!frame.is_valid())
+                break;
+
+            frameNumbers.push_back(service.frame_number(frame.get<raw_frame>().frame));
+        }
+
+        finished = true;
+    }
+}
+
+TEST_CASE("next_frame resumes on the executor with the next frame", "[frame_coroutines]")
+{
+    fake_stream_service service;
+    manual_executor executor;
+    std::vector<int> frameNumbers;
+    bool finished = false;
+
+    {
+        astra::StreamReader reader(service.create_reader());
+        astra_reader_t rawReader = reader.get_handle();
+
+        await_next_frame(reader, executor, service, frameNumbers, finished);
+        REQUIRE(service.callback_count() == 1);
+        REQUIRE(executor.run_all() == 0);
+
+        service.raise_frame(rawReader, 1);
+        REQUIRE_FALSE(finished);
+
+        REQUIRE(executor.run_all() == 1);
+        REQUIRE(finished);
+        REQUIRE((frameNumbers == std::vector<int>{ 1 }));
+
+        //the awaitable went with the coroutine, later frames go nowhere
+        REQUIRE(service.callback_count() == 0);
+        REQUIRE(service.retained_frame_count() == 0);
+        service.raise_frame(rawReader, 2);
+        REQUIRE(executor.run_all() == 0);
+    }
+
+    REQUIRE(service.destroyed_reader_count() == 1);
+}
+
+TEST_CASE("frames delivers in order and drops the oldest beyond maxPendingFrames", "[frame_coroutines]")
+{
+    fake_stream_service service;
+    manual_executor executor;
+    std::vector<int> frameNumbers;
+    bool finished = false;
+
+    astra::StreamReader reader(service.create_reader());
+    astra_reader_t rawReader = reader.get_handle();
+
+    read_frames(reader, executor, 2, service, frameNumbers, finished);
+
+    service.raise_frame(rawReader, 1);
+    service.raise_frame(rawReader, 2);
+    service.raise_frame(rawReader, 3);
+
+    //the dropped frame is released right away
+    REQUIRE(service.retained_frame_count() == 2);
+
+    executor.run_all();
+    REQUIRE((frameNumbers == std::vector<int>{ 2, 3 }));
+    REQUIRE_FALSE(finished);
+
+    service.raise_frame(rawReader, 4);
+    executor.run_all();
+    REQUIRE((frameNumbers == std::vector<int>{ 2, 3, 4 }));
+    REQUIRE(service.retained_frame_count() == 0);
+    REQUIRE_FALSE(finished);
+
+    //pending frames are still delivered once the reader is gone, then an
+    //invalid frame ends the loop
+    service.raise_frame(rawReader, 5);
+    reader = astra::StreamReader();
+    REQUIRE(service.destroyed_reader_count() == 1);
+    REQUIRE(service.callback_count() == 0);
+
+    executor.run_all();
+    REQUIRE(finished);
+    REQUIRE((frameNumbers == std::vector<int>{ 2, 3, 4, 5 }));
+    REQUIRE(service.retained_frame_count() == 0);
+}
+
+TEST_CASE("destroying the reader resumes a suspended FrameTask with an invalid frame", "[frame_coroutines]")
+{
+    fake_stream_service service;
+    manual_executor executor;
+    std::vector<int> frameNumbers;
+    bool finished = false;
+
+    {
+        astra::StreamReader reader(service.create_reader());
+        await_next_frame(reader, executor, service, frameNumbers, finished);
+    }
+
+    //a FrameTask can't be cancelled, so the reader going away must wake it
+    REQUIRE(service.destroyed_reader_count() == 1);
+    REQUIRE(service.callback_count() == 0);
+    REQUIRE_FALSE(finished);
+
+    REQUIRE(executor.run_all() == 1);
+    REQUIRE(finished);
+    REQUIRE((frameNumbers == std::vector<int>{ -1 }));
+}
+
+TEST_CASE("destroying the reader before awaiting next gives an invalid frame without suspending", "[frame_coroutines]")
+{
+    fake_stream_service service;
+    manual_executor executor;
+
+    astra::StreamReader reader(service.create_reader());
+    astra::FrameSequence frames = reader.frames(executor, 1);
+    reader = astra::StreamReader();
+
+    auto next = frames.next();
+    REQUIRE(next.await_ready());
+    REQUIRE_FALSE(next.await_resume().is_valid());
+    REQUIRE(executor.run_all() == 0);
+}
@@ -0,0 +1,445 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "fake_stream_service.hpp"
+#include <astra_core/StreamReader.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+    //runs tasks only when asked, so the test sees when listeners run
+    class manual_executor : public astra::FrameExecutor
+    {
+    public:
+        void execute(std::function<void()> task) override
+        {
+            tasks_.push_back(std::move(task));
+        }
+
+        size_t run_all()
+        {
+            size_t count = 0;
+            while (!tasks_.empty())
+            {
+                std::function<void()> task = std::move(tasks_.front());
+                tasks_.pop_front();
+                task();
+                ++count;
+            }
+            return count;
+        }
+
+    private:
+        std::deque<std::function<void()>> tasks_;
+    };
+
+    //reads the raw reader frame back out of an astra::Frame
+    struct raw_frame
+    {
+        template<typename T>
+        static T acquire(astra_reader_frame_t frame, astra_stream_subtype_t)
+        {
+            return T{ frame };
+        }
+
+        astra_reader_frame_t frame;
+    };
+
+    //records the frame numbers it is called with, optionally held up on a gate
+    class recording_listener : public astra::FrameListener
+    {
+    public:
+        recording_listener(fake_stream_service& service)
+            : service_(service)
+        { }
+
+        void on_frame_ready(astra::StreamReader& reader, astra::Frame& frame) override
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+
+            ++running_;
+            threadIds_.push_back(std::this_thread::get_id());
+            condition_.notify_all();
+            condition_.wait(lock, [this] { return !gated_; });
+
+            frameNumbers_.push_back(service_.frame_number(frame.get<raw_frame>().frame));
+            readerValid_ = readerValid_ && reader.get_handle() != nullptr;
+            --running_;
+            condition_.notify_all();
+        }
+
+        void close_gate()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            gated_ = true;
+        }
+
+        void open_gate()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            gated_ = false;
+            condition_.notify_all();
+        }
+
+        bool wait_until_running()
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            return condition_.wait_for(lock, std::chrono::seconds(5), [this] { return running_ > 0; });
+        }
+
+        bool wait_for_frames(size_t count)
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            return condition_.wait_for(lock,
+                                       std::chrono::seconds(5),
+                                       [this, count] { return frameNumbers_.size() >= count && running_ == 0; });
+        }
+
+        std::vector<int> frame_numbers()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return frameNumbers_;
+        }
+
+        std::vector<std::thread::id> thread_ids()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return threadIds_;
+        }
+
+        bool reader_valid()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return readerValid_;
+        }
+
+    private:
+        fake_stream_service& service_;
+        std::mutex mutex_;
+        std::condition_variable condition_;
+        std::vector<int> frameNumbers_;
+        std::vector<std::thread::id> threadIds_;
+        int running_{0};
+        bool gated_{false};
+        bool readerValid_{true};
+    };
+
+    //calls a function for each frame
+    class function_listener : public astra::FrameListener
+    {
+    public:
+        function_listener(std::function<void(astra::StreamReader&)> onFrame)
+            : onFrame_(std::move(onFrame))
+        { }
+
+        void on_frame_ready(astra::StreamReader& reader, astra::Frame&) override
+        {
+            onFrame_(reader);
+        }
+
+    private:
+        std::function<void(astra::StreamReader&)> onFrame_;
+    };
+
+    //getting it from a reader is a call into the core
+    struct raw_stream
+    {
+        static const astra_stream_type_t id = 1;
+
+        raw_stream(astra_streamconnection_t connection)
+            : connection(connection)
+        { }
+
+        astra_streamconnection_t connection;
+    };
+
+    bool wait_until(const std::function<bool()>& condition)
+    {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!condition())
+        {
+            if (std::chrono::steady_clock::now() > deadline)
+                return false;
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+}
+
+TEST_CASE("Asynchronous listener runs on the executor with retained frames", "[frame_listener]")
+{
+    fake_stream_service service;
+    manual_executor executor;
+    recording_listener listener(service);
+
+    astra::StreamReader reader(service.create_reader());
+    astra_reader_t rawReader = reader.get_handle();
+
+    reader.add_listener(listener, executor, astra::BackpressurePolicy::DropOldest, 4);
+    REQUIRE(service.callback_count() == 1);
+
+    service.raise_frame(rawReader, 1);
+    service.raise_frame(rawReader, 2);
+
+    //nothing runs on the producing thread, the frames outlive their delivery
+    REQUIRE(listener.frame_numbers().empty());
+    REQUIRE(service.retained_frame_count() == 2);
+
+    REQUIRE(executor.run_all() == 1);
+    REQUIRE((listener.frame_numbers() == std::vector<int>{ 1, 2 }));
+    REQUIRE(listener.reader_valid());
+    REQUIRE(service.retained_frame_count() == 0);
+
+    reader.remove_listener(listener);
+    REQUIRE(service.callback_count() == 0);
+}
+
+TEST_CASE("DropOldest keeps the newest frames", "[frame_listener]")
+{
+    fake_stream_service service;
+    manual_executor executor;
+    recording_listener listener(service);
+
+    astra::StreamReader reader(service.create_reader());
+    astra_reader_t rawReader = reader.get_handle();
+
+    reader.add_listener(listener, executor, astra::BackpressurePolicy::DropOldest, 2);
+
+    service.raise_frame(rawReader, 1);
+    service.raise_frame(rawReader, 2);
+    service.raise_frame(rawReader, 3);
+
+    //the dropped frame is released right away
+    REQUIRE(service.retained_frame_count() == 2);
+
+    executor.run_all();
+    REQUIRE((listener.frame_numbers() == std::vector<int>{ 2, 3 }));
+    REQUIRE(service.retained_frame_count() == 0);
+}
+
+TEST_CASE("DropNewest keeps the oldest frames", "[frame_listener]")
+{
+    fake_stream_service service;
+    manual_executor executor;
+    recording_listener listener(service);
+
+    astra::StreamReader reader(service.create_reader());
+    astra_reader_t rawReader = reader.get_handle();
+
+    reader.add_listener(listener, executor, astra::BackpressurePolicy::DropNewest, 2);
+
+    service.raise_frame(rawReader, 1);
+    service.raise_frame(rawReader, 2);
+    service.raise_frame(rawReader, 3);
+
+    REQUIRE(service.retained_frame_count() == 2);
+
+    executor.run_all();
+    REQUIRE((listener.frame_numbers() == std::vector<int>{ 1, 2 }));
+}
+
+TEST_CASE("Block holds up the producer until the listener makes room", "[frame_listener]")
+{
+    fake_stream_service service;
+    astra::ThreadPoolExecutor executor(1);
+    recording_listener listener(service);
+
+    astra::StreamReader reader(service.create_reader());
+    astra_reader_t rawReader = reader.get_handle();
+
+    reader.add_listener(listener, executor, astra::BackpressurePolicy::Block, 1);
+    listener.close_gate();
+
+    const int frameCount = 4;
+    std::atomic<int> raised(0);
+    std::thread producer([&] {
+        for (int i = 1; i <= frameCount; ++i)
+        {
+            service.raise_frame(rawReader, i);
+            ++raised;
+        }
+    });
+
+    //frame 1 is in the listener and frame 2 fills the queue, so frame 3 waits
+    REQUIRE(listener.wait_until_running());
+    REQUIRE(wait_until([&] { return raised >= 2; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    REQUIRE(raised == 2);
+
+    listener.open_gate();
+    producer.join();
+
+    REQUIRE(listener.wait_for_frames(frameCount));
+    REQUIRE((listener.frame_numbers() == std::vector<int>{ 1, 2, 3, 4 }));
+
+    //one frame at a time, all on the executor
+    for (auto& threadId : listener.thread_ids())
+    {
+        REQUIRE(threadId != std::this_thread::get_id());
+    }
+}
+
+TEST_CASE("Destroying the reader drops pending frames and stops the listener", "[frame_listener]")
+{
+    fake_stream_service service;
+    manual_executor executor;
+    recording_listener listener(service);
+
+    {
+        astra::StreamReader reader(service.create_reader());
+        astra_reader_t rawReader = reader.get_handle();
+
+        reader.add_listener(listener, executor, astra::BackpressurePolicy::DropOldest, 2);
+
+        service.raise_frame(rawReader, 1);
+        service.raise_frame(rawReader, 2);
+        REQUIRE(service.retained_frame_count() == 2);
+    }
+
+    //pending frames don't keep the reader alive
+    REQUIRE(service.destroyed_reader_count() == 1);
+    REQUIRE(service.callback_count() == 0);
+    REQUIRE(service.retained_frame_count() == 0);
+
+    executor.run_all();
+    REQUIRE(listener.frame_numbers().empty());
+}
+
+TEST_CASE("Reader released during a listener callback is destroyed on the executor", "[frame_listener]")
+{
+    fake_stream_service service;
+    astra::ThreadPoolExecutor executor(1);
+    recording_listener listener(service);
+
+    astra::StreamReader reader(service.create_reader());
+    astra_reader_t rawReader = reader.get_handle();
+
+    reader.add_listener(listener, executor, astra::BackpressurePolicy::Block, 1);
+    listener.close_gate();
+
+    std::atomic<bool> producing(true);
+    std::thread producer([&] {
+        for (int i = 1; producing; ++i)
+        {
+            service.raise_frame(rawReader, i);
+        }
+    });
+
+    //the producer is delivering or blocked on the full queue while the
+    //callback holds the last reference to the reader
+    REQUIRE(listener.wait_until_running());
+    reader = astra::StreamReader();
+    REQUIRE(service.destroyed_reader_count() == 0);
+
+    listener.open_gate();
+    REQUIRE(wait_until([&] { return service.destroyed_reader_count() == 1; }));
+    REQUIRE(service.callback_count() == 0);
+
+    producing = false;
+    producer.join();
+
+    REQUIRE(wait_until([&] { return service.retained_frame_count() == 0; }));
+}
+
+TEST_CASE("Releasing the reader during a listener callback doesn't wait on the core", "[frame_listener]")
+{
+    fake_stream_service service;
+    astra::ThreadPoolExecutor executor(1);
+
+    //with the executor free, the async callback usually holds the reader while
+    //it waits on the core mutex and the reader is destroyed on the executor.
+    //with the executor busy, the reader is destroyed on the thread raising the
+    //frame, with the callback still to come.
+    std::atomic<bool> executorBlocked(false);
+    for (int round = 1; round <= 200; ++round)
+    {
+        const bool executorBusy = round % 2 == 0;
+        if (executorBusy)
+        {
+            executorBlocked = true;
+            executor.execute([&executorBlocked] {
+                while (executorBlocked)
+                {
+                    std::this_thread::yield();
+                }
+            });
+        }
+
+        std::atomic<int> asyncCallCount(0);
+        function_listener asyncListener([&asyncCallCount] (astra::StreamReader& reader) {
+            raw_stream stream = reader.stream<raw_stream>();
+            if (stream.connection != nullptr)
+            {
+                ++asyncCallCount;
+            }
+        });
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        bool syncRunning = false;
+        bool released = false;
+        function_listener syncListener([&] (astra::StreamReader&) {
+            std::unique_lock<std::mutex> lock(mutex);
+            syncRunning = true;
+            condition.notify_all();
+            condition.wait(lock, [&released] { return released; });
+        });
+
+        std::unique_ptr<astra::StreamReader> reader(new astra::StreamReader(service.create_reader()));
+        astra_reader_t rawReader = reader->get_handle();
+        reader->add_listener(asyncListener, executor, astra::BackpressurePolicy::DropOldest, 1);
+        reader->add_listener(syncListener);
+
+        const size_t destroyedCount = service.destroyed_reader_count();
+        auto raised = std::async(std::launch::async, [&] { service.raise_frame(rawReader, round); });
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            REQUIRE(condition.wait_for(lock, std::chrono::seconds(5), [&syncRunning] { return syncRunning; }));
+        }
+
+        //the app lets go while the sync listener holds up the raising thread
+        reader.reset();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            released = true;
+            condition.notify_all();
+        }
+
+        REQUIRE(raised.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+        if (executorBusy)
+        {
+            REQUIRE(service.destroyed_reader_count() == destroyedCount + 1);
+            executorBlocked = false;
+        }
+
+        REQUIRE(wait_until([&] { return service.destroyed_reader_count() == destroyedCount + 1; }));
+        REQUIRE(service.callback_count() == 0);
+        REQUIRE(wait_until([&] { return service.retained_frame_count() == 0; }));
+        REQUIRE(asyncCallCount <= 1);
+    }
+}
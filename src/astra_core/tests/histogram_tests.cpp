@@ -0,0 +1,48 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#include "catch.hpp"
+#include "../astra_histogram.hpp"
+
+TEST_CASE("Histogram buckets are powers of two microseconds", "[histogram]") {
+    REQUIRE(astra::histogram::bucket_of(0) == 0);
+    REQUIRE(astra::histogram::bucket_of(1) == 1);
+    REQUIRE(astra::histogram::bucket_of(2) == 2);
+    REQUIRE(astra::histogram::bucket_of(3) == 2);
+    REQUIRE(astra::histogram::bucket_of(1000) == 10);
+    REQUIRE(astra::histogram::bucket_of(uint64_t(1) << 40) == astra::histogram::BUCKET_COUNT - 1);
+}
+
+TEST_CASE("Histogram snapshot has count, sum and max", "[histogram]") {
+    astra::histogram histogram;
+    histogram.record(10);
+    histogram.record(30);
+    histogram.record(20);
+
+    astra_histogram_t snapshot;
+    histogram.snapshot(snapshot);
+
+    REQUIRE(snapshot.count == 3);
+    REQUIRE(snapshot.sumMicroseconds == 60);
+    REQUIRE(snapshot.maxMicroseconds == 30);
+    REQUIRE(snapshot.buckets[4] == 1);
+    REQUIRE(snapshot.buckets[5] == 2);
+
+    histogram.reset();
+    histogram.snapshot(snapshot);
+    REQUIRE(snapshot.count == 0);
+    REQUIRE(snapshot.buckets[5] == 0);
+}
@@ -0,0 +1,128 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#include "catch.hpp"
+#include "../astra_parameter_bin.hpp"
+#include <chrono>
+#include <cstdint>
+
+TEST_CASE("Parameter bin is zeroed and sized", "[parameter_bin]") {
+    astra::parameter_bin* bin = astra::parameter_bin::acquire(24);
+    REQUIRE(bin->byteLength() == 24);
+
+    uint8_t* data = static_cast<uint8_t*>(bin->data());
+    for (size_t i = 0; i < 24; ++i)
+    {
+        REQUIRE(data[i] == 0);
+    }
+
+    astra::parameter_bin::release(bin);
+}
+
+TEST_CASE("Small parameter bins are stored inline", "[parameter_bin]") {
+    astra::parameter_bin* bin = astra::parameter_bin::acquire(astra::parameter_bin::INLINE_SIZE);
+
+    uint8_t* binStart = reinterpret_cast<uint8_t*>(bin);
+    uint8_t* data = static_cast<uint8_t*>(bin->data());
+    REQUIRE(data >= binStart);
+    REQUIRE(data < binStart + sizeof(astra::parameter_bin));
+
+    astra::parameter_bin::release(bin);
+}
+
+TEST_CASE("Released parameter bins are reused and zeroed again", "[parameter_bin]") {
+    astra::parameter_bin* first = astra::parameter_bin::acquire(200);
+    std::memset(first->data(), 0xff, first->byteLength());
+    astra::parameter_bin::release(first);
+
+    astra::parameter_bin* second = astra::parameter_bin::acquire(100);
+    REQUIRE(second == first);
+    REQUIRE(second->byteLength() == 100);
+
+    uint8_t* data = static_cast<uint8_t*>(second->data());
+    for (size_t i = 0; i < 100; ++i)
+    {
+        REQUIRE(data[i] == 0);
+    }
+
+    astra::parameter_bin::release(second);
+}
+
+TEST_CASE("Oversized parameter bins are not pooled", "[parameter_bin]") {
+    const size_t byteSize = 1 << 20;
+    astra::parameter_bin* bin = astra::parameter_bin::acquire(byteSize);
+    REQUIRE(bin->byteLength() == byteSize);
+
+    uint8_t* data = static_cast<uint8_t*>(bin->data());
+    data[byteSize - 1] = 1;
+
+    astra::parameter_bin::release(bin);
+}
+
+namespace {
+    //the allocation pattern get_parameter_bin used before pooling
+    struct unpooled_bin
+    {
+        unpooled_bin(size_t byteSize)
+            : data(new uint8_t[byteSize]),
+              byteLength(byteSize)
+        {
+            std::memset(data.get(), 0, byteSize);
+        }
+
+        std::unique_ptr<uint8_t[]> data;
+        size_t byteLength;
+    };
+
+    template<typename Func>
+    double ns_per_iteration(int iterations, Func func)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i)
+        {
+            func();
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+    }
+}
+
+TEST_CASE("Parameter bin round trip", "[.][parameter_bin][benchmark]") {
+    const int iterations = 5000000;
+    const size_t sizes[] = { 8, 64, 1024 };
+    int64_t sink = 0;
+
+    for (size_t byteSize : sizes)
+    {
+        double unpooledNs = ns_per_iteration(iterations, [&] {
+                unpooled_bin* bin = new unpooled_bin(byteSize);
+                reinterpret_cast<int32_t*>(bin->data.get())[0] = 1;
+                sink += reinterpret_cast<int32_t*>(bin->data.get())[0];
+                delete bin;
+            });
+
+        double pooledNs = ns_per_iteration(iterations, [&] {
+                astra::parameter_bin* bin = astra::parameter_bin::acquire(byteSize);
+                static_cast<int32_t*>(bin->data())[0] = 1;
+                sink += static_cast<int32_t*>(bin->data())[0];
+                astra::parameter_bin::release(bin);
+            });
+
+        WARN(byteSize << " bytes: " << unpooledNs << " ns unpooled, " << pooledNs << " ns pooled");
+    }
+
+    REQUIRE(sink == int64_t(2) * iterations * 3);
+}
@@ -0,0 +1,206 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#include "catch.hpp"
+#include "../astra_parameter_cache.hpp"
+#include "../astra_parameter_bin.hpp"
+#include "../astra_streamset.hpp"
+#include "../astra_stream.hpp"
+#include "../astra_logger.hpp"
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+TEST_CASE("Parameter cache returns stored values", "[parameter_cache]") {
+    astra::parameter_cache cache;
+
+    float value = 1.5f;
+    float result = 0;
+    REQUIRE_FALSE(cache.try_get(1, sizeof(float), &result));
+
+    cache.store(1, sizeof(float), &value);
+    REQUIRE(cache.try_get(1, sizeof(float), &result));
+    REQUIRE(result == 1.5f);
+
+    //a read of another size misses instead of truncating
+    double wide = 0;
+    REQUIRE_FALSE(cache.try_get(1, sizeof(double), &wide));
+    REQUIRE_FALSE(cache.try_get(2, sizeof(float), &result));
+}
+
+TEST_CASE("Parameter cache misses after invalidation", "[parameter_cache]") {
+    astra::parameter_cache cache;
+
+    int32_t value = 7;
+    int32_t result = 0;
+    cache.store(1, sizeof(value), &value);
+
+    const uint64_t invalidations = cache.invalidations();
+    cache.invalidate();
+    REQUIRE(cache.invalidations() == invalidations + 1);
+    REQUIRE_FALSE(cache.try_get(1, sizeof(result), &result));
+
+    value = 8;
+    cache.store(1, sizeof(value), &value);
+    REQUIRE(cache.try_get(1, sizeof(result), &result));
+    REQUIRE(result == 8);
+}
+
+TEST_CASE("Parameter cache leaves large and excess parameters uncached", "[parameter_cache]") {
+    astra::parameter_cache cache;
+
+    uint8_t large[astra::parameter_cache::MAX_PARAMETER_SIZE + 1] = {};
+    cache.store(100, sizeof(large), large);
+    REQUIRE_FALSE(cache.try_get(100, sizeof(large), large));
+
+    for (astra_parameter_id id = 0; id < static_cast<astra_parameter_id>(astra::parameter_cache::MAX_PARAMETERS + 1); ++id)
+    {
+        cache.store(id, sizeof(id), &id);
+    }
+
+    astra_parameter_id result = 0;
+    REQUIRE(cache.try_get(astra::parameter_cache::MAX_PARAMETERS - 1, sizeof(result), &result));
+    REQUIRE_FALSE(cache.try_get(astra::parameter_cache::MAX_PARAMETERS, sizeof(result), &result));
+}
+
+TEST_CASE("Parameter cache reads are never torn", "[parameter_cache]") {
+    astra::parameter_cache cache;
+
+    //every word of a value is the same, a torn read would mix two values
+    struct value { uint64_t words[8]; };
+
+    std::atomic<bool> done(false);
+    std::atomic<int> torn(0);
+
+    std::thread readerThread([&] {
+        while (!done)
+        {
+            value v;
+            if (cache.try_get(1, sizeof(v), &v))
+            {
+                for (auto word : v.words)
+                {
+                    if (word != v.words[0])
+                        ++torn;
+                }
+            }
+        }
+    });
+
+    for (uint64_t i = 0; i < 100000; ++i)
+    {
+        value v;
+        for (auto& word : v.words)
+        {
+            word = i;
+        }
+        cache.store(1, sizeof(v), &v);
+        if (i % 16 == 0)
+        {
+            cache.invalidate();
+        }
+    }
+
+    done = true;
+    readerThread.join();
+    REQUIRE(torn == 0);
+}
+
+namespace {
+    struct parameter_plugin
+    {
+        float value{1.0f};
+        int gets{0};
+
+        static void get_parameter(void* context,
+                                  astra_streamconnection_t,
+                                  astra_parameter_id,
+                                  astra_parameter_bin_t* parameterBin)
+        {
+            parameter_plugin* plugin = static_cast<parameter_plugin*>(context);
+            ++plugin->gets;
+
+            astra::parameter_bin* bin = astra::parameter_bin::acquire(sizeof(float));
+            *static_cast<float*>(bin->data()) = plugin->value;
+            *parameterBin = bin->get_handle();
+        }
+
+        static void set_parameter(void* context,
+                                  astra_streamconnection_t,
+                                  astra_parameter_id,
+                                  size_t,
+                                  astra_parameter_data_t inData)
+        {
+            static_cast<parameter_plugin*>(context)->value = *static_cast<float*>(inData);
+        }
+    };
+}
+
+TEST_CASE("Connections cache parameters their stream marked cacheable", "[parameter_cache]") {
+    //logging isn't initialized without a context
+    astra::set_log_severity(ASTRA_SEVERITY_FATAL);
+
+    parameter_plugin plugin;
+    stream_callbacks_t callbacks{};
+    callbacks.context = &plugin;
+    callbacks.get_parameter_callback = &parameter_plugin::get_parameter;
+    callbacks.set_parameter_callback = &parameter_plugin::set_parameter;
+
+    astra::streamset set("test/parameter_cache");
+    astra::stream* stream = set.register_stream(astra_stream_desc_t{ 1, 0 });
+    set.claim_stream(stream, callbacks);
+    astra::stream_connection* connection = stream->create_connection();
+
+    const astra_parameter_id cachedId = 1;
+    const astra_parameter_id uncachedId = 2;
+    stream->set_parameter_cacheable(cachedId, true);
+
+    float result = 0;
+    REQUIRE(connection->read_parameter(cachedId, sizeof(float), &result) == ASTRA_STATUS_SUCCESS);
+    REQUIRE(connection->read_parameter(cachedId, sizeof(float), &result) == ASTRA_STATUS_SUCCESS);
+    REQUIRE(result == 1.0f);
+    REQUIRE(plugin.gets == 1);
+
+    connection->read_parameter(uncachedId, sizeof(float), &result);
+    connection->read_parameter(uncachedId, sizeof(float), &result);
+    REQUIRE(plugin.gets == 3);
+
+    SECTION("setting a parameter invalidates the cache") {
+        float newValue = 2.0f;
+        connection->set_parameter(uncachedId, sizeof(float), &newValue);
+
+        REQUIRE(connection->read_parameter(cachedId, sizeof(float), &result) == ASTRA_STATUS_SUCCESS);
+        REQUIRE(result == 2.0f);
+        REQUIRE(plugin.gets == 4);
+    }
+
+    SECTION("the plugin invalidates the cache") {
+        plugin.value = 3.0f;
+        stream->invalidate_parameters();
+
+        REQUIRE(connection->read_parameter(cachedId, sizeof(float), &result) == ASTRA_STATUS_SUCCESS);
+        REQUIRE(result == 3.0f);
+        REQUIRE(plugin.gets == 4);
+    }
+
+    SECTION("a read of the wrong size fails") {
+        double wide = 1;
+        REQUIRE(connection->read_parameter(cachedId, sizeof(double), &wide) == ASTRA_STATUS_INVALID_PARAMETER);
+        REQUIRE(wide == 0);
+    }
+
+    stream->destroy_connection(connection);
+}
@@ -0,0 +1,190 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#include "catch.hpp"
+#include "../astra_registry.hpp"
+#include "../astra_streamset.hpp"
+#include "../astra_streamset_connection.hpp"
+#include "../astra_stream_reader.hpp"
+#include "../astra_logger.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+    class tracked_probe : public astra::tracked_instance<tracked_probe>
+    {};
+
+    class other_probe : public astra::tracked_instance<other_probe>
+    {};
+
+    //handles keep the slot index in their low half
+    bool same_slot(const void* a, const void* b)
+    {
+        const uintptr_t indexMask = (uintptr_t(1) << (sizeof(uintptr_t) * 4)) - 1;
+        return ((reinterpret_cast<uintptr_t>(a) ^ reinterpret_cast<uintptr_t>(b)) & indexMask) == 0;
+    }
+}
+
+TEST_CASE("Registry rejects a stale handle once its slot is reused", "[registry]") {
+    std::unique_ptr<tracked_probe> probe(new tracked_probe());
+    void* staleHandle = probe->tracked_handle();
+    REQUIRE(staleHandle != nullptr);
+    REQUIRE(astra::registry::get<tracked_probe>(staleHandle) == probe.get());
+
+    probe.reset();
+    REQUIRE(astra::registry::get<tracked_probe>(staleHandle) == nullptr);
+
+    std::unique_ptr<tracked_probe> reused(new tracked_probe());
+    void* handle = reused->tracked_handle();
+    REQUIRE(same_slot(handle, staleHandle));
+    REQUIRE(handle != staleHandle);
+
+    REQUIRE(astra::registry::get<tracked_probe>(handle) == reused.get());
+    REQUIRE(astra::registry::get<tracked_probe>(staleHandle) == nullptr);
+}
+
+TEST_CASE("Registry rejects a handle of another tracked type", "[registry]") {
+    tracked_probe probe;
+    other_probe other;
+
+    REQUIRE(astra::registry::get<tracked_probe>(probe.tracked_handle()) == &probe);
+    REQUIRE(astra::registry::get<other_probe>(other.tracked_handle()) == &other);
+
+    REQUIRE(astra::registry::get<other_probe>(probe.tracked_handle()) == nullptr);
+    REQUIRE(astra::registry::get<tracked_probe>(other.tracked_handle()) == nullptr);
+
+    //a copy is a separate instance
+    tracked_probe copy(probe);
+    REQUIRE(copy.tracked_handle() != probe.tracked_handle());
+    REQUIRE(astra::registry::get<tracked_probe>(copy.tracked_handle()) == &copy);
+
+    REQUIRE(astra::registry::get<tracked_probe>(nullptr) == nullptr);
+}
+
+TEST_CASE("Registry lookups race safely with adds and removes", "[registry]") {
+    tracked_probe anchor;
+    void* anchorHandle = anchor.tracked_handle();
+
+    void* staleHandle;
+    {
+        tracked_probe gone;
+        staleHandle = gone.tracked_handle();
+    }
+
+    const int iterations = 20000;
+    std::atomic<bool> writing(true);
+    std::atomic<int> writerFailures(0);
+    std::atomic<int> readerFailures(0);
+
+    std::vector<std::thread> writers;
+    for (int w = 0; w < 2; ++w)
+    {
+        writers.emplace_back([&] {
+            for (int i = 0; i < iterations; ++i)
+            {
+                std::unique_ptr<tracked_probe> probe(new tracked_probe());
+                std::unique_ptr<other_probe> other(new other_probe());
+                void* handle = probe->tracked_handle();
+
+                if (astra::registry::get<tracked_probe>(handle) != probe.get() ||
+                    astra::registry::get<other_probe>(other->tracked_handle()) != other.get())
+                {
+                    ++writerFailures;
+                }
+
+                probe.reset();
+                if (astra::registry::get<tracked_probe>(handle) != nullptr)
+                {
+                    ++writerFailures;
+                }
+            }
+        });
+    }
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 2; ++r)
+    {
+        readers.emplace_back([&] {
+            while (writing)
+            {
+                if (astra::registry::get<tracked_probe>(anchorHandle) != &anchor ||
+                    astra::registry::get<other_probe>(anchorHandle) != nullptr ||
+                    astra::registry::get<tracked_probe>(staleHandle) != nullptr ||
+                    astra::registry::get<other_probe>(staleHandle) != nullptr)
+                {
+                    ++readerFailures;
+                }
+            }
+        });
+    }
+
+    for (auto& writer : writers)
+    {
+        writer.join();
+    }
+    writing = false;
+    for (auto& reader : readers)
+    {
+        reader.join();
+    }
+
+    REQUIRE(writerFailures == 0);
+    REQUIRE(readerFailures == 0);
+}
+
+TEST_CASE("Instances created while the registry is full are refused", "[registry]") {
+    //logging isn't initialized without a context
+    astra::set_log_severity(ASTRA_SEVERITY_FATAL);
+
+    astra::streamset set("test/registry");
+    astra::streamset_connection* setConnection = set.add_new_connection();
+    REQUIRE(setConnection != nullptr);
+
+    std::vector<std::unique_ptr<tracked_probe>> probes;
+    bool isFull = false;
+    while (!isFull && probes.size() < (size_t(1) << 20))
+    {
+        std::unique_ptr<tracked_probe> probe(new tracked_probe());
+        isFull = probe->tracked_handle() == nullptr;
+        if (!isFull)
+        {
+            probes.push_back(std::move(probe));
+        }
+    }
+    REQUIRE(isFull);
+
+    astra_stream_desc_t desc{ 1, 0 };
+    REQUIRE(set.add_new_connection() == nullptr);
+    REQUIRE(set.create_stream_connection(desc) == nullptr);
+    REQUIRE(setConnection->create_reader() == nullptr);
+
+    //the refused instances released nothing they didn't own
+    REQUIRE(astra::registry::get<tracked_probe>(probes.front()->tracked_handle()) == probes.front().get());
+    REQUIRE(astra::registry::get<astra::streamset_connection>(setConnection->tracked_handle()) == setConnection);
+
+    probes.pop_back();
+    astra::stream_reader* reader = setConnection->create_reader();
+    REQUIRE(reader != nullptr);
+    REQUIRE(astra::stream_reader::get_ptr(reader->get_handle()) == reader);
+
+    probes.clear();
+    astra::stream_connection* connection = reader->get_stream(desc);
+    REQUIRE(connection != nullptr);
+    REQUIRE(set.add_new_connection() != nullptr);
+}
@@ -0,0 +1,93 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#include "catch.hpp"
+#include "../astra_shm_frame_ring.hpp"
+
+#if defined(ASTRA_SHM_SUPPORTED)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+TEST_CASE("Shared memory ring publishes written slots", "[shm_frame_ring]") {
+    astra_stream_desc_t description{1, 0};
+    auto ring = astra::shm_frame_ring::create("test/shm_frame_ring", description, 32, 4);
+    REQUIRE(ring != nullptr);
+
+    auto buffer = ring->acquire();
+    uint32_t slot = ring->slot_of(buffer.get());
+    REQUIRE(slot < 4);
+
+    astra::shm::segment_header* header = ring->header();
+    REQUIRE(header->magic == astra::shm::SEGMENT_MAGIC);
+    REQUIRE(header->latestSlot.load() == astra::shm::NO_SLOT);
+
+    astra::shm::slot_header* slotHeader = astra::shm::get_slot_header(header, slot);
+
+    ring->begin_write(slot);
+    REQUIRE((slotHeader->generation.load() & 1) == 1);
+
+    astra_frame_t frame;
+    frame.byteLength = 32;
+    frame.frameIndex = 7;
+    frame.data = buffer.get();
+    ring->publish(slot, frame, 1000);
+
+    REQUIRE((slotHeader->generation.load() & 1) == 0);
+    REQUIRE(slotHeader->frameIndex == 7);
+    REQUIRE(header->latestSlot.load() == slot);
+    REQUIRE(header->publishedSequence.load() == 1);
+}
+
+TEST_CASE("Shared memory ring recycles released slots", "[shm_frame_ring]") {
+    astra_stream_desc_t description{1, 0};
+    auto ring = astra::shm_frame_ring::create("test/shm_frame_ring", description, 32, 2);
+    REQUIRE(ring != nullptr);
+
+    auto a = ring->acquire();
+    auto b = ring->acquire();
+    REQUIRE(a != nullptr);
+    REQUIRE(b != nullptr);
+    REQUIRE(ring->acquire() == nullptr);
+
+    uint8_t* aData = a.get();
+    a = nullptr;
+
+    auto recycled = ring->acquire();
+    REQUIRE(recycled.get() == aData);
+
+    uint8_t outside = 0;
+    REQUIRE(ring->slot_of(&outside) == astra::shm::NO_SLOT);
+}
+
+TEST_CASE("Shared memory ring segment is private to the host's user", "[shm_frame_ring]") {
+    astra_stream_desc_t description{1, 0};
+    auto ring = astra::shm_frame_ring::create("test/shm_frame_ring", description, 32, 2);
+    REQUIRE(ring != nullptr);
+
+    int fd = shm_open(ring->name().c_str(), O_RDONLY, 0);
+    REQUIRE(fd >= 0);
+
+    struct stat status;
+    REQUIRE(fstat(fd, &status) == 0);
+    close(fd);
+
+    REQUIRE((status.st_mode & (S_IRWXG | S_IRWXO)) == 0);
+    REQUIRE((status.st_mode & S_IRUSR) != 0);
+}
+
+#endif
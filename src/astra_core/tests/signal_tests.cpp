@@ -17,6 +17,10 @@
 #define CATCH_CONFIG_MAIN
 #include "catch.hpp"
 #include "../astra_signal.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
 
 TEST_CASE("Can add to a callback list", "[signal]") {
     astra::CallbackList<void, int> cbList;
@@ -73,3 +77,122 @@ TEST_CASE("Can raise multi param signal", "[signal]") {
     signal.raise(false, 5, "Test");
     REQUIRE(test == 36);
 }
+
+TEST_CASE("Slot removed during raise is not called later in that raise", "[signal]") {
+    astra::signal<int> signal;
+    int test = 0;
+    size_t secondId = 0;
+    signal += [&] (int v) { signal -= secondId; };
+    secondId = signal += [&test] (int v) { test++; };
+    signal.raise(1);
+
+    REQUIRE(test == 0);
+    REQUIRE(signal.slot_count() == 1);
+}
+
+TEST_CASE("Slot added during raise is called from the next raise", "[signal]") {
+    astra::signal<int> signal;
+    int test = 0;
+    bool added = false;
+    signal += [&] (int v)
+        {
+            if (!added)
+            {
+                added = true;
+                signal += [&test] (int v) { test++; };
+            }
+        };
+    signal.raise(1);
+    REQUIRE(test == 0);
+
+    signal.raise(1);
+    REQUIRE(test == 1);
+}
+
+TEST_CASE("Can remove every slot and add again", "[signal]") {
+    astra::signal<int> signal;
+    int test = 0;
+    size_t id = signal += [&test] (int v) { test++; };
+    signal -= id;
+    REQUIRE(signal.slot_count() == 0);
+
+    bool removedAgain = signal -= id;
+    REQUIRE_FALSE(removedAgain);
+
+    signal.raise(1);
+    REQUIRE(test == 0);
+
+    signal += [&test] (int v) { test++; };
+    signal.raise(1);
+    REQUIRE(test == 1);
+}
+
+TEST_CASE("Can raise while other threads add and remove slots", "[signal]") {
+    astra::signal<int> signal;
+    std::atomic<int> permanentCalls(0);
+    std::atomic<int> transientCalls(0);
+    std::atomic<bool> done(false);
+
+    signal += [&permanentCalls] (int v) { permanentCalls += v; };
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 2; ++t)
+    {
+        writers.emplace_back([&]
+            {
+                while (!done)
+                {
+                    size_t id = signal += [&transientCalls] (int v) { transientCalls += v; };
+                    std::this_thread::yield();
+                    signal -= id;
+                }
+            });
+    }
+
+    const int raiseCount = 20000;
+    std::vector<std::thread> raisers;
+    for (int t = 0; t < 2; ++t)
+    {
+        raisers.emplace_back([&]
+            {
+                for (int i = 0; i < raiseCount; ++i)
+                {
+                    signal.raise(1);
+                }
+            });
+    }
+
+    for (auto& raiser : raisers)
+    {
+        raiser.join();
+    }
+    done = true;
+    for (auto& writer : writers)
+    {
+        writer.join();
+    }
+
+    REQUIRE(permanentCalls == 2 * raiseCount);
+    REQUIRE(signal.slot_count() == 1);
+}
+
+TEST_CASE("Raise throughput", "[.][signal][benchmark]") {
+    astra::signal<int, int> signal;
+    int sink = 0;
+    signal += [&sink] (int a, int b) { sink += a; };
+    signal += [&sink] (int a, int b) { sink += b; };
+    signal += [&sink] (int a, int b) { sink -= a; };
+
+    const int raiseCount = 10000000;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < raiseCount; ++i)
+    {
+        signal.raise(i, 1);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    double nsPerRaise = std::chrono::duration<double, std::nano>(elapsed).count() / raiseCount;
+    WARN("3 slots: " << nsPerRaise << " ns per raise");
+
+    REQUIRE(sink == raiseCount);
+}
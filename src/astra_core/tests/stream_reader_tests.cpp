@@ -0,0 +1,454 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#include "catch.hpp"
+#include "../astra_streamset.hpp"
+#include "../astra_streamset_connection.hpp"
+#include "../astra_stream_reader.hpp"
+#include "../astra_stream.hpp"
+#include "../astra_stream_bin.hpp"
+#include "../astra_retained_frame.hpp"
+#include "../astra_logger.hpp"
+#include "../astra_core_mutex.hpp"
+#include "../astra_update_thread.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace {
+    //a streamset with one claimed stream and bin per type, read by one reader
+    class reader_fixture
+    {
+    public:
+        reader_fixture(int streamCount)
+            : set_("test/stream_reader")
+        {
+            //logging isn't initialized without a context
+            astra::set_log_severity(ASTRA_SEVERITY_FATAL);
+
+            stream_callbacks_t callbacks{};
+
+            for (int i = 0; i < streamCount; ++i)
+            {
+                astra_stream_desc_t desc{ i + 1, 0 };
+                astra::stream* stream = set_.register_stream(desc);
+                set_.claim_stream(stream, callbacks);
+
+                astra::stream_bin* bin = stream->create_bin(sizeof(int32_t), 3);
+                producers_.push_back({ desc, bin, bin->get_backBuffer() });
+            }
+
+            add_reader(streamCount);
+        }
+
+        ~reader_fixture()
+        {
+            while (!readers_.empty())
+            {
+                destroy_reader();
+            }
+        }
+
+        //another reader of the same bins, started on the first streamCount streams
+        astra::stream_reader& add_reader(size_t streamCount)
+        {
+            readers_.push_back(std::unique_ptr<astra::stream_reader>(
+                new astra::stream_reader(*set_.add_new_connection())));
+
+            astra::stream_reader& reader = *readers_.back();
+            for (size_t i = 0; i < producers_.size(); ++i)
+            {
+                astra::stream_connection* connection = reader.get_stream(producers_[i].desc);
+                if (i < streamCount)
+                {
+                    connection->start();
+                }
+                connection->set_bin(producers_[i].bin);
+            }
+
+            return reader;
+        }
+
+        //captureTimestamp of 0 leaves the bin to use the cycle time
+        void produce(size_t streamIndex, astra_frame_index_t frameIndex, uint64_t captureTimestamp = 0)
+        {
+            producer& p = producers_[streamIndex];
+            if (captureTimestamp != 0)
+            {
+                p.bin->set_back_buffer_capture_timestamp(captureTimestamp);
+            }
+            p.backBuffer->frameIndex = frameIndex;
+            *static_cast<int32_t*>(p.backBuffer->data) = frameIndex * 10 + static_cast<int32_t>(streamIndex);
+            p.backBuffer = p.bin->cycle_buffers();
+        }
+
+        //destroys the most recently added reader
+        void destroy_reader()
+        {
+            for (auto& producer : producers_)
+            {
+                readers_.back()->get_stream(producer.desc)->set_bin(nullptr);
+            }
+            readers_.pop_back();
+        }
+
+        astra_stream_desc_t desc(size_t streamIndex) { return producers_[streamIndex].desc; }
+        size_t stream_count() const { return producers_.size(); }
+        astra::stream_reader& reader() { return *readers_.front(); }
+
+    private:
+        struct producer
+        {
+            astra_stream_desc_t desc;
+            astra::stream_bin* bin;
+            astra_frame_t* backBuffer;
+        };
+
+        astra::streamset set_;
+        std::vector<producer> producers_;
+        std::vector<std::unique_ptr<astra::stream_reader>> readers_;
+    };
+}
+
+TEST_CASE("Reader returns the same connection for a stream type", "[stream_reader]") {
+    reader_fixture fixture(3);
+
+    for (size_t i = 0; i < fixture.stream_count(); ++i)
+    {
+        astra_stream_desc_t desc = fixture.desc(i);
+        astra::stream_connection* connection = fixture.reader().get_stream(desc);
+        REQUIRE(connection != nullptr);
+        REQUIRE(fixture.reader().get_stream(desc) == connection);
+        REQUIRE(connection->get_description().type == desc.type);
+    }
+}
+
+TEST_CASE("Reader locks once every started stream has a frame", "[stream_reader]") {
+    reader_fixture fixture(3);
+    astra::stream_reader& reader = fixture.reader();
+    astra_reader_frame_t frame = nullptr;
+
+    fixture.produce(0, 1);
+    fixture.produce(1, 1);
+    REQUIRE(reader.lock(0, frame) == ASTRA_STATUS_TIMEOUT);
+
+    fixture.produce(2, 1);
+    REQUIRE(reader.lock(0, frame) == ASTRA_STATUS_SUCCESS);
+
+    for (size_t i = 0; i < fixture.stream_count(); ++i)
+    {
+        astra_stream_desc_t desc = fixture.desc(i);
+        astra_frame_t* subframe = reader.get_subframe(desc);
+        REQUIRE(subframe != nullptr);
+        REQUIRE(subframe->frameIndex == 1);
+        REQUIRE(*static_cast<int32_t*>(subframe->data) == 10 + static_cast<int32_t>(i));
+    }
+
+    astra_stream_desc_t unknown{ 99, 0 };
+    REQUIRE(reader.get_subframe(unknown) == nullptr);
+
+    REQUIRE(reader.unlock(frame) == ASTRA_STATUS_SUCCESS);
+}
+
+namespace {
+    astra_frame_index_t subframe_index(astra::stream_reader& reader, astra_stream_desc_t desc)
+    {
+        astra_frame_t* subframe = reader.get_subframe(desc);
+        REQUIRE(subframe != nullptr);
+        return subframe->frameIndex;
+    }
+
+    int32_t subframe_value(astra::stream_reader& reader, astra_stream_desc_t desc)
+    {
+        astra_frame_t* subframe = reader.get_subframe(desc);
+        REQUIRE(subframe != nullptr);
+        return *static_cast<int32_t*>(subframe->data);
+    }
+}
+
+TEST_CASE("Frame index sync matches equal indices without stalling other readers", "[stream_reader]") {
+    reader_fixture fixture(2);
+    astra::stream_reader& reader = fixture.reader();
+    astra::stream_reader& latestReader = fixture.add_reader(1);
+    astra_reader_frame_t frame = nullptr;
+
+    REQUIRE(reader.set_sync_policy(ASTRA_READER_SYNC_FRAME_INDEX, 0) == ASTRA_STATUS_SUCCESS);
+
+    fixture.produce(0, 1);
+    fixture.produce(0, 2);
+    fixture.produce(0, 3);
+    REQUIRE(reader.lock(0, frame) == ASTRA_STATUS_TIMEOUT);
+
+    //the synced reader waiting for stream 1 doesn't keep stream 0's bin on frame 1
+    REQUIRE(latestReader.lock(0, frame) == ASTRA_STATUS_SUCCESS);
+    REQUIRE(subframe_index(latestReader, fixture.desc(0)) == 3);
+    REQUIRE(latestReader.unlock(frame) == ASTRA_STATUS_SUCCESS);
+
+    fixture.produce(1, 2);
+    REQUIRE(reader.lock(0, frame) == ASTRA_STATUS_SUCCESS);
+    REQUIRE(subframe_index(reader, fixture.desc(0)) == 2);
+    REQUIRE(subframe_index(reader, fixture.desc(1)) == 2);
+    REQUIRE(subframe_value(reader, fixture.desc(0)) == 20);
+    REQUIRE(subframe_value(reader, fixture.desc(1)) == 21);
+
+    //new frames don't disturb the open one
+    fixture.produce(0, 4);
+    fixture.produce(1, 3);
+    REQUIRE(subframe_value(reader, fixture.desc(0)) == 20);
+    REQUIRE(reader.unlock(frame) == ASTRA_STATUS_SUCCESS);
+
+    //frame 3 of stream 0 waited in the history
+    REQUIRE(reader.lock(0, frame) == ASTRA_STATUS_SUCCESS);
+    REQUIRE(subframe_value(reader, fixture.desc(0)) == 30);
+    REQUIRE(subframe_value(reader, fixture.desc(1)) == 31);
+    REQUIRE(reader.unlock(frame) == ASTRA_STATUS_SUCCESS);
+
+    REQUIRE(reader.lock(0, frame) == ASTRA_STATUS_TIMEOUT);
+}
+
+TEST_CASE("Nearest timestamp sync matches capture times within the tolerance", "[stream_reader]") {
+    reader_fixture fixture(2);
+    astra::stream_reader& reader = fixture.reader();
+    astra_reader_frame_t frame = nullptr;
+
+    REQUIRE(reader.set_sync_policy(ASTRA_READER_SYNC_NEAREST_TIMESTAMP, 1000) == ASTRA_STATUS_SUCCESS);
+
+    fixture.produce(0, 1, 10000);
+    fixture.produce(0, 2, 20000);
+    fixture.produce(0, 3, 30000);
+    REQUIRE(reader.lock(0, frame) == ASTRA_STATUS_TIMEOUT);
+
+    //the frame indices of the two streams are unrelated
+    fixture.produce(1, 7, 20400);
+    REQUIRE(reader.lock(0, frame) == ASTRA_STATUS_SUCCESS);
+    REQUIRE(subframe_index(reader, fixture.desc(0)) == 2);
+    REQUIRE(subframe_index(reader, fixture.desc(1)) == 7);
+    REQUIRE(reader.unlock(frame) == ASTRA_STATUS_SUCCESS);
+
+    //nothing captured near 45000 on stream 0 yet
+    fixture.produce(1, 8, 45000);
+    REQUIRE(reader.lock(0, frame) == ASTRA_STATUS_TIMEOUT);
+
+    fixture.produce(0, 4, 45300);
+    REQUIRE(reader.lock(0, frame) == ASTRA_STATUS_SUCCESS);
+    REQUIRE(subframe_index(reader, fixture.desc(0)) == 4);
+    REQUIRE(subframe_index(reader, fixture.desc(1)) == 8);
+
+    //retained frames keep the matched data
+    astra_reader_frame_t retainedFrame = nullptr;
+    REQUIRE(reader.retain(frame, retainedFrame) == ASTRA_STATUS_SUCCESS);
+    REQUIRE(reader.unlock(frame) == ASTRA_STATUS_SUCCESS);
+
+    astra::retained_frame* retained = astra::retained_frame::from_frame(retainedFrame);
+    REQUIRE(retained != nullptr);
+    REQUIRE(*static_cast<int32_t*>(retained->get_subframe(fixture.desc(0))->data) == 40);
+    REQUIRE(*static_cast<int32_t*>(retained->get_subframe(fixture.desc(1))->data) == 81);
+    REQUIRE(retained->release());
+    delete retained;
+}
+
+TEST_CASE("Blocked reader wakes when a signalled update produces a frame", "[stream_reader]") {
+    reader_fixture fixture(1);
+    astra::core_mutex coreMutex;
+    astra::update_signal updateSignal;
+    std::atomic<bool> deviceHasFrame{false};
+    astra_frame_index_t frameIndex = 0;
+
+    //polling alone would leave the reader asleep for far longer than its timeout
+    astra::update_thread updateThread(updateSignal,
+                                      [&] {
+                                          std::lock_guard<astra::core_mutex> lock(coreMutex);
+                                          if (deviceHasFrame.exchange(false))
+                                          {
+                                              fixture.produce(0, ++frameIndex);
+                                          }
+                                      },
+                                      std::chrono::seconds(60),
+                                      std::chrono::seconds(60));
+    updateThread.start();
+
+    {
+        std::lock_guard<astra::core_mutex> lock(coreMutex);
+        astra_reader_frame_t frame = nullptr;
+
+        REQUIRE(fixture.reader().lock(20, frame, &coreMutex) == ASTRA_STATUS_TIMEOUT);
+        REQUIRE(frame == nullptr);
+
+        //as a device thread would through request_update()
+        std::thread device([&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            deviceHasFrame = true;
+            updateSignal.raise();
+        });
+
+        auto start = std::chrono::steady_clock::now();
+        astra_status_t rc = fixture.reader().lock(10000, frame, &coreMutex);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        device.join();
+
+        REQUIRE(rc == ASTRA_STATUS_SUCCESS);
+        REQUIRE(elapsed < std::chrono::seconds(5));
+
+        astra_stream_desc_t desc = fixture.desc(0);
+        REQUIRE(fixture.reader().get_subframe(desc)->frameIndex == 1);
+        REQUIRE(fixture.reader().unlock(frame) == ASTRA_STATUS_SUCCESS);
+    }
+
+    updateThread.stop();
+}
+
+TEST_CASE("Waiting on several readers returns the one with a frame", "[stream_reader]") {
+    //separate streamsets, so the readers share no bins
+    reader_fixture first(1);
+    reader_fixture second(1);
+    astra::core_mutex coreMutex;
+
+    astra_reader_t readers[] = { first.reader().get_handle(), second.reader().get_handle() };
+    size_t readyIndex = 99;
+
+    std::lock_guard<astra::core_mutex> lock(coreMutex);
+
+    REQUIRE(astra::stream_reader::wait_any(readers, 2, ASTRA_TIMEOUT_RETURN_IMMEDIATELY, readyIndex, &coreMutex) ==
+            ASTRA_STATUS_TIMEOUT);
+
+    auto start = std::chrono::steady_clock::now();
+    REQUIRE(astra::stream_reader::wait_any(readers, 2, 20, readyIndex, &coreMutex) == ASTRA_STATUS_TIMEOUT);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    REQUIRE(elapsed >= std::chrono::milliseconds(20));
+    REQUIRE(readyIndex == 99);
+
+    std::thread producer([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        std::lock_guard<astra::core_mutex> producerLock(coreMutex);
+        second.produce(0, 1);
+    });
+
+    astra_status_t rc = astra::stream_reader::wait_any(readers, 2, 10000, readyIndex, &coreMutex);
+    producer.join();
+
+    REQUIRE(rc == ASTRA_STATUS_SUCCESS);
+    REQUIRE(readyIndex == 1);
+
+    //a ready frame is reported without waiting, until it is locked
+    REQUIRE(astra::stream_reader::wait_any(readers, 2, ASTRA_TIMEOUT_RETURN_IMMEDIATELY, readyIndex, &coreMutex) ==
+            ASTRA_STATUS_SUCCESS);
+    REQUIRE(readyIndex == 1);
+
+    astra_reader_frame_t frame = nullptr;
+    REQUIRE(second.reader().lock(0, frame) == ASTRA_STATUS_SUCCESS);
+    REQUIRE(second.reader().unlock(frame) == ASTRA_STATUS_SUCCESS);
+
+    first.produce(0, 1);
+    REQUIRE(astra::stream_reader::wait_any(readers, 2, ASTRA_TIMEOUT_RETURN_IMMEDIATELY, readyIndex, &coreMutex) ==
+            ASTRA_STATUS_SUCCESS);
+    REQUIRE(readyIndex == 0);
+}
+
+TEST_CASE("Waiting on several readers rejects unknown readers", "[stream_reader]") {
+    reader_fixture fixture(1);
+    size_t readyIndex = 0;
+
+    astra_reader_t readers[] = { fixture.reader().get_handle(), nullptr };
+    REQUIRE(astra::stream_reader::wait_any(readers, 2, 0, readyIndex) == ASTRA_STATUS_INVALID_PARAMETER);
+    REQUIRE(astra::stream_reader::wait_any(readers, 0, 0, readyIndex) == ASTRA_STATUS_INVALID_PARAMETER);
+    REQUIRE(astra::stream_reader::wait_any(nullptr, 1, 0, readyIndex) == ASTRA_STATUS_INVALID_PARAMETER);
+}
+
+TEST_CASE("Waiting on several readers survives a reader destroyed by another thread", "[stream_reader]") {
+    reader_fixture first(1);
+    reader_fixture second(1);
+    astra::core_mutex coreMutex;
+
+    astra_reader_t readers[] = { first.reader().get_handle(), second.reader().get_handle() };
+    size_t readyIndex = 99;
+
+    std::lock_guard<astra::core_mutex> lock(coreMutex);
+
+    //the first reader goes away, the wait carries on with the second
+    std::thread client([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        {
+            std::lock_guard<astra::core_mutex> clientLock(coreMutex);
+            first.destroy_reader();
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        std::lock_guard<astra::core_mutex> clientLock(coreMutex);
+        second.produce(0, 1);
+    });
+
+    astra_status_t rc = astra::stream_reader::wait_any(readers, 2, ASTRA_TIMEOUT_FOREVER, readyIndex, &coreMutex);
+    client.join();
+
+    REQUIRE(rc == ASTRA_STATUS_SUCCESS);
+    REQUIRE(readyIndex == 1);
+
+    astra_reader_frame_t frame = nullptr;
+    REQUIRE(second.reader().lock(0, frame) == ASTRA_STATUS_SUCCESS);
+    REQUIRE(second.reader().unlock(frame) == ASTRA_STATUS_SUCCESS);
+
+    //a reader already destroyed is rejected up front
+    REQUIRE(astra::stream_reader::wait_any(readers, 2, ASTRA_TIMEOUT_FOREVER, readyIndex, &coreMutex) ==
+            ASTRA_STATUS_INVALID_PARAMETER);
+
+    //a wait on readers that are all destroyed ends rather than sleeping forever
+    std::thread destroyer([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        std::lock_guard<astra::core_mutex> destroyerLock(coreMutex);
+        second.destroy_reader();
+    });
+
+    rc = astra::stream_reader::wait_any(&readers[1], 1, ASTRA_TIMEOUT_FOREVER, readyIndex, &coreMutex);
+    destroyer.join();
+
+    REQUIRE(rc == ASTRA_STATUS_INVALID_OPERATION);
+}
+
+TEST_CASE("Reader lock and unlock per frame", "[.][stream_reader][benchmark]") {
+    const int frameCount = 1000000;
+
+    for (int streamCount = 1; streamCount <= 4; ++streamCount)
+    {
+        reader_fixture fixture(streamCount);
+        astra::stream_reader& reader = fixture.reader();
+        int64_t sink = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int frameIndex = 1; frameIndex <= frameCount; ++frameIndex)
+        {
+            for (int i = 0; i < streamCount; ++i)
+            {
+                fixture.produce(i, frameIndex);
+            }
+
+            astra_reader_frame_t frame = nullptr;
+            reader.lock(0, frame);
+            for (int i = 0; i < streamCount; ++i)
+            {
+                astra_stream_desc_t desc = fixture.desc(i);
+                sink += reader.get_subframe(desc)->frameIndex;
+            }
+            reader.unlock(frame);
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        double nsPerFrame = std::chrono::duration<double, std::nano>(elapsed).count() / frameCount;
+        WARN(streamCount << " streams: " << nsPerFrame << " ns per frame");
+
+        REQUIRE(sink == int64_t(streamCount) * frameCount * (frameCount + 1) / 2);
+    }
+}
@@ -0,0 +1,153 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#include "catch.hpp"
+#include "../astra_plugin_update_lock.hpp"
+#include "../astra_update_thread.hpp"
+#include "../astra_core_mutex.hpp"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+    bool wait_until(const std::function<bool()>& condition)
+    {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!condition())
+        {
+            if (std::chrono::steady_clock::now() > deadline)
+                return false;
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+}
+
+TEST_CASE("Plugin update lock is recursive and keeps other threads out", "[plugin_update_lock]") {
+    astra::core_mutex coreMutex;
+    astra::plugin_update_lock updateLock(coreMutex);
+
+    updateLock.lock();
+    updateLock.lock();
+
+    std::atomic<bool> otherLocked(false);
+    std::thread other([&] {
+        std::lock_guard<astra::plugin_update_lock> lock(updateLock);
+        otherLocked = true;
+    });
+
+    updateLock.unlock();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    REQUIRE_FALSE(otherLocked);
+
+    updateLock.unlock();
+    other.join();
+    REQUIRE(otherLocked);
+}
+
+TEST_CASE("Core caller waiting on a plugin update lends it the core mutex", "[plugin_update_lock]") {
+    astra::core_mutex coreMutex;
+    astra::plugin_update_lock updateLock(coreMutex);
+
+    std::atomic<bool> updating(false);
+    std::atomic<bool> updateCalledCore(false);
+
+    //a background update that calls into the core partway through
+    std::thread update([&] {
+        std::lock_guard<astra::plugin_update_lock> lock(updateLock);
+        updating = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+        std::lock_guard<astra::core_mutex> coreLock(coreMutex);
+        updateCalledCore = true;
+    });
+
+    REQUIRE(wait_until([&] { return updating.load(); }));
+
+    //a client calling back into the plugin, which holds the core mutex
+    auto callback = std::async(std::launch::async, [&] {
+        std::lock_guard<astra::core_mutex> coreLock(coreMutex);
+        std::lock_guard<astra::plugin_update_lock> lock(updateLock);
+        return updateCalledCore.load();
+    });
+
+    REQUIRE(callback.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+    REQUIRE(callback.get());
+    update.join();
+}
+
+TEST_CASE("Plugin call guard tolerates calls made without a plugin", "[plugin_update_lock]") {
+    astra::plugin_update_lock_ptr noLock;
+    astra::plugin_call_guard guard(noLock);
+    SUCCEED();
+}
+
+TEST_CASE("Update thread wakes on its own signal only", "[update_thread]") {
+    astra::update_signal ownSignal;
+    astra::update_signal otherSignal;
+    std::atomic<int> updateCount(0);
+
+    astra::update_thread updateThread(ownSignal,
+                                      [&] { ++updateCount; },
+                                      std::chrono::seconds(60),
+                                      std::chrono::seconds(60));
+    updateThread.start();
+
+    REQUIRE(wait_until([&] { return updateCount == 1; }));
+
+    otherSignal.raise();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    REQUIRE(updateCount == 1);
+
+    ownSignal.raise();
+    REQUIRE(wait_until([&] { return updateCount == 2; }));
+
+    updateThread.stop();
+}
+
+TEST_CASE("Update thread stops polling once updates are requested", "[update_thread]") {
+    astra::update_signal signal;
+    std::atomic<int> updateCount(0);
+
+    astra::update_thread updateThread(signal,
+                                      [&] { ++updateCount; },
+                                      std::chrono::milliseconds(1),
+                                      std::chrono::seconds(60));
+    updateThread.start();
+
+    //polled while nothing asks for updates
+    REQUIRE(wait_until([&] { return updateCount >= 5; }));
+    REQUIRE_FALSE(signal.is_requested());
+
+    signal.request();
+    REQUIRE(signal.is_requested());
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    //only a request wakes it now
+    const int settledCount = updateCount;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    REQUIRE(updateCount == settledCount);
+
+    signal.request();
+    REQUIRE(wait_until([&] { return updateCount > settledCount; }));
+
+    updateThread.stop();
+}
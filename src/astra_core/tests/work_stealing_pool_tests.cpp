@@ -0,0 +1,148 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#include "catch.hpp"
+#include "../astra_work_stealing_pool.hpp"
+#include "../astra_logger.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+    //counts finished tasks and lets the test wait for them
+    class task_counter
+    {
+    public:
+        void done()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++count_;
+            condition_.notify_all();
+        }
+
+        bool wait_for(size_t count)
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            return condition_.wait_for(lock, std::chrono::seconds(10), [this, count] { return count_ >= count; });
+        }
+
+        size_t count()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return count_;
+        }
+
+    private:
+        std::mutex mutex_;
+        std::condition_variable condition_;
+        size_t count_{0};
+    };
+}
+
+TEST_CASE("Work stealing pool runs every submitted task", "[work_stealing_pool]") {
+    astra::set_log_severity(ASTRA_SEVERITY_FATAL);
+
+    astra::work_stealing_pool pool(4);
+    task_counter counter;
+    const size_t taskCount = 1000;
+
+    for (size_t i = 0; i < taskCount; ++i)
+    {
+        REQUIRE(pool.submit([&counter] { counter.done(); }));
+    }
+
+    REQUIRE(counter.wait_for(taskCount));
+}
+
+TEST_CASE("Work stealing pool runs tasks submitted from a worker", "[work_stealing_pool]") {
+    astra::set_log_severity(ASTRA_SEVERITY_FATAL);
+
+    astra::work_stealing_pool pool(4);
+    task_counter counter;
+    const size_t taskCount = 100;
+    std::atomic<bool> submittedFromWorker{true};
+
+    REQUIRE(pool.submit([&] {
+        for (size_t i = 0; i < taskCount; ++i)
+        {
+            if (!pool.is_worker_thread() || !pool.submit([&counter] { counter.done(); }))
+            {
+                submittedFromWorker = false;
+            }
+        }
+    }));
+
+    REQUIRE(counter.wait_for(taskCount));
+    REQUIRE(submittedFromWorker);
+    REQUIRE_FALSE(pool.is_worker_thread());
+}
+
+TEST_CASE("Work stealing pool refuses tasks once stopped", "[work_stealing_pool]") {
+    astra::set_log_severity(ASTRA_SEVERITY_FATAL);
+
+    astra::work_stealing_pool pool(2);
+    pool.stop();
+
+    bool ran = false;
+    REQUIRE_FALSE(pool.submit([&ran] { ran = true; }));
+    REQUIRE(pool.thread_count() == 2);
+
+    //a second stop, as from the destructor, returns right away
+    pool.stop();
+    REQUIRE_FALSE(ran);
+}
+
+TEST_CASE("Work stealing pool stops while other threads submit", "[work_stealing_pool]") {
+    astra::set_log_severity(ASTRA_SEVERITY_FATAL);
+
+    for (int round = 0; round < 20; ++round)
+    {
+        astra::work_stealing_pool pool(2);
+        std::atomic<size_t> acceptedCount{0};
+        std::atomic<size_t> ranCount{0};
+        std::atomic<bool> refused{false};
+
+        std::vector<std::thread> submitters;
+        for (int i = 0; i < 4; ++i)
+        {
+            submitters.emplace_back([&] {
+                while (pool.submit([&ranCount] { ++ranCount; }))
+                {
+                    ++acceptedCount;
+                }
+                refused = true;
+            });
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        pool.stop();
+
+        for (auto& submitter : submitters)
+        {
+            submitter.join();
+        }
+
+        REQUIRE(refused);
+        //queued tasks are discarded, none runs after stop() returns
+        const size_t ranAtStop = ranCount;
+        REQUIRE(ranAtStop <= acceptedCount);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        REQUIRE(ranCount == ranAtStop);
+    }
+}
@@ -155,4 +155,49 @@ ASTRA_API astra_status_t astra_temp_update()
     return get_api_proxy()->temp_update();
 }
 
+ASTRA_API astra_status_t astra_reader_set_sync_policy(astra_reader_t reader,
+                                                      astra_reader_sync_policy_t policy,
+                                                      uint32_t toleranceMicroseconds)
+{
+    return get_api_proxy()->reader_set_sync_policy(reader, policy, toleranceMicroseconds);
+}
+
+ASTRA_API astra_status_t astra_stream_get_stats(astra_streamconnection_t connection,
+                                                astra_stream_stats_t* stats)
+{
+    return get_api_proxy()->stream_get_stats(connection, stats);
+}
+
+ASTRA_API astra_status_t astra_context_get_stats(astra_context_stats_t* stats)
+{
+    return get_api_proxy()->context_get_stats(stats);
+}
+
+ASTRA_API astra_status_t astra_frame_retain(astra_reader_frame_t frame,
+                                            astra_reader_frame_t* retainedFrame)
+{
+    return get_api_proxy()->frame_retain(frame, retainedFrame);
+}
+
+ASTRA_API astra_status_t astra_frame_release(astra_reader_frame_t* frame)
+{
+    return get_api_proxy()->frame_release(frame);
+}
+
+ASTRA_API astra_status_t astra_reader_wait_any(astra_reader_t* readers,
+                                               size_t count,
+                                               int timeoutMillis,
+                                               size_t* readyIndex)
+{
+    return get_api_proxy()->reader_wait_any(readers, count, timeoutMillis, readyIndex);
+}
+
+ASTRA_API astra_status_t astra_stream_read_parameter(astra_streamconnection_t connection,
+                                                     astra_parameter_id parameterId,
+                                                     size_t byteLength,
+                                                     astra_parameter_data_t data)
+{
+    return get_api_proxy()->stream_read_parameter(connection, parameterId, byteLength, data);
+}
+
 ASTRA_END_DECLS
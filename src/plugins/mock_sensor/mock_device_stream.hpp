@@ -22,6 +22,7 @@
 #include <astra/capi/streams/image_types.h>
 #include <astra/capi/streams/image_capi.h>
 #include <astra/capi/streams/stream_types.h>
+#include <astra/capi/streams/depth_parameters.h>
 
 #include <chrono>
 #include <memory>
@@ -116,6 +117,13 @@ namespace orbbec { namespace mocks {
           deviceStream_(stream)
     {
         deviceStream_->add_listener(this);
+
+        set_parameter_cacheable(ASTRA_PARAMETER_IMAGE_HFOV);
+        set_parameter_cacheable(ASTRA_PARAMETER_IMAGE_VFOV);
+        if (desc.type() == ASTRA_STREAM_DEPTH)
+        {
+            set_parameter_cacheable(ASTRA_PARAMETER_DEPTH_CONVERSION_CACHE);
+        }
     }
 
     template<typename TFrameWrapper>
@@ -366,6 +374,9 @@ namespace orbbec { namespace mocks {
         {
             set_mode(stream->active_mode());
         }
+
+        //a mode change also changes the fields of view and conversion cache
+        invalidate_parameters();
     }
 
     class image_stream : public device_stream<::astra_imageframe_wrapper_t>
@@ -33,24 +33,17 @@ namespace orbbec { namespace ni {
                        listener)
     {
         PROFILE_FUNC();
+
+        set_parameter_cacheable(ASTRA_PARAMETER_DEPTH_CONVERSION_CACHE);
     }
 
-    astra_status_t depthstream::on_open()
+    void depthstream::on_mode_changed()
     {
-        auto rc = devicestream::on_open();
-
-        if (rc != astra_status_t::ASTRA_STATUS_SUCCESS)
-        {
-            return rc;
-        }
-
         PROFILE_FUNC();
         refresh_conversion_cache(oniStream_.getHorizontalFieldOfView(),
                                  oniStream_.getVerticalFieldOfView(),
                                  mode_.width(),
                                  mode_.height());
-
-        return rc;
     }
 
     void depthstream::refresh_conversion_cache(float horizontalFov,
@@ -45,7 +45,7 @@ namespace orbbec { namespace ni {
                                       int resolutionX,
                                       int resolutionY);
 
-        virtual astra_status_t on_open() override;
+        virtual void on_mode_changed() override;
 
         virtual void on_get_parameter(astra_streamconnection_t connection,
                                       astra_parameter_id id,
@@ -23,6 +23,8 @@
 #include <astra/capi/streams/image_parameters.h>
 #include <astra/capi/streams/image_types.h>
 #include <astra/capi/streams/image_capi.h>
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <cstring>
 #include <vector>
@@ -40,7 +42,8 @@
 namespace orbbec { namespace ni {
 
     template<typename TFrameWrapper>
-    class devicestream : public stream
+    class devicestream : public stream,
+                         public openni::VideoStream::NewFrameListener
     {
     public:
         using wrapper_type = TFrameWrapper;
@@ -59,6 +62,9 @@ namespace orbbec { namespace ni {
               oniSensorType_(oniSensorType)
         {
             PROFILE_FUNC();
+
+            set_parameter_cacheable(ASTRA_PARAMETER_IMAGE_HFOV);
+            set_parameter_cacheable(ASTRA_PARAMETER_IMAGE_VFOV);
         }
 
         virtual ~devicestream()
@@ -236,6 +242,9 @@ namespace orbbec { namespace ni {
             {
                 bin_->link_connection(conn);
             };
+
+            on_mode_changed();
+            invalidate_parameters();
         }
 
         virtual void on_new_buffer(wrapper_type* wrapper)
@@ -256,11 +265,25 @@ namespace orbbec { namespace ni {
 
         virtual openni::VideoStream* get_stream() override { return &oniStream_; }
 
+        //called on an OpenNI thread. the frame itself is read on the next update,
+        //this only notes when it arrived and wakes the update thread so it doesn't
+        //wait for its poll interval
+        virtual void onNewFrame(openni::VideoStream&) override
+        {
+            lastFrameArrival_ = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+
+            pluginService().request_update();
+        }
+
         virtual void on_connection_added(astra_streamconnection_t connection) override;
         virtual void on_connection_removed(astra_bin_t bin,
                                            astra_streamconnection_t connection) override;
 
     protected:
+        //called when frames of a new mode start arriving
+        virtual void on_mode_changed() {}
+
         openni::Device& oniDevice_;
         openni::SensorType oniSensorType_;
         openni::VideoStream oniStream_;
@@ -283,6 +306,8 @@ namespace orbbec { namespace ni {
 
             LOG_INFO("orbbec.ni.devicestream", "created oni stream of type: %d", description().type());
 
+            oniStream_.addNewFrameListener(this);
+
             const openni::SensorInfo& pInfo = oniStream_.getSensorInfo();
             auto& modes = pInfo.getSupportedVideoModes();
 
@@ -318,6 +343,7 @@ namespace orbbec { namespace ni {
             stop();
 
             LOG_INFO("orbbec.ni.devicestream", "destroying oni stream of type: %d", description().type());
+            oniStream_.removeNewFrameListener(this);
             oniStream_.destroy();
 
             return ASTRA_STATUS_SUCCESS;
@@ -367,6 +393,8 @@ namespace orbbec { namespace ni {
         std::vector<astra_streamconnection_t> connections_;
 
         size_t bufferLength_{0};
+        //steady clock microseconds, the capture time reported for the next frame read
+        std::atomic<uint64_t> lastFrameArrival_{0};
         astra_stream_t streamHandle_{nullptr};
 
         std::vector<astra::ImageStreamMode> modes_;
@@ -460,6 +488,10 @@ namespace orbbec { namespace ni {
 
             std::memcpy(wrapper->frame.data, oniFrameData, byteSize);
 
+            //device timestamps are in the device's clock, the arrival time is
+            //comparable with the other streams readers sync against
+            bin_->set_capture_timestamp(lastFrameArrival_);
+
             PROFILE_BEGIN(oni_stream_end_write);
             bin_->end_write();
             PROFILE_END();
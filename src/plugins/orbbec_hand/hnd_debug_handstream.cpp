@@ -75,7 +75,8 @@ namespace astra { namespace hand {
                                                               &parameterData);
         if (rc == ASTRA_STATUS_SUCCESS)
         {
-            std::memcpy(parameterData, &viewType_, resultByteLength);
+            debug_handview_type viewType = viewType_;
+            std::memcpy(parameterData, &viewType, resultByteLength);
         }
     }
 
@@ -108,6 +109,7 @@ namespace astra { namespace hand {
             astra_vector2f_t newMousePosition;
             std::memcpy(&newMousePosition, inData, sizeof(astra_vector2f_t));
 
+            std::lock_guard<std::mutex> lock(positionMutex_);
             mouseNormPosition_ = newMousePosition;
         }
     }
@@ -132,6 +134,7 @@ namespace astra { namespace hand {
 
             if (newLockSpawnPoint && !lockSpawnPoint_)
             {
+                std::lock_guard<std::mutex> lock(positionMutex_);
                 spawnNormPosition_ = mouseNormPosition_;
             }
             lockSpawnPoint_ = newLockSpawnPoint;
@@ -21,6 +21,8 @@
 #include <astra/capi/astra_ctypes.h>
 #include <astra/capi/streams/stream_types.h>
 #include <astra/Vector.hpp>
+#include <atomic>
+#include <mutex>
 
 namespace astra { namespace hand {
 
@@ -46,10 +48,20 @@ namespace astra { namespace hand {
         void set_view_type(debug_handview_type view) { viewType_ = view; }
 
         bool use_mouse_probe() const { return useMouseProbe_; }
-        const Vector2f& mouse_norm_position() const { return mouseNormPosition_; }
         bool pause_input() const { return pauseInput_; }
         bool spawn_point_locked() const { return lockSpawnPoint_; }
-        const Vector2f& spawn_norm_position() const { return spawnNormPosition_; }
+
+        Vector2f mouse_norm_position() const
+        {
+            std::lock_guard<std::mutex> lock(positionMutex_);
+            return mouseNormPosition_;
+        }
+
+        Vector2f spawn_norm_position() const
+        {
+            std::lock_guard<std::mutex> lock(positionMutex_);
+            return spawnNormPosition_;
+        }
 
     protected:
         virtual void on_set_parameter(astra_streamconnection_t connection,
@@ -75,12 +87,14 @@ namespace astra { namespace hand {
         void set_pause_input(size_t inByteLength, astra_parameter_data_t& inData);
         void set_lock_spawn_point(size_t inByteLength, astra_parameter_data_t& inData);
 
-        debug_handview_type viewType_{ DEBUG_HAND_VIEW_DEPTH };
-        bool useMouseProbe_{false};
+        //set by clients, read by the tracker on a dataflow worker thread
+        std::atomic<debug_handview_type> viewType_{ DEBUG_HAND_VIEW_DEPTH };
+        std::atomic<bool> useMouseProbe_{false};
+        mutable std::mutex positionMutex_;
         Vector2f mouseNormPosition_;
         Vector2f spawnNormPosition_;
-        bool pauseInput_{false};
-        bool lockSpawnPoint_{false};
+        std::atomic<bool> pauseInput_{false};
+        std::atomic<bool> lockSpawnPoint_{false};
     };
 }}
 
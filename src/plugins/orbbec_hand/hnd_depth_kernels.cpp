@@ -0,0 +1,252 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#include "hnd_depth_kernels_impl.hpp"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HND_DEPTH_KERNELS_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+//armv7 NEON has no exact divide, so only 64-bit arm gets vector kernels
+#define HND_DEPTH_KERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined(ASTRA_HAND_AVX2) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace astra { namespace hand { namespace depth_kernels {
+
+    namespace {
+
+        struct scalar_ops
+        {
+            static void convert(const std::int16_t* depth, float* target, std::size_t count)
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    convert_pixel(depth + i, target + i);
+                }
+            }
+
+            static void velocity(const float* depth,
+                                 float* previous,
+                                 float* filled,
+                                 std::uint8_t* filledMask,
+                                 float* average,
+                                 float* velocity,
+                                 std::size_t count,
+                                 const velocity_params& params)
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    velocity_pixel(depth[i], previous[i], filled[i], filledMask[i], average[i], velocity[i], params);
+                }
+            }
+
+            static void threshold(const float* velocity, std::uint8_t* signal, std::size_t count, float threshold)
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    threshold_pixel(velocity[i], signal[i], threshold);
+                }
+            }
+        };
+
+#if defined(HND_DEPTH_KERNELS_SSE2)
+        struct sse2_ops
+        {
+            using vec = __m128;
+            static const std::size_t WIDTH = 4;
+            static const std::size_t CONVERT_WIDTH = 8;
+
+            static vec set1(float value) { return _mm_set1_ps(value); }
+            static vec load(const float* source) { return _mm_loadu_ps(source); }
+            static void store(float* target, vec value) { _mm_storeu_ps(target, value); }
+
+            static vec add(vec a, vec b) { return _mm_add_ps(a, b); }
+            static vec sub(vec a, vec b) { return _mm_sub_ps(a, b); }
+            static vec mul(vec a, vec b) { return _mm_mul_ps(a, b); }
+            static vec div(vec a, vec b) { return _mm_div_ps(a, b); }
+            static vec abs(vec a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+
+            static vec cmpeq(vec a, vec b) { return _mm_cmpeq_ps(a, b); }
+            static vec cmpgt(vec a, vec b) { return _mm_cmpgt_ps(a, b); }
+            static vec cmplt(vec a, vec b) { return _mm_cmplt_ps(a, b); }
+            static vec bit_and(vec a, vec b) { return _mm_and_ps(a, b); }
+            static vec bit_or(vec a, vec b) { return _mm_or_ps(a, b); }
+
+            static vec select(vec mask, vec a, vec b)
+            {
+                return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+            }
+
+            static void store_mask(std::uint8_t* target, vec mask)
+            {
+                const std::uint32_t bytes = expand_mask_bits(_mm_movemask_ps(mask));
+                std::memcpy(target, &bytes, sizeof(bytes));
+            }
+
+            static void convert_block(const std::int16_t* depth, float* target)
+            {
+                const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(depth));
+                //interleave into the high halves then shift down to sign extend
+                const __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(values, values), 16);
+                const __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(values, values), 16);
+                _mm_storeu_ps(target, _mm_cvtepi32_ps(low));
+                _mm_storeu_ps(target + 4, _mm_cvtepi32_ps(high));
+            }
+        };
+#endif
+
+#if defined(HND_DEPTH_KERNELS_NEON)
+        struct neon_ops
+        {
+            using vec = float32x4_t;
+            static const std::size_t WIDTH = 4;
+            static const std::size_t CONVERT_WIDTH = 8;
+
+            static vec set1(float value) { return vdupq_n_f32(value); }
+            static vec load(const float* source) { return vld1q_f32(source); }
+            static void store(float* target, vec value) { vst1q_f32(target, value); }
+
+            static vec add(vec a, vec b) { return vaddq_f32(a, b); }
+            static vec sub(vec a, vec b) { return vsubq_f32(a, b); }
+            static vec mul(vec a, vec b) { return vmulq_f32(a, b); }
+            static vec div(vec a, vec b) { return vdivq_f32(a, b); }
+            static vec abs(vec a) { return vabsq_f32(a); }
+
+            static vec cmpeq(vec a, vec b) { return vreinterpretq_f32_u32(vceqq_f32(a, b)); }
+            static vec cmpgt(vec a, vec b) { return vreinterpretq_f32_u32(vcgtq_f32(a, b)); }
+            static vec cmplt(vec a, vec b) { return vreinterpretq_f32_u32(vcltq_f32(a, b)); }
+
+            static vec bit_and(vec a, vec b)
+            {
+                return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b)));
+            }
+
+            static vec bit_or(vec a, vec b)
+            {
+                return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b)));
+            }
+
+            static vec select(vec mask, vec a, vec b)
+            {
+                return vbslq_f32(vreinterpretq_u32_f32(mask), a, b);
+            }
+
+            static void store_mask(std::uint8_t* target, vec mask)
+            {
+                const uint16x4_t halves = vmovn_u32(vreinterpretq_u32_f32(mask));
+                const uint8x8_t bytes = vand_u8(vmovn_u16(vcombine_u16(halves, halves)), vdup_n_u8(1));
+                vst1_lane_u32(reinterpret_cast<std::uint32_t*>(target), vreinterpret_u32_u8(bytes), 0);
+            }
+
+            static void convert_block(const std::int16_t* depth, float* target)
+            {
+                const int16x8_t values = vld1q_s16(depth);
+                vst1q_f32(target, vcvtq_f32_s32(vmovl_s16(vget_low_s16(values))));
+                vst1q_f32(target + 4, vcvtq_f32_s32(vmovl_s16(vget_high_s16(values))));
+            }
+        };
+#endif
+
+#if defined(ASTRA_HAND_AVX2)
+        bool cpu_supports_avx2()
+        {
+#if defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7)
+            {
+                return false;
+            }
+
+            //the os has to save the ymm registers as well
+            __cpuid(info, 1);
+            const bool osxsave = (info[2] & (1 << 27)) != 0;
+            const bool avx = (info[2] & (1 << 28)) != 0;
+            if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+            {
+                return false;
+            }
+
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+#else
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") != 0;
+#endif
+        }
+#endif
+    }
+
+    const kernel_set& scalar_kernels()
+    {
+        static const kernel_set kernels = {
+            "scalar",
+            &scalar_ops::convert,
+            &scalar_ops::velocity,
+            &scalar_ops::threshold
+        };
+        return kernels;
+    }
+
+    std::vector<const kernel_set*> supported_kernels()
+    {
+        std::vector<const kernel_set*> kernels;
+        kernels.push_back(&scalar_kernels());
+
+#if defined(HND_DEPTH_KERNELS_SSE2)
+        static const kernel_set sse2 = {
+            "sse2",
+            &convert_kernel<sse2_ops>,
+            &velocity_kernel<sse2_ops>,
+            &threshold_kernel<sse2_ops>
+        };
+        kernels.push_back(&sse2);
+#endif
+
+#if defined(HND_DEPTH_KERNELS_NEON)
+        static const kernel_set neon = {
+            "neon",
+            &convert_kernel<neon_ops>,
+            &velocity_kernel<neon_ops>,
+            &threshold_kernel<neon_ops>
+        };
+        kernels.push_back(&neon);
+#endif
+
+#if defined(ASTRA_HAND_AVX2)
+        if (cpu_supports_avx2())
+        {
+            kernels.push_back(&avx2_kernels());
+        }
+#endif
+
+        return kernels;
+    }
+
+    const kernel_set& best_kernels()
+    {
+        static const kernel_set& kernels = *supported_kernels().back();
+        return kernels;
+    }
+}}}
@@ -0,0 +1,86 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#ifndef HND_DEPTH_KERNELS_H
+#define HND_DEPTH_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace astra { namespace hand {
+
+    // Per-pixel passes of depth_utility::depth_to_velocity_signal. The
+    // scalar kernels are the reference; the vector kernels give bit-identical
+    // results, they only use IEEE add, sub, mul, div and compares in the same
+    // order, never fused multiply-adds or reciprocal estimates.
+    namespace depth_kernels {
+
+        struct velocity_params
+        {
+            //running average weight of the current frame
+            float alpha;
+            //relative increase in depth treated as an edge jump
+            float jumpThreshold;
+            //0 keeps signed velocities unscaled by depth
+            float depthAdjustmentFactor;
+            float minDepth;
+            float maxDepth;
+        };
+
+        //int16 depth to float
+        using convert_fn = void(*)(const std::int16_t* depth,
+                                   float* target,
+                                   std::size_t count);
+
+        //one sweep over the processing-size frame that fills zero depth from
+        //the previous frame, updates the running average, computes the
+        //velocity as a fraction of the average, scales it by depth and
+        //stores depth as the next frame's previous depth
+        using velocity_fn = void(*)(const float* depth,
+                                    float* previous,
+                                    float* filled,
+                                    std::uint8_t* filledMask,
+                                    float* average,
+                                    float* velocity,
+                                    std::size_t count,
+                                    const velocity_params& params);
+
+        //foreground where velocity is above the threshold, background elsewhere
+        using threshold_fn = void(*)(const float* velocity,
+                                     std::uint8_t* signal,
+                                     std::size_t count,
+                                     float threshold);
+
+        struct kernel_set
+        {
+            const char* name;
+            convert_fn convert;
+            velocity_fn velocity;
+            threshold_fn threshold;
+        };
+
+        const kernel_set& scalar_kernels();
+
+        //the widest kernels this cpu supports, chosen once
+        const kernel_set& best_kernels();
+
+        //every kernel set this cpu supports, scalar first
+        std::vector<const kernel_set*> supported_kernels();
+    }
+}}
+
+#endif // HND_DEPTH_KERNELS_H
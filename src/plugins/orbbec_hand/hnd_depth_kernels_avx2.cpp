@@ -0,0 +1,79 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+// Built with AVX2 code generation. Nothing here may run before
+// best_kernels() has checked the cpu, so this file only hands out a
+// kernel_set and has no static initializers that execute AVX2 code.
+#include "hnd_depth_kernels_impl.hpp"
+#include <immintrin.h>
+#include <cstring>
+
+namespace astra { namespace hand { namespace depth_kernels {
+
+    namespace {
+
+        struct avx2_ops
+        {
+            using vec = __m256;
+            static const std::size_t WIDTH = 8;
+            static const std::size_t CONVERT_WIDTH = 8;
+
+            static vec set1(float value) { return _mm256_set1_ps(value); }
+            static vec load(const float* source) { return _mm256_loadu_ps(source); }
+            static void store(float* target, vec value) { _mm256_storeu_ps(target, value); }
+
+            static vec add(vec a, vec b) { return _mm256_add_ps(a, b); }
+            static vec sub(vec a, vec b) { return _mm256_sub_ps(a, b); }
+            static vec mul(vec a, vec b) { return _mm256_mul_ps(a, b); }
+            static vec div(vec a, vec b) { return _mm256_div_ps(a, b); }
+            static vec abs(vec a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+
+            static vec cmpeq(vec a, vec b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+            static vec cmpgt(vec a, vec b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+            static vec cmplt(vec a, vec b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+            static vec bit_and(vec a, vec b) { return _mm256_and_ps(a, b); }
+            static vec bit_or(vec a, vec b) { return _mm256_or_ps(a, b); }
+
+            static vec select(vec mask, vec a, vec b) { return _mm256_blendv_ps(b, a, mask); }
+
+            static void store_mask(std::uint8_t* target, vec mask)
+            {
+                const unsigned bits = static_cast<unsigned>(_mm256_movemask_ps(mask));
+                const std::uint32_t low = expand_mask_bits(bits);
+                const std::uint32_t high = expand_mask_bits(bits >> 4);
+                std::memcpy(target, &low, sizeof(low));
+                std::memcpy(target + 4, &high, sizeof(high));
+            }
+
+            static void convert_block(const std::int16_t* depth, float* target)
+            {
+                const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(depth));
+                _mm256_storeu_ps(target, _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(values)));
+            }
+        };
+    }
+
+    const kernel_set& avx2_kernels()
+    {
+        static const kernel_set kernels = {
+            "avx2",
+            &convert_kernel<avx2_ops>,
+            &velocity_kernel<avx2_ops>,
+            &threshold_kernel<avx2_ops>
+        };
+        return kernels;
+    }
+}}}
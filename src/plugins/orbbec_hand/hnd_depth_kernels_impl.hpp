@@ -0,0 +1,229 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#ifndef HND_DEPTH_KERNELS_IMPL_H
+#define HND_DEPTH_KERNELS_IMPL_H
+
+#include "hnd_depth_kernels.hpp"
+#include <cmath>
+#include <limits>
+
+// Kernel bodies shared by the translation units of each instruction set.
+// Everything here has internal linkage, so code built for one instruction
+// set is never picked by the linker for another.
+
+namespace astra { namespace hand { namespace depth_kernels {
+
+#if defined(ASTRA_HAND_AVX2)
+    //built in its own translation unit with AVX2 enabled
+    const kernel_set& avx2_kernels();
+#endif
+
+    namespace {
+
+        const std::uint8_t MASK_NORMAL = 0;
+        const std::uint8_t MASK_FILLED = 1;
+        const std::uint8_t SIGNAL_BACKGROUND = 0;
+        const std::uint8_t SIGNAL_FOREGROUND = 1;
+
+        inline void convert_pixel(const std::int16_t* depth, float* target)
+        {
+            *target = static_cast<float>(*depth);
+        }
+
+        inline void velocity_pixel(const float depth,
+                                   float& previous,
+                                   float& filled,
+                                   std::uint8_t& filledMask,
+                                   float& average,
+                                   float& velocity,
+                                   const velocity_params& params)
+        {
+            const float epsilon = std::numeric_limits<float>::epsilon();
+            const float previousDepth = previous;
+
+            //fill 0 depth pixels with the value from the previous frame
+            const bool isFilled = depth == 0.0f;
+            const float filledDepth = isFilled ? previousDepth : depth;
+
+            //update running average
+            float averageDepth = (1.0f - params.alpha) * average + params.alpha * filledDepth;
+
+            if (isFilled || previousDepth == 0.0f)
+            {
+                //no usable history, restart the average
+                averageDepth = filledDepth;
+            }
+            else
+            {
+                //suppress the signal when a pixel jumps a long distance from near to far
+                const float percentChange = (filledDepth - previousDepth) / previousDepth;
+                if (percentChange > 0.0f && percentChange > params.jumpThreshold)
+                {
+                    averageDepth = filledDepth;
+                }
+            }
+
+            //current minus average, scaled by average = velocity as a percent change
+            const float t0 = averageDepth + epsilon;
+            float pixelVelocity = ((filledDepth - t0) + epsilon) / t0;
+
+            //scale by depth and remove signed velocities
+            if (params.depthAdjustmentFactor != 0.0f && depth != 0.0f)
+            {
+                if (depth > params.minDepth && depth < params.maxDepth)
+                {
+                    const float depthM = depth / 1000.0f;
+                    pixelVelocity = std::fabs(pixelVelocity / (depthM * params.depthAdjustmentFactor));
+                }
+                else
+                {
+                    pixelVelocity = 0.0f;
+                }
+            }
+
+            previous = depth;
+            filled = filledDepth;
+            filledMask = isFilled ? MASK_FILLED : MASK_NORMAL;
+            average = averageDepth;
+            velocity = pixelVelocity;
+        }
+
+        inline void threshold_pixel(const float velocity, std::uint8_t& signal, const float threshold)
+        {
+            signal = velocity > threshold ? SIGNAL_FOREGROUND : SIGNAL_BACKGROUND;
+        }
+
+        // TOps wraps one instruction set: a float vector type vec of WIDTH
+        // lanes, lane-wise arithmetic and compares that return all-ones
+        // lanes, select(mask, a, b), store_mask writing 0 or 1 per lane, and
+        // convert_block for CONVERT_WIDTH int16 values.
+
+        template<typename TOps>
+        void convert_kernel(const std::int16_t* depth, float* target, std::size_t count)
+        {
+            std::size_t i = 0;
+            for (; i + TOps::CONVERT_WIDTH <= count; i += TOps::CONVERT_WIDTH)
+            {
+                TOps::convert_block(depth + i, target + i);
+            }
+
+            for (; i < count; ++i)
+            {
+                convert_pixel(depth + i, target + i);
+            }
+        }
+
+        template<typename TOps>
+        void velocity_kernel(const float* depth,
+                             float* previous,
+                             float* filled,
+                             std::uint8_t* filledMask,
+                             float* average,
+                             float* velocity,
+                             std::size_t count,
+                             const velocity_params& params)
+        {
+            using vec = typename TOps::vec;
+
+            const vec zero = TOps::set1(0.0f);
+            const vec epsilon = TOps::set1(std::numeric_limits<float>::epsilon());
+            const vec alpha = TOps::set1(params.alpha);
+            const vec oneMinusAlpha = TOps::set1(1.0f - params.alpha);
+            const vec jumpThreshold = TOps::set1(params.jumpThreshold);
+            const vec minDepth = TOps::set1(params.minDepth);
+            const vec maxDepth = TOps::set1(params.maxDepth);
+            const vec millimetersPerMeter = TOps::set1(1000.0f);
+            const vec depthAdjustmentFactor = TOps::set1(params.depthAdjustmentFactor);
+            const bool adjustForDepth = params.depthAdjustmentFactor != 0.0f;
+
+            std::size_t i = 0;
+            for (; i + TOps::WIDTH <= count; i += TOps::WIDTH)
+            {
+                const vec d = TOps::load(depth + i);
+                const vec previousDepth = TOps::load(previous + i);
+
+                const vec isFilled = TOps::cmpeq(d, zero);
+                const vec filledDepth = TOps::select(isFilled, previousDepth, d);
+
+                vec averageDepth = TOps::add(TOps::mul(oneMinusAlpha, TOps::load(average + i)),
+                                             TOps::mul(alpha, filledDepth));
+
+                const vec percentChange = TOps::div(TOps::sub(filledDepth, previousDepth), previousDepth);
+                const vec isJump = TOps::bit_and(TOps::cmpgt(percentChange, zero),
+                                                 TOps::cmpgt(percentChange, jumpThreshold));
+                const vec restart = TOps::bit_or(TOps::bit_or(isFilled, TOps::cmpeq(previousDepth, zero)),
+                                                 isJump);
+                averageDepth = TOps::select(restart, filledDepth, averageDepth);
+
+                const vec t0 = TOps::add(averageDepth, epsilon);
+                vec pixelVelocity = TOps::div(TOps::add(TOps::sub(filledDepth, t0), epsilon), t0);
+
+                if (adjustForDepth)
+                {
+                    const vec depthM = TOps::div(d, millimetersPerMeter);
+                    const vec scaled = TOps::abs(TOps::div(pixelVelocity,
+                                                           TOps::mul(depthM, depthAdjustmentFactor)));
+                    const vec inRange = TOps::bit_and(TOps::cmpgt(d, minDepth), TOps::cmplt(d, maxDepth));
+
+                    //out of range lanes become +0, zero depth lanes keep their velocity
+                    pixelVelocity = TOps::select(isFilled, pixelVelocity, TOps::bit_and(inRange, scaled));
+                }
+
+                TOps::store(previous + i, d);
+                TOps::store(filled + i, filledDepth);
+                TOps::store_mask(filledMask + i, isFilled);
+                TOps::store(average + i, averageDepth);
+                TOps::store(velocity + i, pixelVelocity);
+            }
+
+            for (; i < count; ++i)
+            {
+                velocity_pixel(depth[i], previous[i], filled[i], filledMask[i], average[i], velocity[i], params);
+            }
+        }
+
+        template<typename TOps>
+        void threshold_kernel(const float* velocity, std::uint8_t* signal, std::size_t count, float threshold)
+        {
+            using vec = typename TOps::vec;
+
+            const vec thresholdVec = TOps::set1(threshold);
+
+            std::size_t i = 0;
+            for (; i + TOps::WIDTH <= count; i += TOps::WIDTH)
+            {
+                TOps::store_mask(signal + i, TOps::cmpgt(TOps::load(velocity + i), thresholdVec));
+            }
+
+            for (; i < count; ++i)
+            {
+                threshold_pixel(velocity[i], signal[i], threshold);
+            }
+        }
+
+        //0 or 1 in each of the low four bytes for the low four bits
+        inline std::uint32_t expand_mask_bits(unsigned bits)
+        {
+            return (bits & 1u)
+                | ((bits & 2u) << 7)
+                | ((bits & 4u) << 14)
+                | ((bits & 8u) << 21);
+        }
+    }
+}}}
+
+#endif // HND_DEPTH_KERNELS_IMPL_H
@@ -26,6 +26,7 @@ namespace astra { namespace hand {
     depth_utility::depth_utility(float width, float height, depth_utility_settings& settings) :
         processingWidth_(width),
         processingHeight_(height),
+        kernels_(depth_kernels::best_kernels()),
         depthSmoothingFactor_(settings.depthSmoothingFactor),
         velocityThresholdFactor_(settings.velocityThresholdFactor),
         maxDepthJumpPercent_(settings.maxDepthJumpPercent),
@@ -76,58 +77,6 @@ namespace astra { namespace hand {
         }
     }
 
-    void depth_utility::accumulate_averages(const BitmapF& input,
-                                            const BitmapF& prevInput,
-                                            const BitmapMask& mask,
-                                            const float alpha,
-                                            const float jumpThreshold,
-                                            BitmapF& accumulated)
-    {
-        assert(input.width() == accumulated.width());
-        assert(input.height() == accumulated.height());
-
-        const float oneMinusAlpha = 1.0f - alpha;
-
-        const unsigned width = input.width();
-        const unsigned height = input.height();
-
-        const float* inputData = input.data();
-        const auto* prevInputData = prevInput.data();
-        const MaskType* maskData = mask.data();
-        float* accumulatedData = accumulated.data();
-
-        for(unsigned y = 0; y < height; ++y)
-        {
-            for (unsigned x = 0; x < width; ++x, ++inputData, ++prevInputData, ++maskData, ++accumulatedData)
-            {
-                //update running average
-                *accumulatedData = oneMinusAlpha * (*accumulatedData) +
-                                   alpha * (*inputData);
-
-                const fill_mask_type mergeMask = fill_mask_type(*maskData);
-                const bool updatedValue = mergeMask == fill_mask_type::normal;
-                const bool indeterminateValues = *inputData == 0.0f || *prevInputData == 0.0f;
-
-                if (!updatedValue || indeterminateValues)
-                {
-                    *accumulatedData = *inputData;
-                }
-                else
-                {
-                    const float currentValue = *inputData;
-                    const float previousValue = *prevInputData;
-                    const float percentChange = (currentValue - previousValue) / previousValue;
-                    const bool isIncreasing = percentChange > 0.0f;
-
-                    if (isIncreasing && std::fabs(percentChange) > jumpThreshold)
-                    {
-                        *accumulatedData = *inputData;
-                    }
-                }
-            }
-        }
-    }
-
     void depth_utility::depth_to_velocity_signal(const DepthFrame& depthFrame,
                                                  BitmapF& matDepth,
                                                  BitmapF& matDepthFullSize,
@@ -152,49 +101,33 @@ namespace astra { namespace hand {
         }
 
         matVelocitySignal.recreate(matDepth.size());
-        matVelocitySignal.fill(0);
-
-        //fill 0 depth pixels with the value from the previous frame
-        fill_zero_values(matDepth, matDepthFilled_, matDepthFilledMask_, matDepthPrevious_);
-
-        accumulate_averages(matDepthFilled_,
-                            matDepthPrevious_,
-                            matDepthFilledMask_,
-                            depthSmoothingFactor_,
-                            maxDepthJumpPercent_,
-                            matDepthAvg_);
-
-        //current minus average, scaled by average = velocity as a percent change
-
-        auto* velocityData = matDepthVel_.data();
-        const float* t0Data = matDepthAvg_.data();
-        const float* t1Data = matDepthFilled_.data();
-
-        // abstractly:
-        //matDepthVel_ = (matDepthFilled_ - matDepthAvg_) / matDepthAvg_;
-        for (unsigned y = 0; y < matDepthVel_.height(); ++y)
-        {
-            for(unsigned x = 0; x < matDepthVel_.width(); ++x, ++velocityData, ++t0Data, ++t1Data)
-            {
-                float t0Value = *t0Data + std::numeric_limits<float>::epsilon();
-                float t1Value = *t1Data;
-                // percentage of the previous velocities
-                float percentVelocity = ((t1Value - t0Value) + std::numeric_limits<float>::epsilon()) / t0Value;
-
-                *velocityData = percentVelocity;
-            }
-        }
-
-        // scales velocity by depth, removed signed velocities
-        adjust_velocities_for_depth(matDepth, matDepthVel_);
-
-        erode(matDepthVel_, matDepthVelErode_, rectElement_);
-
-        threshold_velocity_signal(matDepthVelErode_,
-                                  matVelocitySignal,
-                                  velocityThresholdFactor_);
 
-        copy_to(matDepth, matDepthPrevious_);
+        depth_kernels::velocity_params params;
+        params.alpha = depthSmoothingFactor_;
+        params.jumpThreshold = maxDepthJumpPercent_;
+        params.depthAdjustmentFactor = depthAdjustmentFactor_;
+        params.minDepth = minDepth_;
+        params.maxDepth = maxDepth_;
+
+        //one sweep fills 0 depth pixels from the previous frame, updates the
+        //running average, computes the velocity as a percent change of the
+        //average scaled by depth, and keeps this depth as the previous frame
+        kernels_.velocity(matDepth.data(),
+                          matDepthPrevious_.data(),
+                          matDepthFilled_.data(),
+                          matDepthFilledMask_.data(),
+                          matDepthAvg_.data(),
+                          matDepthVel_.data(),
+                          matDepth.length(),
+                          params);
+
+        erode(matDepthVel_, matDepthVelErode_, rectElement_, morphologyScratch_);
+
+        //matDepthVelErode_ is already abs(vel)
+        kernels_.threshold(matDepthVelErode_.data(),
+                           matVelocitySignal.data(),
+                           matVelocitySignal.length(),
+                           velocityThresholdFactor_);
 
         //analyze_velocities(matDepth, matDepthVelErode_);
     }
@@ -208,176 +141,7 @@ namespace astra { namespace hand {
         //ensure initialized
         matTarget.recreate(width, height);
 
-        const int16_t* depthData = depthFrameSrc.data();
-
-        for (int y = 0; y < height; ++y)
-        {
-            float* row = matTarget.data(y);
-            for (int x = 0; x < width; ++x)
-            {
-                float depth = static_cast<float>(*depthData);
-                *row = depth;
-                ++row;
-                ++depthData;
-            }
-        }
-    }
-
-    void depth_utility::fill_zero_values(BitmapF& matDepth,
-                                         BitmapF& matDepthFilled,
-                                         BitmapMask& matDepthFilledMask,
-                                         BitmapF& matDepthPrevious)
-    {
-        PROFILE_FUNC();
-        const int width = matDepth.width();
-        const int height = matDepth.height();
-
-        for (int y = 0; y < height; ++y)
-        {
-            const auto* depthRow = matDepth.data(y);
-            const auto* prevDepthRow = matDepthPrevious.data(y);
-            auto* filledDepthRow = matDepthFilled.data(y);
-            auto* filledDepthMaskRow = matDepthFilledMask.data(y);
-
-            for (int x = 0; x < width; ++x)
-            {
-                auto depth = *depthRow;
-
-                if (depth == 0)
-                {
-                    depth = *prevDepthRow;
-                    *filledDepthMaskRow = static_cast<MaskType>(fill_mask_type::filled);
-                }
-                else
-                {
-                    *filledDepthMaskRow = static_cast<MaskType>(fill_mask_type::normal);
-                }
-
-                *filledDepthRow = depth;
-
-                ++depthRow;
-                ++prevDepthRow;
-                ++filledDepthRow;
-                ++filledDepthMaskRow;
-            }
-        }
-    }
-
-    void depth_utility::filter_zero_values_and_jumps(BitmapF& matDepth,
-                                                     BitmapF& matDepthPrevious,
-                                                     BitmapF& matDepthAvg,
-                                                     BitmapMask& matDepthFilledMask,
-                                                     const float maxDepthJumpPercent)
-    {
-        PROFILE_FUNC();
-        const int width = matDepth.width();
-        const int height = matDepth.width();
-
-        for (int y = 0; y < height; ++y)
-        {
-            auto* depthRow = matDepth.data(y);
-            auto* prevDepthRow = matDepthPrevious.data(y);
-            auto* avgRow = matDepthAvg.data(y);
-            auto* filledDepthMaskRow = matDepthFilledMask.data(y);
-
-            for (int x = 0; x < width; ++x, ++depthRow, ++prevDepthRow, ++filledDepthMaskRow)
-            {
-                float depth = *depthRow;
-                float previousDepth = *prevDepthRow;
-                fill_mask_type fillType = static_cast<fill_mask_type>(*filledDepthMaskRow);
-
-                //calculate percent change since last frame
-                float deltaPercent = (depth - previousDepth) / previousDepth;
-                float absDeltaPercent = std::fabs(deltaPercent);
-                bool movingAway = deltaPercent > 0;
-
-                //suppress signal if either current or previous pixel are invalid
-                bool isZeroDepth = (0 == depth || 0 == previousDepth);
-
-                //suppress signal when a pixel was artificially filled
-                bool isFilled = (fillType == fill_mask_type::filled);
-
-                //suppress signal when a pixel jumps a long distance from near to far
-                bool isJumpingAway = (absDeltaPercent > maxDepthJumpPercent && movingAway);
-
-                if (isZeroDepth || isFilled || isJumpingAway)
-                {
-                    //set the average to the current depth, and set velocity to zero
-                    //this suppresses the velocity signal for edge jumping artifacts
-                    avgRow[x] = depth;
-                }
-
-                *prevDepthRow = depth;
-            }
-        }
-    }
-
-    void depth_utility::threshold_velocity_signal(BitmapF& matVelocityFiltered,
-                                                  BitmapMask& matVelocitySignal,
-                                                  const float velocityThresholdFactor)
-    {
-        PROFILE_FUNC();
-        const int width = matVelocitySignal.width();
-        const int height = matVelocitySignal.height();
-
-        for (int y = 0; y < height; ++y)
-        {
-            auto* velFilteredRow = matVelocityFiltered.data(y);
-            auto* velocitySignalRow = matVelocitySignal.data(y);
-
-            for (int x = 0; x < width; ++x, ++velFilteredRow, ++velocitySignalRow)
-            {
-                //matVelocityFiltered is already abs(vel)
-                const float velFiltered = *velFilteredRow;
-
-                if (velFiltered > velocityThresholdFactor)
-                {
-                    *velocitySignalRow = pixel_type::foreground;
-                }
-                else
-                {
-                    *velocitySignalRow = pixel_type::background;
-                }
-            }
-        }
-    }
-
-    void depth_utility::adjust_velocities_for_depth(BitmapF& matDepth, BitmapF& matVelocityFiltered)
-    {
-        PROFILE_FUNC();
-        if (depthAdjustmentFactor_ == 0)
-        {
-            return;
-        }
-
-        const int width = matDepth.width();
-        const int height = matDepth.height();
-
-        for (int y = 0; y < height; ++y)
-        {
-            auto* depthRow = matDepth.data(y);
-            auto* velFilteredRow = matVelocityFiltered.data(y);
-
-            for (int x = 0; x < width; ++x, ++depthRow, ++velFilteredRow)
-            {
-                const float depth = *depthRow;
-                if (depth != 0.0f)
-                {
-                    float& velFiltered = *velFilteredRow;
-
-                    if (depth > minDepth_ && depth < maxDepth_)
-                    {
-                        float depthM = depth / 1000.0f;
-                        // scale by depth, constant, remove signed velocities
-                        velFiltered = std::fabs(velFiltered / (depthM * depthAdjustmentFactor_));
-                    }
-                    else
-                    {
-                        velFiltered = 0;
-                    }
-                }
-            }
-        }
+        kernels_.convert(depthFrameSrc.data(), matTarget.data(), matTarget.length());
     }
 
     int depth_utility::depth_to_chunk_index(float depth)
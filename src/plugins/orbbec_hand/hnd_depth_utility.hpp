@@ -20,6 +20,8 @@
 #include <astra/astra.hpp>
 #include "hnd_settings.hpp"
 #include "hnd_bitmap.hpp"
+#include "hnd_depth_kernels.hpp"
+#include "hnd_morphology.hpp"
 #include <cstdint>
 
 #ifndef MIN
@@ -50,40 +52,10 @@ namespace astra { namespace hand {
         const BitmapF& matDepthFilled() const { return matDepthFilled_; }
 
     private:
-        enum class fill_mask_type : std::uint8_t
-        {
-            normal = 0,
-            filled = 1
-        };
-
-        static void depthframe_to_matrix(const DepthFrame& depthFrameSrc,
-                                         const int width,
-                                         const int height,
-                                         BitmapF& matTarget);
-
-        static void accumulate_averages(const BitmapF& input,
-                                        const BitmapF& prevInput,
-                                        const BitmapMask& mask,
-                                        const float alpha,
-                                        const float jumpThreshold,
-                                        BitmapF& accumulated);
-
-        static void fill_zero_values(BitmapF& matDepth,
-                                     BitmapF& matDepthFilled,
-                                     BitmapMask& matDepthFilledMask,
-                                     BitmapF& matDepthPrevious);
-
-        static void filter_zero_values_and_jumps(BitmapF& depthCurrent,
-                                                 BitmapF& depthPrev,
-                                                 BitmapF& depthAvg,
-                                                 BitmapMask& matDepthFilledMask,
-                                                 const float maxDepthJumpPercent);
-        void threshold_velocity_signal(BitmapF& matVelocityFiltered,
-                                       BitmapMask& matVelocitySignal,
-                                       const float velocityThresholdFactor);
-
-        void adjust_velocities_for_depth(BitmapF& matDepth,
-                                         BitmapF& matVelocityFiltered);
+        void depthframe_to_matrix(const DepthFrame& depthFrameSrc,
+                                  const int width,
+                                  const int height,
+                                  BitmapF& matTarget);
 
         int depth_to_chunk_index(float depth);
 
@@ -92,6 +64,7 @@ namespace astra { namespace hand {
 
         const float processingWidth_;
         const float processingHeight_;
+        const depth_kernels::kernel_set& kernels_;
 
         BitmapMask rectElement_;
         BitmapMask rectElement2_;
@@ -102,6 +75,7 @@ namespace astra { namespace hand {
         BitmapF matDepthAvg_;
         BitmapF matDepthVel_;
         BitmapF matDepthVelErode_;
+        morphology_scratch<float> morphologyScratch_;
 
         float depthSmoothingFactor_;
         float velocityThresholdFactor_;
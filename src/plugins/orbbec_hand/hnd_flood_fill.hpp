@@ -0,0 +1,191 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#ifndef HND_FLOOD_FILL_HPP
+#define HND_FLOOD_FILL_HPP
+
+#include "hnd_size.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace astra { namespace hand {
+
+    enum class fill_action
+    {
+        //stop at this pixel
+        skip,
+        //enqueue this pixel's unvisited neighbors
+        expand,
+        //end the fill
+        stop
+    };
+
+    // Buffers reused by the segmentation flood fills so a fill does not
+    // allocate or clear a visited map.
+    //
+    // Every fill enqueues a pixel at most once, so a ring sized to the frame
+    // never overflows. Visits are stamped with the current fill number and
+    // the map is only cleared when the stamp wraps.
+    class flood_fill_scratch
+    {
+    public:
+        struct entry
+        {
+            int x;
+            int y;
+            float ttl;
+        };
+
+        //! sizes the buffers and forgets every earlier visit
+        void begin_fill(Size2i size)
+        {
+            if (size != size_)
+            {
+                size_ = size;
+                const std::size_t pixelCount = size.width() * size.height();
+                queue_.assign(std::max<std::size_t>(pixelCount, 1), entry());
+                visited_.assign(pixelCount, 0);
+                stamp_ = 0;
+            }
+
+            if (++stamp_ == 0)
+            {
+                std::fill(visited_.begin(), visited_.end(), 0);
+                stamp_ = 1;
+            }
+
+            clear_queue();
+        }
+
+        //! empties the queue but keeps this fill's visits
+        void clear_queue()
+        {
+            head_ = 0;
+            count_ = 0;
+        }
+
+        //! marks index visited, returns false if it already was
+        bool visit(int index)
+        {
+            std::uint16_t& visited = visited_[index];
+            if (visited == stamp_)
+            {
+                return false;
+            }
+
+            visited = stamp_;
+            return true;
+        }
+
+        bool is_visited(int index) const { return visited_[index] == stamp_; }
+
+        bool empty() const { return count_ == 0; }
+
+        void push(int x, int y, float ttl)
+        {
+            assert(count_ < queue_.size());
+
+            std::size_t tail = head_ + count_;
+            if (tail >= queue_.size())
+            {
+                tail -= queue_.size();
+            }
+
+            queue_[tail] = entry{ x, y, ttl };
+            ++count_;
+        }
+
+        entry pop()
+        {
+            assert(count_ > 0);
+
+            const entry front = queue_[head_];
+            if (++head_ == queue_.size())
+            {
+                head_ = 0;
+            }
+            --count_;
+            return front;
+        }
+
+        Size2i size() const { return size_; }
+
+    private:
+        Size2i size_;
+        std::vector<entry> queue_;
+        std::vector<std::uint16_t> visited_;
+        std::uint16_t stamp_{0};
+        std::size_t head_{0};
+        std::size_t count_{0};
+    };
+
+    //! Breadth first fill from the pixels already queued in scratch.
+    //!
+    //! visit(x, y, ttl) is called once per dequeued pixel with its time to
+    //! live, which it may change, and returns what to do next. Neighbors are
+    //! queued right, left, down, up with the pixel's ttl after the visit. As
+    //! with the fills this replaces, pixels on the frame border never expand.
+    //! Returns true if visit stopped the fill.
+    template<typename TVisit>
+    bool flood_fill(flood_fill_scratch& scratch, TVisit&& visit)
+    {
+        const int width = scratch.size().width();
+        const int height = scratch.size().height();
+
+        while (!scratch.empty())
+        {
+            flood_fill_scratch::entry pt = scratch.pop();
+
+            const fill_action action = visit(pt.x, pt.y, pt.ttl);
+            if (action == fill_action::stop)
+            {
+                return true;
+            }
+
+            if (action == fill_action::skip ||
+                pt.x < 1 || pt.x > width - 2 ||
+                pt.y < 1 || pt.y > height - 2)
+            {
+                continue;
+            }
+
+            const int index = pt.x + pt.y * width;
+
+            if (scratch.visit(index + 1))
+            {
+                scratch.push(pt.x + 1, pt.y, pt.ttl);
+            }
+            if (scratch.visit(index - 1))
+            {
+                scratch.push(pt.x - 1, pt.y, pt.ttl);
+            }
+            if (scratch.visit(index + width))
+            {
+                scratch.push(pt.x, pt.y + 1, pt.ttl);
+            }
+            if (scratch.visit(index - width))
+            {
+                scratch.push(pt.x, pt.y - 1, pt.ttl);
+            }
+        }
+
+        return false;
+    }
+}}
+
+#endif // HND_FLOOD_FILL_HPP
@@ -48,15 +48,25 @@ namespace astra { namespace hand {
         PROFILE_FUNC();
 
         create_streams(pluginService_, streamSet);
-        depthStream_.start();
 
-        reader_.stream<PointStream>().start();
-        reader_.add_listener(*this);
+        //points may be computed on another worker, so pair them with depth by frame index
+        reader_.set_sync_policy(ASTRA_READER_SYNC_FRAME_INDEX);
+
+        //reads the points of the xs plugin's node, so the core runs it after that one
+        dataflowNode_ = std::unique_ptr<plugins::dataflow_node>(
+            new plugins::dataflow_node(pluginService_,
+                                       reader_,
+                                       { depthDesc, StreamDescription(ASTRA_STREAM_POINT) },
+                                       { StreamDescription(ASTRA_STREAM_HAND),
+                                         StreamDescription(ASTRA_STREAM_DEBUG_HAND) },
+                                       *this));
     }
 
     hand_tracker::~hand_tracker()
     {
         PROFILE_FUNC();
+        dataflowNode_.reset();
+
         if (worldPoints_ != nullptr)
         {
             delete[] worldPoints_;
@@ -120,7 +130,8 @@ namespace astra { namespace hand {
             generate_hand_frame(frameIndex);
         }
 
-        if (debugimagestream_->has_connections())
+        //a debug client that connected during tracking gets its first frame next time
+        if (debugimagestream_->has_connections() && arena_.debugLayersEnabled)
         {
             generate_hand_debug_image_frame(frameIndex);
         }
@@ -133,68 +144,8 @@ namespace astra { namespace hand {
     {
         PROFILE_FUNC();
 
-        layerSegmentation_.recreate(matDepth.size());
-        layerSegmentation_.fill(0);
-
-        layerScore_.recreate(matDepth.size());
-        layerScore_.fill(0.f);
-
-        layerEdgeDistance_.recreate(matDepth.size());
-        layerEdgeDistance_.fill(0.f);
-
-        debugUpdateSegmentation_.recreate(matDepth.size());
-        debugUpdateSegmentation_.fill(0);
-
-        debugCreateSegmentation_.recreate(matDepth.size());
-        debugCreateSegmentation_.fill(0);
-
-        debugRefineSegmentation_.recreate(matDepth.size());
-        debugRefineSegmentation_.fill(0);
-
-        updateForegroundSearched_.recreate(matDepth.size());
-        updateForegroundSearched_.fill(0);
-
-        createForegroundSearched_.recreate(matDepth.size());
-        createForegroundSearched_.fill(0);
-
-        refineForegroundSearched_.recreate(matDepth.size());
-        refineForegroundSearched_.fill(0);
-
-        debugUpdateScore_.recreate(matDepth.size());
-        debugUpdateScore_.fill(0.f);
-
-        debugCreateScore_.recreate(matDepth.size());
-        debugCreateScore_.fill(0.f);
-
-        matDepthWindow_.recreate(matDepth.size());
-        matDepthWindow_.fill(0.f);
-
-        refineSegmentation_.recreate(matDepth.size());
-        refineSegmentation_.fill(0);
-
-        refineScore_.recreate(matDepth.size());
-        refineScore_.fill(0.f);
-
-        refineEdgeDistance_.recreate(matDepth.size());
-        refineEdgeDistance_.fill(0.f);
-
-        debugUpdateScoreValue_.recreate(matDepth.size());
-        debugUpdateScoreValue_.fill(0.f);
-
-        debugCreateScoreValue_.recreate(matDepth.size());
-        debugCreateScoreValue_.fill(0.f);
-
-        debugRefineScoreValue_.recreate(matDepth.size());
-        debugRefineScoreValue_.fill(0.f);
-
-        debugCreateTestPassMap_.recreate(matDepth.size());
-        debugCreateTestPassMap_.fill(0);
-
-        debugUpdateTestPassMap_.recreate(matDepth.size());
-        debugUpdateTestPassMap_.fill(0);
-
-        debugRefineTestPassMap_.recreate(matDepth.size());
-        debugRefineTestPassMap_.fill(0);
+        const bool debugLayersEnabled = debugimagestream_->has_connections();
+        arena_.begin_frame(matDepth.size(), debugLayersEnabled);
 
         int numPoints = matDepth.width()* matDepth.height();
         if (worldPoints_ == nullptr || numWorldPoints_ != numPoints)
@@ -211,7 +162,6 @@ namespace astra { namespace hand {
 
         const conversion_cache_t depthToWorldData = depthStream_.depth_to_world_data();
 
-        bool debugLayersEnabled = debugimagestream_->has_connections();
         bool enabledTestPassMap = debugimagestream_->view_type() == DEBUG_HAND_VIEW_TEST_PASS_MAP;
 
         tracking_matrices updateMatrices(matDepthFullSize,
@@ -219,16 +169,18 @@ namespace astra { namespace hand {
                                          matArea_,
                                          matAreaSqrt_,
                                          matVelocitySignal,
-                                         updateForegroundSearched_,
-                                         layerSegmentation_,
-                                         layerScore_,
-                                         layerEdgeDistance_,
-                                         layerIntegralArea_,
-                                         layerTestPassMap_,
-                                         debugUpdateSegmentation_,
-                                         debugUpdateScore_,
-                                         debugUpdateScoreValue_,
-                                         debugUpdateTestPassMap_,
+                                         arena_.updateForegroundSearched,
+                                         arena_.updateForegroundSearchedBounds,
+                                         arena_.floodFill,
+                                         arena_.layerSegmentation,
+                                         arena_.layerScore,
+                                         arena_.layerEdgeDistance,
+                                         arena_.layerIntegralArea,
+                                         arena_.layerTestPassMap,
+                                         arena_.debugUpdateSegmentation,
+                                         arena_.debugUpdateScore,
+                                         arena_.debugUpdateScoreValue,
+                                         arena_.debugUpdateTestPassMap,
                                          enabledTestPassMap,
                                          fullSizeWorldPoints,
                                          worldPoints_,
@@ -253,16 +205,18 @@ namespace astra { namespace hand {
                                          matArea_,
                                          matAreaSqrt_,
                                          matVelocitySignal,
-                                         createForegroundSearched_,
-                                         layerSegmentation_,
-                                         layerScore_,
-                                         layerEdgeDistance_,
-                                         layerIntegralArea_,
-                                         layerTestPassMap_,
-                                         debugCreateSegmentation_,
-                                         debugCreateScore_,
-                                         debugCreateScoreValue_,
-                                         debugCreateTestPassMap_,
+                                         arena_.createForegroundSearched,
+                                         arena_.createForegroundSearchedBounds,
+                                         arena_.floodFill,
+                                         arena_.layerSegmentation,
+                                         arena_.layerScore,
+                                         arena_.layerEdgeDistance,
+                                         arena_.layerIntegralArea,
+                                         arena_.layerTestPassMap,
+                                         arena_.debugCreateSegmentation,
+                                         arena_.debugCreateScore,
+                                         arena_.debugCreateScoreValue,
+                                         arena_.debugCreateTestPassMap,
                                          enabledTestPassMap,
                                          fullSizeWorldPoints,
                                          worldPoints_,
@@ -275,7 +229,7 @@ namespace astra { namespace hand {
         {
             Point2i seedPosition;
             Point2i nextSearchStart(0, 0);
-            while (segmentation::find_next_velocity_seed_pixel(matVelocitySignal, createForegroundSearched_, seedPosition, nextSearchStart))
+            while (segmentation::find_next_velocity_seed_pixel(matVelocitySignal, arena_.createForegroundSearched, seedPosition, nextSearchStart))
             {
                 pointProcessor_.update_tracked_or_create_new_point_from_seed(createMatrices, seedPosition);
             }
@@ -291,20 +245,22 @@ namespace astra { namespace hand {
         pointProcessor_.remove_stale_or_dead_points();
 
         tracking_matrices refinementMatrices(matDepthFullSize,
-                                             matDepthWindow_,
+                                             arena_.depthWindow,
                                              matArea_,
                                              matAreaSqrt_,
                                              matVelocitySignal,
-                                             refineForegroundSearched_,
-                                             refineSegmentation_,
-                                             refineScore_,
-                                             refineEdgeDistance_,
-                                             layerIntegralArea_,
-                                             layerTestPassMap_,
-                                             debugRefineSegmentation_,
-                                             debugRefineScore_,
-                                             debugRefineScoreValue_,
-                                             debugRefineTestPassMap_,
+                                             arena_.refineForegroundSearched,
+                                             arena_.refineForegroundSearchedBounds,
+                                             arena_.floodFill,
+                                             arena_.refineSegmentation,
+                                             arena_.refineScore,
+                                             arena_.refineEdgeDistance,
+                                             arena_.layerIntegralArea,
+                                             arena_.layerTestPassMap,
+                                             arena_.debugRefineSegmentation,
+                                             arena_.debugRefineScore,
+                                             arena_.debugRefineScoreValue,
+                                             arena_.debugRefineTestPassMap,
                                              enabledTestPassMap,
                                              fullSizeWorldPoints,
                                              worldPoints_,
@@ -319,7 +275,8 @@ namespace astra { namespace hand {
 
     void hand_tracker::debug_probe_point(tracking_matrices& matrices)
     {
-        if (!debugimagestream_->use_mouse_probe())
+        //reads the debug layers, which only exist while a debug client is connected
+        if (!debugimagestream_->use_mouse_probe() || !arena_.debugLayersEnabled)
         {
             return;
         }
@@ -329,8 +286,8 @@ namespace astra { namespace hand {
         BitmapF& matDepth = matrices.depth;
 
         float depth = matDepth.at(probePosition);
-        float score = debugCreateScoreValue_.at(probePosition);
-        float edgeDist = layerEdgeDistance_.at(probePosition);
+        float score = arena_.debugCreateScoreValue.at(probePosition);
+        float edgeDist = arena_.layerEdgeDistance.at(probePosition);
 
         auto segmentationSettings = settings_.pointProcessorSettings.segmentationSettings;
 
@@ -618,13 +575,13 @@ namespace astra { namespace hand {
                                                   colorFrame);
             break;
         case DEBUG_HAND_VIEW_UPDATE_SEGMENTATION:
-            debugVisualizer_.show_norm_array<MaskType>(debugUpdateSegmentation_,
-                                                       debugUpdateSegmentation_,
+            debugVisualizer_.show_norm_array<MaskType>(arena_.debugUpdateSegmentation,
+                                                       arena_.debugUpdateSegmentation,
                                                        colorFrame);
             break;
         case DEBUG_HAND_VIEW_CREATE_SEGMENTATION:
-            debugVisualizer_.show_norm_array<MaskType>(debugCreateSegmentation_,
-                                                       debugCreateSegmentation_,
+            debugVisualizer_.show_norm_array<MaskType>(arena_.debugCreateSegmentation,
+                                                       arena_.debugCreateSegmentation,
                                                        colorFrame);
             break;
         case DEBUG_HAND_VIEW_UPDATE_SEARCHED:
@@ -633,22 +590,22 @@ namespace astra { namespace hand {
                                                colorFrame);
             break;
         case DEBUG_HAND_VIEW_CREATE_SCORE:
-            debugVisualizer_.show_norm_array<float>(debugCreateScore_,
-                                                    debugCreateSegmentation_,
+            debugVisualizer_.show_norm_array<float>(arena_.debugCreateScore,
+                                                    arena_.debugCreateSegmentation,
                                                     colorFrame);
             break;
         case DEBUG_HAND_VIEW_UPDATE_SCORE:
-            debugVisualizer_.show_norm_array<float>(debugUpdateScore_,
-                                                    debugUpdateSegmentation_,
+            debugVisualizer_.show_norm_array<float>(arena_.debugUpdateScore,
+                                                    arena_.debugUpdateSegmentation,
                                                     colorFrame);
             break;
         case DEBUG_HAND_VIEW_HANDWINDOW:
-            debugVisualizer_.show_depth_matrix(matDepthWindow_,
+            debugVisualizer_.show_depth_matrix(arena_.depthWindow,
                                                colorFrame);
             break;
         case DEBUG_HAND_VIEW_TEST_PASS_MAP:
-            debugVisualizer_.show_norm_array<MaskType>(debugCreateTestPassMap_,
-                                                       debugCreateTestPassMap_,
+            debugVisualizer_.show_norm_array<MaskType>(arena_.debugCreateTestPassMap,
+                                                       arena_.debugCreateTestPassMap,
                                                        colorFrame);
             break;
         }
@@ -662,13 +619,13 @@ namespace astra { namespace hand {
         {
             if (view == DEBUG_HAND_VIEW_CREATE_SEARCHED)
             {
-                debugVisualizer_.overlay_mask(createForegroundSearched_, colorFrame, searchedColor, pixel_type::searched);
-                debugVisualizer_.overlay_mask(createForegroundSearched_, colorFrame, searchedColor2, pixel_type::searched_from_out_of_range);
+                debugVisualizer_.overlay_mask(arena_.createForegroundSearched, colorFrame, searchedColor, pixel_type::searched);
+                debugVisualizer_.overlay_mask(arena_.createForegroundSearched, colorFrame, searchedColor2, pixel_type::searched_from_out_of_range);
             }
             else if (view == DEBUG_HAND_VIEW_UPDATE_SEARCHED)
             {
-                debugVisualizer_.overlay_mask(updateForegroundSearched_, colorFrame, searchedColor, pixel_type::searched);
-                debugVisualizer_.overlay_mask(updateForegroundSearched_, colorFrame, searchedColor2, pixel_type::searched_from_out_of_range);
+                debugVisualizer_.overlay_mask(arena_.updateForegroundSearched, colorFrame, searchedColor, pixel_type::searched);
+                debugVisualizer_.overlay_mask(arena_.updateForegroundSearched, colorFrame, searchedColor2, pixel_type::searched_from_out_of_range);
             }
 
             debugVisualizer_.overlay_mask(matVelocitySignal_, colorFrame, foregroundColor, pixel_type::foreground);
@@ -29,6 +29,7 @@
 #include "hnd_debug_handstream.hpp"
 #include "hnd_debug_visualizer.hpp"
 #include "hnd_settings.hpp"
+#include "hnd_scratch_arena.hpp"
 #include <memory>
 #include "hnd_bitmap.hpp"
 
@@ -90,40 +91,20 @@ namespace astra { namespace hand {
 
         BitmapF matDepth_;
         BitmapF matDepthFullSize_;
-        BitmapF matDepthWindow_;
         BitmapMask matVelocitySignal_;
         BitmapF matArea_;
         BitmapF matAreaSqrt_;
-        BitmapF layerIntegralArea_;
-        BitmapMask debugUpdateSegmentation_;
-        BitmapMask debugCreateSegmentation_;
-        BitmapMask debugRefineSegmentation_;
-        BitmapMask updateForegroundSearched_;
-        BitmapMask createForegroundSearched_;
-        BitmapF debugUpdateScore_;
-        BitmapF debugCreateScore_;
-        BitmapF debugRefineScore_;
-        BitmapF debugUpdateScoreValue_;
-        BitmapF debugCreateScoreValue_;
-        BitmapF debugRefineScoreValue_;
-        BitmapMask debugCreateTestPassMap_;
-        BitmapMask debugUpdateTestPassMap_;
-        BitmapMask debugRefineTestPassMap_;
-
-        BitmapMask layerSegmentation_;
-        BitmapF layerScore_;
-        BitmapF layerEdgeDistance_;
-        BitmapMask layerTestPassMap_;
-
-        BitmapMask refineForegroundSearched_;
-        BitmapMask refineSegmentation_;
-        BitmapF refineScore_;
-        BitmapF refineEdgeDistance_;
+
+        //layers reused across frames
+        scratch_arena arena_;
 
         astra::Vector3f* worldPoints_{nullptr};
         int numWorldPoints_{0};
 
         debug_visualizer debugVisualizer_;
+
+        //reset first in the destructor, on_frame_ready may be running on a worker thread
+        std::unique_ptr<plugins::dataflow_node> dataflowNode_;
     };
 
 }}
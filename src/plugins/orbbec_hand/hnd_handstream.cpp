@@ -54,7 +54,8 @@ namespace astra { namespace hand {
                                                               &parameterData);
         if (rc == ASTRA_STATUS_SUCCESS)
         {
-            memcpy(parameterData, &includeCandidatePoints_, resultByteLength);
+            bool includeCandidatePoints = includeCandidatePoints_;
+            memcpy(parameterData, &includeCandidatePoints, resultByteLength);
         }
     }
 
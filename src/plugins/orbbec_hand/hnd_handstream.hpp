@@ -19,9 +19,11 @@
 
 #include <astra_core/plugins/SingleBinStream.hpp>
 #include <astra/capi/streams/hand_types.h>
+#include <astra/capi/streams/hand_parameters.h>
 #include <astra/capi/astra_ctypes.h>
 #include <astra/capi/streams/stream_types.h>
 #include <Shiny.h>
+#include <atomic>
 
 namespace astra { namespace hand {
 
@@ -36,7 +38,10 @@ namespace astra { namespace hand {
                                 StreamDescription(ASTRA_STREAM_HAND,
                                                   DEFAULT_SUBTYPE),
                                 sizeof(astra_handpoint_t) * maxHandCount)
-        { }
+        {
+            //only changed through set_parameter, which invalidates it
+            set_parameter_cacheable(ASTRA_PARAMETER_HAND_INCLUDE_CANDIDATE_POINTS);
+        }
 
         bool include_candidate_points() const { return includeCandidatePoints_; }
         void set_include_candidate_points(bool includeCandidatePoints)
@@ -67,7 +72,8 @@ namespace astra { namespace hand {
 #endif
         }
 
-        bool includeCandidatePoints_{false};
+        //read by the tracker on a dataflow worker thread
+        std::atomic<bool> includeCandidatePoints_{false};
     };
 
 }}
@@ -18,6 +18,13 @@
 #define HND_MORPHOLOGY_HPP
 
 #include "hnd_bitmap.hpp"
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#endif
 
 namespace astra { namespace hand {
 
@@ -64,164 +71,374 @@ namespace astra { namespace hand {
         return element;
     }
 
-    //TODO look at mallocs
+    // Buffers reused across erode and dilate calls so that repeated
+    // morphology on the same size bitmaps does not allocate.
     template<typename T>
-    void erode(const Bitmap<T>& input, Bitmap<T>& output, const BitmapMask& element)
+    struct morphology_scratch
     {
-        Bitmap<T> temp;
-        const Bitmap<T>* source = &input;
-        if (input == output)
+        //copy of the input when it is also the output
+        std::vector<T> source;
+        //first pass of the separable filters
+        std::vector<T> lines;
+        //van Herk/Gil-Werman block prefix and suffix extremes
+        std::vector<T> forward;
+        std::vector<T> backward;
+        std::vector<T> paddedRow;
+        std::vector<T> identityRow;
+    };
+
+    namespace morphology_detail {
+
+        template<typename T>
+        struct min_op
         {
-            //input and output are the same. Create a temporary bitmap for the source data
-            temp = input.clone();
-            source = &temp;
-        } else {
-            //enforce allocation and same size as the input
-            output.recreate(input.size());
-        }
+            static T identity() { return std::numeric_limits<T>::max(); }
+            //value used by the generic path before any tap, matches the original erode
+            static T initial() { return std::numeric_limits<T>::max(); }
+            static T apply(T accumulated, T value) { return value < accumulated ? value : accumulated; }
+        };
 
-        //Use source instead of input from here down
+        template<typename T>
+        struct max_op
+        {
+            static T identity() { return std::numeric_limits<T>::lowest(); }
+            static T initial() { return std::numeric_limits<T>::min(); }
+            static T apply(T accumulated, T value) { return value > accumulated ? value : accumulated; }
+        };
 
-        const int width = source->width();
-        const int height = source->height();
-        const int elementWidth = element.width();
-        const int elementHeight = element.height();
-        const int halfElementHeight = elementHeight >> 1;
-        const int halfElementWidth = elementWidth >> 1;
+        template<typename TOp, typename T>
+        inline void apply_rows(const T* accumulated, const T* values, T* output, int count)
+        {
+            for (int i = 0; i < count; ++i)
+            {
+                output[i] = TOp::apply(accumulated[i], values[i]);
+            }
+        }
 
-        const T borderValue = std::numeric_limits<T>::max();
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        //minps and maxps return their second operand when the compare fails,
+        //the same as the scalar apply
+        template<>
+        inline void apply_rows<min_op<float>, float>(const float* accumulated,
+                                                     const float* values,
+                                                     float* output,
+                                                     int count)
+        {
+            int i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                _mm_storeu_ps(output + i, _mm_min_ps(_mm_loadu_ps(values + i), _mm_loadu_ps(accumulated + i)));
+            }
+            for (; i < count; ++i)
+            {
+                output[i] = min_op<float>::apply(accumulated[i], values[i]);
+            }
+        }
 
-        const T* const sourceData = source->data();
-        T* outputData = output.data();
-        const MaskType* elementData = element.data();
+        template<>
+        inline void apply_rows<max_op<float>, float>(const float* accumulated,
+                                                     const float* values,
+                                                     float* output,
+                                                     int count)
+        {
+            int i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                _mm_storeu_ps(output + i, _mm_max_ps(_mm_loadu_ps(values + i), _mm_loadu_ps(accumulated + i)));
+            }
+            for (; i < count; ++i)
+            {
+                output[i] = max_op<float>::apply(accumulated[i], values[i]);
+            }
+        }
+#endif
 
-        const T** rows = new const T*[elementHeight];
+        enum class element_kind
+        {
+            rect,
+            cross,
+            other
+        };
 
-        for (int y = 0; y < height; ++y)
+        inline element_kind classify_element(const BitmapMask& element)
         {
-            for (int i = 0; i < elementHeight; ++i)
+            const int width = element.width();
+            const int height = element.height();
+            const int centerX = width >> 1;
+            const int centerY = height >> 1;
+            const MaskType* data = element.data();
+
+            bool isRect = true;
+            bool isCross = true;
+            for (int y = 0; y < height; ++y)
             {
-                int rowY = y + i - halfElementHeight;
-                rows[i] = &sourceData[rowY * width];
+                for (int x = 0; x < width; ++x, ++data)
+                {
+                    const bool set = *data != 0;
+                    isRect = isRect && set;
+                    isCross = isCross && (set == (x == centerX || y == centerY));
+                }
             }
 
-            for (int x = 0; x < width; ++x)
+            if (isRect)
             {
-                //apply kernel:
-                T minValue = borderValue;
-                for (int elemY = 0; elemY < elementHeight; ++elemY)
+                return element_kind::rect;
+            }
+            return isCross ? element_kind::cross : element_kind::other;
+        }
+
+        inline int round_up(int value, int multiple)
+        {
+            return (value + multiple - 1) / multiple * multiple;
+        }
+
+        // Extreme over [x - before, x - before + size) of every row, taps
+        // outside the row are skipped. O(1) per pixel for any size.
+        template<typename TOp, typename T>
+        void horizontal_lines(const T* source,
+                              T* output,
+                              int width,
+                              int height,
+                              int size,
+                              int before,
+                              morphology_scratch<T>& scratch)
+        {
+            const int paddedWidth = round_up(width + size - 1, size);
+            scratch.paddedRow.resize(paddedWidth);
+            scratch.forward.resize(paddedWidth);
+            scratch.backward.resize(paddedWidth);
+
+            T* padded = scratch.paddedRow.data();
+            T* forward = scratch.forward.data();
+            T* backward = scratch.backward.data();
+
+            std::fill(padded, padded + paddedWidth, TOp::identity());
+
+            for (int y = 0; y < height; ++y, source += width, output += width)
+            {
+                std::copy(source, source + width, padded + before);
+
+                for (int blockStart = 0; blockStart < paddedWidth; blockStart += size)
                 {
-                    int currentY = y + elemY - halfElementHeight;
-                    const T* currentRow = rows[elemY];
-                    for (int elemX = 0; elemX < elementWidth; ++elemX)
+                    const int blockEnd = blockStart + size - 1;
+
+                    forward[blockStart] = padded[blockStart];
+                    for (int i = blockStart + 1; i <= blockEnd; ++i)
                     {
-                        int elementIndex = elemX + elemY * elementWidth;
-                        //Only check if the kernel element is non-zero
-                        if (elementData[elementIndex] != 0)
-                        {
-                            int currentX = x + elemX - halfElementWidth;
-                            if (currentX >= 0 && currentX < width &&
-                                currentY >= 0 && currentY < height)
-                            {
-                                //in range of input
-                                T currentValue = currentRow[currentX];
-                                //Erode is the MIN operation
-                                if (currentValue < minValue)
-                                {
-                                    minValue = currentValue;
-                                }
-                            }
-                            //If out of range, would use the borderValue.
-                            //For erode, the default value is borderValue, so no check required.
-                        }
+                        forward[i] = TOp::apply(forward[i - 1], padded[i]);
                     }
+
+                    backward[blockEnd] = padded[blockEnd];
+                    for (int i = blockEnd - 1; i >= blockStart; --i)
+                    {
+                        backward[i] = TOp::apply(backward[i + 1], padded[i]);
+                    }
+                }
+
+                //window [x, x + size) spans at most two blocks
+                for (int x = 0; x < width; ++x)
+                {
+                    output[x] = TOp::apply(backward[x], forward[x + size - 1]);
                 }
-                int outIndex = x + y * width;
-                outputData[outIndex] = minValue;
             }
         }
 
-        delete[] rows;
-    }
-
-        //TODO look at mallocs
-    template<typename T>
-    void dilate(const Bitmap<T>& input, Bitmap<T>& output, const BitmapMask& element)
-    {
-        Bitmap<T> temp;
-        const Bitmap<T>* source = &input;
-        if (input == output)
+        // Extreme over rows [y - before, y - before + size) of every column,
+        // whole rows at a time so the work is vectorized across the columns.
+        // Combines into output with TOp::initial() like the generic path.
+        template<typename TOp, typename T>
+        void vertical_lines(const T* source,
+                            T* output,
+                            int width,
+                            int height,
+                            int size,
+                            int before,
+                            morphology_scratch<T>& scratch)
         {
-            //input and output are the same. Create a temporary bitmap for the source data
-            temp = input.clone();
-            source = &temp;
-        } else {
-            //enforce allocation and same size as the input
-            output.recreate(input.size());
-        }
+            const int paddedHeight = round_up(height + size - 1, size);
+            scratch.forward.resize(paddedHeight * width);
+            scratch.backward.resize(paddedHeight * width);
+            scratch.identityRow.assign(width, TOp::identity());
 
-        //Use source instead of input from here down
+            T* forward = scratch.forward.data();
+            T* backward = scratch.backward.data();
+            const T* identityRow = scratch.identityRow.data();
 
-        const int width = source->width();
-        const int height = source->height();
-        const int elementWidth = element.width();
-        const int elementHeight = element.height();
-        const int halfElementHeight = elementHeight >> 1;
-        const int halfElementWidth = elementWidth >> 1;
+            auto paddedRow = [&](int paddedY) -> const T*
+            {
+                const int y = paddedY - before;
+                return y >= 0 && y < height ? source + y * width : identityRow;
+            };
 
-        const T borderValue = std::numeric_limits<T>::min();
+            for (int blockStart = 0; blockStart < paddedHeight; blockStart += size)
+            {
+                const int blockEnd = blockStart + size - 1;
 
-        const T* const sourceData = source->data();
-        T* outputData = output.data();
-        const MaskType* elementData = element.data();
+                std::copy(paddedRow(blockStart), paddedRow(blockStart) + width, forward + blockStart * width);
+                for (int i = blockStart + 1; i <= blockEnd; ++i)
+                {
+                    apply_rows<TOp>(forward + (i - 1) * width, paddedRow(i), forward + i * width, width);
+                }
 
-        const T** rows = new const T*[elementHeight];
+                std::copy(paddedRow(blockEnd), paddedRow(blockEnd) + width, backward + blockEnd * width);
+                for (int i = blockEnd - 1; i >= blockStart; --i)
+                {
+                    apply_rows<TOp>(backward + (i + 1) * width, paddedRow(i), backward + i * width, width);
+                }
+            }
 
-        for (int y = 0; y < height; ++y)
-        {
-            for (int i = 0; i < elementHeight; ++i)
+            //source may be output, every read of it is done
+            scratch.identityRow.assign(width, TOp::initial());
+            for (int y = 0; y < height; ++y)
             {
-                int rowY = y + i - halfElementHeight;
-                rows[i] = &sourceData[rowY * width];
+                T* outputRow = output + y * width;
+                apply_rows<TOp>(backward + y * width, forward + (y + size - 1) * width, outputRow, width);
+                apply_rows<TOp>(identityRow, outputRow, outputRow, width);
             }
+        }
 
-            for (int x = 0; x < width; ++x)
+        template<typename TOp, typename T>
+        void apply_element_generic(const T* sourceData,
+                                   T* outputData,
+                                   int width,
+                                   int height,
+                                   const BitmapMask& element)
+        {
+            const int elementWidth = element.width();
+            const int elementHeight = element.height();
+            const int halfElementHeight = elementHeight >> 1;
+            const int halfElementWidth = elementWidth >> 1;
+
+            const MaskType* elementData = element.data();
+
+            for (int y = 0; y < height; ++y)
             {
-                //apply kernel:
-                T maxValue = borderValue;
-                for (int elemY = 0; elemY < elementHeight; ++elemY)
+                for (int x = 0; x < width; ++x)
                 {
-                    int currentY = y + elemY - halfElementHeight;
-                    const T* currentRow = rows[elemY];
-                    for (int elemX = 0; elemX < elementWidth; ++elemX)
+                    //apply kernel:
+                    T value = TOp::initial();
+                    for (int elemY = 0; elemY < elementHeight; ++elemY)
                     {
-                        int elementIndex = elemX + elemY * elementWidth;
-                        //Only check if the kernel element is non-zero
-                        if (elementData[elementIndex] != 0)
+                        int currentY = y + elemY - halfElementHeight;
+                        if (currentY < 0 || currentY >= height)
                         {
-                            int currentX = x + elemX - halfElementWidth;
-                            if (currentX >= 0 && currentX < width &&
-                                currentY >= 0 && currentY < height)
+                            //out of range taps keep the initial value
+                            continue;
+                        }
+
+                        const T* currentRow = sourceData + currentY * width;
+                        for (int elemX = 0; elemX < elementWidth; ++elemX)
+                        {
+                            int elementIndex = elemX + elemY * elementWidth;
+                            //Only check if the kernel element is non-zero
+                            if (elementData[elementIndex] != 0)
                             {
-                                //in range of input
-                                T currentValue = currentRow[currentX];
-                                //Dilate is the MAX operation
-                                if (currentValue > maxValue)
+                                int currentX = x + elemX - halfElementWidth;
+                                if (currentX >= 0 && currentX < width)
                                 {
-                                    maxValue = currentValue;
+                                    value = TOp::apply(value, currentRow[currentX]);
                                 }
                             }
-                            //If out of range, would use the borderValue.
-                            //For dilate, the default value is borderValue, so no check required.
                         }
                     }
+                    outputData[x + y * width] = value;
                 }
-                int outIndex = x + y * width;
-                outputData[outIndex] = maxValue;
             }
         }
 
-        delete[] rows;
+        template<typename TOp, typename T>
+        void apply_element(const Bitmap<T>& input,
+                           Bitmap<T>& output,
+                           const BitmapMask& element,
+                           morphology_scratch<T>& scratch)
+        {
+            const element_kind kind = classify_element(element);
+            const T* sourceData = input.data();
+            if (input == output)
+            {
+                //the line passes read every pixel before writing, the generic one does not
+                if (kind == element_kind::other)
+                {
+                    scratch.source.assign(sourceData, sourceData + input.length());
+                    sourceData = scratch.source.data();
+                }
+            }
+            else
+            {
+                //enforce allocation and same size as the input
+                output.recreate(input.size());
+            }
+
+            const int width = input.width();
+            const int height = input.height();
+            const int elementWidth = element.width();
+            const int elementHeight = element.height();
+            T* outputData = output.data();
+
+            if (width == 0 || height == 0)
+            {
+                return;
+            }
+
+            switch (kind)
+            {
+            case element_kind::rect:
+                //separable: rows, then columns of the row result
+                scratch.lines.resize(input.length());
+                horizontal_lines<TOp>(sourceData, scratch.lines.data(), width, height,
+                                      elementWidth, elementWidth >> 1, scratch);
+                vertical_lines<TOp>(scratch.lines.data(), outputData, width, height,
+                                    elementHeight, elementHeight >> 1, scratch);
+                break;
+            case element_kind::cross:
+                //union of the center row and the center column
+                scratch.lines.resize(input.length());
+                horizontal_lines<TOp>(sourceData, scratch.lines.data(), width, height,
+                                      elementWidth, elementWidth >> 1, scratch);
+                vertical_lines<TOp>(sourceData, outputData, width, height,
+                                    elementHeight, elementHeight >> 1, scratch);
+                apply_rows<TOp>(outputData, scratch.lines.data(), outputData, input.length());
+                break;
+            default:
+                apply_element_generic<TOp>(sourceData, outputData, width, height, element);
+                break;
+            }
+        }
+    }
+
+    // Erode is the MIN over the element, taps outside the bitmap are skipped.
+    // Rect and cross elements cost O(1) per pixel whatever their size.
+    template<typename T>
+    void erode(const Bitmap<T>& input,
+               Bitmap<T>& output,
+               const BitmapMask& element,
+               morphology_scratch<T>& scratch)
+    {
+        morphology_detail::apply_element<morphology_detail::min_op<T>>(input, output, element, scratch);
+    }
+
+    template<typename T>
+    void erode(const Bitmap<T>& input, Bitmap<T>& output, const BitmapMask& element)
+    {
+        morphology_scratch<T> scratch;
+        erode(input, output, element, scratch);
+    }
+
+    // Dilate is the MAX over the element, taps outside the bitmap are skipped.
+    template<typename T>
+    void dilate(const Bitmap<T>& input,
+                Bitmap<T>& output,
+                const BitmapMask& element,
+                morphology_scratch<T>& scratch)
+    {
+        morphology_detail::apply_element<morphology_detail::max_op<T>>(input, output, element, scratch);
+    }
+
+    template<typename T>
+    void dilate(const Bitmap<T>& input, Bitmap<T>& output, const BitmapMask& element)
+    {
+        morphology_scratch<T> scratch;
+        dilate(input, output, element, scratch);
     }
 }}
 
@@ -25,6 +25,11 @@ namespace astra { namespace hand {
         settings_(settings)
     {
         PROFILE_FUNC();
+        if (settings_.trackingThreads > 1)
+        {
+            taskPool_ = std::unique_ptr<task_pool>(new task_pool(settings_.trackingThreads));
+            segmentationScratch_.resize(taskPool_->slot_count());
+        }
     }
 
     point_processor::~point_processor()
@@ -111,13 +116,33 @@ namespace astra { namespace hand {
         PROFILE_FUNC();
         auto scalingMapper = get_scaling_mapper(matrices);
 
+        collect_points_to_update();
+
+        //debug layers accumulate across points in update order
+        if (taskPool_ != nullptr && !matrices.debugLayersEnabled && pointsToUpdate_.size() > 1)
+        {
+            update_points_in_parallel(matrices, scalingMapper);
+            return;
+        }
+
+        for (tracked_point* trackedPoint : pointsToUpdate_)
+        {
+            update_tracked_point(matrices, scalingMapper, *trackedPoint);
+        }
+    }
+
+    void point_processor::collect_points_to_update()
+    {
+        PROFILE_FUNC();
+        pointsToUpdate_.clear();
+
         //give priority updates to active points
         for (auto iter = trackedPoints_.begin(); iter != trackedPoints_.end(); ++iter)
         {
             tracked_point& trackedPoint = *iter;
             if (trackedPoint.pointType == tracked_point_type::active_point)
             {
-                update_tracked_point(matrices, scalingMapper, trackedPoint);
+                pointsToUpdate_.push_back(&trackedPoint);
             }
         }
 
@@ -127,7 +152,7 @@ namespace astra { namespace hand {
             tracked_point& trackedPoint = *iter;
             if (trackedPoint.pointType != tracked_point_type::active_point)
             {
-                update_tracked_point(matrices, scalingMapper, trackedPoint);
+                pointsToUpdate_.push_back(&trackedPoint);
             }
             ++numUpdatedPoints;
             if (numUpdatedPoints > settings_.maxhandpointUpdatesPerFrame)
@@ -137,6 +162,69 @@ namespace astra { namespace hand {
         }
     }
 
+    void point_processor::update_points_in_parallel(tracking_matrices& matrices,
+                                                    const scaling_coordinate_mapper& scalingMapper)
+    {
+        PROFILE_FUNC();
+        const Size2i size = matrices.depth.size();
+        const std::size_t pointCount = pointsToUpdate_.size();
+
+        if (searchedScratch_.size() < pointCount)
+        {
+            searchedScratch_.resize(pointCount);
+        }
+
+        for (std::size_t i = 0; i < pointCount; ++i)
+        {
+            searchedScratch_[i].prepare(size);
+        }
+
+        //each update only writes its own point, its slot's layers and its own
+        //searched layer, everything else in matrices is read only here
+        taskPool_->run(pointCount,
+            [this, &matrices, &scalingMapper] (std::size_t index, std::size_t slot)
+            {
+                segmentation_scratch& layers = segmentationScratch_[slot];
+                searched_scratch& searched = searchedScratch_[index];
+
+                tracking_matrices taskMatrices(matrices.depthFullSize,
+                                               matrices.depth,
+                                               matrices.area,
+                                               matrices.areaSqrt,
+                                               matrices.velocitySignal,
+                                               searched.foregroundSearched,
+                                               searched.foregroundSearchedBounds,
+                                               layers.floodFill,
+                                               layers.layerSegmentation,
+                                               layers.layerScore,
+                                               layers.layerEdgeDistance,
+                                               layers.layerIntegralArea,
+                                               layers.layerTestPassMap,
+                                               layers.debugSegmentation,
+                                               layers.debugScore,
+                                               layers.debugScoreValue,
+                                               layers.debugTestPassMap,
+                                               matrices.enableTestPassMap,
+                                               matrices.fullSizeWorldPoints,
+                                               matrices.worldPoints,
+                                               false,
+                                               matrices.fullSizeMapper,
+                                               matrices.depthToWorldData);
+
+                scaling_coordinate_mapper taskMapper = scalingMapper;
+                update_tracked_point(taskMatrices, taskMapper, *pointsToUpdate_[index]);
+            });
+
+        //later updates overwrite earlier ones, as they would serially
+        for (std::size_t i = 0; i < pointCount; ++i)
+        {
+            merge_dirty(searchedScratch_[i].foregroundSearched,
+                        searchedScratch_[i].foregroundSearchedBounds,
+                        matrices.foregroundSearched,
+                        matrices.foregroundSearchedBounds);
+        }
+    }
+
     void point_processor::update_tracked_point(tracking_matrices& matrices,
                                                scaling_coordinate_mapper& scalingMapper,
                                                tracked_point& trackedPoint)
@@ -21,6 +21,8 @@
 #include "hnd_scaling_coordinate_mapper.hpp"
 #include <astra_core/plugins/PluginLogging.hpp>
 #include "hnd_settings.hpp"
+#include "hnd_task_pool.hpp"
+#include <memory>
 #include <unordered_map>
 #include "hnd_trajectory_analyzer.hpp"
 
@@ -53,6 +55,9 @@ namespace astra { namespace hand {
     private:
         Vector3f smooth_world_positions(const Vector3f& oldWorldPosition, const Vector3f& newWorldPosition);
         void calculate_area(tracking_matrices& matrices, scaling_coordinate_mapper mapper);
+        void collect_points_to_update();
+        void update_points_in_parallel(tracking_matrices& matrices,
+                                       const scaling_coordinate_mapper& scalingMapper);
         void update_tracked_point(tracking_matrices& matrices,
                                   scaling_coordinate_mapper& scalingMapper,
                                   tracked_point& trackedPoint);
@@ -79,6 +84,14 @@ namespace astra { namespace hand {
         std::vector<tracked_point> trackedPoints_;
 
         std::unordered_map<int, trajectory_analyzer> trajectories_;
+
+        //null when trackingThreads is 1
+        std::unique_ptr<task_pool> taskPool_;
+        std::vector<tracked_point*> pointsToUpdate_;
+        //one per pool slot
+        std::vector<segmentation_scratch> segmentationScratch_;
+        //one per point update, merged in update order
+        std::vector<searched_scratch> searchedScratch_;
     };
 
 }}
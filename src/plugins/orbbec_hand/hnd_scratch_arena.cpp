@@ -0,0 +1,104 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#include "hnd_scratch_arena.hpp"
+#include <Shiny.h>
+
+namespace astra { namespace hand {
+
+    namespace {
+
+        template<typename T>
+        std::size_t reset_layer(Bitmap<T>& bitmap, Size2i size)
+        {
+            bitmap.recreate(size);
+            bitmap.fill(T());
+            return bitmap.byte_length();
+        }
+
+        template<typename T>
+        void release_layer(Bitmap<T>& bitmap)
+        {
+            bitmap.recreate(0, 0);
+        }
+    }
+
+    std::size_t scratch_arena::begin_frame(Size2i frameSize, bool enableDebugLayers)
+    {
+        PROFILE_FUNC();
+        std::size_t bytesCleared = 0;
+
+        if (frameSize != size)
+        {
+            size = frameSize;
+
+            bytesCleared += reset_layer(layerSegmentation, size);
+            bytesCleared += reset_layer(layerScore, size);
+            bytesCleared += reset_layer(layerEdgeDistance, size);
+            bytesCleared += reset_layer(layerIntegralArea, size);
+            bytesCleared += reset_layer(layerTestPassMap, size);
+            bytesCleared += reset_layer(refineSegmentation, size);
+            bytesCleared += reset_layer(refineScore, size);
+            bytesCleared += reset_layer(refineEdgeDistance, size);
+
+            bytesCleared += reset_layer(updateForegroundSearched, size);
+            bytesCleared += reset_layer(createForegroundSearched, size);
+            bytesCleared += reset_layer(refineForegroundSearched, size);
+            updateForegroundSearchedBounds.reset();
+            createForegroundSearchedBounds.reset();
+            refineForegroundSearchedBounds.reset();
+
+            bytesCleared += reset_layer(depthWindow, size);
+        }
+
+        //the seed search reads the create layer, the debug view the update layer
+        bytesCleared += clear_dirty(updateForegroundSearched, updateForegroundSearchedBounds);
+        bytesCleared += clear_dirty(createForegroundSearched, createForegroundSearchedBounds);
+        bytesCleared += clear_dirty(refineForegroundSearched, refineForegroundSearchedBounds);
+
+        debugLayersEnabled = enableDebugLayers;
+        if (!debugLayersEnabled)
+        {
+            release_layer(debugUpdateSegmentation);
+            release_layer(debugCreateSegmentation);
+            release_layer(debugUpdateScore);
+            release_layer(debugCreateScore);
+            release_layer(debugUpdateScoreValue);
+            release_layer(debugCreateScoreValue);
+            release_layer(debugUpdateTestPassMap);
+            release_layer(debugCreateTestPassMap);
+            return bytesCleared;
+        }
+
+        bytesCleared += reset_layer(debugUpdateSegmentation, size);
+        bytesCleared += reset_layer(debugCreateSegmentation, size);
+        bytesCleared += reset_layer(debugUpdateScore, size);
+        bytesCleared += reset_layer(debugCreateScore, size);
+        bytesCleared += reset_layer(debugUpdateScoreValue, size);
+        bytesCleared += reset_layer(debugCreateScoreValue, size);
+        bytesCleared += reset_layer(debugUpdateTestPassMap, size);
+        bytesCleared += reset_layer(debugCreateTestPassMap, size);
+
+        //the mouse probe and the depth window view read these between seeds,
+        //keep them blank as they were when every layer was cleared per frame
+        bytesCleared += reset_layer(layerSegmentation, size);
+        bytesCleared += reset_layer(layerScore, size);
+        bytesCleared += reset_layer(layerEdgeDistance, size);
+        bytesCleared += reset_layer(depthWindow, size);
+
+        return bytesCleared;
+    }
+}}
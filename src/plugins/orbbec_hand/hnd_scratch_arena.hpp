@@ -0,0 +1,218 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#ifndef HND_SCRATCH_ARENA_H
+#define HND_SCRATCH_ARENA_H
+
+#include "hnd_bitmap.hpp"
+#include "hnd_flood_fill.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+
+namespace astra { namespace hand {
+
+    //! Bounds of the pixels written to a layer since it was last cleared
+    struct dirty_rect
+    {
+        int left{0};
+        int top{0};
+        //exclusive
+        int right{0};
+        int bottom{0};
+
+        bool empty() const { return right <= left || bottom <= top; }
+
+        int area() const { return empty() ? 0 : (right - left) * (bottom - top); }
+
+        void add(int x, int y)
+        {
+            if (empty())
+            {
+                left = x;
+                top = y;
+                right = x + 1;
+                bottom = y + 1;
+                return;
+            }
+
+            left = std::min(left, x);
+            top = std::min(top, y);
+            right = std::max(right, x + 1);
+            bottom = std::max(bottom, y + 1);
+        }
+
+        void add(const dirty_rect& other)
+        {
+            if (other.empty())
+            {
+                return;
+            }
+
+            add(other.left, other.top);
+            add(other.right - 1, other.bottom - 1);
+        }
+
+        void reset()
+        {
+            left = top = right = bottom = 0;
+        }
+    };
+
+    //! Zeros the dirty part of a layer. Returns the number of bytes written.
+    template<typename T>
+    std::size_t clear_dirty(Bitmap<T>& bitmap, dirty_rect& dirty)
+    {
+        if (dirty.empty())
+        {
+            return 0;
+        }
+
+        const std::size_t bytes = dirty.area() * sizeof(T);
+        const int width = dirty.right - dirty.left;
+        for (int y = dirty.top; y < dirty.bottom; ++y)
+        {
+            std::fill_n(bitmap.data(y) + dirty.left, width, T());
+        }
+
+        dirty.reset();
+        return bytes;
+    }
+
+    //! Copies the nonzero pixels in source's dirty part over target, then
+    //! clears source. Merging in a fixed order gives the same target as
+    //! writing every source into it in that order.
+    template<typename T>
+    void merge_dirty(Bitmap<T>& source, dirty_rect& sourceDirty,
+                     Bitmap<T>& target, dirty_rect& targetDirty)
+    {
+        if (sourceDirty.empty())
+        {
+            return;
+        }
+
+        assert(source.size() == target.size());
+
+        for (int y = sourceDirty.top; y < sourceDirty.bottom; ++y)
+        {
+            const T* sourceRow = source.data(y);
+            T* targetRow = target.data(y);
+            for (int x = sourceDirty.left; x < sourceDirty.right; ++x)
+            {
+                if (sourceRow[x] != T())
+                {
+                    targetRow[x] = sourceRow[x];
+                }
+            }
+        }
+
+        targetDirty.add(sourceDirty);
+        clear_dirty(source, sourceDirty);
+    }
+
+    //! Per seed layers for one tracking thread. Segmentation sizes and clears
+    //! them itself, the debug layers are never written since debug layers
+    //! keep tracking serial.
+    struct segmentation_scratch
+    {
+        BitmapMask layerSegmentation;
+        BitmapF layerScore;
+        BitmapF layerEdgeDistance;
+        BitmapF layerIntegralArea;
+        BitmapMask layerTestPassMap;
+        flood_fill_scratch floodFill;
+
+        BitmapMask debugSegmentation;
+        BitmapF debugScore;
+        BitmapF debugScoreValue;
+        BitmapMask debugTestPassMap;
+    };
+
+    //! Searched layer for one tracked point update, merged into the frame's
+    //! searched layer once the update is done
+    struct searched_scratch
+    {
+        BitmapMask foregroundSearched;
+        dirty_rect foregroundSearchedBounds;
+
+        void prepare(Size2i size)
+        {
+            if (foregroundSearched.size() != size)
+            {
+                foregroundSearched.recreate(size);
+                foregroundSearched.fill(0);
+                foregroundSearchedBounds.reset();
+            }
+        }
+    };
+
+    //! Layers the hand tracker reuses every frame.
+    //!
+    //! Buffers are sized once per processing size. Per frame, only layers that
+    //! are read before being written are cleared, and the flood-filled
+    //! searched layers only over their dirty rectangles. Debug layers exist
+    //! only while debug layers are enabled.
+    struct scratch_arena
+    {
+        //! sizes the layers and clears what the coming frame reads.
+        //! returns the number of bytes cleared
+        std::size_t begin_frame(Size2i frameSize, bool enableDebugLayers);
+
+        Size2i size;
+        bool debugLayersEnabled{false};
+
+        //per seed layers, cleared by segmentation before each use
+        BitmapMask layerSegmentation;
+        BitmapF layerScore;
+        BitmapF layerEdgeDistance;
+        BitmapF layerIntegralArea;
+        BitmapMask layerTestPassMap;
+        BitmapMask refineSegmentation;
+        BitmapF refineScore;
+        BitmapF refineEdgeDistance;
+        //sized by the fills, shared by the update, create and refine phases
+        flood_fill_scratch floodFill;
+
+        //written by the segmentation flood fills
+        BitmapMask updateForegroundSearched;
+        BitmapMask createForegroundSearched;
+        BitmapMask refineForegroundSearched;
+        dirty_rect updateForegroundSearchedBounds;
+        dirty_rect createForegroundSearchedBounds;
+        dirty_rect refineForegroundSearchedBounds;
+
+        //overwritten for every refined point
+        BitmapF depthWindow;
+
+        //allocated only while debug layers are enabled
+        BitmapMask debugUpdateSegmentation;
+        BitmapMask debugCreateSegmentation;
+        BitmapF debugUpdateScore;
+        BitmapF debugCreateScore;
+        BitmapF debugUpdateScoreValue;
+        BitmapF debugCreateScoreValue;
+        BitmapMask debugUpdateTestPassMap;
+        BitmapMask debugCreateTestPassMap;
+
+        //refinement never writes debug layers, these stay empty
+        BitmapMask debugRefineSegmentation;
+        BitmapF debugRefineScore;
+        BitmapF debugRefineScoreValue;
+        BitmapMask debugRefineTestPassMap;
+    };
+}}
+
+#endif // HND_SCRATCH_ARENA_H
@@ -15,7 +15,7 @@
 //
 // Be excellent to each other.
 #include "hnd_tracking_data.hpp"
-#include <queue>
+#include "hnd_flood_fill.hpp"
 #include "hnd_scaling_coordinate_mapper.hpp"
 #include "hnd_morphology.hpp"
 #include <cmath>
@@ -29,71 +29,11 @@
 
 namespace astra { namespace hand { namespace segmentation {
 
-    struct point_ttl
-    {
-        int x;
-        int y;
-        float ttl;
-
-        point_ttl(int x, int y, float ttl) :
-            x(x),
-            y(y),
-            ttl(ttl)
-        { }
-    };
-
-    static void enqueue_neighbors(BitmapMask& matVisited,
-                                  std::queue<point_ttl>& pointQueue,
-                                  const point_ttl& pt)
-    {
-        PROFILE_FUNC();
-        const int& x = pt.x;
-        const int& y = pt.y;
-        const int width = matVisited.width();
-        const int height = matVisited.height();
-
-        if (x < 1 || x > width - 2 ||
-            y < 1 || y > height - 2)
-        {
-            return;
-        }
-
-        const float& ttlRef = pt.ttl;
-
-        auto& rightVisited = matVisited.at(x+1, y);
-        if (0 == rightVisited)
-        {
-            rightVisited = 1;
-            pointQueue.push(point_ttl(x+1, y, ttlRef));
-        }
-
-        auto& leftVisited = matVisited.at(x-1, y);
-        if (0 == leftVisited)
-        {
-            leftVisited = 1;
-            pointQueue.push(point_ttl(x-1, y, ttlRef));
-        }
-
-        auto& downVisited = matVisited.at(x, y+1);
-        if (0 == downVisited)
-        {
-            downVisited = 1;
-            pointQueue.push(point_ttl(x, y+1, ttlRef));
-        }
-
-        auto& upVisited = matVisited.at(x, y-1);
-        if (0 == upVisited)
-        {
-            upVisited = 1;
-            pointQueue.push(point_ttl(x, y-1, ttlRef));
-        }
-    }
-
     static Point2i find_nearest_in_range_pixel(tracking_data& data,
-                                               BitmapMask& matVisited)
+                                               flood_fill_scratch& fill)
     {
         PROFILE_FUNC();
-        assert(matVisited.size() == data.matrices.depth.size());
+        assert(fill.size() == data.matrices.depth.size());
         const float referenceAreaSqrt = data.referenceAreaSqrt;
         if (referenceAreaSqrt == 0)
         {
@@ -103,62 +43,59 @@ namespace astra { namespace hand { namespace segmentation {
         const float minDepth = data.referenceWorldPosition.z - data.settings.segmentationBandwidthDepthNear;
         const float maxDepth = data.referenceWorldPosition.z + data.settings.segmentationBandwidthDepthFar;
         const float maxSegmentationDist = data.settings.maxSegmentationDist;
-        BitmapF& depthMatrix = data.matrices.depth;
-        BitmapMask& searchedMatrix = data.matrices.foregroundSearched;
+        const int width = data.matrices.depth.width();
+        const float* depthData = data.matrices.depth.data();
+        MaskType* searchedData = data.matrices.foregroundSearched.data();
+        dirty_rect& searchedBounds = data.matrices.foregroundSearchedBounds;
 
-        std::queue<point_ttl> pointQueue;
+        fill.clear_queue();
+        fill.visit(data.seedPosition.x + data.seedPosition.y * width);
+        fill.push(data.seedPosition.x, data.seedPosition.y, maxSegmentationDist);
 
-        pointQueue.push(point_ttl(data.seedPosition.x,
-                                  data.seedPosition.y,
-                                  maxSegmentationDist));
+        Point2i nearestPoint = INVALID_POINT;
 
-        matVisited.at(data.seedPosition) = 1;
-
-        while (!pointQueue.empty())
+        flood_fill(fill, [&] (int x, int y, float& ttl)
         {
-            point_ttl pt = pointQueue.front();
-            pointQueue.pop();
-            const int& x = pt.x;
-            const int& y = pt.y;
-            float& ttlRef = pt.ttl;
-
-            if (ttlRef <= 0)
+            if (ttl <= 0)
             {
-                continue;
+                return fill_action::skip;
             }
 
-            searchedMatrix.at(x, y) =
-                pixel_type::searched_from_out_of_range;
+            const int index = x + y * width;
+            searchedData[index] = pixel_type::searched_from_out_of_range;
+            searchedBounds.add(x, y);
 
-            float depth = depthMatrix.at(x, y);
+            const float depth = depthData[index];
             bool pointInRange = depth != 0 && depth > minDepth && depth < maxDepth;
 
             if (pointInRange)
             {
-                return Point2i(x, y);
+                nearestPoint = Point2i(x, y);
+                return fill_action::stop;
             }
 
-            ttlRef -= referenceAreaSqrt;
+            ttl -= referenceAreaSqrt;
+            return fill_action::expand;
+        });
 
-            enqueue_neighbors(matVisited, pointQueue, pt);
-        }
-
-        return INVALID_POINT;
+        return nearestPoint;
     }
 
     static float segment_foreground_and_get_average_depth(tracking_data& data)
     {
         PROFILE_FUNC();
-        const float& maxSegmentationDist = data.settings.maxSegmentationDist;
-        const segmentation_velocity_policy& velocitySignalPolicy = data.velocityPolicy;
+        const float maxSegmentationDist = data.settings.maxSegmentationDist;
+        const bool resetTtlOnVelocity = data.velocityPolicy == VELOCITY_POLICY_RESET_TTL;
         const float seedDepth = data.matrices.depth.at(data.seedPosition);
         const float referenceAreaSqrt = data.referenceAreaSqrt;
         BitmapF& depthMatrix = data.matrices.depth;
-        BitmapMask& velocitySignalMatrix = data.matrices.velocitySignal;
-        BitmapMask& segmentationMatrix = data.matrices.layerSegmentation;
-        BitmapMask& searchedMatrix = data.matrices.foregroundSearched;
-
-        std::queue<point_ttl> pointQueue;
+        const int width = depthMatrix.width();
+        const float* depthData = depthMatrix.data();
+        const MaskType* velocitySignalData = data.matrices.velocitySignal.data();
+        MaskType* segmentationData = data.matrices.layerSegmentation.data();
+        MaskType* searchedData = data.matrices.foregroundSearched.data();
+        dirty_rect& searchedBounds = data.matrices.foregroundSearchedBounds;
+        flood_fill_scratch& fill = data.matrices.floodFill;
 
         double totalDepth = 0;
         int depthCount = 0;
@@ -170,15 +107,15 @@ namespace astra { namespace hand { namespace segmentation {
         const float minDepth = data.referenceWorldPosition.z - bandwidthDepth;
         const float maxDepth = data.referenceWorldPosition.z + data.settings.segmentationBandwidthDepthFar;
 
-        BitmapMask matVisited(depthMatrix.size());
-        matVisited.fill(0);
+        //the nearest pixel search and the segmentation share visits
+        fill.begin_fill(depthMatrix.size());
 
         Point2i seedPosition = data.seedPosition;
 
         bool seedInRange = seedDepth != 0 && seedDepth > minDepth && seedDepth < maxDepth;
         if (!seedInRange)
         {
-            seedPosition = find_nearest_in_range_pixel(data, matVisited);
+            seedPosition = find_nearest_in_range_pixel(data, fill);
             if (seedPosition == INVALID_POINT)
             {
                 //No in range pixels found, no foreground to set
@@ -186,52 +123,46 @@ namespace astra { namespace hand { namespace segmentation {
             }
         }
 
-        pointQueue.push(point_ttl(seedPosition.x,
-                                  seedPosition.y,
-                                  maxSegmentationDist));
+        fill.clear_queue();
+        fill.visit(seedPosition.x + seedPosition.y * width);
+        fill.push(seedPosition.x, seedPosition.y, maxSegmentationDist);
 
-        matVisited.at(seedPosition) = 1;
-
-        while (!pointQueue.empty())
+        flood_fill(fill, [&] (int x, int y, float& ttl)
         {
-            point_ttl pt = pointQueue.front();
-            pointQueue.pop();
-            const int& x = pt.x;
-            const int& y = pt.y;
-            float& ttlRef = pt.ttl;
-
-            if (velocitySignalPolicy == VELOCITY_POLICY_RESET_TTL &&
-                velocitySignalMatrix.at(x, y) == pixel_type::foreground)
+            const int index = x + y * width;
+
+            if (resetTtlOnVelocity &&
+                velocitySignalData[index] == pixel_type::foreground)
             {
-                ttlRef = maxSegmentationDist;
+                ttl = maxSegmentationDist;
             }
 
-            float depth = depthMatrix.at(x, y);
+            const float depth = depthData[index];
             bool pointOutOfRange = depth == 0 ||
                 depth < minDepth ||
                         depth > maxDepth;
 
-            if (ttlRef <= 0)
+            if (ttl <= 0)
             {
-                segmentationMatrix.at(x, y) = pixel_type::foreground_out_of_range_edge;
-                continue;
+                segmentationData[index] = pixel_type::foreground_out_of_range_edge;
+                return fill_action::skip;
             }
             else if (pointOutOfRange)
             {
-                segmentationMatrix.at(x, y) = pixel_type::foreground_natural_edge;
-                continue;
+                segmentationData[index] = pixel_type::foreground_natural_edge;
+                return fill_action::skip;
             }
 
             totalDepth += depth;
             ++depthCount;
 
-            searchedMatrix.at(x, y) = pixel_type::searched;
-            segmentationMatrix.at(x, y) = pixel_type::foreground;
+            searchedData[index] = pixel_type::searched;
+            searchedBounds.add(x, y);
+            segmentationData[index] = pixel_type::foreground;
 
-            ttlRef -= referenceAreaSqrt;
-
-            enqueue_neighbors(matVisited, pointQueue, pt);
-        }
+            ttl -= referenceAreaSqrt;
+            return fill_action::expand;
+        });
 
         if (depthCount > 0)
         {
@@ -969,6 +900,7 @@ namespace astra { namespace hand { namespace segmentation {
         PROFILE_FUNC();
         BitmapF eroded;
         BitmapMask crossElement = get_structuring_element(MorphShape::Cross, Size2i(3, 3));
+        morphology_scratch<float> scratch;
 
         edgeDistanceMatrix.recreate(segmentationMatrix.size());
         edgeDistanceMatrix.fill(0.f);
@@ -982,7 +914,7 @@ namespace astra { namespace hand { namespace segmentation {
         int dilateCount = 1;
         for (int i = 0; i < dilateCount; i++)
         {
-            dilate(eroded, eroded, crossElement);
+            dilate(eroded, eroded, crossElement, scratch);
         }
 
         int nonZeroCount = 0;
@@ -995,7 +927,7 @@ namespace astra { namespace hand { namespace segmentation {
         {
             PROFILE_BEGIN(edge_dist_loop);
             //erode makes the image smaller
-            erode(eroded, eroded, crossElement);
+            erode(eroded, eroded, crossElement, scratch);
             //accumulate the eroded image to the edgeDistance buffer
             scalar_add(areaSqrtMatrix, edgeDistanceMatrix, edgeDistanceMatrix, eroded);
 
@@ -106,6 +106,8 @@ namespace astra { namespace hand {
         float secondChanceMinDistance{ 100.0f };
         float mergePointDistance { 100.0f }; //mm
         int maxhandpointUpdatesPerFrame { 10 };
+        //threads that update tracked points, 1 updates them serially
+        int trackingThreads { 1 };
     };
 
     struct hand_settings
@@ -77,6 +77,7 @@ namespace astra { namespace hand {
         settings.secondChanceMinDistance = get_float_from_table(t, "pointprocessor.secondChanceMinDistance", settings.secondChanceMinDistance);
         settings.mergePointDistance = get_float_from_table(t, "pointprocessor.mergePointDistance", settings.mergePointDistance);
         settings.maxhandpointUpdatesPerFrame = get_int_from_table(t, "pointprocessor.maxhandpointUpdatesPerFrame", settings.maxhandpointUpdatesPerFrame);
+        settings.trackingThreads = get_int_from_table(t, "pointprocessor.trackingThreads", settings.trackingThreads);
 
         return settings;
     }
@@ -0,0 +1,135 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#include "hnd_task_pool.hpp"
+
+namespace astra { namespace hand {
+
+    task_pool::task_pool(std::size_t threadCount)
+    {
+        for (std::size_t slot = 1; slot < threadCount; ++slot)
+        {
+            workers_.emplace_back(&task_pool::worker_loop, this, slot);
+        }
+    }
+
+    task_pool::~task_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        workReady_.notify_all();
+
+        for (auto& worker : workers_)
+        {
+            worker.join();
+        }
+    }
+
+    void task_pool::run(std::size_t taskCount, const task& fn)
+    {
+        if (taskCount == 0)
+        {
+            return;
+        }
+
+        if (workers_.empty() || taskCount == 1)
+        {
+            for (std::size_t i = 0; i < taskCount; ++i)
+            {
+                fn(i, 0);
+            }
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            task_ = &fn;
+            taskCount_ = taskCount;
+            nextTask_ = 0;
+            remainingTasks_ = taskCount;
+            ++generation_;
+        }
+        workReady_.notify_all();
+
+        run_tasks(fn, taskCount, 0);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        workDone_.wait(lock, [this] { return remainingTasks_ == 0 && activeWorkers_ == 0; });
+
+        //a worker that wakes up late finds nothing to run instead of a dangling task
+        task_ = nullptr;
+        taskCount_ = 0;
+    }
+
+    void task_pool::worker_loop(std::size_t slot)
+    {
+        std::uint64_t seenGeneration = 0;
+
+        while (true)
+        {
+            const task* fn;
+            std::size_t taskCount;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                workReady_.wait(lock, [this, seenGeneration] { return stopping_ || generation_ != seenGeneration; });
+
+                if (stopping_)
+                {
+                    return;
+                }
+
+                seenGeneration = generation_;
+                fn = task_;
+                taskCount = taskCount_;
+                if (fn == nullptr)
+                {
+                    continue;
+                }
+                ++activeWorkers_;
+            }
+
+            run_tasks(*fn, taskCount, slot);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                --activeWorkers_;
+            }
+            workDone_.notify_all();
+        }
+    }
+
+    void task_pool::run_tasks(const task& fn, std::size_t taskCount, std::size_t slot)
+    {
+        while (true)
+        {
+            const std::size_t index = nextTask_++;
+            if (index >= taskCount)
+            {
+                return;
+            }
+
+            fn(index, slot);
+
+            if (--remainingTasks_ == 0)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                workDone_.notify_all();
+            }
+        }
+    }
+}}
@@ -0,0 +1,74 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#ifndef HND_TASK_POOL_H
+#define HND_TASK_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace astra { namespace hand {
+
+    //! Fixed set of threads that run a batch of indexed tasks. The thread
+    //! calling run() works on the batch too, so a pool of N threads starts
+    //! N - 1 workers.
+    class task_pool
+    {
+    public:
+        using task = std::function<void(std::size_t taskIndex, std::size_t slot)>;
+
+        explicit task_pool(std::size_t threadCount);
+        ~task_pool();
+
+        task_pool(const task_pool&) = delete;
+        task_pool& operator=(const task_pool&) = delete;
+
+        //! threads that run tasks, including the caller of run()
+        std::size_t slot_count() const { return workers_.size() + 1; }
+
+        //! runs fn for every index in [0, taskCount) and returns when all are
+        //! done. slot is below slot_count() and names the running thread, so
+        //! tasks can keep per-thread scratch. The caller is slot 0.
+        void run(std::size_t taskCount, const task& fn);
+
+    private:
+        void worker_loop(std::size_t slot);
+        void run_tasks(const task& fn, std::size_t taskCount, std::size_t slot);
+
+        std::vector<std::thread> workers_;
+
+        std::mutex mutex_;
+        std::condition_variable workReady_;
+        std::condition_variable workDone_;
+
+        const task* task_{nullptr};
+        std::size_t taskCount_{0};
+        std::uint64_t generation_{0};
+        std::size_t activeWorkers_{0};
+        bool stopping_{false};
+
+        std::atomic<std::size_t> nextTask_{0};
+        std::atomic<std::size_t> remainingTasks_{0};
+    };
+}}
+
+#endif // HND_TASK_POOL_H
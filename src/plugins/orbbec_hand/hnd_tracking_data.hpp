@@ -18,6 +18,7 @@
 #define HND_TRACKING_DATA_H
 
 #include "hnd_bitmap.hpp"
+#include "hnd_scratch_arena.hpp"
 #include "hnd_scaling_coordinate_mapper.hpp"
 #include "hnd_settings.hpp"
 #include <cstdint>
@@ -96,6 +97,8 @@ namespace astra { namespace hand {
         BitmapF& layerIntegralArea;
         BitmapMask& layerTestPassMap;
         BitmapMask& foregroundSearched;
+        dirty_rect& foregroundSearchedBounds;
+        flood_fill_scratch& floodFill;
         BitmapMask& debugSegmentation;
         BitmapF& debugScore;
         BitmapF& debugScoreValue;
@@ -115,6 +118,8 @@ namespace astra { namespace hand {
                           BitmapF& areaSqrt,
                           BitmapMask& velocitySignal,
                           BitmapMask& foregroundSearched,
+                          dirty_rect& foregroundSearchedBounds,
+                          flood_fill_scratch& floodFill,
                           BitmapMask& layerSegmentation,
                           BitmapF& layerScore,
                           BitmapF& layerEdgeDistance,
@@ -142,6 +147,8 @@ namespace astra { namespace hand {
             layerIntegralArea(layerIntegralArea),
             layerTestPassMap(layerTestPassMap),
             foregroundSearched(foregroundSearched),
+            foregroundSearchedBounds(foregroundSearchedBounds),
+            floodFill(floodFill),
             debugSegmentation(debugSegmentation),
             debugScore(debugScore),
             debugScoreValue(debugScoreValue),
@@ -0,0 +1,237 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "../hnd_depth_kernels.hpp"
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace astra::hand::depth_kernels;
+
+namespace {
+
+    velocity_params default_params()
+    {
+        velocity_params params;
+        params.alpha = 0.05f;
+        params.jumpThreshold = 0.1f;
+        params.depthAdjustmentFactor = 2.5f;
+        params.minDepth = 500.0f;
+        params.maxDepth = 4000.0f;
+        return params;
+    }
+
+    struct velocity_state
+    {
+        explicit velocity_state(size_t count)
+            : previous(count, 0.0f),
+              filled(count, 0.0f),
+              filledMask(count, 0),
+              average(count, 0.0f),
+              velocity(count, 0.0f),
+              signal(count, 0)
+        {}
+
+        void run(const kernel_set& kernels, const float* depth, const velocity_params& params)
+        {
+            kernels.velocity(depth,
+                             previous.data(),
+                             filled.data(),
+                             filledMask.data(),
+                             average.data(),
+                             velocity.data(),
+                             previous.size(),
+                             params);
+
+            kernels.threshold(velocity.data(), signal.data(), signal.size(), 0.005f);
+        }
+
+        std::vector<float> previous;
+        std::vector<float> filled;
+        std::vector<uint8_t> filledMask;
+        std::vector<float> average;
+        std::vector<float> velocity;
+        std::vector<uint8_t> signal;
+    };
+
+    //a moving ramp with holes, far-away jumps and out of range depths
+    std::vector<int16_t> make_depth_frame(std::mt19937& random, size_t count)
+    {
+        std::uniform_int_distribution<int> depthDistribution(300, 5000);
+        std::uniform_int_distribution<int> kindDistribution(0, 9);
+
+        std::vector<int16_t> depth(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const int kind = kindDistribution(random);
+            if (kind == 0)
+            {
+                depth[i] = 0;
+            }
+            else if (kind == 1)
+            {
+                depth[i] = 8000;
+            }
+            else
+            {
+                depth[i] = static_cast<int16_t>(depthDistribution(random));
+            }
+        }
+        return depth;
+    }
+
+    bool same_bits(const std::vector<float>& a, const std::vector<float>& b)
+    {
+        return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+    }
+}
+
+TEST_CASE("Scalar kernels are always supported", "[depth_kernels]") {
+    auto kernels = supported_kernels();
+    REQUIRE(!kernels.empty());
+    REQUIRE(kernels.front() == &scalar_kernels());
+    REQUIRE(kernels.back() == &best_kernels());
+}
+
+TEST_CASE("Scalar velocity fills holes and restarts the average", "[depth_kernels]") {
+    const velocity_params params = default_params();
+    velocity_state state(1);
+
+    const float first = 1000.0f;
+    state.run(scalar_kernels(), &first, params);
+    REQUIRE(state.average[0] == first);
+    REQUIRE(state.filledMask[0] == 0);
+    REQUIRE(state.previous[0] == first);
+
+    //a hole keeps the previous depth and the velocity stays near zero
+    const float hole = 0.0f;
+    state.run(scalar_kernels(), &hole, params);
+    REQUIRE(state.filled[0] == first);
+    REQUIRE(state.filledMask[0] == 1);
+    REQUIRE(state.previous[0] == 0.0f);
+    REQUIRE(state.signal[0] == 0);
+
+    //moving closer is signal, depth outside the range is not
+    const float start = 2000.0f;
+    state.run(scalar_kernels(), &start, params);
+    const float closer = 1800.0f;
+    state.run(scalar_kernels(), &closer, params);
+    REQUIRE(state.velocity[0] > 0.005f);
+    REQUIRE(state.signal[0] == 1);
+
+    const float tooFar = 4500.0f;
+    state.run(scalar_kernels(), &tooFar, params);
+    REQUIRE(state.velocity[0] == 0.0f);
+    REQUIRE(state.signal[0] == 0);
+}
+
+TEST_CASE("Vector kernels match scalar kernels bit for bit", "[depth_kernels]") {
+    //odd sizes exercise the scalar tails
+    const size_t counts[] = { 1, 7, 13, 160 * 120, 160 * 120 + 5 };
+    const float adjustmentFactors[] = { 2.5f, 0.0f };
+
+    for (const kernel_set* kernels : supported_kernels())
+    {
+        for (size_t count : counts)
+        {
+            for (float adjustmentFactor : adjustmentFactors)
+            {
+                INFO(kernels->name << " count " << count << " adjustment " << adjustmentFactor);
+
+                velocity_params params = default_params();
+                params.depthAdjustmentFactor = adjustmentFactor;
+
+                std::mt19937 random(1234);
+                velocity_state reference(count);
+                velocity_state actual(count);
+
+                for (int frame = 0; frame < 5; ++frame)
+                {
+                    const std::vector<int16_t> rawDepth = make_depth_frame(random, count);
+
+                    std::vector<float> referenceDepth(count);
+                    std::vector<float> actualDepth(count);
+                    scalar_kernels().convert(rawDepth.data(), referenceDepth.data(), count);
+                    kernels->convert(rawDepth.data(), actualDepth.data(), count);
+                    REQUIRE(same_bits(referenceDepth, actualDepth));
+
+                    reference.run(scalar_kernels(), referenceDepth.data(), params);
+                    actual.run(*kernels, actualDepth.data(), params);
+
+                    REQUIRE(same_bits(reference.previous, actual.previous));
+                    REQUIRE(same_bits(reference.filled, actual.filled));
+                    REQUIRE(reference.filledMask == actual.filledMask);
+                    REQUIRE(same_bits(reference.average, actual.average));
+                    REQUIRE(same_bits(reference.velocity, actual.velocity));
+                    REQUIRE(reference.signal == actual.signal);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Convert handles negative depth", "[depth_kernels]") {
+    std::vector<int16_t> depth(19);
+    for (size_t i = 0; i < depth.size(); ++i)
+    {
+        depth[i] = static_cast<int16_t>(i % 2 == 0 ? -32768 + i : 32767 - i);
+    }
+
+    for (const kernel_set* kernels : supported_kernels())
+    {
+        INFO(kernels->name);
+        std::vector<float> converted(depth.size());
+        kernels->convert(depth.data(), converted.data(), depth.size());
+
+        for (size_t i = 0; i < depth.size(); ++i)
+        {
+            REQUIRE(converted[i] == static_cast<float>(depth[i]));
+        }
+    }
+}
+
+TEST_CASE("Depth to velocity throughput", "[.][depth_kernels][benchmark]") {
+    const size_t sizes[][2] = { { 160, 120 }, { 320, 240 }, { 640, 480 } };
+    const int iterations = 200;
+    const velocity_params params = default_params();
+    std::mt19937 random(42);
+
+    for (auto& size : sizes)
+    {
+        const size_t count = size[0] * size[1];
+        const std::vector<int16_t> rawDepth = make_depth_frame(random, count);
+        std::vector<float> depth(count);
+
+        for (const kernel_set* kernels : supported_kernels())
+        {
+            velocity_state state(count);
+
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < iterations; ++i)
+            {
+                kernels->convert(rawDepth.data(), depth.data(), count);
+                state.run(*kernels, depth.data(), params);
+            }
+            auto elapsed = std::chrono::steady_clock::now() - start;
+
+            double usPerFrame = std::chrono::duration<double, std::micro>(elapsed).count() / iterations;
+            WARN(size[0] << "x" << size[1] << " " << kernels->name << ": " << usPerFrame << " us per frame");
+        }
+    }
+}
@@ -0,0 +1,438 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#include "catch.hpp"
+#include "../hnd_flood_fill.hpp"
+#include "../hnd_bitmap.hpp"
+#include <chrono>
+#include <cstring>
+#include <queue>
+#include <random>
+
+using namespace astra::hand;
+
+namespace {
+
+    const MaskType FOREGROUND = 1;
+    const MaskType SEARCHED = 2;
+    const MaskType SEARCHED_FROM_OUT_OF_RANGE = 3;
+    const MaskType NATURAL_EDGE = 4;
+    const MaskType OUT_OF_RANGE_EDGE = 5;
+
+    struct fill_input
+    {
+        BitmapF depth;
+        BitmapMask velocity;
+        std::vector<Point2i> seeds;
+    };
+
+    struct fill_params
+    {
+        float referenceDepth;
+        float maxTtl;
+        float step;
+        bool resetTtl;
+    };
+
+    struct fill_output
+    {
+        BitmapMask segmentation;
+        BitmapMask searched;
+        double totalDepth{0};
+        int depthCount{0};
+    };
+
+    //hands at different depths in front of a wall with dropouts, seeds on
+    //every hand and beside each one so the nearest pixel search runs too
+    fill_input make_frame(std::mt19937& random, int hands)
+    {
+        const int width = 160;
+        const int height = 120;
+        std::uniform_real_distribution<float> unit(0.f, 1.f);
+
+        fill_input input;
+        input.depth.recreate(width, height);
+        input.velocity.recreate(width, height);
+        input.depth.fill(2500.f);
+        input.velocity.fill(0);
+
+        for (int h = 0; h < hands; ++h)
+        {
+            const int cx = 15 + static_cast<int>(unit(random) * (width - 30));
+            const int cy = 15 + static_cast<int>(unit(random) * (height - 30));
+            const float z = 700.f + 100.f * h;
+            const int radius = 6 + h;
+
+            for (int y = cy - 3 * radius; y <= cy + radius; ++y)
+            {
+                for (int x = cx - radius; x <= cx + radius; ++x)
+                {
+                    if (x < 0 || y < 0 || x >= width || y >= height)
+                    {
+                        continue;
+                    }
+
+                    const bool palm = (x - cx) * (x - cx) + (y - cy) * (y - cy) <= radius * radius;
+                    const bool finger = y < cy && (x - cx + radius) % 4 < 2;
+                    if (palm || finger)
+                    {
+                        input.depth.at(x, y) = z + unit(random) * 20.f;
+                        if (unit(random) < 0.3f)
+                        {
+                            input.velocity.at(x, y) = 1;
+                        }
+                    }
+                }
+            }
+
+            input.seeds.push_back(Point2i(cx, cy));
+            input.seeds.push_back(Point2i(std::min(width - 1, cx + radius + 3), cy));
+        }
+
+        for (int i = 0; i < width * height / 50; ++i)
+        {
+            input.depth.data()[static_cast<int>(unit(random) * (width * height - 1))] = 0.f;
+        }
+
+        return input;
+    }
+
+    //the queue based fills segmentation used before flood_fill
+    struct queued_point
+    {
+        int x;
+        int y;
+        float ttl;
+    };
+
+    void reference_enqueue_neighbors(BitmapMask& visited, std::queue<queued_point>& queue, const queued_point& pt)
+    {
+        const int width = visited.width();
+        const int height = visited.height();
+        if (pt.x < 1 || pt.x > width - 2 || pt.y < 1 || pt.y > height - 2)
+        {
+            return;
+        }
+
+        const Point2i neighbors[] = { Point2i(pt.x + 1, pt.y), Point2i(pt.x - 1, pt.y),
+                                      Point2i(pt.x, pt.y + 1), Point2i(pt.x, pt.y - 1) };
+        for (const Point2i& neighbor : neighbors)
+        {
+            auto& neighborVisited = visited.at(neighbor);
+            if (neighborVisited == 0)
+            {
+                neighborVisited = 1;
+                queue.push(queued_point{ neighbor.x, neighbor.y, pt.ttl });
+            }
+        }
+    }
+
+    void reference_fill(fill_input& input, const Point2i& seed, const fill_params& params, fill_output& output)
+    {
+        const float minDepth = params.referenceDepth - 500.f;
+        const float maxDepth = params.referenceDepth + 100.f;
+        auto in_range = [&] (float depth) { return depth != 0 && depth > minDepth && depth < maxDepth; };
+
+        BitmapF& depth = input.depth;
+        BitmapMask& velocity = input.velocity;
+        BitmapMask visited(depth.size());
+        visited.fill(0);
+
+        Point2i start = seed;
+        if (!in_range(depth.at(seed)))
+        {
+            start = Point2i(-1, -1);
+            std::queue<queued_point> queue;
+            queue.push(queued_point{ seed.x, seed.y, params.maxTtl });
+            visited.at(seed) = 1;
+
+            while (!queue.empty())
+            {
+                queued_point pt = queue.front();
+                queue.pop();
+                if (pt.ttl <= 0)
+                {
+                    continue;
+                }
+
+                output.searched.at(pt.x, pt.y) = SEARCHED_FROM_OUT_OF_RANGE;
+                if (in_range(depth.at(pt.x, pt.y)))
+                {
+                    start = Point2i(pt.x, pt.y);
+                    break;
+                }
+
+                pt.ttl -= params.step;
+                reference_enqueue_neighbors(visited, queue, pt);
+            }
+
+            if (start.x == -1)
+            {
+                return;
+            }
+        }
+
+        std::queue<queued_point> queue;
+        queue.push(queued_point{ start.x, start.y, params.maxTtl });
+        visited.at(start) = 1;
+
+        while (!queue.empty())
+        {
+            queued_point pt = queue.front();
+            queue.pop();
+
+            if (params.resetTtl && velocity.at(pt.x, pt.y) == FOREGROUND)
+            {
+                pt.ttl = params.maxTtl;
+            }
+
+            const float value = depth.at(pt.x, pt.y);
+            if (pt.ttl <= 0)
+            {
+                output.segmentation.at(pt.x, pt.y) = OUT_OF_RANGE_EDGE;
+                continue;
+            }
+            else if (!in_range(value))
+            {
+                output.segmentation.at(pt.x, pt.y) = NATURAL_EDGE;
+                continue;
+            }
+
+            output.totalDepth += value;
+            ++output.depthCount;
+            output.searched.at(pt.x, pt.y) = SEARCHED;
+            output.segmentation.at(pt.x, pt.y) = FOREGROUND;
+
+            pt.ttl -= params.step;
+            reference_enqueue_neighbors(visited, queue, pt);
+        }
+    }
+
+    //the same two fills as segmentation runs them on flood_fill
+    void scratch_fill(const fill_input& input, const Point2i& seed, const fill_params& params,
+                      flood_fill_scratch& fill, fill_output& output)
+    {
+        const float minDepth = params.referenceDepth - 500.f;
+        const float maxDepth = params.referenceDepth + 100.f;
+        auto in_range = [&] (float depth) { return depth != 0 && depth > minDepth && depth < maxDepth; };
+
+        const int width = input.depth.width();
+        const float* depthData = input.depth.data();
+        const MaskType* velocityData = input.velocity.data();
+        MaskType* segmentationData = output.segmentation.data();
+        MaskType* searchedData = output.searched.data();
+
+        fill.begin_fill(input.depth.size());
+
+        Point2i start = seed;
+        if (!in_range(depthData[seed.x + seed.y * width]))
+        {
+            start = Point2i(-1, -1);
+            fill.visit(seed.x + seed.y * width);
+            fill.push(seed.x, seed.y, params.maxTtl);
+
+            flood_fill(fill, [&] (int x, int y, float& ttl)
+            {
+                if (ttl <= 0)
+                {
+                    return fill_action::skip;
+                }
+
+                const int index = x + y * width;
+                searchedData[index] = SEARCHED_FROM_OUT_OF_RANGE;
+                if (in_range(depthData[index]))
+                {
+                    start = Point2i(x, y);
+                    return fill_action::stop;
+                }
+
+                ttl -= params.step;
+                return fill_action::expand;
+            });
+
+            if (start.x == -1)
+            {
+                return;
+            }
+        }
+
+        fill.clear_queue();
+        fill.visit(start.x + start.y * width);
+        fill.push(start.x, start.y, params.maxTtl);
+
+        flood_fill(fill, [&] (int x, int y, float& ttl)
+        {
+            const int index = x + y * width;
+            if (params.resetTtl && velocityData[index] == FOREGROUND)
+            {
+                ttl = params.maxTtl;
+            }
+
+            const float value = depthData[index];
+            if (ttl <= 0)
+            {
+                segmentationData[index] = OUT_OF_RANGE_EDGE;
+                return fill_action::skip;
+            }
+            else if (!in_range(value))
+            {
+                segmentationData[index] = NATURAL_EDGE;
+                return fill_action::skip;
+            }
+
+            output.totalDepth += value;
+            ++output.depthCount;
+            searchedData[index] = SEARCHED;
+            segmentationData[index] = FOREGROUND;
+
+            ttl -= params.step;
+            return fill_action::expand;
+        });
+    }
+
+    void reset_output(fill_output& output, Size2i size)
+    {
+        output.segmentation.recreate(size);
+        output.segmentation.fill(0);
+        output.searched.recreate(size);
+        output.searched.fill(0);
+        output.totalDepth = 0;
+        output.depthCount = 0;
+    }
+
+    bool same_mask(const BitmapMask& a, const BitmapMask& b)
+    {
+        return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.length()) == 0;
+    }
+}
+
+TEST_CASE("Flood fill scratch forgets visits between fills", "[flood_fill]") {
+    flood_fill_scratch fill;
+    fill.begin_fill(Size2i(4, 3));
+
+    REQUIRE(fill.visit(5));
+    REQUIRE_FALSE(fill.visit(5));
+    REQUIRE(fill.is_visited(5));
+
+    //clearing the queue keeps the visits of the current fill
+    fill.clear_queue();
+    REQUIRE(fill.is_visited(5));
+
+    fill.begin_fill(Size2i(4, 3));
+    REQUIRE_FALSE(fill.is_visited(5));
+
+    //stamps wrap without old visits coming back
+    fill.visit(7);
+    for (int i = 0; i < 70000; ++i)
+    {
+        fill.begin_fill(Size2i(4, 3));
+        REQUIRE_FALSE(fill.is_visited(7));
+    }
+}
+
+TEST_CASE("Flood fill queue stays first in first out across the ring end", "[flood_fill]") {
+    flood_fill_scratch fill;
+    fill.begin_fill(Size2i(3, 2));
+
+    int next = 0;
+    for (int round = 0; round < 10; ++round)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            fill.push(next + i, 0, 0.f);
+        }
+        for (int i = 0; i < 4; ++i)
+        {
+            REQUIRE(fill.pop().x == next + i);
+        }
+        next += 4;
+    }
+    REQUIRE(fill.empty());
+}
+
+TEST_CASE("Flood fill matches the queue fill it replaced", "[flood_fill]") {
+    std::mt19937 random(11);
+    flood_fill_scratch fill;
+    fill_output expected;
+    fill_output actual;
+
+    for (int hands = 1; hands <= 6; ++hands)
+    {
+        fill_input input = make_frame(random, hands);
+
+        for (const Point2i& seed : input.seeds)
+        {
+            for (bool resetTtl : { false, true })
+            {
+                const float referenceDepth = 700.f + 100.f * (seed.x % hands);
+                const fill_params params{ referenceDepth, 250.f, 7.f, resetTtl };
+
+                reset_output(expected, input.depth.size());
+                reset_output(actual, input.depth.size());
+
+                reference_fill(input, seed, params, expected);
+                scratch_fill(input, seed, params, fill, actual);
+
+                REQUIRE(same_mask(expected.segmentation, actual.segmentation));
+                REQUIRE(same_mask(expected.searched, actual.searched));
+                REQUIRE(expected.depthCount == actual.depthCount);
+                //same visiting order, so the same rounding
+                REQUIRE(expected.totalDepth == actual.totalDepth);
+            }
+        }
+    }
+}
+
+TEST_CASE("Flood fill throughput", "[.][flood_fill][benchmark]") {
+    std::mt19937 random(5);
+    flood_fill_scratch fill;
+    fill_output output;
+    const int iterations = 100;
+
+    for (int hands = 1; hands <= 6; ++hands)
+    {
+        fill_input input = make_frame(random, hands);
+        reset_output(output, input.depth.size());
+
+        auto run = [&] (bool useScratch)
+        {
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < iterations; ++i)
+            {
+                for (const Point2i& seed : input.seeds)
+                {
+                    const fill_params params{ 700.f + 100.f * (seed.x % hands), 250.f, 7.f, true };
+                    if (useScratch)
+                    {
+                        scratch_fill(input, seed, params, fill, output);
+                    }
+                    else
+                    {
+                        reference_fill(input, seed, params, output);
+                    }
+                }
+            }
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            return std::chrono::duration<double, std::micro>(elapsed).count() / iterations;
+        };
+
+        const double scratchUs = run(true);
+        const double referenceUs = run(false);
+
+        WARN(hands << " hands, " << input.seeds.size() << " seeds: " << scratchUs
+             << " us per frame, queue fill " << referenceUs << " us");
+    }
+}
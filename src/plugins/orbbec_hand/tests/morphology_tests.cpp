@@ -0,0 +1,191 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#include "catch.hpp"
+#include "../hnd_morphology.hpp"
+#include <chrono>
+#include <random>
+
+using namespace astra::hand;
+
+namespace {
+
+    //direct transcription of the definition, taps outside the bitmap are skipped
+    template<typename T, typename TOp>
+    BitmapF reference_morph(const BitmapF& input, const BitmapMask& element, T initial, TOp better)
+    {
+        const int width = input.width();
+        const int height = input.height();
+        const int elementWidth = element.width();
+        const int elementHeight = element.height();
+
+        BitmapF output(input.size());
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                T value = initial;
+                for (int elemY = 0; elemY < elementHeight; ++elemY)
+                {
+                    for (int elemX = 0; elemX < elementWidth; ++elemX)
+                    {
+                        const int currentX = x + elemX - (elementWidth >> 1);
+                        const int currentY = y + elemY - (elementHeight >> 1);
+                        if (element.data(elemY)[elemX] != 0 &&
+                            currentX >= 0 && currentX < width &&
+                            currentY >= 0 && currentY < height &&
+                            better(input.data(currentY)[currentX], value))
+                        {
+                            value = input.data(currentY)[currentX];
+                        }
+                    }
+                }
+                output.data(y)[x] = value;
+            }
+        }
+        return output;
+    }
+
+    BitmapF reference_erode(const BitmapF& input, const BitmapMask& element)
+    {
+        return reference_morph(input, element, std::numeric_limits<float>::max(),
+                               [] (float a, float b) { return a < b; });
+    }
+
+    BitmapF reference_dilate(const BitmapF& input, const BitmapMask& element)
+    {
+        return reference_morph(input, element, std::numeric_limits<float>::min(),
+                               [] (float a, float b) { return a > b; });
+    }
+
+    BitmapF random_bitmap(std::mt19937& random, int width, int height)
+    {
+        std::uniform_real_distribution<float> distribution(-10.0f, 10.0f);
+        BitmapF bitmap(width, height);
+        for (unsigned i = 0; i < bitmap.length(); ++i)
+        {
+            bitmap.data()[i] = distribution(random);
+        }
+        return bitmap;
+    }
+
+    bool same_values(const BitmapF& a, const BitmapF& b)
+    {
+        return a.size() == b.size() && std::equal(a.data(), a.data() + a.length(), b.data());
+    }
+
+    BitmapMask diagonal_element(int size)
+    {
+        BitmapMask element(size, size);
+        element.fill(0);
+        for (int i = 0; i < size; ++i)
+        {
+            element.data(i)[i] = 1;
+        }
+        return element;
+    }
+}
+
+TEST_CASE("Erode and dilate match the reference for every element shape", "[morphology]") {
+    std::mt19937 random(7);
+    const Size2i bitmapSizes[] = { Size2i(1, 1), Size2i(5, 3), Size2i(17, 11), Size2i(64, 48) };
+    const Size2i elementSizes[] = { Size2i(1, 1), Size2i(3, 3), Size2i(5, 3), Size2i(4, 4), Size2i(9, 9), Size2i(31, 1) };
+
+    morphology_scratch<float> scratch;
+
+    for (const Size2i& bitmapSize : bitmapSizes)
+    {
+        const BitmapF input = random_bitmap(random, bitmapSize.width(), bitmapSize.height());
+
+        for (const Size2i& elementSize : elementSizes)
+        {
+            const BitmapMask elements[] = {
+                get_structuring_element(MorphShape::Rect, elementSize),
+                get_structuring_element(MorphShape::Cross, elementSize),
+                diagonal_element(elementSize.width())
+            };
+
+            for (const BitmapMask& element : elements)
+            {
+                INFO("bitmap " << bitmapSize.width() << "x" << bitmapSize.height() <<
+                     " element " << element.width() << "x" << element.height());
+
+                BitmapF eroded;
+                erode(input, eroded, element, scratch);
+                REQUIRE(same_values(eroded, reference_erode(input, element)));
+
+                BitmapF dilated;
+                dilate(input, dilated, element, scratch);
+                REQUIRE(same_values(dilated, reference_dilate(input, element)));
+            }
+        }
+    }
+}
+
+TEST_CASE("Erode and dilate work in place", "[morphology]") {
+    std::mt19937 random(11);
+    const BitmapF input = random_bitmap(random, 33, 21);
+
+    const BitmapMask elements[] = {
+        get_structuring_element(MorphShape::Rect, Size2i(3, 5)),
+        get_structuring_element(MorphShape::Cross, Size2i(3, 3)),
+        diagonal_element(3)
+    };
+
+    for (const BitmapMask& element : elements)
+    {
+        BitmapF bitmap = input.clone();
+        erode(bitmap, bitmap, element);
+        REQUIRE(same_values(bitmap, reference_erode(input, element)));
+
+        bitmap = input.clone();
+        dilate(bitmap, bitmap, element);
+        REQUIRE(same_values(bitmap, reference_dilate(input, element)));
+    }
+}
+
+TEST_CASE("Erode throughput", "[.][morphology][benchmark]") {
+    std::mt19937 random(3);
+    const BitmapF input = random_bitmap(random, 160, 120);
+    const int sizes[] = { 3, 9, 21 };
+    const int iterations = 200;
+
+    morphology_scratch<float> scratch;
+    BitmapF output;
+
+    for (int size : sizes)
+    {
+        const BitmapMask element = get_structuring_element(MorphShape::Rect, Size2i(size, size));
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i)
+        {
+            erode(input, output, element, scratch);
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        double fastUs = std::chrono::duration<double, std::micro>(elapsed).count() / iterations;
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i)
+        {
+            output = reference_erode(input, element);
+        }
+        elapsed = std::chrono::steady_clock::now() - start;
+        double referenceUs = std::chrono::duration<double, std::micro>(elapsed).count() / iterations;
+
+        WARN("160x120 rect " << size << "x" << size << ": " << fastUs << " us, reference " << referenceUs << " us");
+    }
+}
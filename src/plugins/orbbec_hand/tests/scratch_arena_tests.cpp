@@ -0,0 +1,202 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#include "catch.hpp"
+#include "../hnd_scratch_arena.hpp"
+#include <chrono>
+
+using namespace astra::hand;
+
+namespace {
+
+    bool all_zero_mask(const BitmapMask& bitmap)
+    {
+        return std::all_of(bitmap.data(), bitmap.data() + bitmap.length(),
+                           [] (MaskType value) { return value == 0; });
+    }
+
+    //what track_points cleared every frame before the arena
+    std::size_t clear_every_layer(BitmapMask* masks, int maskCount, BitmapF* floats, int floatCount, Size2i size)
+    {
+        std::size_t bytes = 0;
+        for (int i = 0; i < maskCount; ++i)
+        {
+            masks[i].recreate(size);
+            masks[i].fill(0);
+            bytes += masks[i].byte_length();
+        }
+        for (int i = 0; i < floatCount; ++i)
+        {
+            floats[i].recreate(size);
+            floats[i].fill(0.f);
+            bytes += floats[i].byte_length();
+        }
+        return bytes;
+    }
+}
+
+TEST_CASE("Dirty rect grows to cover every added pixel", "[scratch_arena]") {
+    dirty_rect rect;
+    REQUIRE(rect.empty());
+    REQUIRE(rect.area() == 0);
+
+    rect.add(5, 7);
+    REQUIRE(rect.area() == 1);
+
+    rect.add(2, 9);
+    REQUIRE(rect.left == 2);
+    REQUIRE(rect.top == 7);
+    REQUIRE(rect.right == 6);
+    REQUIRE(rect.bottom == 10);
+
+    rect.reset();
+    REQUIRE(rect.empty());
+}
+
+TEST_CASE("Clear dirty zeros only the dirty rectangle", "[scratch_arena]") {
+    BitmapMask bitmap(8, 6);
+    bitmap.fill(0);
+
+    dirty_rect rect;
+    bitmap.at(2, 1) = 2;
+    rect.add(2, 1);
+    bitmap.at(4, 3) = 3;
+    rect.add(4, 3);
+
+    REQUIRE(clear_dirty(bitmap, rect) == 3 * 3);
+    REQUIRE(all_zero_mask(bitmap));
+    REQUIRE(rect.empty());
+    REQUIRE(clear_dirty(bitmap, rect) == 0);
+}
+
+TEST_CASE("Arena clears searched layers and releases debug layers", "[scratch_arena]") {
+    const Size2i size(160, 120);
+    scratch_arena arena;
+
+    arena.begin_frame(size, true);
+    REQUIRE(arena.debugCreateScore.size() == size);
+    REQUIRE(arena.createForegroundSearched.size() == size);
+
+    arena.createForegroundSearched.at(10, 20) = 2;
+    arena.createForegroundSearchedBounds.add(10, 20);
+    arena.updateForegroundSearched.at(30, 40) = 3;
+    arena.updateForegroundSearchedBounds.add(30, 40);
+
+    const std::size_t bytesCleared = arena.begin_frame(size, false);
+    REQUIRE(bytesCleared == 2);
+    REQUIRE(all_zero_mask(arena.createForegroundSearched));
+    REQUIRE(all_zero_mask(arena.updateForegroundSearched));
+    REQUIRE(!arena.debugLayersEnabled);
+    REQUIRE(arena.debugCreateScore.length() == 0);
+    REQUIRE(arena.debugUpdateSegmentation.length() == 0);
+    REQUIRE(arena.debugRefineScore.length() == 0);
+
+    //a new size starts clean
+    arena.createForegroundSearched.at(1, 1) = 2;
+    arena.begin_frame(Size2i(80, 60), false);
+    REQUIRE(arena.createForegroundSearched.size() == Size2i(80, 60));
+    REQUIRE(all_zero_mask(arena.createForegroundSearched));
+    REQUIRE(arena.createForegroundSearchedBounds.empty());
+}
+
+TEST_CASE("Per frame layer clearing", "[.][scratch_arena][benchmark]") {
+    const Size2i size(160, 120);
+    const int iterations = 2000;
+
+    BitmapMask masks[11];
+    BitmapF floats[10];
+    std::size_t everyLayerBytes = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        everyLayerBytes = clear_every_layer(masks, 11, floats, 10, size);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    double everyLayerUs = std::chrono::duration<double, std::micro>(elapsed).count() / iterations;
+
+    scratch_arena arena;
+    arena.begin_frame(size, false);
+    std::size_t arenaBytes = 0;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        //a hand sized flood fill in each searched layer
+        arena.createForegroundSearchedBounds.add(60, 40);
+        arena.createForegroundSearchedBounds.add(100, 80);
+        arena.updateForegroundSearchedBounds.add(60, 40);
+        arena.updateForegroundSearchedBounds.add(100, 80);
+        arenaBytes = arena.begin_frame(size, false);
+    }
+    elapsed = std::chrono::steady_clock::now() - start;
+    double arenaUs = std::chrono::duration<double, std::micro>(elapsed).count() / iterations;
+
+    WARN("160x120 every layer: " << everyLayerBytes << " bytes, " << everyLayerUs << " us per frame");
+    WARN("160x120 arena: " << arenaBytes << " bytes, " << arenaUs << " us per frame");
+}
+
+TEST_CASE("Merging searched layers in order matches writing them in order", "[scratch_arena]") {
+    const Size2i size(16, 12);
+
+    BitmapMask serial(size);
+    serial.fill(0);
+
+    BitmapMask merged(size);
+    merged.fill(0);
+    dirty_rect mergedBounds;
+
+    searched_scratch first;
+    first.prepare(size);
+    searched_scratch second;
+    second.prepare(size);
+
+    //overlapping writes, the later one wins
+    for (int y = 2; y < 6; ++y)
+    {
+        for (int x = 3; x < 9; ++x)
+        {
+            serial.at(x, y) = 3;
+            first.foregroundSearched.at(x, y) = 3;
+            first.foregroundSearchedBounds.add(x, y);
+        }
+    }
+    for (int y = 4; y < 10; ++y)
+    {
+        for (int x = 7; x < 12; ++x)
+        {
+            serial.at(x, y) = 2;
+            second.foregroundSearched.at(x, y) = 2;
+            second.foregroundSearchedBounds.add(x, y);
+        }
+    }
+
+    merge_dirty(first.foregroundSearched, first.foregroundSearchedBounds, merged, mergedBounds);
+    merge_dirty(second.foregroundSearched, second.foregroundSearchedBounds, merged, mergedBounds);
+
+    REQUIRE(std::equal(serial.data(), serial.data() + serial.length(), merged.data()));
+
+    REQUIRE(mergedBounds.left == 3);
+    REQUIRE(mergedBounds.top == 2);
+    REQUIRE(mergedBounds.right == 12);
+    REQUIRE(mergedBounds.bottom == 10);
+
+    //sources are ready for the next frame
+    REQUIRE(first.foregroundSearchedBounds.empty());
+    REQUIRE(second.foregroundSearchedBounds.empty());
+    REQUIRE(all_zero_mask(first.foregroundSearched));
+    REQUIRE(all_zero_mask(second.foregroundSearched));
+}
@@ -0,0 +1,88 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#include "catch.hpp"
+#include "../hnd_task_pool.hpp"
+#include <atomic>
+#include <vector>
+
+using namespace astra::hand;
+
+TEST_CASE("Task pool runs every task once", "[task_pool]") {
+    task_pool pool(4);
+    REQUIRE(pool.slot_count() == 4);
+
+    const std::size_t taskCount = 1000;
+    std::vector<std::atomic<int>> runs(taskCount);
+    for (auto& count : runs)
+    {
+        count = 0;
+    }
+    std::atomic<bool> slotInRange(true);
+
+    pool.run(taskCount,
+        [&] (std::size_t index, std::size_t slot)
+        {
+            ++runs[index];
+            if (slot >= pool.slot_count())
+            {
+                slotInRange = false;
+            }
+        });
+
+    REQUIRE(slotInRange);
+    for (auto& count : runs)
+    {
+        REQUIRE(count == 1);
+    }
+}
+
+TEST_CASE("Task pool can be reused for many batches", "[task_pool]") {
+    task_pool pool(3);
+
+    for (std::size_t batch = 0; batch < 200; ++batch)
+    {
+        const std::size_t taskCount = batch % 7;
+        std::vector<int> results(taskCount, 0);
+
+        //each task writes only its own element, like the tracked point updates
+        pool.run(taskCount,
+            [&] (std::size_t index, std::size_t)
+            {
+                results[index] = static_cast<int>(index * batch);
+            });
+
+        for (std::size_t i = 0; i < taskCount; ++i)
+        {
+            REQUIRE(results[i] == static_cast<int>(i * batch));
+        }
+    }
+}
+
+TEST_CASE("Single thread task pool runs tasks in order on the caller", "[task_pool]") {
+    task_pool pool(1);
+    REQUIRE(pool.slot_count() == 1);
+
+    std::vector<std::size_t> order;
+    pool.run(5,
+        [&] (std::size_t index, std::size_t slot)
+        {
+            REQUIRE(slot == 0);
+            order.push_back(index);
+        });
+
+    REQUIRE(order == std::vector<std::size_t>({ 0, 1, 2, 3, 4 }));
+}
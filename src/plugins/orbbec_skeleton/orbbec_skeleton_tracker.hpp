@@ -41,9 +41,6 @@ namespace orbbec { namespace skeleton {
               pluginService_(pluginService)
         {
             depthStream_ = reader_.stream<astra::DepthStream>();
-            depthStream_.start();
-
-            reader_.add_listener(*this);
 
             LOG_DEBUG("orbbec.skeleton.skeleton_tracker", "creating skeleton stream for %p", sourceStreamHandle_);
             auto s = astra::plugins::make_stream<skeletonstream>(pluginService_,
@@ -51,12 +48,19 @@ namespace orbbec { namespace skeleton {
                                                                  skeleton_tracker::MAX_SKELETONS);
             s->set_handler(this);
             skeletonStream_ = std::unique_ptr<skeletonstream>(std::move(s));
+
+            dataflowNode_ = std::unique_ptr<astra::plugins::dataflow_node>(
+                new astra::plugins::dataflow_node(pluginService_,
+                                                  reader_,
+                                                  { astra::StreamDescription(ASTRA_STREAM_DEPTH) },
+                                                  { astra::StreamDescription(ASTRA_STREAM_SKELETON) },
+                                                  *this));
         }
 
         virtual ~skeleton_tracker() override
         {
+            dataflowNode_.reset();
             skeletonStream_->set_handler(nullptr);
-            reader_.remove_listener(*this);
 
             LOG_DEBUG("orbbec.skeleton.skeleton_tracker", "destroying skeleton tracker for %p", sourceStreamHandle_);
         }
@@ -88,6 +92,8 @@ namespace orbbec { namespace skeleton {
 
         using skeletonstream_ptr = std::unique_ptr<skeletonstream>;
         skeletonstream_ptr skeletonStream_;
+
+        std::unique_ptr<astra::plugins::dataflow_node> dataflowNode_;
     };
 }}
 
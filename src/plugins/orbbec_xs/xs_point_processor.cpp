@@ -16,6 +16,7 @@
 // Be excellent to each other.
 #include "xs_point_processor.hpp"
 #include <Shiny.h>
+#include <algorithm>
 
 namespace astra { namespace xs {
 
@@ -26,14 +27,22 @@ namespace astra { namespace xs {
           setHandle_(streamset),
           reader_(streamset_.create_reader()),
           depthStream_(reader_.stream<DepthStream>(depthDesc.subtype())),
-          pluginService_(pluginService)
+          pluginService_(pluginService),
+          dataflowNode_(pluginService,
+                        reader_,
+                        { depthDesc },
+                        { StreamDescription(ASTRA_STREAM_POINT) },
+                        *this)
+    {}
+
+    point_processor::~point_processor()
     {
-        depthStream_.start();
-        reader_.add_listener(*this);
+        if (pointStream_)
+        {
+            pluginService_.set_stream_compute_callback(pointStream_->get_handle(), nullptr, nullptr);
+        }
     }
 
-    point_processor::~point_processor() = default;
-
     void point_processor::on_frame_ready(StreamReader& reader, Frame& frame)
     {
         const DepthFrame depthFrame = frame.get<DepthFrame>();
@@ -43,7 +52,7 @@ namespace astra { namespace xs {
         if (pointStream_->has_connections())
         {
             LOG_TRACE("astra.xs.point_processor", "updating point frame");
-            update_pointframe_from_depth(depthFrame);
+            update_pointframe_from_depth(frame, depthFrame);
         }
     }
 
@@ -60,17 +69,22 @@ namespace astra { namespace xs {
         auto ps = plugins::make_stream<PointStream>(pluginService_, setHandle_, width, height);
         pointStream_ = std::unique_ptr<PointStream>(std::move(ps));
 
+        pluginService_.set_stream_compute_callback(pointStream_->get_handle(),
+                                                   &point_processor::compute_point_frame_thunk,
+                                                   this);
+
         LOG_INFO("astra.xs.point_processor", "created point stream");
 
         depthConversionCache_ = depthStream_.depth_to_world_data();
     }
 
-    void point_processor::update_pointframe_from_depth(const DepthFrame& depthFrame)
+    void point_processor::update_pointframe_from_depth(Frame& frame, const DepthFrame& depthFrame)
     {
         //use same frameIndex as source depth frame
         astra_frame_index_t frameIndex = depthFrame.frame_index();
 
-        astra_imageframe_wrapper_t* pointFrameWrapper = pointStream_->begin_write(frameIndex);
+        auto buffers = pointStream_->begin_write_ex(frameIndex);
+        astra_imageframe_wrapper_t* pointFrameWrapper = buffers.second;
 
         if (pointFrameWrapper != nullptr)
         {
@@ -85,13 +99,83 @@ namespace astra { namespace xs {
 
             pointFrameWrapper->frame.metadata = metadata;
 
-            Vector3f* p_points = reinterpret_cast<Vector3f*>(pointFrameWrapper->frame.data);
-            calculate_point_frame(depthFrame, p_points);
+            //shares the depth data rather than copying it. must be in place
+            //before end_write(), a reader may ask for the points right away
+            keep_depth_frame(buffers.first, frame.retain());
 
             pointStream_->end_write();
         }
     }
 
+    void point_processor::keep_depth_frame(astra_frame_t* pointBuffer, Frame depthFrame)
+    {
+        //the replaced frame is released on return, outside the lock, since
+        //releasing it takes the core mutex that compute_point_frame runs under
+        Frame replacedFrame(nullptr);
+        {
+            std::lock_guard<std::mutex> lock(pendingDepthFramesMutex_);
+
+            auto it = std::find_if(pendingDepthFrames_.begin(),
+                                   pendingDepthFrames_.end(),
+                                   [pointBuffer] (const pending_depth_frame& pending)
+                                   { return pending.pointBuffer == pointBuffer; });
+
+            if (it != pendingDepthFrames_.end())
+            {
+                replacedFrame = it->depthFrame;
+                it->depthFrame = depthFrame;
+            }
+            else
+            {
+                pendingDepthFrames_.push_back({ pointBuffer, depthFrame });
+            }
+        }
+    }
+
+    void point_processor::compute_point_frame_thunk(void* clientTag,
+                                                    astra_stream_t stream,
+                                                    astra_frame_t* pointBuffer)
+    {
+        static_cast<point_processor*>(clientTag)->compute_point_frame(pointBuffer);
+    }
+
+    void point_processor::compute_point_frame(astra_frame_t* pointBuffer)
+    {
+        Frame frame(nullptr);
+        {
+            std::lock_guard<std::mutex> lock(pendingDepthFramesMutex_);
+
+            auto it = std::find_if(pendingDepthFrames_.begin(),
+                                   pendingDepthFrames_.end(),
+                                   [pointBuffer] (const pending_depth_frame& pending)
+                                   { return pending.pointBuffer == pointBuffer; });
+
+            if (it != pendingDepthFrames_.end())
+            {
+                frame = it->depthFrame;
+            }
+        }
+
+        if (!frame)
+        {
+            LOG_WARN("astra.xs.point_processor", "no depth frame kept for point frame %d", pointBuffer->frameIndex);
+            return;
+        }
+
+        const DepthFrame depthFrame = frame.get<DepthFrame>();
+        if (!depthFrame.is_valid() || depthFrame.frame_index() != pointBuffer->frameIndex)
+        {
+            LOG_WARN("astra.xs.point_processor", "depth frame kept for point frame %d is missing", pointBuffer->frameIndex);
+            return;
+        }
+
+        astra_imageframe_wrapper_t* pointFrameWrapper =
+            static_cast<astra_imageframe_wrapper_t*>(pointBuffer->data);
+
+        Vector3f* p_points = reinterpret_cast<Vector3f*>(pointFrameWrapper->frame.data);
+        calculate_point_frame(depthFrame, p_points);
+    }
+
     void point_processor::calculate_point_frame(const DepthFrame& depthFrame,
                                                 Vector3f* p_points)
     {
@@ -20,6 +20,8 @@
 #include <astra_core/plugins/Plugin.hpp>
 #include <astra/astra.hpp>
 #include "xs_pointstream.hpp"
+#include <mutex>
+#include <vector>
 
 namespace astra { namespace xs {
 
@@ -35,7 +37,13 @@ namespace astra { namespace xs {
     private:
         void create_point_stream_if_necessary(const DepthFrame& depthFrame);
 
-        void update_pointframe_from_depth(const DepthFrame& depthFrame);
+        void update_pointframe_from_depth(Frame& frame, const DepthFrame& depthFrame);
+        void keep_depth_frame(astra_frame_t* pointBuffer, Frame depthFrame);
+
+        static void compute_point_frame_thunk(void* clientTag,
+                                              astra_stream_t stream,
+                                              astra_frame_t* pointBuffer);
+        void compute_point_frame(astra_frame_t* pointBuffer);
         void calculate_point_frame(const DepthFrame& depthFrame,
                                    Vector3f* p_points);
 
@@ -49,6 +57,22 @@ namespace astra { namespace xs {
         PointStreamPtr pointStream_;
 
         conversion_cache_t depthConversionCache_;
+
+        //point frames are published without data and computed when a reader
+        //asks for them. each point bin buffer keeps the depth it was published
+        //for until it is written again. on_frame_ready may run on a dataflow
+        //worker while a reader computes, so the list is guarded
+        struct pending_depth_frame
+        {
+            astra_frame_t* pointBuffer;
+            Frame depthFrame;
+        };
+
+        std::mutex pendingDepthFramesMutex_;
+        std::vector<pending_depth_frame> pendingDepthFrames_;
+
+        //last, so it stops calling on_frame_ready before the rest goes away
+        plugins::dataflow_node dataflowNode_;
     };
 }}
 
@@ -0,0 +1,140 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#include "shm_client_plugin.hpp"
+#include <cstring>
+#include <dirent.h>
+
+EXPORT_PLUGIN(astra::shm::plugin);
+
+namespace astra { namespace shm {
+
+    //segments created by shm_open on Linux
+    const char* const SEGMENT_DIRECTORY = "/dev/shm";
+    const char* const URI_SCHEME = "shm://";
+
+    //exports come and go rarely, no need to list the directory every update
+    const std::chrono::seconds SCAN_INTERVAL(1);
+
+    plugin::~plugin()
+    {
+        streams_.clear();
+
+        for (auto& pair : streamSets_)
+        {
+            pluginService().destroy_stream_set(pair.second);
+        }
+
+        LOG_INFO("astra.shm_client", "Terminated shm client plugin");
+    }
+
+    void plugin::temp_update()
+    {
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastScan_ >= SCAN_INTERVAL)
+        {
+            lastScan_ = now;
+            remove_closed_streams();
+            find_new_segments();
+        }
+
+        for (auto& pair : streams_)
+        {
+            pair.second->update();
+        }
+    }
+
+    void plugin::find_new_segments()
+    {
+        DIR* directory = opendir(SEGMENT_DIRECTORY);
+        if (directory == nullptr)
+        {
+            return;
+        }
+
+        const size_t prefixLength = strlen(SEGMENT_NAME_PREFIX);
+
+        while (dirent* entry = readdir(directory))
+        {
+            if (strncmp(entry->d_name, SEGMENT_NAME_PREFIX, prefixLength) != 0)
+            {
+                continue;
+            }
+
+            std::string name = std::string("/") + entry->d_name;
+            if (streams_.find(name) != streams_.end())
+            {
+                continue;
+            }
+
+            std::unique_ptr<segment_mapping> segment = segment_mapping::open(name);
+            if (!segment)
+            {
+                continue;
+            }
+
+            const segment_header* header = segment->header();
+            std::string setUri = std::string(URI_SCHEME) +
+                std::string(header->uri, strnlen(header->uri, MAX_URI_LENGTH));
+
+            LOG_INFO("astra.shm_client", "mirroring %s type: %d subtype: %d from process %d",
+                     setUri.c_str(),
+                     header->description.type,
+                     header->description.subtype,
+                     header->hostPid);
+
+            astra_streamset_t setHandle = add_or_get_streamset(setUri);
+
+            streams_[name] = client_stream_ptr(plugins::make_stream<client_stream>(pluginService(),
+                                                                                   setHandle,
+                                                                                   std::move(segment)));
+        }
+
+        closedir(directory);
+    }
+
+    void plugin::remove_closed_streams()
+    {
+        auto it = streams_.begin();
+        while (it != streams_.end())
+        {
+            if (!it->second->is_closed())
+            {
+                ++it;
+                continue;
+            }
+
+            LOG_INFO("astra.shm_client", "removing %s", it->first.c_str());
+
+            it = streams_.erase(it);
+        }
+    }
+
+    astra_streamset_t plugin::add_or_get_streamset(const std::string& uri)
+    {
+        auto it = streamSets_.find(uri);
+        if (it != streamSets_.end())
+        {
+            return it->second;
+        }
+
+        astra_streamset_t setHandle;
+        pluginService().create_stream_set(uri.c_str(), setHandle);
+
+        streamSets_.insert(std::make_pair(uri, setHandle));
+        return setHandle;
+    }
+}}
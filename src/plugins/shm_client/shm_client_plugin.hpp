@@ -0,0 +1,63 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#ifndef SHM_CLIENT_PLUGIN_H
+#define SHM_CLIENT_PLUGIN_H
+
+#include <astra_core/plugins/Plugin.hpp>
+#include "shm_client_stream.hpp"
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace astra { namespace shm {
+
+    // Mirrors the streams other processes export to shared memory (see
+    // [shared_memory] in astra.toml). A stream exported from "device/sensor0"
+    // shows up here as part of the streamset "shm://device/sensor0".
+    class plugin : public astra::plugins::plugin_base
+    {
+    public:
+        plugin(PluginServiceProxy* pluginProxy)
+            : plugin_base(pluginProxy, "shm_client")
+        {
+            LOG_INFO("astra.shm_client", "Initializing shm client plugin");
+        }
+
+        virtual ~plugin();
+
+        virtual void temp_update() override;
+
+    private:
+        void find_new_segments();
+        void remove_closed_streams();
+
+        astra_streamset_t add_or_get_streamset(const std::string& uri);
+
+        using client_stream_ptr = std::unique_ptr<client_stream>;
+
+        //by segment name
+        std::map<std::string, client_stream_ptr> streams_;
+        //by uri, "shm://device/sensor0". kept until the plugin goes away so
+        //readers stay connected while their host restarts.
+        std::map<std::string, astra_streamset_t> streamSets_;
+
+        std::chrono::steady_clock::time_point lastScan_;
+    };
+}}
+
+#endif /* SHM_CLIENT_PLUGIN_H */
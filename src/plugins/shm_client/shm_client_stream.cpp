@@ -0,0 +1,266 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#include "shm_client_stream.hpp"
+#include <astra/capi/astra_ctypes.h>
+#include <astra/capi/streams/stream_types.h>
+#include <astra/capi/streams/skeleton_types.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace astra { namespace shm {
+
+    //bounds how long the receiver takes to notice shutdown or a dead host
+    const int RECEIVE_TIMEOUT_MS = 100;
+    const size_t NO_POINTER = SIZE_MAX;
+
+    std::unique_ptr<segment_mapping> segment_mapping::open(const std::string& name)
+    {
+        int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0)
+        {
+            return nullptr;
+        }
+
+        struct stat segmentStat;
+        if (fstat(fd, &segmentStat) != 0 ||
+            static_cast<size_t>(segmentStat.st_size) < sizeof(segment_header))
+        {
+            close(fd);
+            return nullptr;
+        }
+
+        const size_t mappedSize = static_cast<size_t>(segmentStat.st_size);
+        void* mapped = mmap(nullptr, mappedSize, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+
+        if (mapped == MAP_FAILED)
+        {
+            return nullptr;
+        }
+
+        std::unique_ptr<segment_mapping> mapping(
+            new segment_mapping(name, static_cast<segment_header*>(mapped), mappedSize));
+
+        const segment_header* header = mapping->header();
+        bool valid = header->magic == SEGMENT_MAGIC;
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        valid = valid &&
+            header->version == SEGMENT_VERSION &&
+            header->slotCount > 0 &&
+            segment_size(header->slotCount, static_cast<size_t>(header->slotSize)) <= mappedSize &&
+            header->hostPid != static_cast<int32_t>(getpid()) &&
+            header->closed.load() == 0 &&
+            mapping->is_host_alive();
+
+        return valid ? std::move(mapping) : nullptr;
+    }
+
+    segment_mapping::segment_mapping(std::string name, segment_header* header, size_t mappedSize)
+        : name_(name),
+          header_(header),
+          mappedSize_(mappedSize)
+    { }
+
+    segment_mapping::~segment_mapping()
+    {
+        munmap(header_, mappedSize_);
+    }
+
+    bool segment_mapping::is_host_alive() const
+    {
+        return kill(static_cast<pid_t>(header_->hostPid), 0) == 0 || errno == EPERM;
+    }
+
+    client_stream::client_stream(PluginServiceProxy& pluginService,
+                                 astra_streamset_t streamSet,
+                                 std::unique_ptr<segment_mapping> segment)
+        : stream(pluginService, streamSet, segment->header()->description),
+          segment_(std::move(segment))
+    {
+        bin_ = astra::make_unique<bin_type>(pluginService,
+                                            get_handle(),
+                                            static_cast<size_t>(segment_->header()->slotSize));
+
+        receiver_ = std::thread(&client_stream::receive, this);
+    }
+
+    client_stream::~client_stream()
+    {
+        running_ = false;
+
+        //wakes every waiter on the segment, the others just wait again
+        futex_wake_all(&segment_->header()->publishedSequence);
+
+        if (receiver_.joinable())
+        {
+            receiver_.join();
+        }
+    }
+
+    void client_stream::on_connection_added(astra_streamconnection_t connection)
+    {
+        bin_->link_connection(connection);
+    }
+
+    void client_stream::on_connection_removed(astra_bin_t bin,
+                                              astra_streamconnection_t connection)
+    {
+        bin_->unlink_connection(connection);
+    }
+
+    void client_stream::update()
+    {
+        connected_ = bin_->has_connections();
+
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        if (pendingFrame_)
+        {
+            bin_->end_write();
+            pendingFrame_ = false;
+        }
+    }
+
+    void client_stream::receive()
+    {
+        segment_header* header = segment_->header();
+
+        //a frame published before the stream existed counts as new
+        uint32_t seenSequence = header->publishedSequence.load() - 1;
+
+        while (running_)
+        {
+            uint32_t sequence = header->publishedSequence.load(std::memory_order_acquire);
+
+            if (header->closed.load() != 0)
+            {
+                LOG_INFO("astra.shm_client", "%s closed by its host", segment_->name().c_str());
+                break;
+            }
+
+            if (sequence == seenSequence)
+            {
+                futex_wait(&header->publishedSequence, sequence, RECEIVE_TIMEOUT_MS);
+
+                if (header->publishedSequence.load() == sequence && !segment_->is_host_alive())
+                {
+                    LOG_WARN("astra.shm_client", "host of %s is gone", segment_->name().c_str());
+                    break;
+                }
+
+                continue;
+            }
+
+            seenSequence = sequence;
+
+            if (connected_)
+            {
+                copy_latest_frame();
+            }
+        }
+
+        closed_ = true;
+    }
+
+    void client_stream::copy_latest_frame()
+    {
+        segment_header* header = segment_->header();
+
+        uint32_t slot = header->latestSlot.load(std::memory_order_acquire);
+        if (slot >= header->slotCount)
+        {
+            return;
+        }
+
+        const slot_header* slotHeader = get_slot_header(header, slot);
+
+        uint32_t generation = slotHeader->generation.load(std::memory_order_acquire);
+        if ((generation & 1) != 0)
+        {
+            //the host is already rewriting it, a newer frame is on the way
+            return;
+        }
+
+        const astra_frame_index_t frameIndex = slotHeader->frameIndex;
+        const uint64_t hostAddress = slotHeader->hostAddress;
+        const size_t byteLength = std::min(static_cast<size_t>(slotHeader->byteLength),
+                                           static_cast<size_t>(header->slotSize));
+
+        std::lock_guard<std::mutex> lock(writeMutex_);
+
+        std::pair<astra_frame_t*, uint8_t*> backBuffer = bin_->begin_write_ex(frameIndex);
+        backBuffer.first->frameIndex = frameIndex;
+        memcpy(backBuffer.second, get_slot_data(header, slot), byteLength);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slotHeader->generation.load(std::memory_order_relaxed) != generation)
+        {
+            //torn copy, and whatever was pending before is gone too
+            pendingFrame_ = false;
+            return;
+        }
+
+        relocate_frame_pointer(backBuffer.second, hostAddress, byteLength);
+        pendingFrame_ = true;
+    }
+
+    static size_t frame_pointer_offset(astra_stream_type_t type)
+    {
+        switch (type)
+        {
+        case ASTRA_STREAM_DEPTH:
+        case ASTRA_STREAM_COLOR:
+        case ASTRA_STREAM_INFRARED:
+        case ASTRA_STREAM_STYLIZED_DEPTH:
+        case ASTRA_STREAM_POINT:
+        case ASTRA_STREAM_DEBUG_HAND:
+            return offsetof(_astra_imageframe, data);
+        case ASTRA_STREAM_HAND:
+            return offsetof(_astra_handframe, handpoints);
+        case ASTRA_STREAM_SKELETON:
+            return offsetof(_astra_skeletonframe, skeletons);
+        default:
+            return NO_POINTER;
+        }
+    }
+
+    void client_stream::relocate_frame_pointer(uint8_t* data, uint64_t hostAddress, size_t byteLength)
+    {
+        //frame wrappers point at their own data, which the host mapped elsewhere
+        const size_t offset = frame_pointer_offset(segment_->header()->description.type);
+        if (offset == NO_POINTER || offset + sizeof(uintptr_t) > byteLength)
+        {
+            return;
+        }
+
+        uintptr_t pointer;
+        memcpy(&pointer, data + offset, sizeof(pointer));
+
+        if (pointer >= hostAddress && pointer < hostAddress + byteLength)
+        {
+            pointer = reinterpret_cast<uintptr_t>(data) + (pointer - hostAddress);
+            memcpy(data + offset, &pointer, sizeof(pointer));
+        }
+    }
+}}
@@ -0,0 +1,98 @@
+// This file is part of the Orbbec Astra SDK [https://orbbec3d.com]
+// Copyright (c) 2015 Orbbec 3D
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Be excellent to each other.
+#ifndef SHM_CLIENT_STREAM_H
+#define SHM_CLIENT_STREAM_H
+
+#include <astra_core/plugins/Plugin.hpp>
+#include <astra_core/plugins/StreamBin.hpp>
+#include <astra_shm_segment.hpp>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace astra { namespace shm {
+
+    // Read-only mapping of a segment another process exports.
+    class segment_mapping
+    {
+    public:
+        //nullptr unless the segment is complete and its host is another live process
+        static std::unique_ptr<segment_mapping> open(const std::string& name);
+        ~segment_mapping();
+
+        segment_mapping(const segment_mapping&) = delete;
+        segment_mapping& operator=(const segment_mapping&) = delete;
+
+        const std::string& name() const { return name_; }
+        segment_header* header() const { return header_; }
+        bool is_host_alive() const;
+
+    private:
+        segment_mapping(std::string name, segment_header* header, size_t mappedSize);
+
+        const std::string name_;
+        segment_header* header_;
+        const size_t mappedSize_;
+    };
+
+    // Mirrors one exported stream. A receiver thread sleeps on the segment's
+    // futex and copies each published frame into the back buffer, the
+    // plugin update cycles it to readers. Frames are copied because readers
+    // write into frame data and the mapping is read-only.
+    class client_stream : public plugins::stream
+    {
+    public:
+        client_stream(PluginServiceProxy& pluginService,
+                      astra_streamset_t streamSet,
+                      std::unique_ptr<segment_mapping> segment);
+        virtual ~client_stream();
+
+        //called from the plugin update
+        void update();
+
+        //the host stopped publishing or went away
+        bool is_closed() const { return closed_; }
+
+    protected:
+        virtual void on_connection_added(astra_streamconnection_t connection) override;
+        virtual void on_connection_removed(astra_bin_t bin,
+                                           astra_streamconnection_t connection) override;
+
+    private:
+        void receive();
+        void copy_latest_frame();
+        void relocate_frame_pointer(uint8_t* data, uint64_t hostAddress, size_t byteLength);
+
+        std::unique_ptr<segment_mapping> segment_;
+
+        using bin_type = plugins::stream_bin<uint8_t>;
+        std::unique_ptr<bin_type> bin_;
+
+        //guards the back buffer between the receiver and update()
+        std::mutex writeMutex_;
+        bool pendingFrame_{false};
+
+        std::atomic<bool> connected_{false};
+        std::atomic<bool> closed_{false};
+        std::atomic<bool> running_{true};
+        std::thread receiver_;
+    };
+}}
+
+#endif /* SHM_CLIENT_STREAM_H */